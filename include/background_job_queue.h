@@ -0,0 +1,116 @@
+#pragma once
+
+#include "logger.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+// FIFO of jobs run one at a time on a background thread, for post-processing of finished
+// takes (StagingMigrator, EventTranscoder). The owner supplies the work and how its result
+// is reported; users get a completion callback and can wait for the queue to drain.
+// Declare it as the owner's last member so its thread stops before the state it uses.
+template <typename Job>
+class BackgroundJobQueue {
+public:
+    // Runs one job; false or an exception (its text becomes the message) means failure
+    using RunFn = std::function<bool(const Job& job, std::string& message)>;
+    using CompletionCallback = std::function<void(const Job& job, bool success, const std::string& message)>;
+
+    // description names the pending work in the shutdown message, e.g. "staged take(s) to be migrated"
+    BackgroundJobQueue(std::string description, RunFn run, CompletionCallback report)
+        : m_description(std::move(description)), m_run(std::move(run)), m_report(std::move(report)) {
+        m_thread = std::thread(&BackgroundJobQueue::worker, this);
+    }
+
+    // Finishes all queued jobs
+    ~BackgroundJobQueue() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_queue.empty() || m_busy) {
+                EBV_LOG_INFO << "Waiting for " << (m_queue.size() + (m_busy ? 1 : 0)) << " " << m_description << "...";
+            }
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    BackgroundJobQueue(const BackgroundJobQueue&) = delete;
+    BackgroundJobQueue& operator=(const BackgroundJobQueue&) = delete;
+
+    void enqueue(Job job) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(std::move(job));
+        }
+        m_condition.notify_one();
+    }
+
+    void setCompletionCallback(CompletionCallback callback) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_callback = std::move(callback);
+    }
+
+    // Block until every queued job has finished
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idleCondition.wait(lock, [this] { return m_queue.empty() && !m_busy; });
+    }
+
+    size_t pendingJobs() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_queue.size() + (m_busy ? 1 : 0);
+    }
+
+private:
+    void worker() {
+        while (true) {
+            Job job;
+            CompletionCallback callback;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+                if (m_queue.empty()) break; // stopping and drained
+                job = std::move(m_queue.front());
+                m_queue.pop_front();
+                m_busy = true;
+                callback = m_callback;
+            }
+
+            std::string message;
+            bool ok = false;
+            try {
+                ok = m_run(job, message);
+            } catch (const std::exception& e) {
+                message = e.what();
+            }
+            if (m_report) m_report(job, ok, message);
+            if (callback) callback(job, ok, message);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_busy = false;
+            }
+            m_idleCondition.notify_all();
+        }
+    }
+
+    const std::string m_description;
+    const RunFn m_run;
+    const CompletionCallback m_report;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::condition_variable m_idleCondition;
+    std::deque<Job> m_queue;
+    bool m_busy{false};
+    bool m_stopping{false};
+    CompletionCallback m_callback;
+    std::thread m_thread;
+};
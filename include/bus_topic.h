@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Generic building blocks for the in-process live data bus (see live_data_bus.h).
+// Publishers hand out reference-counted immutable payloads; every subscriber owns a
+// bounded queue with its own drop policy, so a slow consumer only ever loses its own
+// items and never back-pressures the publishing (capture) thread.
+
+enum class DropPolicy {
+    DropOldest,  // keep the most recent items (GUI, analytics)
+    DropNewest   // keep the backlog, reject new items when full (writers, exporters)
+};
+
+template <typename T>
+class BusTopic;
+
+template <typename T>
+class BusSubscription {
+public:
+    using Ptr = std::shared_ptr<const T>;
+
+    BusSubscription(std::string name, size_t capacity, DropPolicy policy)
+        : m_name(std::move(name)), m_capacity(capacity == 0 ? 1 : capacity), m_policy(policy) {}
+
+    const std::string& name() const { return m_name; }
+    size_t capacity() const { return m_capacity; }
+    DropPolicy policy() const { return m_policy; }
+
+    // Non-blocking pop of the oldest queued item
+    bool tryPop(Ptr& out) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty()) return false;
+        out = std::move(m_queue.front());
+        m_queue.pop_front();
+        return true;
+    }
+
+    // Blocking pop with timeout; returns false on timeout or when the subscription is closed
+    bool waitPop(Ptr& out, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_cv.wait_for(lock, timeout, [this] { return !m_queue.empty() || m_closed; })) {
+            return false;
+        }
+        if (m_queue.empty()) return false;
+        out = std::move(m_queue.front());
+        m_queue.pop_front();
+        return true;
+    }
+
+    // Drain the queue and return only the most recent item (nullptr if nothing was queued)
+    Ptr takeLatest() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty()) return nullptr;
+        Ptr latest = std::move(m_queue.back());
+        m_queue.clear();
+        return latest;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_queue.size();
+    }
+
+    size_t delivered() const { return m_delivered.load(std::memory_order_relaxed); }
+    size_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Wake up any waiting consumer; further pushes are ignored
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+            m_queue.clear();
+        }
+        m_cv.notify_all();
+    }
+
+    bool isClosed() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_closed;
+    }
+
+private:
+    friend class BusTopic<T>;
+
+    // Called on the publisher thread; O(1) and never waits for the consumer
+    void push(const Ptr& item) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_closed) return;
+            if (m_queue.size() >= m_capacity) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                if (m_policy == DropPolicy::DropNewest) return;
+                m_queue.pop_front();
+            }
+            m_queue.push_back(item);
+            m_delivered.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_cv.notify_one();
+    }
+
+    const std::string m_name;
+    const size_t m_capacity;
+    const DropPolicy m_policy;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Ptr> m_queue;
+    bool m_closed{false};
+    std::atomic<size_t> m_delivered{0};
+    std::atomic<size_t> m_dropped{0};
+};
+
+template <typename T>
+class BusTopic {
+public:
+    using Ptr = std::shared_ptr<const T>;
+    using SubscriptionPtr = std::shared_ptr<BusSubscription<T>>;
+
+    BusTopic() : m_subscribers(std::make_shared<const SubscriberList>()) {}
+
+    SubscriptionPtr subscribe(const std::string& name, size_t capacity, DropPolicy policy = DropPolicy::DropOldest) {
+        auto subscription = std::make_shared<BusSubscription<T>>(name, capacity, policy);
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        auto updated = std::make_shared<SubscriberList>(*std::atomic_load(&m_subscribers));
+        updated->push_back(subscription);
+        m_subscriberCount.store(updated->size(), std::memory_order_release);
+        std::atomic_store(&m_subscribers, std::shared_ptr<const SubscriberList>(std::move(updated)));
+        return subscription;
+    }
+
+    void unsubscribe(const SubscriptionPtr& subscription) {
+        if (!subscription) return;
+        subscription->close();
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        auto updated = std::make_shared<SubscriberList>();
+        for (const auto& s : *std::atomic_load(&m_subscribers)) {
+            if (s != subscription) updated->push_back(s);
+        }
+        m_subscriberCount.store(updated->size(), std::memory_order_release);
+        std::atomic_store(&m_subscribers, std::shared_ptr<const SubscriberList>(std::move(updated)));
+    }
+
+    // Publishers may skip building a payload entirely when nobody listens
+    bool hasSubscribers() const { return m_subscriberCount.load(std::memory_order_acquire) > 0; }
+    size_t subscriberCount() const { return m_subscriberCount.load(std::memory_order_acquire); }
+
+    // Fan out one shared payload to every subscriber (no copies of T)
+    void publish(Ptr item) {
+        if (!item) return;
+        const auto subscribers = std::atomic_load(&m_subscribers); // copy-on-write snapshot
+        for (const auto& s : *subscribers) {
+            s->push(item);
+        }
+        m_published.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t published() const { return m_published.load(std::memory_order_relaxed); }
+
+private:
+    using SubscriberList = std::vector<SubscriptionPtr>;
+
+    std::mutex m_writeMutex; // serializes subscribe/unsubscribe only; publish is lock-free on the list
+    std::shared_ptr<const SubscriberList> m_subscribers;
+    std::atomic<size_t> m_subscriberCount{0};
+    std::atomic<size_t> m_published{0};
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+
+// Line-based control protocol of the recorder daemon over a local Unix domain socket.
+// Depends only on POSIX, so automation tools can link it without the camera SDKs.
+//
+//   request:  <command> [key=value ...]\n        e.g. "start prefix=calib"
+//   response: ok [key=value ...]\n | error <message>\n
+//
+// Values are percent-encoded (space, '%', '=' and control characters), so directory names
+// with spaces survive the round trip.
+namespace ControlProtocol {
+
+struct Request {
+    std::string command;
+    std::map<std::string, std::string> args;
+};
+
+struct Response {
+    bool ok{false};
+    std::string error;                         // set when !ok
+    std::map<std::string, std::string> fields; // set when ok
+};
+
+std::string encodeValue(const std::string& value);
+std::string decodeValue(const std::string& value);
+
+std::string formatRequest(const Request& request);
+// Throws std::runtime_error on malformed input (empty line, argument without '=')
+Request parseRequest(const std::string& line);
+std::string formatResponse(const Response& response);
+Response parseResponse(const std::string& line);
+
+inline Response okResponse(std::map<std::string, std::string> fields = {}) {
+    return Response{true, {}, std::move(fields)};
+}
+inline Response errorResponse(const std::string& message) {
+    return Response{false, message, {}};
+}
+
+} // namespace ControlProtocol
+
+// Serves requests on a Unix domain socket from one background thread. Clients are handled one
+// at a time, each may send several requests on its connection; the handler runs on the
+// server thread and may block (e.g. while a take is being closed). A client that sends no
+// complete line within the idle timeout is disconnected, so a stuck connection cannot lock
+// out everyone else.
+class ControlServer {
+public:
+    using Handler = std::function<ControlProtocol::Response(const ControlProtocol::Request& request)>;
+
+    static constexpr std::chrono::milliseconds DEFAULT_IDLE_TIMEOUT{5000};
+
+    ControlServer(std::string socketPath, Handler handler,
+                  std::chrono::milliseconds idleTimeout = DEFAULT_IDLE_TIMEOUT);
+    ~ControlServer();
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    // Bind and start serving; a stale socket file from a crashed daemon is replaced.
+    // Throws std::runtime_error if the socket cannot be created.
+    void start();
+    void stop();
+    bool isRunning() const { return m_running.load(); }
+    const std::string& socketPath() const { return m_socketPath; }
+
+private:
+    void serveLoop();
+    void serveClient(int clientFd);
+
+    const std::string m_socketPath;
+    const Handler m_handler;
+    const std::chrono::milliseconds m_idleTimeout;
+    int m_listenFd{-1};
+    int m_wakeFd[2]{-1, -1}; // self-pipe to interrupt poll() on stop
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+};
+
+class ControlClient {
+public:
+    // Send one request and wait for its response. Throws std::runtime_error if the daemon is
+    // not reachable or does not answer within the timeout.
+    static ControlProtocol::Response request(const std::string& socketPath, const ControlProtocol::Request& request,
+                                             std::chrono::milliseconds timeout = std::chrono::seconds(30));
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include "recording_manager.h"
+
+// Keeps cameras open and their streams allocated between takes. Devices are only closed on
+// an explicit release() (or when the owner shuts down), so the next take starts from a warm
+// device instead of going through the full open/configure path. Calls block the caller but run
+// on the manager's control thread, in order with commands queued by submit*().
+//
+//   Released --open()--> Idle --startStreaming()--> Streaming --startTake()--> Recording
+//   Recording --stopTake()--> Streaming --goIdle()--> Idle --release()--> Released
+class DeviceLifecycleManager {
+public:
+    enum class State { Released, Idle, Streaming, Recording };
+
+    explicit DeviceLifecycleManager(RecordingManager& manager);
+    ~DeviceLifecycleManager() = default;
+
+    DeviceLifecycleManager(const DeviceLifecycleManager&) = delete;
+    DeviceLifecycleManager& operator=(const DeviceLifecycleManager&) = delete;
+
+    // Open devices if released; otherwise apply config changes in place
+    bool open(const RecordingManager::RecordingConfig& config);
+    // Live preview on warm devices (opens with the last config if needed)
+    bool startStreaming();
+    // Start a take; time from call to recording is kept in lastTimeToTakeMs()
+    bool startTake(const std::string& outputDirectory);
+    // Stop the take; returns once the files are closed, devices keep streaming
+    void stopTake();
+    // Stop streaming but keep devices open and buffers allocated (idle power state:
+    // frame acquisition stopped, event sensors not streaming)
+    void goIdle();
+    // Close all devices; the next open()/startTake() performs a full configure
+    void release();
+
+    State state() const;
+    static const char* stateName(State state);
+    double lastTimeToTakeMs() const { return m_lastTimeToTakeMs.load(); }
+
+private:
+    bool ensureOpen();
+
+    RecordingManager& m_manager;
+    mutable std::mutex m_mutex;
+    RecordingManager::RecordingConfig m_config;
+    bool m_hasConfig{false};
+    std::atomic<double> m_lastTimeToTakeMs{0.0};
+};
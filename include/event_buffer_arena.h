@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Events in structure-of-arrays layout: rasterizers and filters touch only the columns
+// they need, and every column streams through the cache linearly.
+struct EventBlock {
+    std::vector<uint16_t> x;
+    std::vector<uint16_t> y;
+    std::vector<uint8_t> p;
+    std::vector<int64_t> t;
+
+    size_t size() const { return t.size(); }
+    bool empty() const { return t.empty(); }
+    size_t capacity() const { return t.capacity(); }
+    void clear() {
+        x.clear();
+        y.clear();
+        p.clear();
+        t.clear();
+    }
+    void reserve(size_t events) {
+        x.reserve(events);
+        y.reserve(events);
+        p.reserve(events);
+        t.reserve(events);
+    }
+    void swap(EventBlock& other) noexcept {
+        x.swap(other.x);
+        y.swap(other.y);
+        p.swap(other.p);
+        t.swap(other.t);
+    }
+
+    // Any event type with x, y, p, t members (Metavision::EventCD)
+    template <typename EventIt>
+    void append(EventIt begin, EventIt end) {
+        for (auto it = begin; it != end; ++it) push(*it);
+    }
+    template <typename EventIt, typename Predicate>
+    void appendIf(EventIt begin, EventIt end, Predicate keep) {
+        for (auto it = begin; it != end; ++it) {
+            if (keep(*it)) push(*it);
+        }
+    }
+    template <typename Event>
+    void push(const Event& event) {
+        x.push_back(static_cast<uint16_t>(event.x));
+        y.push_back(static_cast<uint16_t>(event.y));
+        p.push_back(static_cast<uint8_t>(event.p));
+        t.push_back(static_cast<int64_t>(event.t));
+    }
+};
+
+// Pool of event buffers that are recycled across windows/callbacks instead of being
+// allocated per use. New buffers are reserved to a moving average of the sizes seen on
+// release, so after warm-up the steady state does not allocate at all. Buffers may be
+// released on another thread than the one that acquired them (e.g. SDK callback thread
+// -> writer thread); the pool outlives its arena as long as buffers are in flight.
+//
+// Buffer is any container with clear(), size(), capacity() and reserve()
+// (EventBlock, std::vector<Metavision::EventCD>, ...).
+template <typename Buffer>
+class EventBufferArena {
+    struct Pool;
+
+public:
+    struct Recycler {
+        std::shared_ptr<Pool> pool;
+        void operator()(Buffer* buffer) const { pool->recycle(buffer); }
+    };
+    using Handle = std::unique_ptr<Buffer, Recycler>;
+
+    explicit EventBufferArena(size_t maxFreeBuffers = 32, size_t initialReserve = 4096)
+        : m_pool(std::make_shared<Pool>(maxFreeBuffers, initialReserve)) {}
+
+    // Empty buffer with at least the typical capacity
+    Handle acquire() { return Handle(m_pool->take(), Recycler{m_pool}); }
+
+    // Arena owned by the calling thread, for code that needs scratch buffers per window
+    static EventBufferArena& threadLocal() {
+        thread_local EventBufferArena arena;
+        return arena;
+    }
+
+    size_t typicalSize() const { return m_pool->typical.load(std::memory_order_relaxed); }
+    size_t allocations() const { return m_pool->allocations.load(std::memory_order_relaxed); }
+    size_t reuses() const { return m_pool->reuses.load(std::memory_order_relaxed); }
+    size_t freeBuffers() const {
+        std::lock_guard<std::mutex> lock(m_pool->mutex);
+        return m_pool->free.size();
+    }
+
+private:
+    struct Pool {
+        Pool(size_t maxFree, size_t initialReserve) : maxFreeBuffers(maxFree), typical(initialReserve) {
+            free.reserve(maxFree);
+        }
+        ~Pool() {
+            for (auto* buffer : free) delete buffer;
+        }
+
+        Buffer* take() {
+            Buffer* buffer = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!free.empty()) {
+                    buffer = free.back();
+                    free.pop_back();
+                }
+            }
+            if (buffer) {
+                reuses.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                buffer = new Buffer();
+                allocations.fetch_add(1, std::memory_order_relaxed);
+            }
+            // Grow to the typical size up front instead of event by event
+            const size_t wanted = typical.load(std::memory_order_relaxed);
+            if (buffer->capacity() < wanted) buffer->reserve(wanted + wanted / 4);
+            return buffer;
+        }
+
+        void recycle(Buffer* buffer) {
+            // Moving average over recent uses (weight 1/8), rounded up so it can follow growth
+            const size_t used = buffer->size();
+            const size_t previous = typical.load(std::memory_order_relaxed);
+            typical.store(previous + (used > previous ? (used - previous + 7) / 8 : 0) - (used < previous ? (previous - used) / 8 : 0),
+                          std::memory_order_relaxed);
+            buffer->clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (free.size() < maxFreeBuffers) {
+                    free.push_back(buffer);
+                    return;
+                }
+            }
+            delete buffer;
+        }
+
+        const size_t maxFreeBuffers;
+        std::atomic<size_t> typical;
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> reuses{0};
+        mutable std::mutex mutex;
+        std::vector<Buffer*> free;
+    };
+
+    std::shared_ptr<Pool> m_pool;
+};
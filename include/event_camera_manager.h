@@ -8,12 +8,22 @@
 #include <atomic>
 #include <mutex>
 #include <queue>
+#include <limits>
 #include <opencv2/opencv.hpp>
 #include <metavision/sdk/stream/camera.h>
 #include <metavision/hal/facilities/i_camera_synchronization.h>
 #include <metavision/hal/facilities/i_ll_biases.h>
 #include <metavision/hal/device/device_discovery.h>
 #include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/base/events/event_ext_trigger.h>
+#include "event_buffer_arena.h"
+#include "stall_watchdog.h"
+#include "profiled_mutex.h"
+#include "memory_accounting.h"
+#include "recording_summary.h"
+
+class LiveDataBus;
+class OverloadController;
 
 struct BiasLimits {
     int min_value;
@@ -31,6 +41,12 @@ struct EventFrameData {
 class EventCameraManager {
 public:
     using BiasConfig = std::unordered_map<std::string, int>; 
+    // HDF5 output tuning; compressionLevel < 0 keeps the SDK writer (ECF codec), 0..9 selects
+    // the tunable writer (shuffle + deflate) with the given chunk size
+    struct Hdf5Settings {
+        int compressionLevel = -1;
+        size_t chunkEvents = 16384;
+    };
     struct CameraConfig {
         std::string serial;
         std::unordered_map<std::string,int> biases; // biases matched to this serial
@@ -42,14 +58,42 @@ public:
     // NOTE: This code is in principle compatible with an arbitrary number of event cameras,
     // but it has only been tested for two cameras
     void openAndSetupDevices(const std::vector<CameraConfig>& cameraConfigs = {});
+    // Write only the biases that differ from the last applied values to the already-open
+    // cameras (configs must match the opened serials in order); throws otherwise
+    void applyBiases(const std::vector<CameraConfig>& cameraConfigs);
+    // Recording attaches a file sink to the running capture pipeline (started on demand) and
+    // never restarts it. For hdf5 every event with t >= start boundary and t < stop boundary
+    // is written; raw recordings use the camera's native stream recorder.
     void startRecording(const std::string& outputPath, const std::string& fileFormat = "hdf5");
     void stopRecording();
+    // Close the current take and open the next one at the same timestamp boundary (no gap)
+    void switchRecording(const std::string& outputPath, const std::string& fileFormat = "hdf5");
+    bool isRecording() const { return m_recording; }
+    // The HDF5 library is typically built without thread safety; every writer in the process
+    // (recording sinks, background transcoding) holds this while calling into it
+    static std::mutex& hdf5Mutex();
+    // Applies to takes started after the call
+    void setHdf5Settings(const Hdf5Settings& settings) { m_hdf5Settings = settings; }
+    Metavision::timestamp lastRecordingBoundary() const { return m_lastBoundary; }
     void closeDevices(); // Explicitly close all cameras and release resources
+    size_t cameraCount() const { return m_cameras.size(); }
+    // Directory of ebv_cam_<i>.* per camera for the next recording (empty = recording path)
+    void setStreamDirectories(const std::vector<std::string>& directories) { m_streamDirectories = directories; }
     
     // Live data access for recording buffer
     bool startLiveStreaming();
     void stopLiveStreaming();
     bool getLatestEventFrame(int cameraId, cv::Mat& eventFrame, size_t& frameIndex);
+    // Publish event chunks and rendered preview frames on the live data bus
+    void setLiveDataBus(LiveDataBus* bus) { m_liveBus = bus; }
+    // Preview frames follow its budget (frame rate, event density); recording never does
+    void setOverloadController(const OverloadController* controller) { m_overload = controller; }
+    // SDK callbacks, recording writers and preview workers report blocking calls to it
+    void setWatchdog(StallWatchdog* watchdog) { m_watchdog = watchdog; }
+    // Unwritten events of the busiest recording sink relative to MAX_SINK_BACKLOG_EVENTS
+    double writerPressure() const;
+    // Per-camera statistics of the last take whose files were closed (stop or take switch)
+    std::vector<StreamSummary> lastTakeSummaries() const { return m_lastTakeSummaries; }
 
     // ---- Test helper accessors (Phase 2) ----
     // Inline static default maps (header-only for unit test linking without .cpp)
@@ -97,9 +141,57 @@ private:
     
     // (Inline static maps defined above; no separate declarations needed)
 
+    // File sink fed from the CD/trigger callbacks (hdf5 only), writes on its own thread
+    class EventRecordingSink;
+    // Statistics of a native RAW take, computed from copies on their own thread
+    class RawTakeStatistics;
+    // Per-camera state shared between the SDK callbacks and the preview worker
+    struct CameraPipeline {
+        ProfiledMutex mutex{"event_pipeline"};            // guards previewEvents and sinks
+        EventBlock previewEvents;                         // accumulated for the next preview frame
+        std::shared_ptr<EventRecordingSink> activeSink;   // receives t >= its start boundary
+        std::shared_ptr<EventRecordingSink> retiringSink; // receives t < its stop boundary until detached
+        std::atomic<Metavision::timestamp> lastTimestamp{-1};
+        // Stop boundary of a take closed before this camera reached it: events with t below it
+        // have no file any more and are counted until the camera passes the boundary
+        Metavision::timestamp lateBoundary{std::numeric_limits<Metavision::timestamp>::min()};
+        uint64_t lateEvents{0};
+        StallWatchdog::HeartbeatPtr callbackHeartbeat;    // SDK callback thread
+        // Native RAW take in progress (HDF5 sinks count their own)
+        std::shared_ptr<RawTakeStatistics> rawStatistics;
+        std::string rawPath;
+        size_t cdCallbackId{0};
+        size_t triggerCallbackId{0};
+        bool hasCdCallback{false};
+        bool hasTriggerCallback{false};
+    };
+
+    void attachPipelineCallbacks(int cameraId);
+    void detachPipelineCallbacks(int cameraId);
+    void dispatchEvents(int cameraId, const Metavision::EventCD* begin, const Metavision::EventCD* end);
+    void dispatchTriggers(int cameraId, const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end);
+    Metavision::timestamp currentBoundary() const;
+    std::vector<std::shared_ptr<EventRecordingSink>> openSinks(const std::string& outputPath, Metavision::timestamp startTs);
+    void retireSinks(Metavision::timestamp stopTs);
+    void finishRetiredSinks(Metavision::timestamp stopTs);
+    // Pipeline mutex held; count events of an already closed take
+    void countLateEvents(int cameraId, uint64_t late, Metavision::timestamp lastTs);
+    std::string eventFilePath(const std::string& outputPath, size_t cameraIndex, const std::string& extension) const;
+    void startRawRecording(const std::string& outputPath);
+    void stopRawRecording();
+
     std::vector<std::unique_ptr<Metavision::Camera>> m_cameras; // index 0 master, rest slaves
+    std::vector<std::string> m_cameraSerials;  // serial per opened camera (same order)
+    std::vector<BiasConfig> m_appliedBiases;   // last biases written per camera (clipped)
     std::atomic<bool> m_recording;
     std::string m_outputPath;
+    std::vector<std::string> m_streamDirectories;
+    Hdf5Settings m_hdf5Settings;
+    std::string m_fileFormat;
+    std::vector<std::unique_ptr<CameraPipeline>> m_pipelines;
+    mutable std::mutex m_pipelinesMutex; // guards the list (not the pipelines) for writerPressure()
+    std::atomic<Metavision::timestamp> m_lastBoundary{0};
+    std::vector<StreamSummary> m_lastTakeSummaries;
     
     // Live streaming support
     std::atomic<bool> m_liveStreaming{false};
@@ -107,16 +199,29 @@ private:
     std::vector<bool> m_startedForStreaming;
     std::vector<std::thread> m_eventStreamingThreads;
     std::vector<std::queue<EventFrameData>> m_liveEventBuffers;
-    std::vector<std::unique_ptr<std::mutex>> m_eventBufferMutexes;
+    std::vector<std::unique_ptr<ProfiledMutex>> m_eventBufferMutexes;
+    MemoryCounter m_liveFrameMemory{"event_live_frames"}; // all m_liveEventBuffers together
     std::vector<size_t> m_eventFrameCounters;
+    LiveDataBus* m_liveBus{nullptr};
+    const OverloadController* m_overload{nullptr};
+    StallWatchdog* m_watchdog{nullptr};
     
     // Event accumulation parameters
     static constexpr size_t MAX_EVENT_BUFFER_SIZE = 100;
+    static constexpr size_t MAX_PREVIEW_EVENTS = 4'000'000; // cap if the preview worker stalls
+    // Last resort when a camera does not reach the stop boundary (stalled or silent)
+    static constexpr auto SINK_DRAIN_TIMEOUT = std::chrono::milliseconds(2000);
+    static constexpr size_t MAX_SINK_BACKLOG_EVENTS = 20'000'000; // ~1-2 s at peak event rates
+    // Stall thresholds: an SDK callback or a file write should never take this long
+    static constexpr auto CALLBACK_STALL_THRESHOLD = std::chrono::milliseconds(200);
+    static constexpr auto WRITER_STALL_THRESHOLD = std::chrono::milliseconds(500);
+    static constexpr auto PREVIEW_STALL_THRESHOLD = std::chrono::milliseconds(1000);
     static constexpr double EVENT_FRAME_RATE = 30.0; // Generate frames at 30 FPS
     static constexpr int EVENT_FRAME_WIDTH = 640;
     static constexpr int EVENT_FRAME_HEIGHT = 480;
     
     // Live streaming methods
     void eventStreamingWorker(int cameraId);
-    cv::Mat generateEventFrame(const std::vector<Metavision::EventCD>& events, int width, int height);
+    // stride > 1 draws every stride-th event (preview under load)
+    cv::Mat generateEventFrame(const EventBlock& events, int width, int height, size_t stride = 1);
 };
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Persistent second-level cache for rendered event frames, so reopening a recording plays
+// back at full speed without decoding events again. One file per (event file, camera,
+// frame window, render mode and version) in the user cache directory; it is invalidated
+// automatically when the source file changes (size and mtime are part of the key). The
+// directory is kept under a size cap by deleting the least recently opened files.
+//
+// Frames are stored as class planes (one byte per pixel: 0 = no event, 1 = positive,
+// 2 = negative), run-length encoded, which is exact for the player's renderer and very
+// fast to decode. New frames are encoded and appended by a background thread; reads go
+// through a read-only memory mapping of the cache file.
+//
+// File layout: Header | IndexEntry[frameCapacity] | encoded frames (append only)
+class EventFrameDiskCache {
+public:
+    struct Key {
+        std::string sourcePath;
+        int cameraId{0};
+        int64_t windowUs{0};  // frame duration: frame i covers [i*windowUs - overlapUs, (i+1)*windowUs + overlapUs)
+        int64_t overlapUs{0}; // margin added on both sides of every frame
+        std::string renderMode;
+        uint32_t rendererVersion{0}; // bump when the renderer's output changes
+    };
+
+    enum PixelClass : uint8_t { NoEvent = 0, Positive = 1, Negative = 2 };
+
+    static constexpr uint64_t MAGIC = 0x3145484341435245ull; // "ERCACHE1" (little endian)
+    static constexpr uint32_t VERSION = 2;
+    static constexpr size_t MAX_PENDING_WRITES = 64;
+    static constexpr uint64_t DEFAULT_MAX_CACHE_BYTES = 8ull << 30;
+
+    // $EBV_RENDER_CACHE, else $XDG_CACHE_HOME/ebv_frame_recording/render, else ~/.cache/...
+    // Returns an empty path if caching is disabled (EBV_RENDER_CACHE=off)
+    static std::filesystem::path defaultCacheDirectory();
+    static std::string fileNameFor(const Key& key);
+    // $EBV_RENDER_CACHE_MAX_GB, else DEFAULT_MAX_CACHE_BYTES
+    static uint64_t maxCacheBytes();
+    // Delete least recently opened cache files until the directory fits in maxBytes; files
+    // open in another player and keep (the caller's own file) are left alone
+    static void enforceSizeLimit(const std::filesystem::path& cacheDirectory, uint64_t maxBytes,
+                                 const std::filesystem::path& keep = {});
+
+    EventFrameDiskCache(const std::filesystem::path& cacheDirectory, const Key& key,
+                        int width, int height, size_t frameCapacity);
+    ~EventFrameDiskCache(); // writes everything still queued
+
+    EventFrameDiskCache(const EventFrameDiskCache&) = delete;
+    EventFrameDiskCache& operator=(const EventFrameDiskCache&) = delete;
+
+    bool isOpen() const { return m_fd >= 0; }
+    // False if another process owns the cache file; reads still work
+    bool isWritable() const { return m_writable; }
+
+    bool contains(size_t frameIndex) const;
+    // plane is resized to width*height
+    bool read(size_t frameIndex, std::vector<uint8_t>& plane) const;
+    // Queue a frame for encoding and writing; dropped if the writer is behind
+    void store(size_t frameIndex, std::vector<uint8_t> plane);
+    void flush(); // block until queued frames are written
+    size_t cachedFrameCount() const;
+
+    // Codec: sequence of (value byte, LEB128 run length)
+    static void encodeRle(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+    static bool decodeRle(const uint8_t* data, size_t size, uint8_t* out, size_t outSize);
+
+private:
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t width;
+        uint32_t height;
+        uint32_t rendererVersion;
+        uint64_t frameCapacity;
+        int64_t windowUs;
+        int64_t overlapUs;
+    };
+    struct IndexEntry {
+        uint64_t offset; // 0 = not cached
+        uint32_t size;
+        uint32_t reserved;
+    };
+
+    bool openFile(const std::filesystem::path& path);
+    bool initializeFile();
+    bool remapIfNeeded(uint64_t requiredBytes) const;
+    const IndexEntry* entry(size_t frameIndex) const;
+    void writerLoop();
+
+    int m_width;
+    int m_height;
+    size_t m_frameCapacity;
+    Key m_key;
+    int m_fd{-1};
+    bool m_writable{false};
+    uint64_t m_fileSize{0};
+
+    mutable std::mutex m_mapMutex;
+    mutable const uint8_t* m_map{nullptr};
+    mutable size_t m_mappedBytes{0};
+
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::condition_variable m_idleCondition;
+    std::deque<std::pair<size_t, std::vector<uint8_t>>> m_queue;
+    bool m_writing{false};
+    bool m_stopping{false};
+    std::thread m_writerThread;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <string>
+
+// Blends event activity onto the matching frame-camera image. The geometric mapping
+// (event sensor -> frame sensor homography) is turned into a per-pixel remap table once
+// per recording; each overlay is then a nearest-neighbour remap plus a masked blend,
+// all of which run as vectorized OpenCV passes.
+//
+// Calibration: overlay_calibration.yml in the recording directory, one 3x3 matrix per
+// pair named "<event stream>_to_<frame stream>" (e.g. ebv_cam_0_to_frame_cam0), mapping
+// event pixel coordinates to frame pixel coordinates.
+class EventOverlay {
+public:
+    static constexpr const char *CALIBRATION_FILE = "overlay_calibration.yml";
+
+    struct RemapTable {
+        cv::Mat map1; // fixed-point maps from cv::convertMaps (CV_16SC2 + CV_16UC1)
+        cv::Mat map2;
+        cv::Size frameSize;
+        cv::Size eventSize;
+        bool empty() const { return map1.empty(); }
+    };
+
+    // For every frame pixel, the event pixel it shows (inverse of eventToFrame)
+    static RemapTable buildRemapTable(const cv::Matx33d &eventToFrame, cv::Size eventSize, cv::Size frameSize);
+    // Uncalibrated fallback: scale the event sensor to fit the frame, centered
+    static cv::Matx33d defaultHomography(cv::Size eventSize, cv::Size frameSize);
+    static std::string calibrationKey(const std::string &eventStream, const std::string &frameStream);
+    // False if the file or the entry does not exist (H is left unchanged)
+    static bool loadHomography(const std::string &recordingDir, const std::string &eventStream,
+                               const std::string &frameStream, cv::Matx33d &eventToFrame);
+
+    // Pixels of eventImage (same channel count as the 3-channel frame) that differ from
+    // background are blended into frame with the given weight; frame is converted to
+    // 3 channels if it is grayscale
+    static void blend(cv::Mat &frame, const cv::Mat &eventImage, const RemapTable &table,
+                      const cv::Scalar &background, double alpha);
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Drives all event streams of a recording against one shared time cursor. Render work for
+// the frames ahead of the cursor is scheduled on a common worker pool in frame order, every
+// stream of an instant before the next instant, so a slow camera gets more workers instead
+// of falling behind. A frame set (one frame per stream) is published once all streams have
+// it, or handed out explicitly late when the caller cannot wait any longer.
+//
+// The engine does not own images: the render function fills the stream's own frame cache
+// and must be idempotent (rendering an already cached frame is a cheap no-op).
+class EventPlaybackEngine {
+public:
+    // Render frame frameIndex of stream into that stream's cache; false if it cannot be rendered
+    using RenderFn = std::function<bool(size_t stream, size_t frameIndex)>;
+    // Called on a worker thread when every stream has finished a frame at or ahead of the cursor
+    using FrameSetCallback = std::function<void(size_t frameIndex)>;
+
+    struct Options {
+        size_t workers = 0;     // 0 = one per stream, at least two
+        size_t lookahead = 120; // frames rendered ahead of the cursor
+    };
+
+    struct FrameSet {
+        size_t frameIndex{0};
+        std::vector<bool> ready; // per stream
+        bool complete{false};    // every stream finished (rendered or failed)
+        bool late{false};        // returned on timeout with streams still missing
+    };
+
+    EventPlaybackEngine(size_t streamCount, size_t frameCount, RenderFn render);
+    EventPlaybackEngine(size_t streamCount, size_t frameCount, RenderFn render, Options options);
+    ~EventPlaybackEngine();
+
+    EventPlaybackEngine(const EventPlaybackEngine&) = delete;
+    EventPlaybackEngine& operator=(const EventPlaybackEngine&) = delete;
+
+    void setFrameSetCallback(FrameSetCallback callback);
+
+    // Move the shared cursor; scheduling restarts from there, frames behind it are forgotten
+    void setCursor(size_t frameIndex);
+    size_t cursor() const { return m_cursor.load(); }
+
+    // Wait until all streams have frameIndex or the timeout passes (then the set is late)
+    FrameSet waitForFrameSet(size_t frameIndex, std::chrono::milliseconds timeout);
+    // Number of consecutive complete frame sets starting at the cursor
+    size_t readyAhead() const;
+
+    // Paused: only the frame at the cursor is rendered, nothing ahead of it (e.g. while live
+    // capture needs the CPU)
+    void setPaused(bool paused);
+    bool isPaused() const { return m_paused.load(); }
+
+    void stop();
+
+    size_t streamCount() const { return m_streamCount; }
+    size_t workerCount() const { return m_workers.size(); }
+
+private:
+    enum class SlotState : uint8_t { Pending, Rendering, Ready, Failed };
+
+    struct Job {
+        size_t stream;
+        size_t frameIndex;
+    };
+
+    void workerMain();
+    bool nextJob(Job& job);
+    bool isComplete(const std::vector<SlotState>& slots) const;
+    std::vector<SlotState>& slotsFor(size_t frameIndex);
+    void pruneBehind(size_t cursor);
+
+    const size_t m_streamCount;
+    const size_t m_frameCount;
+    const RenderFn m_render;
+    const Options m_options;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workCv;
+    std::condition_variable m_readyCv;
+    std::map<size_t, std::vector<SlotState>> m_slots; // frames at and ahead of the cursor
+    std::atomic<size_t> m_cursor{0};
+    std::atomic<bool> m_paused{false};
+    bool m_stopping{false};
+    FrameSetCallback m_callback;
+    std::vector<std::thread> m_workers;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "background_job_queue.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// Converts the RAW event files of finished takes into compressed HDF5 on a background
+// thread, so capture only pays for the cheap RAW write. The cameras of a take are decoded and
+// compressed (Hdf5EventWriter, shuffle + deflate) in parallel; only storing the compressed
+// chunks is serialized, the HDF5 library is not thread-safe. Every file is written to a
+// temporary name, verified by reading it back block by block (locking per read) and comparing
+// CD and trigger counts, and only then renamed to ebv_cam_<i>.hdf5. The RAW files are removed
+// (unless kept) only when every camera of the take succeeded; a partial failure keeps them all.
+// The take's session manifest records the result (transcode.<stream>=ok|failed).
+class EventTranscoder {
+public:
+    struct Job {
+        std::filesystem::path takeDirectory; // holds the session manifest
+        bool keepRaw{false};
+    };
+    using CompletionCallback = BackgroundJobQueue<Job>::CompletionCallback;
+
+    EventTranscoder();
+    // The destructor finishes all queued jobs
+
+    EventTranscoder(const EventTranscoder&) = delete;
+    EventTranscoder& operator=(const EventTranscoder&) = delete;
+
+    void enqueue(Job job) { m_jobs.enqueue(std::move(job)); }
+    void setCompletionCallback(CompletionCallback callback) { m_jobs.setCompletionCallback(std::move(callback)); }
+    void waitIdle() { m_jobs.waitIdle(); }
+    size_t pendingJobs() const { return m_jobs.pendingJobs(); }
+
+    // Transcode a single file synchronously; returns the number of CD events written.
+    // Throws std::runtime_error on failure (the destination is left untouched).
+    static uint64_t transcodeFile(const std::filesystem::path& rawFile, const std::filesystem::path& hdf5File);
+
+private:
+    bool transcodeTake(const Job& job, std::string& message);
+
+    BackgroundJobQueue<Job> m_jobs;
+};
@@ -3,6 +3,8 @@
 #include <peak/peak.hpp>
 // #include <peak_ipl/peak_ipl.hpp>
 #include <vector>
+#include <filesystem>
+#include <map>
 #include <memory>
 #include <string>
 #include <thread>
@@ -12,12 +14,19 @@
 #include <condition_variable>
 #include <opencv2/opencv.hpp>
 #include <optional>
+#include "stall_watchdog.h"
+#include "profiled_mutex.h"
+#include "memory_accounting.h"
+#include "recording_summary.h"
+
+class LiveDataBus;
 
 struct FrameData {
     cv::Mat image;
     int deviceId;
     int frameIndex;
     std::chrono::steady_clock::time_point timestamp;
+    uint64_t take{0}; // writer take the frame was queued for (0 = not queued)
 };
 
 class FrameCameraManager {
@@ -38,17 +47,41 @@ public:
     // Seamless transition controls when preview is already running
     void startRecordingToPath(const std::string& outputPath); // start only disk writer
     void stopRecordingOnly(); // stop only disk writer, keep preview acquisition running
+    // Next take without pausing the writer: frames queued from now on go to outputPath; returns
+    // once the previous take's frames are written (its statistics are then in lastTakeSummaries)
+    void switchRecordingPath(const std::string& outputPath);
     void closeDevices(); // Close and release all camera resources
+    size_t deviceCount() const { return m_devices.size(); }
+    // Parent directory of frame_cam<i> per camera for the next recording (empty = recording path)
+    void setStreamDirectories(const std::vector<std::string>& directories) { m_streamDirectories = directories; }
     
     // Live data access for recording buffer
     bool getLatestFrame(int deviceId, FrameData& frameData);
+    // Publish captured frames and FPS stats on the live data bus (set before acquisition starts)
+    void setLiveDataBus(LiveDataBus* bus) { m_liveBus = bus; }
+    // Acquisition and disk writer threads report blocking calls to it (set before acquisition starts)
+    void setWatchdog(StallWatchdog* watchdog) { m_watchdog = watchdog; }
+    // Writer queue fill or lag of the oldest queued frame, whichever is closer to its limit
+    double writerPressure() const;
+    // Per-camera statistics of the last take that was completely written
+    std::vector<StreamSummary> lastTakeSummaries() const { return m_lastTakeSummaries; }
 
 private:
     void setupDevice(std::shared_ptr<peak::core::Device> device);
     void acquisitionWorker(int deviceId);
-    void diskWriterWorker(const std::string& outputPath);
+    void diskWriterWorker();
     void startAcquisition();
     void stopAcquisition();
+    // Output of one take of the running writer. Queued frames carry their take number, so a
+    // take switch redirects new frames while the writer finishes the old ones.
+    struct WriterTake {
+        std::vector<std::filesystem::path> cameraDirs;
+        std::vector<std::unique_ptr<StreamStatistics>> statistics; // per camera
+        size_t pendingFrames{0}; // queued or being written (m_queueMutex)
+    };
+    std::shared_ptr<WriterTake> makeWriterTake(const std::string& outputPath) const;
+    std::vector<StreamSummary> summarize(const WriterTake& take) const;
+    void beginWriting(const std::string& outputPath);
 
     std::vector<std::shared_ptr<peak::core::Device>> m_devices;
     std::vector<std::shared_ptr<peak::core::DataStream>> m_dataStreams;
@@ -59,12 +92,26 @@ private:
 
     // Frame buffer queue for non-blocking capture
     std::queue<FrameData> m_frameQueue;
-    std::mutex m_queueMutex;
-    std::condition_variable m_queueCondition;
+    mutable ProfiledMutex m_queueMutex{"frame_queue"};
+    ProfiledConditionVariable m_queueCondition;
+    MemoryCounter m_queueMemory{"frame_writer_queue"};
     static constexpr size_t MAX_QUEUE_SIZE = 1000; // Adjust based on memory constraints
+    static constexpr auto MAX_WRITER_LAG = std::chrono::seconds(2);
+    // Takes with frames still queued, by number; new frames go to m_currentTake (m_queueMutex)
+    std::map<uint64_t, std::shared_ptr<WriterTake>> m_writerTakes;
+    uint64_t m_currentTake{0};
+    ProfiledConditionVariable m_takeDrainedCondition;
+    std::vector<StreamSummary> m_lastTakeSummaries;
 
     // Latest frame per device for live preview access (decoupled from writer queue)
     std::vector<FrameData> m_latestFrames;
-    std::mutex m_latestMutex;
+    ProfiledMutex m_latestMutex{"frame_latest"};
+
+    LiveDataBus* m_liveBus{nullptr};
+    StallWatchdog* m_watchdog{nullptr};
+    std::vector<std::string> m_streamDirectories;
+    // WaitForFinishedBuffer times out after 1 s without a trigger; anything far beyond is a hang
+    static constexpr auto CAPTURE_STALL_THRESHOLD = std::chrono::milliseconds(2500);
+    static constexpr auto WRITER_STALL_THRESHOLD = std::chrono::milliseconds(500);
 };
 
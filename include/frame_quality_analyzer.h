@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <opencv2/core.hpp>
+#include "live_data_bus.h"
+
+// Image quality feedback for rig setup: focus (variance of the Laplacian), over/under
+// exposed pixel ratios and a grey-level histogram per frame camera.
+struct FrameQualityMetrics {
+    static constexpr int HISTOGRAM_BINS = 64;
+
+    int cameraId{0};
+    size_t frameIndex{0};
+    double sharpness{0.0};         // variance of the Laplacian; higher = sharper
+    double clippedHighRatio{0.0};  // fraction of pixels >= clipHigh
+    double clippedLowRatio{0.0};   // fraction of pixels <= clipLow
+    double meanLevel{0.0};
+    std::array<float, HISTOGRAM_BINS> histogram{}; // normalized to sum 1
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+// Background analytics stage on the live data bus. It takes frames from a single-slot
+// DropOldest subscription, analyzes at most maxRateHz per camera on a decimated copy and
+// publishes the results as bus stats (source "frame_cam<i>"). It never blocks capture:
+// frames it has no time for are simply dropped from its queue.
+class FrameQualityAnalyzer {
+public:
+    struct Options {
+        double maxRateHz = 4.0;
+        int analysisWidth = 640; // frames are decimated to at most this width first
+        uint8_t clipHigh = 250;
+        uint8_t clipLow = 5;
+    };
+
+    explicit FrameQualityAnalyzer(LiveDataBus& bus);
+    FrameQualityAnalyzer(LiveDataBus& bus, Options options);
+    ~FrameQualityAnalyzer();
+
+    FrameQualityAnalyzer(const FrameQualityAnalyzer&) = delete;
+    FrameQualityAnalyzer& operator=(const FrameQualityAnalyzer&) = delete;
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_running.load(); }
+
+    // Latest result per camera; false until the camera has been analyzed once
+    bool latest(int cameraId, FrameQualityMetrics& metrics) const;
+
+    // Metrics of one image (grey, BGR or BGRA; any size)
+    static FrameQualityMetrics analyze(const cv::Mat& image, const Options& options);
+
+private:
+    void analysisWorker();
+
+    LiveDataBus& m_bus;
+    const Options m_options;
+    BusTopic<LiveFramePacket>::SubscriptionPtr m_subscription;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::map<int, std::chrono::steady_clock::time_point> m_lastAnalysis;
+    mutable std::mutex m_resultsMutex;
+    std::map<int, FrameQualityMetrics> m_results;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Undistortion / stereo rectification of frame camera images with precomputed remap
+// tables. Maps are built once per camera and output size (scaled from the calibration
+// resolution) and reused for every frame, so each image costs one fixed-point cv::remap.
+//
+// Calibration: OpenCV FileStorage file (rectification.yml) with, per frame stream,
+// <stream>_K (3x3), <stream>_D (distortion), optional <stream>_R (3x3 rectification) and
+// <stream>_P (3x3 or 3x4 new projection, e.g. from cv::stereoRectify), plus image_width
+// and image_height of the calibration images.
+class FrameRectifier {
+public:
+    static constexpr const char *CALIBRATION_FILE = "rectification.yml";
+
+    struct Calibration {
+        cv::Mat cameraMatrix;
+        cv::Mat distCoeffs;
+        cv::Mat rectification; // identity if absent
+        cv::Mat projection;    // cameraMatrix if absent
+        cv::Size imageSize;
+    };
+
+    static bool loadCalibration(const std::string &path, const std::string &stream, Calibration &calibration);
+    // Rectifier for frame_cam0..N-1; null if the file has no usable entry
+    static std::shared_ptr<FrameRectifier> fromFile(const std::string &path, size_t cameraCount);
+
+    explicit FrameRectifier(std::vector<std::optional<Calibration>> calibrations);
+
+    bool hasCamera(int camera) const;
+    // Rectify at the image's own resolution (full resolution for export); images of
+    // cameras without calibration are returned unchanged
+    cv::Mat rectify(int camera, const cv::Mat &image) const;
+    // Downscale to at most maxWidth first, then rectify with maps for that size (preview)
+    cv::Mat rectifyPreview(int camera, const cv::Mat &image, int maxWidth) const;
+
+private:
+    struct Maps {
+        cv::Mat map1;
+        cv::Mat map2;
+    };
+    const Maps &mapsFor(int camera, cv::Size size) const;
+
+    std::vector<std::optional<Calibration>> m_calibrations;
+    mutable std::mutex m_mapsMutex;
+    mutable std::map<std::tuple<int, int, int>, Maps> m_maps; // (camera, width, height)
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Replays a reference RAW recording through several HDF5 writer settings and reports
+// throughput, CPU time and compression ratio, so chunking/compression can be chosen per rig
+// from measurements. Meant to run standalone (no cameras open): CPU time is process-wide.
+class Hdf5Benchmark {
+public:
+    struct Setting {
+        std::string name;
+        int compressionLevel;   // -1 = SDK writer (ECF), 0..9 = tunable writer deflate level
+        size_t chunkEvents;
+    };
+    struct Result {
+        Setting setting;
+        uint64_t events{0};
+        double wallSeconds{0.0};
+        double cpuSeconds{0.0};
+        uint64_t fileBytes{0};
+    };
+
+    static std::vector<Setting> defaultSettings();
+
+    // Decodes up to maxEvents CD events of rawFile into memory once, then writes them with
+    // every setting into scratchDirectory (files are removed afterwards)
+    static std::vector<Result> run(const std::string& rawFile, const std::vector<Setting>& settings,
+                                   const std::string& scratchDirectory, uint64_t maxEvents = 50'000'000);
+
+    static void printReport(std::ostream& out, const std::vector<Result>& results, uint64_t rawFileBytes);
+};
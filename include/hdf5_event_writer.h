@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <hdf5.h>
+
+// HDF5 event file writer with tunable chunking and compression. Uses the group layout of the
+// Metavision SDK writer (/CD/events, /CD/indexes, /EXT_TRIGGER/events, /EXT_TRIGGER/indexes,
+// metadata as root string attributes), but standard HDF5 filters (shuffle + deflate) instead
+// of the ECF plugin, so the chunk size and compression level can be chosen per rig and the
+// files open in any HDF5 tool. Not thread-safe; callers serialize HDF5 access
+// (EventCameraManager::hdf5Mutex). Buffering and encodeChunks() make no HDF5 calls, so
+// several writers can compress in parallel and only hold the lock for writeEncodedChunks().
+class Hdf5EventWriter {
+public:
+    struct Options {
+        size_t chunkEvents = 16384;     // events per HDF5 chunk (unit of compression and I/O)
+        int compressionLevel = 4;       // deflate level 0..9, 0 = uncompressed
+        bool shuffle = true;            // byte shuffle before deflate (better ratio on timestamps)
+        int64_t indexPeriodUs = 2000;   // one /indexes entry per period from t = 0, for seeking
+    };
+
+    // Memory layout of one stored event (matches the compound types in the file)
+    struct CdEvent {
+        uint16_t x;
+        uint16_t y;
+        int16_t p;
+        int64_t t;
+    };
+    struct TriggerEvent {
+        int16_t p;
+        int64_t t;
+        int16_t id;
+    };
+
+    Hdf5EventWriter(const std::string& path, Options options);
+    Hdf5EventWriter(const std::string& path) : Hdf5EventWriter(path, Options{}) {}
+    ~Hdf5EventWriter();
+
+    Hdf5EventWriter(const Hdf5EventWriter&) = delete;
+    Hdf5EventWriter& operator=(const Hdf5EventWriter&) = delete;
+
+    void addMetadata(const std::string& key, const std::string& value);
+
+    // Buffer events without writing them. Accepts any event type with x, y, p, t (CD) or
+    // p, t, id (trigger) members.
+    template <typename Event>
+    void bufferCdEvents(const Event* begin, const Event* end) {
+        checkBuffering(m_cd.finalEncoded);
+        for (auto it = begin; it != end; ++it) {
+            m_cd.pending.push_back(CdEvent{static_cast<uint16_t>(it->x), static_cast<uint16_t>(it->y),
+                                           static_cast<int16_t>(it->p), static_cast<int64_t>(it->t)});
+        }
+    }
+    template <typename Event>
+    void bufferTriggerEvents(const Event* begin, const Event* end) {
+        checkBuffering(m_triggers.finalEncoded);
+        for (auto it = begin; it != end; ++it) {
+            m_triggers.pending.push_back(TriggerEvent{static_cast<int16_t>(it->p), static_cast<int64_t>(it->t),
+                                                      static_cast<int16_t>(it->id)});
+        }
+    }
+
+    // Buffer events and write every completed chunk
+    template <typename Event>
+    void addCdEvents(const Event* begin, const Event* end) {
+        bufferCdEvents(begin, end);
+        if (m_cd.pending.size() >= m_options.chunkEvents) flushCdChunks();
+    }
+    template <typename Event>
+    void addTriggerEvents(const Event* begin, const Event* end) {
+        bufferTriggerEvents(begin, end);
+        if (m_triggers.pending.size() >= m_options.chunkEvents) flushTriggerChunks();
+    }
+
+    // Pack, shuffle and deflate the complete chunks buffered so far exactly like the HDF5
+    // filter pipeline would, without calling into HDF5. With final, the trailing partial
+    // chunks are encoded too and no more events may be buffered.
+    void encodeChunks(bool final = false);
+    // Store the chunks encoded so far (H5Dwrite_chunk) and their index rows
+    void writeEncodedChunks();
+
+    // Write buffered events and close the file (idempotent; also done by the destructor)
+    void close();
+
+    uint64_t cdEventsWritten() const { return m_cd.written; }
+    uint64_t triggerEventsWritten() const { return m_triggers.written; }
+    const Options& options() const { return m_options; }
+
+private:
+    struct IndexEntry {
+        uint64_t id; // index of the first event with t >= ts
+        int64_t ts;
+    };
+    // Where one compound member lives in memory and in the packed file row
+    struct MemberCopy {
+        size_t memOffset;
+        size_t fileOffset;
+        size_t size;
+    };
+    struct EncodedChunk {
+        uint64_t firstRow;
+        size_t rows;
+        std::vector<unsigned char> bytes;
+    };
+    template <typename Event>
+    struct Stream {
+        hid_t group{-1};
+        hid_t events{-1};
+        hid_t indexes{-1};
+        hid_t fileType{-1};
+        hid_t memType{-1};
+        std::vector<MemberCopy> members;
+        size_t rowBytes{0};
+        std::vector<Event> pending;
+        uint64_t encoded{0};            // rows handed to an encoded chunk
+        bool finalEncoded{false};
+        std::vector<EncodedChunk> chunks;
+        std::vector<IndexEntry> indexRows;
+        uint64_t written{0};
+        uint64_t indexesWritten{0};
+        int64_t nextIndexTs{0};
+    };
+
+    static void checkBuffering(bool finalEncoded);
+    void flushCdChunks();
+    void flushTriggerChunks();
+    template <typename Event>
+    void createStream(Stream<Event>& stream, const char* groupName, hid_t memType);
+    template <typename Event>
+    void flushStream(Stream<Event>& stream, bool all);
+    template <typename Event>
+    void encodeStream(Stream<Event>& stream, bool all);
+    template <typename Event>
+    void writeStream(Stream<Event>& stream);
+    template <typename Event>
+    void addIndexRows(Stream<Event>& stream, const Event* events, size_t count);
+    template <typename Event>
+    void closeStream(Stream<Event>& stream);
+
+    const std::string m_path;
+    Options m_options;
+    hid_t m_file{-1};
+    hid_t m_indexType{-1};
+    Stream<CdEvent> m_cd;
+    Stream<TriggerEvent> m_triggers;
+};
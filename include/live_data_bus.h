@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <metavision/sdk/base/events/event_cd.h>
+#include "bus_topic.h"
+
+// Payloads published on the live data bus. All payloads are immutable once published
+// and shared between subscribers by reference count (cv::Mat data is never deep-copied).
+
+struct LiveFramePacket {
+    cv::Mat image;      // BGRa8 image as delivered by the frame camera
+    int cameraId{0};
+    size_t frameIndex{0};
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+struct LiveEventChunk {
+    int cameraId{0};
+    std::vector<Metavision::EventCD> events; // one SDK callback worth of decoded CD events
+    Metavision::timestamp firstTimestamp{0};
+    Metavision::timestamp lastTimestamp{0};
+};
+
+struct LiveEventFrame {
+    cv::Mat frame;      // rendered preview frame (BGR)
+    int cameraId{0};
+    size_t frameIndex{0};
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+struct LiveStatsSample {
+    std::string source; // e.g. "frame_cam0"
+    std::string name;   // e.g. "fps"
+    double value{0.0};
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+// Typed in-process publish/subscribe bus for live data.
+// Capture stages publish, consumers (GUI, writers, analytics, metrics) subscribe with their
+// own bounded queue and drop policy, e.g.:
+//   auto sub = bus.frames.subscribe("gui", 2, DropPolicy::DropOldest);
+class LiveDataBus {
+public:
+    BusTopic<LiveFramePacket> frames;
+    BusTopic<LiveEventChunk> eventChunks;
+    BusTopic<LiveEventFrame> eventFrames;
+    BusTopic<LiveStatsSample> stats;
+
+    void publishStat(const std::string& source, const std::string& name, double value) {
+        if (!stats.hasSubscribers()) return;
+        auto sample = std::make_shared<LiveStatsSample>();
+        sample->source = source;
+        sample->name = name;
+        sample->value = value;
+        sample->timestamp = std::chrono::steady_clock::now();
+        stats.publish(std::move(sample));
+    }
+};
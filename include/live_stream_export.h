@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include "live_data_bus.h"
+#include "shm_stream_exporter.h"
+
+// Bridges the live data bus to the shared-memory ring so external processes can consume
+// frames and event chunks during recording. Runs on its own thread with DropOldest bus
+// queues: a slow export (or a full ring) never back-pressures the capture threads.
+class LiveStreamExport {
+public:
+    LiveStreamExport(LiveDataBus& bus, ShmStreamExporter::Options options);
+    ~LiveStreamExport();
+
+    LiveStreamExport(const LiveStreamExport&) = delete;
+    LiveStreamExport& operator=(const LiveStreamExport&) = delete;
+
+    bool start();
+    void stop();
+    bool isRunning() const { return m_running.load(); }
+
+    const ShmStreamExporter& exporter() const { return m_exporter; }
+
+private:
+    void exportWorker();
+    void exportFrame(const LiveFramePacket& packet);
+    void exportEvents(const LiveEventChunk& chunk);
+
+    static constexpr size_t FRAME_QUEUE_SIZE = 4;
+    static constexpr size_t EVENT_QUEUE_SIZE = 256;
+
+    LiveDataBus& m_bus;
+    ShmStreamExporter m_exporter;
+    BusTopic<LiveFramePacket>::SubscriptionPtr m_frameSubscription;
+    BusTopic<LiveEventChunk>::SubscriptionPtr m_eventSubscription;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::unordered_map<int, uint64_t> m_eventChunkCounters;
+};
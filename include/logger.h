@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+// Asynchronous logger for the core library. A log line is formatted into a per-thread
+// buffer and handed to a lock-free per-thread ring; a background thread drains the rings
+// and writes to the sink. Logging never waits for the terminal or a pipe: when a thread's
+// ring is full the line is dropped and counted. Usage:
+//   EBV_LOG_INFO << "Closed " << path;
+//   EBV_LOG_WARN_EVERY(5) << "Frame queue full for device " << id; // at most 5 per second
+namespace Log {
+
+enum class Level : uint8_t { Debug, Info, Warning, Error };
+
+struct Record {
+    std::chrono::system_clock::time_point time;
+    Level level{Level::Info};
+    const char* file{""}; // source file name without directories
+    int line{0};
+    uint32_t thread{0};   // small per-process thread number, in order of first log
+    std::string message;
+};
+using Sink = std::function<void(const Record& record)>;
+
+// Lines below the level are discarded before they are formatted (default Info, or the
+// value of $EBV_LOG_LEVEL: debug, info, warning, error)
+void setLevel(Level level);
+Level level();
+inline bool enabled(Level level);
+
+// Default sink: one line per record, debug/info on stdout, warnings/errors on stderr
+void setSink(Sink sink);
+// Block until every line logged before the call has reached the sink
+void flush();
+// Lines lost because their thread's ring was full
+uint64_t droppedCount();
+
+const char* levelName(Level level);
+std::string formatRecord(const Record& record);
+
+// Passes at most perSecond lines per second of one call site; the next line that passes
+// reports how many were suppressed
+class RateLimit {
+public:
+    explicit RateLimit(unsigned perSecond) : m_perSecond(perSecond) {}
+    bool allow();
+    uint64_t takeSuppressed() { return m_suppressed.exchange(0, std::memory_order_relaxed); }
+
+private:
+    const unsigned m_perSecond;
+    std::atomic<int64_t> m_windowStart{0};
+    std::atomic<unsigned> m_count{0};
+    std::atomic<uint64_t> m_suppressed{0};
+};
+
+namespace detail {
+struct LineBuffer;
+}
+
+// One log line; formats into a reused per-thread buffer and is submitted when destroyed
+class Line {
+public:
+    Line(Level level, const char* file, int line, RateLimit* limit = nullptr);
+    ~Line();
+    Line(const Line&) = delete;
+    Line& operator=(const Line&) = delete;
+
+    template <typename T>
+    Line& operator<<(const T& value) {
+        m_stream << value;
+        return *this;
+    }
+    Line& operator<<(std::ostream& (*manipulator)(std::ostream&)) {
+        m_stream << manipulator;
+        return *this;
+    }
+
+private:
+    const Level m_level;
+    const char* const m_file;
+    const int m_line;
+    RateLimit* const m_limit;
+    detail::LineBuffer* const m_buffer;
+    std::ostream& m_stream;
+};
+
+namespace detail {
+extern std::atomic<int> minimumLevel;
+}
+
+inline bool enabled(Level level) {
+    return static_cast<int>(level) >= detail::minimumLevel.load(std::memory_order_relaxed);
+}
+
+} // namespace Log
+
+#define EBV_LOG(level) \
+    if (!::Log::enabled(level)) {} else ::Log::Line(level, __FILE__, __LINE__)
+#define EBV_LOG_DEBUG EBV_LOG(::Log::Level::Debug)
+#define EBV_LOG_INFO EBV_LOG(::Log::Level::Info)
+#define EBV_LOG_WARN EBV_LOG(::Log::Level::Warning)
+#define EBV_LOG_ERROR EBV_LOG(::Log::Level::Error)
+
+// Rate-limited variants for messages that can repeat at capture rate (drops, full queues)
+#define EBV_LOG_EVERY(level, perSecond)                                                    \
+    if (static ::Log::RateLimit ebvLogLimit_(perSecond); !::Log::enabled(level) || !ebvLogLimit_.allow()) {} \
+    else ::Log::Line(level, __FILE__, __LINE__, &ebvLogLimit_)
+#define EBV_LOG_WARN_EVERY(perSecond) EBV_LOG_EVERY(::Log::Level::Warning, perSecond)
+#define EBV_LOG_ERROR_EVERY(perSecond) EBV_LOG_EVERY(::Log::Level::Error, perSecond)
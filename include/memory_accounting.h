@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Byte accounting of the large memory pools (writer queues, live buffers, frame caches,
+// preloaded recordings). Each owner of a pool entry keeps a MemoryCounter and updates it on
+// insert and evict; counters with the same pool name add up (one per camera, per loader,
+// ...). Bytes are what a pool references: an image shared by two pools counts in both.
+class MemoryCounter {
+public:
+    explicit MemoryCounter(const char* pool);
+    // Whatever is still counted is returned to the pool
+    ~MemoryCounter();
+
+    MemoryCounter(const MemoryCounter&) = delete;
+    MemoryCounter& operator=(const MemoryCounter&) = delete;
+
+    void add(uint64_t bytes, uint64_t items = 1);
+    void release(uint64_t bytes, uint64_t items = 1);
+    // The owner dropped all of its entries at once
+    void clear();
+
+    uint64_t bytes() const { return m_bytes.load(std::memory_order_relaxed); }
+    uint64_t items() const { return m_items.load(std::memory_order_relaxed); }
+
+    struct Pool;
+
+private:
+    Pool& m_pool;
+    std::atomic<uint64_t> m_bytes{0};
+    std::atomic<uint64_t> m_items{0};
+};
+
+namespace MemoryAccounting {
+
+struct PoolUsage {
+    std::string name;
+    uint64_t bytes{0};
+    uint64_t peakBytes{0};
+    uint64_t items{0};
+};
+
+// Every pool seen so far, largest first
+std::vector<PoolUsage> snapshot();
+uint64_t totalBytes();
+// Resident set size of the process (Linux /proc/self/statm), 0 if unknown
+uint64_t residentBytes();
+// "512 B", "3.4 MB", "12.1 GB"
+std::string formatBytes(uint64_t bytes);
+
+} // namespace MemoryAccounting
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// What preview work may cost right now. Capture and disk writers never consult this; only
+// preview rendering, GUI scaling and background prefetch scale themselves down with it.
+struct PreviewBudget {
+    int level{0};                // 0 = full quality, higher = more degraded
+    double frameRateScale{1.0};  // fraction of the nominal preview frame rate
+    double resolutionScale{1.0}; // fraction of the preview resolution
+    double eventDensity{1.0};    // fraction of events drawn into preview event frames
+    bool prefetchPaused{false};  // background rendering ahead of the playback cursor
+};
+
+// Watches the pressure on the capture path (writer queue fill, writer lag, CPU load) and
+// degrades preview quality step by step before capture is affected: first prefetch is
+// paused, then the preview frame rate, then resolution and event density drop. Levels go
+// up one step per evaluation while pressure stays above the high-water mark and come down
+// one step after it stayed below the low-water mark for a while (hysteresis, no flapping).
+class OverloadController {
+public:
+    // Pressure of one source normalized to its limit: 0 = idle, 1 = at the limit (drops imminent)
+    using Probe = std::function<double()>;
+    using LevelCallback = std::function<void(int level, const std::string& reason)>;
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        double highWater = 0.6;  // degrade one more step above this pressure
+        double lowWater = 0.3;   // restore one step after pressure stayed below this ...
+        std::chrono::milliseconds recoverAfter{2000}; // ... for this long
+        std::chrono::milliseconds interval{250};      // evaluation period of the monitor thread
+    };
+
+    OverloadController();
+    explicit OverloadController(Options options);
+    ~OverloadController();
+
+    OverloadController(const OverloadController&) = delete;
+    OverloadController& operator=(const OverloadController&) = delete;
+
+    void addProbe(const std::string& name, Probe probe);
+    // Probe the system CPU load (Linux /proc/stat); busy / busyLimit is the pressure
+    void addCpuProbe(double busyLimit = 0.9);
+    void setLevelCallback(LevelCallback callback);
+
+    // Evaluate periodically on a monitor thread
+    void start();
+    void stop();
+
+    // One evaluation step (called by the monitor thread; public for tests)
+    int evaluate(Clock::time_point now = Clock::now());
+
+    int level() const { return m_level.load(std::memory_order_relaxed); }
+    PreviewBudget budget() const { return budgetForLevel(level()); }
+    // Highest pressure seen in the last evaluation and the probe it came from
+    double pressure() const;
+    std::string dominantProbe() const;
+
+    static PreviewBudget budgetForLevel(int level);
+    static int maxLevel();
+
+private:
+    struct NamedProbe {
+        std::string name;
+        Probe probe;
+    };
+
+    void monitorLoop();
+
+    const Options m_options;
+    mutable std::mutex m_mutex;
+    std::vector<NamedProbe> m_probes;
+    LevelCallback m_callback;
+    std::atomic<int> m_level{0};
+    double m_pressure{0.0};
+    std::string m_dominant;
+    Clock::time_point m_calmSince{};
+    bool m_calm{false};
+
+    std::thread m_thread;
+    std::mutex m_threadMutex;
+    std::condition_variable m_threadCv;
+    bool m_running{false};
+};
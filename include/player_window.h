@@ -5,6 +5,7 @@
 #include <QFrame>
 #include <QSlider>
 #include <QPushButton>
+#include <QCheckBox>
 #include <QTimer>
 #include <QString>
 #include <QImage>
@@ -14,13 +15,18 @@
 #include "recording_loader.h"
 #include "recording_buffer.h"
 #include "cached_timeline_slider.h"
+#include "timeline_thumbnail_strip.h"
+#include "frame_rectifier.h"
 
 #include <vector>
+#include <memory>
 #include <atomic>
 #include <chrono>
 
 // Forward declarations
 class RecordingManager;
+class FrameQualityAnalyzer;
+class DeviceLifecycleManager;
 
 struct Pane {
     QFrame *frame {nullptr};
@@ -36,10 +42,16 @@ public:
     void selectAndLoadFolder();
     void loadRecording(const QString &dirPath);
     void autoLoadIfProvided(const QString &dirPath);
+    // Load recordings fully into RAM (see RecordingLoader::setPreloadOptions)
+    void setPreloadOptions(const PreloadOptions &options);
+    // Calibration for rectified live views; recordings with their own rectification.yml use that
+    void setRectificationFile(const QString &path);
     
     // Recording controls
     void startRecording();
     void stopRecording();
+    // Close the running take and continue into a new directory without a gap
+    void startNextTake();
     void stopRecordingShowPreview();
 
 protected:
@@ -51,12 +63,17 @@ private slots:
     void onLoadingProgress(const QString &status);
     void onRecordingToggle();
     void onRecordingStatusUpdate(const QString &message);
+    void onReleaseCameras();
 
 private:
     void updateDisplays();
     void updateStatus();
     void updateCachedFrames();
     void updateFPS(size_t currentFrame);
+    void applyLiveRectifier();
+    void updateQualityDisplay();
+    void updateMemoryDisplay();
+    void applyRecordingUi(bool recording);
     QString formatTime(double seconds) const;
     std::string generateRecordingDirectory() const;
     void notifyStatus(const std::string& message) const;
@@ -65,32 +82,55 @@ private:
     QLabel *m_pathLabel {nullptr};
     QPushButton *m_recordButton {nullptr};
     QPushButton *m_stopShowRecButton {nullptr};
+    QPushButton *m_nextTakeButton {nullptr};
     QPushButton *m_stopShowPrevButton {nullptr};
+    QPushButton *m_releaseCamerasButton {nullptr};
     QLabel *m_recordingStatusLabel {nullptr};
+    TimelineThumbnailStrip *m_thumbnailStrip {nullptr};
     CachedTimelineSlider *m_timelineSlider {nullptr};
     QPushButton *m_btnBack {nullptr};
     QPushButton *m_btnPlay {nullptr};
     QPushButton *m_btnFwd {nullptr};
+    QCheckBox *m_overlayCheck {nullptr};
+    QCheckBox *m_rectifyCheck {nullptr};
     QTimer m_timer;
     QTimer m_cacheUpdateTimer;
     QString m_loadedDir;
     std::vector<Pane> m_panes;
     QLabel *m_statusLabel {nullptr};
     QLabel *m_fpsLabel {nullptr};
+    QLabel *m_qualityLabel {nullptr};
+    QLabel *m_histogramLabel {nullptr};
+    QTimer m_qualityTimer;
+    // Accounted pool memory (tooltip: per pool) and process RSS
+    QLabel *m_memoryLabel {nullptr};
+    QTimer m_memoryTimer;
     
     // Data loader
     RecordingLoader *m_dataLoader {nullptr};
     
+    // Rectification: from --rectification (live and fallback) and from the loaded recording
+    std::shared_ptr<const FrameRectifier> m_configuredRectifier;
+    std::shared_ptr<const FrameRectifier> m_playbackRectifier;
+    
     // Recording buffer for unified data access
     RecordingBuffer *m_recordingBuffer {nullptr};
     
     // Recording manager
     RecordingManager *m_recordingManager {nullptr};
+    // Keeps cameras open between takes; released only on request or exit
+    DeviceLifecycleManager *m_deviceLifecycle {nullptr};
+    // Focus / exposure feedback from the live frames (preview and recording)
+    std::unique_ptr<FrameQualityAnalyzer> m_qualityAnalyzer;
     bool m_isRecording {false};
+    // A start/stop command is queued on the recording manager; further clicks are ignored
+    bool m_controlPending {false};
     QTimer m_recordingTimer;
     
     std::atomic<size_t> m_currentIndex {0};
     double m_assumedFps {30.0};
+    // Last event frame set was handed out late; redraw when the engine reports it complete
+    bool m_eventSetLate {false};
     
     // FPS tracking
     std::chrono::steady_clock::time_point m_lastFrameTime;
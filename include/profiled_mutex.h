@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Lock contention profiling. Hot-path mutexes are declared as ProfiledMutex with a site
+// name; a normal build maps it to std::mutex (the name is dropped), a build configured with
+// -DEBV_PROFILE_LOCKS=ON maps it to LockProfiling::InstrumentedMutex, which records how
+// long threads waited for and held each lock and which call sites held it while others
+// waited. Mutexes sharing a name (one per camera, one per sink, ...) share statistics.
+namespace LockProfiling {
+
+// Bucket 0 counts durations below 1 us, bucket b in [2^(b-1), 2^b) us, the last one is open-ended
+constexpr size_t HISTOGRAM_BUCKETS = 16;
+// Distinct call sites tracked per lock name; further sites are counted as "other"
+constexpr size_t MAX_CALL_SITES = 16;
+
+using Histogram = std::array<uint64_t, HISTOGRAM_BUCKETS>;
+
+size_t histogramBucket(int64_t durationNs);
+
+struct CallSiteSnapshot {
+    uintptr_t address{0};       // return address into the locking function, 0 = other sites
+    std::string symbol;         // demangled function name + offset when resolvable
+    uint64_t acquisitions{0};
+    uint64_t waitNs{0};         // time this site spent waiting for the lock
+    uint64_t holdNs{0};
+    uint64_t maxHoldNs{0};
+    uint64_t blockedOthers{0};  // acquisitions of other sites that had to wait for this one
+};
+
+struct LockSnapshot {
+    std::string name;
+    uint64_t acquisitions{0};
+    uint64_t contended{0};      // acquisitions that had to wait
+    uint64_t totalWaitNs{0};
+    uint64_t maxWaitNs{0};
+    uint64_t totalHoldNs{0};
+    uint64_t maxHoldNs{0};
+    Histogram waitHistogram{};
+    Histogram holdHistogram{};
+    std::vector<CallSiteSnapshot> callSites; // most waiting + blocking first
+};
+
+// Lock-free counters of one lock name; created once per name and never freed
+class LockStats {
+public:
+    explicit LockStats(std::string name) : m_name(std::move(name)) {}
+
+    void recordAcquire(uintptr_t site, int64_t waitNs, bool contended, uintptr_t blockingSite);
+    void recordRelease(uintptr_t site, int64_t holdNs);
+    LockSnapshot snapshot() const;
+    void reset();
+
+    const std::string& name() const { return m_name; }
+
+private:
+    struct Site {
+        std::atomic<uintptr_t> address{0};
+        std::atomic<uint64_t> acquisitions{0};
+        std::atomic<uint64_t> waitNs{0};
+        std::atomic<uint64_t> holdNs{0};
+        std::atomic<uint64_t> maxHoldNs{0};
+        std::atomic<uint64_t> blockedOthers{0};
+    };
+
+    Site& site(uintptr_t address);
+
+    const std::string m_name;
+    std::atomic<uint64_t> m_acquisitions{0};
+    std::atomic<uint64_t> m_contended{0};
+    std::atomic<uint64_t> m_totalWaitNs{0};
+    std::atomic<uint64_t> m_maxWaitNs{0};
+    std::atomic<uint64_t> m_totalHoldNs{0};
+    std::atomic<uint64_t> m_maxHoldNs{0};
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> m_waitHistogram{};
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> m_holdHistogram{};
+    std::array<Site, MAX_CALL_SITES> m_sites;
+    Site m_otherSites;
+};
+
+// Statistics shared by every mutex named name
+LockStats& statsFor(const std::string& name);
+// All lock names seen so far, highest total wait time first
+std::vector<LockSnapshot> snapshot();
+void reset();
+void writeReport(std::ostream& out);
+// Profiling builds: print the report to stderr (or to the file named by $EBV_LOCK_REPORT)
+// when the process exits. No-op otherwise.
+void installExitReport();
+
+constexpr bool enabled() {
+#ifdef EBV_PROFILE_LOCKS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// std::mutex replacement that feeds LockStats. The owner call site is the return address of
+// lock(), i.e. the function that took the lock (std::lock_guard is inlined into it in
+// optimized builds).
+class InstrumentedMutex {
+public:
+    explicit InstrumentedMutex(const char* name = "unnamed");
+
+    InstrumentedMutex(const InstrumentedMutex&) = delete;
+    InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+
+    void lock();
+    bool try_lock();
+    void unlock();
+
+private:
+    void acquired(uintptr_t site, int64_t waitNs, bool contended, uintptr_t blockingSite);
+
+    std::mutex m_mutex;
+    LockStats* m_stats;
+    // Written by the owner only; the owner site is read racily by waiters (relaxed atomic)
+    std::atomic<uintptr_t> m_ownerSite{0};
+    int64_t m_lockedAtNs{0};
+};
+
+} // namespace LockProfiling
+
+#ifdef EBV_PROFILE_LOCKS
+using ProfiledMutex = LockProfiling::InstrumentedMutex;
+using ProfiledConditionVariable = std::condition_variable_any;
+using ProfiledUniqueLock = std::unique_lock<ProfiledMutex>;
+#else
+// Exactly std::mutex; the site name only matters to profiling builds
+class ProfiledMutex : public std::mutex {
+public:
+    explicit ProfiledMutex(const char* /*name*/ = nullptr) {}
+};
+using ProfiledConditionVariable = std::condition_variable;
+using ProfiledUniqueLock = std::unique_lock<std::mutex>;
+#endif
@@ -14,9 +14,15 @@
 #include <thread>
 #include <functional>
 #include <chrono>
+#include "bus_topic.h"
+#include "profiled_mutex.h"
+#include "memory_accounting.h"
 
 // Forward declarations
 class RecordingLoader;
+class FrameRectifier;
+struct LiveFramePacket;
+struct LiveEventFrame;
 // Note: RecordingManager forward declaration without including header to avoid hardware dependencies in GUI
 
 // Data structures for buffered frame data
@@ -77,6 +83,8 @@ public:
     
     // Live recording specific methods
     size_t getLiveFrameCount() const;
+    // Rectify live frames at preview resolution in the buffer worker (null = off)
+    void setLiveRectifier(std::shared_ptr<const FrameRectifier> rectifier, int previewWidth);
     UnifiedFrameData getLatestLiveData() const;
     
     // Cache information (for timeline visualization)
@@ -132,8 +140,20 @@ private:
     // Live data buffers
     std::queue<BufferedFrameData> m_liveFrameBuffer;
     std::queue<BufferedEventData> m_liveEventBuffer;
-    mutable std::mutex m_liveBufferMutex;
-    std::condition_variable m_liveBufferCondition;
+    mutable ProfiledMutex m_liveBufferMutex{"player_live_buffer"};
+    ProfiledConditionVariable m_liveBufferCondition;
+    MemoryCounter m_liveBufferMemory{"player_live_buffer"}; // both live queues
+
+    // Live data bus subscriptions (preferred over polling the manager getters)
+    std::shared_ptr<BusSubscription<LiveFramePacket>> m_frameSubscription;
+    std::shared_ptr<BusSubscription<LiveEventFrame>> m_eventFrameSubscription;
+    bool m_busFramesSeen{false};
+    bool m_busEventFramesSeen{false};
+
+    std::shared_ptr<const FrameRectifier> m_liveRectifier;
+    int m_rectifyPreviewWidth{0};
+    std::mutex m_rectifierMutex;
+    static constexpr size_t LIVE_BUS_QUEUE_SIZE = 8;
     
     // Buffer management
     static constexpr size_t MAX_LIVE_BUFFER_SIZE = 500;  // Maximum frames to keep in live buffer
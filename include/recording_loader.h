@@ -7,24 +7,40 @@
 #include <metavision/sdk/stream/camera.h>
 #include <metavision/sdk/core/utils/cd_frame_generator.h>
 #include <metavision/sdk/base/events/event_cd.h>
+#include "event_frame_disk_cache.h"
+#include "recording_preload.h"
+#include "event_overlay.h"
+#include "event_buffer_arena.h"
+#include "event_playback_engine.h"
+#include "profiled_mutex.h"
+#include "memory_accounting.h"
 
 #include <vector>
 #include <string>
+#include <chrono>
 #include <thread>
 #include <atomic>
 #include <functional>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
 
 struct FrameCameraData {
     std::vector<std::string> image_files; // sorted
-    // Lazy load cache for current frame
-    cv::Mat loadFrame(size_t idx) const {
+    // Encoded images held in memory (preload mode); null when streaming from disk
+    std::shared_ptr<PreloadedFrameStore> preloaded;
+    // Lazy load cache for current frame (cv::IMREAD_REDUCED_* flags decode JPEGs at reduced size)
+    cv::Mat loadFrame(size_t idx, int imreadFlags = cv::IMREAD_UNCHANGED) const {
         if (idx >= image_files.size()) return {};
-        return cv::imread(image_files[idx], cv::IMREAD_UNCHANGED);
+        if (preloaded && idx < preloaded->frameCount()) {
+            const auto bytes = preloaded->frame(idx);
+            const cv::Mat encoded(1, static_cast<int>(bytes.second), CV_8U, const_cast<uint8_t *>(bytes.first));
+            return cv::imdecode(encoded, imreadFlags);
+        }
+        return cv::imread(image_files[idx], imreadFlags);
     }
 };
 
@@ -43,32 +59,61 @@ struct EventCameraData {
 // Efficient event camera frame loader with lazy generation
 class EventCameraLoader {
 public:
-    EventCameraLoader(const std::string &filePath);
+    EventCameraLoader(const std::string &filePath, int cameraId = 0);
     ~EventCameraLoader();
+
+    // Frame timing of event playback; the frame count and prepareFrame use it
+    static constexpr double PLAYBACK_FPS = 30.0;
     
     // Get frame at specific time index (lazy generation)
-    QImage getFrame(size_t frameIndex, double fps = 30.0);
-    // Notify loader of externally updated playback position (optional helper)
+    QImage getFrame(size_t frameIndex, double fps = PLAYBACK_FPS);
+    // Small preview for the timeline; bypasses the frame cache but feeds the disk cache
+    QImage renderThumbnail(size_t frameIndex, int maxWidth, double fps = PLAYBACK_FPS);
+    // Playback position; a jump evicts cached frames far away from it
     void setCurrentFrameIndex(size_t frameIndex);
-    void setPlaybackFps(double fps);
+    // Render a frame into the frame cache unless it is there already (EventPlaybackEngine
+    // render step, thread safe); false if the frame cannot be produced
+    bool prepareFrame(size_t frameIndex);
+    bool hasFrame(size_t frameIndex) const;
     
     // Get metadata
     int getWidth() const { return m_width; }
     int getHeight() const { return m_height; }
     size_t getEstimatedFrameCount() const { return m_estimatedFrameCount; }
     bool isValid() const { return m_isValid; }
+    const std::string &getFilePath() const { return m_filePath; }
+    int64_t getDurationUs() const { return m_durationUs; }
+
+    // Render from events held in memory instead of decoding the file (call before playback starts)
+    void setPreloadedEvents(std::shared_ptr<const PreloadedEventStore> events) { m_preloaded = std::move(events); }
+    bool isPreloaded() const { return m_preloaded != nullptr; }
     
     // Get cached frame indices
     QSet<int> getCachedFrames() const;
     
 private:
     void initialize();
-    QImage generateFrameFromTimeRange(Metavision::timestamp startTime, Metavision::timestamp endTime);
-    QImage generateFrameFromEvents(const std::vector<Metavision::EventCD> &events);
-    void prefetchThreadMain();
-    void requestPrefetch();
+    // Event time range shown as frame frameIndex at fps. Every render path uses it, so the
+    // frame and disk caches, both keyed by frame index, never mix differently sized windows.
+    static std::pair<Metavision::timestamp, Metavision::timestamp> frameWindow(size_t frameIndex, double fps);
+    static Metavision::timestamp frameDurationUs(double fps) { return static_cast<Metavision::timestamp>(1000000.0 / fps); }
+    // Margin added on both sides of a frame window to avoid gaps at the boundaries
+    static Metavision::timestamp frameOverlapUs(double fps) { return frameDurationUs(fps) / 10; }
+    // Disk cache hit, or render from events and queue the result for the disk cache
+    QImage loadOrGenerateFrame(size_t frameIndex, double fps, Metavision::timestamp startTime,
+                               Metavision::timestamp endTime, bool *fromDisk = nullptr);
+    std::shared_ptr<EventFrameDiskCache> diskCacheFor(double fps);
+    bool generatePlaneFromTimeRange(Metavision::timestamp startTime, Metavision::timestamp endTime,
+                                    std::vector<uint8_t> &plane);
+    std::vector<uint8_t> classifyEvents(const EventBlock &events) const;
+    std::vector<uint8_t> classifyPreloadedEvents(Metavision::timestamp startTime, Metavision::timestamp endTime) const;
+    QImage renderClassPlane(const std::vector<uint8_t> &plane) const;
+    // Insert and evict the oldest entry beyond MAX_CACHE_SIZE; m_frameMutex must be held
+    void cacheFrameLocked(size_t frameIndex, const QImage &frame);
     
     std::string m_filePath;
+    int m_cameraId{0};
+    int64_t m_durationUs{0};
     
     int m_width{0};
     int m_height{0};
@@ -77,19 +122,22 @@ private:
     
     // Frame cache only (no event pre-loading)
     std::unordered_map<size_t, QImage> m_frameCache;
-    mutable std::mutex m_frameMutex;
+    mutable ProfiledMutex m_frameMutex{"loader_frame_cache"};
+    MemoryCounter m_cacheMemory{"event_frame_cache"};
     static const size_t MAX_CACHE_SIZE = 10000;
-    static const size_t PREFETCH_AHEAD_FRAMES = MAX_CACHE_SIZE / 2; // how many future frames to pre-generate
+    static const size_t CACHE_KEEP_FRAMES = MAX_CACHE_SIZE / 2; // kept behind the position after a jump
+
+    // Persistent second-level cache of rendered frames (survives reopening the recording)
+    static constexpr const char *RENDER_MODE = "polarity";
+    static constexpr uint32_t RENDERER_VERSION = 1; // bump when classifyEvents or frameWindow change
+    std::shared_ptr<EventFrameDiskCache> m_diskCache; // shared: in-flight users survive an fps switch
+    int64_t m_diskCacheWindowUs{0};
+    std::mutex m_diskCacheMutex;
+
+    std::shared_ptr<const PreloadedEventStore> m_preloaded;
 
-    // Prefetch machinery
-    std::thread m_prefetchThread;
-    std::atomic<bool> m_stopPrefetch{false};
+    // Playback state; rendering ahead is scheduled by the session's EventPlaybackEngine
     std::atomic<size_t> m_currentFrameIndex{0};
-    std::atomic<double> m_fps{30.0};
-    std::mutex m_prefetchMutex;
-    std::condition_variable m_prefetchCv;
-    bool m_prefetchDirty{false};
-    bool m_prefetchRestart{false};
 };
 
 struct RecordingData {
@@ -100,6 +148,12 @@ struct RecordingData {
     bool isValid{false};
 };
 
+// Event images of all event cameras for one playback instant
+struct EventFrameSet {
+    std::vector<QImage> images; // per event camera; null if missing or not ready in time
+    bool late{false};           // some cameras were still rendering when the set was handed out
+};
+
 class RecordingLoader : public QObject {
     Q_OBJECT
 
@@ -115,10 +169,23 @@ public:
     const RecordingData& getData() const { return m_data; }
     bool isDataReady() const { return m_dataReady.load(); }
     bool isLoading() const { return m_loading.load(); }
+    // Whole-recording RAM preload, applied from the next loadRecording() on
+    void setPreloadOptions(const PreloadOptions &options) { m_preloadOptions = options; }
+    const PreloadOptions &getPreloadOptions() const { return m_preloadOptions; }
 
     // Frame access helpers
     cv::Mat getFrameCameraFrame(int camera, size_t frameIndex) const;
     QImage getEventCameraFrame(int camera, size_t frameIndex) const;
+    // All event cameras at one instant, in lockstep: waits up to timeout for the playback
+    // engine, then returns what is ready and marks the set late (eventFrameSetReady follows)
+    EventFrameSet getEventFrameSet(size_t frameIndex, std::chrono::milliseconds timeout) const;
+    // Frame image with the matching event camera's activity blended in (pair i <-> i). events
+    // is that camera's image of the same instant, e.g. from getEventFrameSet; nothing is
+    // rendered here, a null image returns the plain frame.
+    cv::Mat getFrameCameraOverlay(int camera, size_t frameIndex, const QImage &events, double alpha = 0.6) const;
+    // Reduced-resolution previews for the timeline thumbnail strip (thread safe)
+    cv::Mat getFrameCameraThumbnail(int camera, size_t frameIndex) const;
+    QImage getEventCameraThumbnail(int camera, size_t frameIndex, int maxWidth) const;
     
     // Cache information helpers
     QSet<int> getCachedEventFrames(int camera) const;
@@ -126,23 +193,40 @@ public:
     
     // Prefetch control
     void notifyFrameChanged(size_t frameIndex);
+    // Stop rendering ahead of the cursor (live capture needs the CPU); kept across loads
+    void setPrefetchPaused(bool paused);
 
 signals:
     void loadingStarted(const QString &path);
     void loadingFinished(bool success, const QString &message);
     void loadingProgress(const QString &status);
+    // Every event camera has finished frameIndex (emitted on the loader's thread)
+    void eventFrameSetReady(qulonglong frameIndex);
 
 private:
     void loadDataWorker(const std::string &dirPath);
     void loadFrameCameraData(const std::string &dirPath, int camera, FrameCameraData &data);
     void loadEventCameraData(const std::string &dirPath, int camera, EventCameraData &data);
     size_t calculateTotalFrames() const;
+    void preloadStreams();
 
+    const EventOverlay::RemapTable &overlayTableFor(int camera, cv::Size frameSize, cv::Size eventSize) const;
+
+    PreloadOptions m_preloadOptions;
+    // Declared before m_data: the preloaded stores charge their memory to it
+    std::unique_ptr<PreloadBudget> m_preloadBudget;
     RecordingData m_data;
+    // Schedules event rendering for all event cameras; declared after m_data since it renders through its loaders
+    std::unique_ptr<EventPlaybackEngine> m_eventPlayback;
     std::thread m_loaderThread;
     std::atomic<bool> m_abortLoading{false};
     std::atomic<bool> m_dataReady{false};
     std::atomic<bool> m_loading{false};
+    std::atomic<bool> m_prefetchPaused{false};
+
+    // Overlay remap tables, built on first use per camera pair and kept for the session
+    mutable std::vector<EventOverlay::RemapTable> m_overlayTables;
+    mutable std::mutex m_overlayMutex;
 };
 
 // Utility functions moved from player_window
@@ -6,9 +6,22 @@
 #include <unordered_map>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
 #include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
 #include "event_camera_manager.h"
 #include "frame_camera_manager.h"
+#include "live_data_bus.h"
+#include "overload_controller.h"
+
+class LiveStreamExport;
+class StagingMigrator;
+class EventTranscoder;
 
 class RecordingManager {
 public:
@@ -25,18 +38,40 @@ public:
     virtual void stopPreview() = 0;
     virtual void startRecordingToPath(const std::string& outputPath) = 0;
     virtual void stopRecordingOnly() = 0;
+        // Running disk writer continues into outputPath: frames captured from now on go there;
+        // returns once every frame of the previous take is written
+        virtual void switchRecordingPath(const std::string& outputPath) = 0;
+        virtual void setLiveDataBus(LiveDataBus* bus) = 0;
+        // Output striping: per-camera parent directories for the next recording
+        virtual size_t deviceCount() const = 0;
+        virtual void setStreamDirectories(const std::vector<std::string>& directories) = 0;
+        // Writer backlog relative to its limit (0 = idle, 1 = about to drop), see OverloadController
+        virtual double writerPressure() const { return 0.0; }
+        virtual void setWatchdog(StallWatchdog* watchdog) { (void)watchdog; }
+        // Statistics of the take whose recording was stopped last, see RecordingSummary
+        virtual std::vector<StreamSummary> lastTakeSummaries() const { return {}; }
     };
     struct IEventCameraManager {
     using BiasConfig = std::unordered_map<std::string,int>;
     using CameraConfig = EventCameraManager::CameraConfig; // reuse concrete struct for simplicity
         virtual ~IEventCameraManager() = default;
         virtual void openAndSetupDevices(const std::vector<CameraConfig>& cameraConfigs) = 0;
+        virtual void applyBiases(const std::vector<CameraConfig>& cameraConfigs) = 0;
         virtual void startRecording(const std::string& outputPath, const std::string& fileFormat) = 0;
         virtual void stopRecording() = 0;
+        virtual void switchRecording(const std::string& outputPath, const std::string& fileFormat) = 0;
         virtual void closeDevices() = 0;
         virtual bool startLiveStreaming() = 0;
         virtual void stopLiveStreaming() = 0;
         virtual bool getLatestEventFrame(int cameraId, cv::Mat& eventFrame, size_t& frameIndex) = 0;
+        virtual void setLiveDataBus(LiveDataBus* bus) = 0;
+        virtual size_t deviceCount() const = 0;
+        virtual void setStreamDirectories(const std::vector<std::string>& directories) = 0;
+        virtual void setHdf5Settings(const EventCameraManager::Hdf5Settings& settings) = 0;
+        virtual double writerPressure() const { return 0.0; }
+        virtual void setOverloadController(const OverloadController* controller) { (void)controller; }
+        virtual void setWatchdog(StallWatchdog* watchdog) { (void)watchdog; }
+        virtual std::vector<StreamSummary> lastTakeSummaries() const { return {}; }
     };
     // Configuration structure for recording
     struct RecordingConfig {
@@ -45,6 +80,26 @@ public:
         std::string eventFileFormat = "hdf5";  // "raw" or "hdf5"
         std::string outputPrefix = "";
         int recordingLengthSeconds = -1;  // -1 for indefinite
+        // Optional shared-memory export of live data for external processes (empty = disabled)
+        std::string liveExportName = "";
+        uint32_t liveExportSlots = 16;
+        size_t liveExportSlotBytes = 32u << 20;
+        // Tiered output: capture into this fast directory (tmpfs / NVMe scratch) and migrate
+        // each finished take to its output directory in the background (empty = direct)
+        std::string stagingDirectory = "";
+        uint64_t migrationBytesPerSecond = 0; // 0 = unthrottled
+        // Striping over several disks: streams are placed round-robin on these roots, each in
+        // <root>/<take name>; streamOutputRoots pins single streams ("frame_cam0", "ebv_cam_1").
+        // Not combined with staging. The session manifest records where every stream went.
+        std::vector<std::string> outputRoots;
+        std::map<std::string, std::string> streamOutputRoots;
+        // Record RAW (cheapest to write) and convert each finished take to compressed HDF5 in
+        // the background; only used with eventFileFormat == "raw"
+        bool transcodeRawToHdf5 = false;
+        bool keepRawAfterTranscode = false;
+        // HDF5 tuning: -1 = SDK writer (ECF codec); 0..9 = deflate level of the tunable writer
+        int hdf5CompressionLevel = -1;
+        size_t hdf5ChunkEvents = 16384;
     };
 
     // Status callback function type
@@ -56,23 +111,76 @@ public:
                      std::unique_ptr<IEventCameraManager> eventMgr);
     ~RecordingManager();
 
-    // Configuration interface - must be called before recording
+    // Configuration interface - must be called before recording.
+    // If devices are already open and only biases/format/output settings changed, the
+    // difference is applied in place; devices are reopened only on serial/topology changes.
     bool configure(const RecordingConfig& config);
+    static bool requiresDeviceReopen(const RecordingConfig& current, const RecordingConfig& next);
     bool isConfigured() const { return m_configured; }
     
     // Main recording interface
     bool startRecording(const std::string& outputDirectory);
     void stopRecording();
+    // Close the current take and continue seamlessly into a new output directory (starts a
+    // normal recording if none is running). Runs on the control thread, see submitNextTake.
+    bool startNextTake(const std::string& outputDirectory);
     void closeDevices(); // Close and release all camera resources
     
     // Live preview control (no disk I/O)
     bool startPreview();
     void stopPreview();
     bool isPreviewing() const { return m_previewing; }
+    // Stop all streaming (preview and the event pipeline) but keep devices open
+    void enterIdle();
     
-    // Async setup: open devices on a background thread and notify via callback
+    // Async setup: queued as a configure command (see below) and reported via callback
     using SetupCallback = std::function<void(bool success, const std::string& message)>;
     void configureAsync(const RecordingConfig& config, SetupCallback onComplete);
+
+    // ---- Asynchronous control ----
+    // Commands run one after another on the manager's control thread, so callers (the GUI)
+    // never block on device or file operations. Each command checks the state it finds when
+    // it runs; invalid transitions are rejected with success == false and change nothing.
+    //
+    //   Closed --configure--> Idle --preview--> Previewing --record--> Recording
+    //   Recording --next--> Recording (new take, no gap), Idle/Previewing --next--> Recording
+    //   Recording --stop--> Previewing/Idle, Previewing/Idle --stop--> Idle (streams stopped),
+    //   any --close--> Closed
+    enum class State { Closed, Idle, Previewing, Recording };
+    enum class Command { Configure, Preview, Record, NextTake, Stop, Close };
+    struct CommandResult {
+        bool success{false};
+        std::string message;
+        State state{State::Closed}; // state after the command
+        std::string directory;      // record/next/stop: capture directory of the take
+        std::string closedDirectory; // next: capture directory of the take that was closed
+    };
+    // Called on the control thread before the future becomes ready
+    using CommandCallback = std::function<void(const CommandResult& result)>;
+
+    std::future<CommandResult> submitConfigure(const RecordingConfig& config, CommandCallback onComplete = {});
+    std::future<CommandResult> submitPreview(CommandCallback onComplete = {});
+    std::future<CommandResult> submitRecord(const std::string& outputDirectory, CommandCallback onComplete = {});
+    std::future<CommandResult> submitNextTake(const std::string& outputDirectory, CommandCallback onComplete = {});
+    std::future<CommandResult> submitStop(CommandCallback onComplete = {});
+    std::future<CommandResult> submitClose(CommandCallback onComplete = {});
+
+    State state() const;
+    static bool isValidTransition(State from, Command command);
+    static const char* stateName(State state);
+    static const char* commandName(Command command);
+
+    // Run fn on the control thread after everything queued so far and wait for its result
+    // (runs inline when called from the control thread, e.g. from a command callback).
+    // Keeps direct callers of the synchronous interface serialized with queued commands.
+    template <typename Fn>
+    auto invokeOnControlThread(Fn fn) -> decltype(fn()) {
+        if (onControlThread()) return fn();
+        auto task = std::make_shared<std::packaged_task<decltype(fn())()>>(std::move(fn));
+        auto result = task->get_future();
+        enqueueControlTask([task] { (*task)(); }, [task] { (*task)(); });
+        return result.get();
+    }
     
     // Legacy interface for backward compatibility
     bool startRecording(const RecordingConfig& config);
@@ -80,8 +188,18 @@ public:
     
     // Status and information
     virtual bool isRecording() const { return m_recording; }
-    std::string getCurrentOutputDirectory() const { return m_currentOutputDir; }
-    std::chrono::steady_clock::time_point getRecordingStartTime() const { return m_recordingStartTime; }
+    // Directory the current/last take is written to (staging location when staging is enabled).
+    // The take getters may be called from any thread while the control thread switches takes.
+    std::string getCurrentOutputDirectory() const;
+    // Final destination of the current/last take
+    std::string getFinalOutputDirectory() const;
+    size_t pendingMigrations() const;
+    size_t pendingTranscodes() const;
+    // Called (from a worker thread) once a take's post-processing (transcoding, migration) has
+    // finished and it is in its final location; not called for takes without post-processing
+    using TakeFinalizedCallback = std::function<void(const std::string& finalDirectory, bool success)>;
+    void setTakeFinalizedCallback(TakeFinalizedCallback callback) { m_takeFinalizedCallback = std::move(callback); }
+    std::chrono::steady_clock::time_point getRecordingStartTime() const;
     double getRecordingDurationSeconds() const;
     bool isReady() const { return m_configured; }
 
@@ -100,29 +218,90 @@ public:
     virtual bool getLiveFrameData(int cameraId, cv::Mat& frame, size_t& frameIndex);
     virtual bool getLiveEventData(int cameraId, cv::Mat& eventFrame, size_t& frameIndex);
 
+    // Push-based live data: frames, event chunks, rendered event frames and stats
+    LiveDataBus& liveDataBus() { return m_liveBus; }
+    bool isLiveExportActive() const { return m_liveExport != nullptr; }
+    // Preview quality budget under load; preview consumers scale themselves down with it
+    const OverloadController& overloadController() const { return m_overload; }
+    // Blocking calls of capture, writer and preview threads; stalls go to the status callback
+    // and into the session manifest of the take they happened in
+    const StallWatchdog& stallWatchdog() const { return m_watchdog; }
+    // Publish the byte counts of all memory pools (MemoryAccounting) as bus stats, source
+    // "memory": one stat per pool plus "total" and "resident"; call periodically
+    void publishMemoryUsage();
+
 private:
     std::string generateOutputDirectory(const std::string& prefix = "") const;
     std::vector<EventCameraManager::CameraConfig> createEventCameraConfigs(const RecordingConfig& config) const;
     void validateConfig(const RecordingConfig& config) const;
     void notifyStatus(const std::string& message) const;
+    bool reconfigureInPlace(const RecordingConfig& config);
+    bool switchToNextTake(const std::string& outputDirectory);
+    void setCurrentTake(const std::string& captureDirectory, const std::string& finalDirectory);
+    std::string captureDirectoryFor(const std::string& outputDirectory) const;
+    void beginTakeManifest(const std::string& captureDirectory, const std::string& finalDirectory,
+                           const std::map<std::string, std::filesystem::path>& streamLayout);
+    std::map<std::string, std::filesystem::path> applyStreamLayout(const std::string& captureDirectory);
+    void finishTake(const std::string& captureDirectory, const std::string& finalDirectory, double durationSeconds);
+    void onTranscodeFinished(const std::string& captureDirectory, bool success, const std::string& message);
+    void startLiveExport();
+    void stopLiveExport();
+    std::future<CommandResult> submit(Command command, RecordingConfig config, std::string outputDirectory,
+                                      CommandCallback onComplete);
+    CommandResult executeCommand(Command command, const RecordingConfig& config, const std::string& outputDirectory);
+    // cancel runs instead of run for tasks still queued at shutdown
+    void enqueueControlTask(std::function<void()> run, std::function<void()> cancel);
+    void controlThreadMain();
+    void stopControlThread();
+    bool onControlThread();
+    void setupOverloadControl();
+    void setupStallWatchdog();
     
+    // Declared before the camera managers so they outlive their worker threads
+    LiveDataBus m_liveBus;
+    StallWatchdog m_watchdog;
+    std::unique_ptr<LiveStreamExport> m_liveExport;
+    // Moves finished takes from the staging directory; created on first staged take
+    std::unique_ptr<StagingMigrator> m_migrator;
+    // Converts RAW takes to HDF5 after capture; created on first transcoded take
+    std::unique_ptr<EventTranscoder> m_transcoder;
+
     // Camera managers
     // Use abstract pointers to allow substitution with mocks
     std::unique_ptr<IFrameCameraManager> m_frameCameraManager;
     std::unique_ptr<IEventCameraManager> m_eventCameraManager;
+    // Probes the managers above; stopped first in the destructor
+    OverloadController m_overload;
     
     // Recording state
     std::atomic<bool> m_recording{false};
     std::atomic<bool> m_previewing{false};
     std::atomic<bool> m_configured{false};
+    // Current take: written on the control thread under m_takeMutex (setCurrentTake), read
+    // there without it and from other threads through the getters
+    mutable std::mutex m_takeMutex;
     std::string m_currentOutputDir;
+    std::string m_finalOutputDir;
     std::chrono::steady_clock::time_point m_recordingStartTime;
     RecordingConfig m_currentConfig;
     
     // Callbacks and external control
     StatusCallback m_statusCallback;
+    TakeFinalizedCallback m_takeFinalizedCallback;
     std::atomic<bool>* m_shutdownFlag{nullptr};
     
+    // Control thread and its command queue (started with the first queued command)
+    struct ControlTask {
+        std::function<void()> run;
+        std::function<void()> cancel;
+    };
+    std::thread m_controlThread;
+    std::thread::id m_controlThreadId;
+    std::mutex m_controlMutex;
+    std::condition_variable m_controlCv;
+    std::deque<ControlTask> m_controlQueue;
+    bool m_controlStopping{false};
+    
     // Default bias values
     static const std::unordered_map<std::string, int> DEFAULT_BIASES;
 };
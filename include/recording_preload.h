@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <utility>
+#include <vector>
+#include "memory_accounting.h"
+
+// Whole-recording RAM preload for review workstations: frame images are kept as their
+// encoded file bytes and events in a compact structure-of-arrays form, so playback and
+// scrubbing never touch the disk once loading has finished. Everything is accounted
+// against a memory ceiling; streams that do not fit are played back from disk as before.
+
+struct PreloadOptions {
+    bool enabled = false;
+    uint64_t memoryCeilingBytes = 0; // 0 = half of the physical memory
+    bool hugePages = false;          // back large arrays with transparent huge pages
+};
+
+// Large anonymous mappings (optionally madvise'd for huge pages); small blocks use the heap
+class PreloadMemory {
+public:
+    static constexpr size_t MAPPING_THRESHOLD = 2u << 20;
+
+    static void* allocate(size_t bytes, bool hugePages);
+    static void release(void* pointer, size_t bytes) noexcept;
+    static uint64_t physicalMemoryBytes();
+    // Ceiling to use for the given options (resolves the 0 = default case)
+    static uint64_t ceilingFor(const PreloadOptions& options);
+};
+
+template <typename T>
+struct PreloadAllocator {
+    using value_type = T;
+
+    PreloadAllocator() = default;
+    explicit PreloadAllocator(bool useHugePages) : hugePages(useHugePages) {}
+    template <typename U>
+    PreloadAllocator(const PreloadAllocator<U>& other) : hugePages(other.hugePages) {}
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_alloc();
+        return static_cast<T*>(PreloadMemory::allocate(n * sizeof(T), hugePages));
+    }
+    void deallocate(T* pointer, size_t n) noexcept { PreloadMemory::release(pointer, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const PreloadAllocator<U>& other) const { return hugePages == other.hugePages; }
+    template <typename U>
+    bool operator!=(const PreloadAllocator<U>& other) const { return !(*this == other); }
+
+    bool hugePages{false};
+};
+
+template <typename T>
+using PreloadVector = std::vector<T, PreloadAllocator<T>>;
+
+// Shared byte budget of one preload; every store charges its allocations here
+class PreloadBudget {
+public:
+    explicit PreloadBudget(uint64_t ceilingBytes) : m_ceiling(ceilingBytes) {}
+
+    bool tryReserve(uint64_t bytes);
+    void release(uint64_t bytes);
+    uint64_t ceiling() const { return m_ceiling; }
+    uint64_t used() const { return m_used.load(); }
+
+private:
+    const uint64_t m_ceiling;
+    std::atomic<uint64_t> m_used{0};
+    MemoryCounter m_memory{"preload"};
+};
+
+// Encoded frame images back to back in one buffer
+class PreloadedFrameStore {
+public:
+    PreloadedFrameStore(PreloadBudget& budget, bool hugePages, uint64_t expectedBytes, size_t expectedFrames);
+    ~PreloadedFrameStore();
+
+    PreloadedFrameStore(const PreloadedFrameStore&) = delete;
+    PreloadedFrameStore& operator=(const PreloadedFrameStore&) = delete;
+
+    // False if the budget is exhausted; the store is unchanged then
+    bool append(const uint8_t* data, size_t size);
+    size_t frameCount() const { return m_offsets.size() - 1; }
+    std::pair<const uint8_t*, size_t> frame(size_t index) const;
+    uint64_t memoryBytes() const { return m_charged; }
+
+private:
+    bool charge(size_t bytes, size_t frames);
+
+    PreloadBudget& m_budget;
+    PreloadVector<uint8_t> m_bytes;
+    std::vector<uint64_t> m_offsets{0};
+    uint64_t m_charged{0};
+};
+
+// CD events as separate x / y / polarity / time arrays. Timestamps are stored as 32-bit
+// offsets from the first event (covers 71 minutes); events must be appended in time order.
+class PreloadedEventStore {
+public:
+    static constexpr size_t BYTES_PER_EVENT = 2 + 2 + 1 + 4;
+
+    PreloadedEventStore(PreloadBudget& budget, bool hugePages, size_t expectedEvents);
+    ~PreloadedEventStore();
+
+    PreloadedEventStore(const PreloadedEventStore&) = delete;
+    PreloadedEventStore& operator=(const PreloadedEventStore&) = delete;
+
+    // Any event type with x, y, p, t members (Metavision::EventCD). False if the budget is
+    // exhausted or a timestamp is out of range; the store is then incomplete and unusable.
+    template <typename EventIt>
+    bool append(EventIt begin, EventIt end) {
+        const size_t count = static_cast<size_t>(end - begin);
+        if (count == 0) return m_complete;
+        if (!m_complete || !ensureCapacity(m_t.size() + count)) return m_complete = false;
+        if (m_t.empty()) m_baseTime = static_cast<int64_t>(begin->t);
+        for (auto it = begin; it != end; ++it) {
+            const int64_t offset = static_cast<int64_t>(it->t) - m_baseTime;
+            if (offset < 0 || offset > static_cast<int64_t>(std::numeric_limits<uint32_t>::max())) {
+                return m_complete = false;
+            }
+            m_x.push_back(static_cast<uint16_t>(it->x));
+            m_y.push_back(static_cast<uint16_t>(it->y));
+            m_p.push_back(static_cast<uint8_t>(it->p));
+            m_t.push_back(static_cast<uint32_t>(offset));
+        }
+        return true;
+    }
+
+    bool isComplete() const { return m_complete; }
+    size_t size() const { return m_t.size(); }
+    // Index range of the events with startUs <= t < endUs
+    std::pair<size_t, size_t> range(int64_t startUs, int64_t endUs) const;
+    uint16_t x(size_t i) const { return m_x[i]; }
+    uint16_t y(size_t i) const { return m_y[i]; }
+    uint8_t p(size_t i) const { return m_p[i]; }
+    int64_t t(size_t i) const { return m_baseTime + m_t[i]; }
+    uint64_t memoryBytes() const { return m_charged; }
+
+private:
+    bool ensureCapacity(size_t events);
+
+    PreloadBudget& m_budget;
+    PreloadVector<uint16_t> m_x;
+    PreloadVector<uint16_t> m_y;
+    PreloadVector<uint8_t> m_p;
+    PreloadVector<uint32_t> m_t;
+    int64_t m_baseTime{0};
+    uint64_t m_charged{0};
+    bool m_complete{true};
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Per-stream statistics of one take ("recording_summary.txt" next to the session manifest,
+// one key=value per line). The writers accumulate them while the take is written, so judging
+// a take means reading a few lines instead of loading it in the player.
+struct StreamSummary {
+    std::string stream; // "frame_cam0", "ebv_cam_1", see StreamLayout
+    bool events{false}; // event stream (else frame stream)
+    double durationSeconds{0.0}; // first to last timestamp
+    uint64_t bytes{0};           // on disk at the end of the take
+
+    // Frame streams: rates over whole seconds of the take (min/max) and over the full span (avg)
+    uint64_t frames{0};
+    uint64_t droppedFrames{0};
+    double fpsMin{0.0};
+    double fpsAvg{0.0};
+    double fpsMax{0.0};
+
+    // Event streams
+    uint64_t eventsOn{0};
+    uint64_t eventsOff{0};
+    uint64_t triggers{0};
+    double rateOn{0.0};      // events/s over the span
+    double rateOff{0.0};
+    double rateMax{0.0};     // busiest whole second, both polarities
+    // HDF5 takes: how far the camera's last event was short of the stop boundary when its
+    // file had to be closed on the drain timeout (0 = the take is complete up to the boundary)
+    int64_t boundaryLagUs{0};
+    // RAW takes: events counted without looking at them (statistics backlog full); the on/off
+    // split is scaled from the others and silences among them are not detected
+    uint64_t eventsCountedOnly{0};
+
+    // Frame intervals above GAP_FACTOR x the average so far, or event silences above
+    // EVENT_GAP_US
+    uint64_t gaps{0};
+    double maxGapMs{0.0};
+};
+
+// Timestamp bookkeeping shared by both stream kinds: span, per-second counts and gaps.
+// Calls are serialized by an internal mutex; writers call it once per frame or event chunk.
+class StreamStatistics {
+public:
+    static constexpr double GAP_FACTOR = 1.5;
+    static constexpr int64_t EVENT_GAP_US = 50'000;
+
+    void reset();
+    // Frame streams, timestamps in microseconds of any monotonic clock
+    void addFrame(int64_t timestampUs, uint64_t bytes = 0);
+    void addDroppedFrames(uint64_t frames = 1);
+    // Event streams: one call per chunk in timestamp order; Event has t (us) and p (0/1)
+    template <typename Event>
+    void addEvents(const Event* begin, const Event* end);
+    // A chunk whose events could not be looked at (RAW statistics backlog full): only its count
+    // and time span are added, the polarity split is scaled to the total and silences inside
+    // it are not seen
+    void addEventChunk(uint64_t count, int64_t firstUs, int64_t lastUs);
+    void addTriggers(uint64_t count);
+    // Size of the stream's file, once it is closed
+    void setBytes(uint64_t bytes);
+
+    StreamSummary summary(const std::string& stream, bool events) const;
+
+private:
+    // Called with m_mutex held for each frame or chunk (count items at timestampUs)
+    void advance(int64_t timestampUs, uint64_t count);
+
+    mutable std::mutex m_mutex;
+    bool m_started{false};
+    uint64_t m_items{0}; // frames or events
+    uint64_t m_on{0};
+    uint64_t m_off{0};
+    uint64_t m_triggers{0};
+    uint64_t m_dropped{0};
+    uint64_t m_bytes{0};
+    int64_t m_firstUs{0};
+    int64_t m_lastUs{0};
+    // Whole-second windows from the first timestamp
+    int64_t m_windowStartUs{0};
+    uint64_t m_windowCount{0};
+    uint64_t m_windows{0};
+    uint64_t m_windowMin{0};
+    uint64_t m_windowMax{0};
+    uint64_t m_gaps{0};
+    int64_t m_maxGapUs{0};
+    uint64_t m_countedOnly{0}; // events added by addEventChunk
+};
+
+template <typename Event>
+void StreamStatistics::addEvents(const Event* begin, const Event* end) {
+    if (begin == end) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t on = 0;
+    int64_t previous = m_started ? m_lastUs : static_cast<int64_t>(begin->t);
+    for (const Event* ev = begin; ev != end; ++ev) {
+        on += ev->p != 0;
+        const int64_t silence = static_cast<int64_t>(ev->t) - previous;
+        if (silence > EVENT_GAP_US) {
+            ++m_gaps;
+            if (silence > m_maxGapUs) m_maxGapUs = silence;
+        }
+        previous = ev->t;
+    }
+    const uint64_t count = static_cast<uint64_t>(end - begin);
+    m_on += on;
+    m_off += count - on;
+    // Per-second windows are advanced per chunk; chunks span well under a second
+    advance(begin->t, 0);
+    advance((end - 1)->t, count);
+}
+
+class RecordingSummary {
+public:
+    static constexpr const char* FILE_NAME = "recording_summary.txt";
+
+    RecordingSummary(double durationSeconds, std::vector<StreamSummary> streams)
+        : m_durationSeconds(durationSeconds), m_streams(std::move(streams)) {}
+
+    const std::vector<StreamSummary>& streams() const { return m_streams; }
+    std::string format() const;
+    bool save(const std::filesystem::path& directory) const;
+
+private:
+    double m_durationSeconds;
+    std::vector<StreamSummary> m_streams;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+// Plain-text description of a recording session ("session_manifest.txt", one key=value per
+// line). Tools and the loader use it to find out where a session's streams live and whether
+// post-processing (migration, transcoding) has finished. Saving is atomic: the file is
+// written to a temporary name, fsync'ed and renamed over the previous version, so readers
+// only ever see a complete manifest.
+class SessionManifest {
+public:
+    static constexpr const char* FILE_NAME = "session_manifest.txt";
+
+    // Well-known keys
+    static constexpr const char* KEY_STATE = "session.state";          // recording|transcoding|captured|migrating|complete|failed
+    static constexpr const char* KEY_CAPTURE_DIR = "session.capture_dir";
+    static constexpr const char* KEY_FINAL_DIR = "session.final_dir";
+    // "stream.<name>.dir": directory holding a stream's files when it is not the take directory
+    static std::string streamKey(const std::string& stream) { return "stream." + stream + ".dir"; }
+
+    void set(const std::string& key, const std::string& value) { m_entries[key] = value; }
+    std::string get(const std::string& key, const std::string& fallback = "") const;
+    bool has(const std::string& key) const { return m_entries.count(key) > 0; }
+    void erase(const std::string& key) { m_entries.erase(key); }
+    // All keys starting with prefix (e.g. "file.")
+    std::vector<std::string> keysWithPrefix(const std::string& prefix) const;
+    const std::map<std::string, std::string>& entries() const { return m_entries; }
+    // Where a stream's files live: its recorded directory, or takeDirectory if none is recorded
+    std::filesystem::path streamDirectory(const std::string& stream, const std::filesystem::path& takeDirectory) const;
+
+    bool save(const std::filesystem::path& directory) const;
+    bool load(const std::filesystem::path& directory);
+    static bool exists(const std::filesystem::path& directory);
+
+private:
+    std::map<std::string, std::string> m_entries; // sorted for stable, diffable files
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "shm_stream_protocol.h"
+
+// Single-writer side of the shared-memory live stream ring (see shm_stream_protocol.h).
+// publish() copies one record into the next slot and returns immediately; it never waits
+// for readers, slow readers simply observe lost records.
+class ShmStreamExporter {
+public:
+    struct Options {
+        std::string name = "/ebv_live";   // POSIX shm object name
+        uint32_t slotCount = 16;
+        size_t slotBytes = 32u << 20;     // per slot including header; must hold the largest frame
+    };
+
+    explicit ShmStreamExporter(Options options);
+    ~ShmStreamExporter();
+
+    ShmStreamExporter(const ShmStreamExporter&) = delete;
+    ShmStreamExporter& operator=(const ShmStreamExporter&) = delete;
+
+    // Create and map the segment; a leftover segment is replaced only if its writer process
+    // is gone (false while another live recorder owns the name)
+    bool open();
+    void close();  // unmap and unlink
+    bool isOpen() const { return m_base != nullptr; }
+
+    bool publishFrame(int cameraId, uint64_t index, int64_t timestampUs,
+                      uint32_t width, uint32_t height, int32_t pixelType,
+                      const void* data, size_t bytes);
+    bool publishEvents(int cameraId, uint64_t index, int64_t firstTimestampUs,
+                       const void* events, uint32_t eventCount, size_t bytes);
+
+    uint64_t publishedCount() const { return m_published.load(std::memory_order_relaxed); }
+    uint64_t rejectedCount() const { return m_rejected.load(std::memory_order_relaxed); }
+    size_t maxPayloadBytes() const { return m_options.slotBytes - ebv_shm::kSlotHeaderBytes; }
+    const std::string& name() const { return m_options.name; }
+
+private:
+    static bool ownerAlive(const std::string& name);
+    bool publish(ebv_shm::RecordType type, int cameraId, uint64_t index, int64_t timestampUs,
+                 uint32_t width, uint32_t height, int32_t pixelType, uint32_t eventCount,
+                 const void* payload, size_t bytes);
+
+    Options m_options;
+    int m_fd{-1};
+    void* m_base{nullptr};
+    size_t m_mappedBytes{0};
+    uint64_t m_nextSequence{1};
+    std::atomic<uint64_t> m_published{0};
+    std::atomic<uint64_t> m_rejected{0};
+};
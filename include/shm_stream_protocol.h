@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Shared-memory live stream ring layout (version 1).
+//
+// The segment is a POSIX shared-memory object (shm_open name, e.g. "/ebv_live") laid out as
+//
+//   [RingHeader (64 bytes)] [slot 0] [slot 1] ... [slot slotCount-1]
+//   slot = [SlotHeader (64 bytes)] [payload (slotBytes - 64 bytes)]
+//
+// All integers are little-endian and naturally aligned, so the layout can be mapped from
+// Python (numpy/mmap) as well. The single writer never waits for readers:
+//   1. slot.sequence = 0                      (slot is being rewritten)
+//   2. header fields + payload are written
+//   3. slot.sequence = n                      (n = 1-based record sequence number)
+//   4. ring.writeSequence = n
+// Record n lives in slot (n - 1) % slotCount. A reader that wants record n checks
+// slot.sequence == n before and after consuming the payload (seqlock); if it changed the
+// record was overwritten and must be discarded. Readers that fall more than slotCount
+// records behind skip ahead and account the skipped records as lost.
+
+namespace ebv_shm {
+
+constexpr uint32_t kRingMagic = 0x53564245; // "EBVS"
+constexpr uint32_t kRingVersion = 1;
+constexpr size_t kRingHeaderBytes = 64;
+constexpr size_t kSlotHeaderBytes = 64;
+
+enum class RecordType : uint32_t {
+    Frame = 1,      // payload: height rows of width * channels bytes (pixelType = OpenCV type code)
+    EventChunk = 2  // payload: eventCount Metavision::EventCD records, 16 bytes each (x u16 @0, y u16 @2, p i16 @4, t i64 @8)
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free, "shared-memory ring needs lock-free 64-bit atomics");
+
+struct alignas(64) RingHeader {
+    std::atomic<uint32_t> magic;    // stored last (release); read first (acquire)
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t headerBytes;           // kRingHeaderBytes
+    uint64_t slotBytes;             // bytes per slot including the SlotHeader
+    std::atomic<uint64_t> writeSequence; // last published record (0 = none yet)
+    uint64_t writerPid;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(RingHeader) == kRingHeaderBytes, "RingHeader layout changed");
+
+struct alignas(64) SlotHeader {
+    std::atomic<uint64_t> sequence; // 0 while being written, otherwise the record sequence number
+    uint32_t type;                  // RecordType
+    int32_t cameraId;
+    uint64_t index;                 // frame index or chunk counter of the source stream
+    int64_t timestampUs;            // frame: steady clock us; events: first event timestamp
+    uint32_t width;
+    uint32_t height;
+    int32_t pixelType;
+    uint32_t eventCount;
+    uint64_t payloadBytes;
+    uint8_t reserved[8];
+};
+static_assert(sizeof(SlotHeader) == kSlotHeaderBytes, "SlotHeader layout changed");
+
+} // namespace ebv_shm
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "shm_stream_protocol.h"
+
+// Minimal reader for the shared-memory live stream ring (see shm_stream_protocol.h).
+// Depends only on POSIX, so external analysis tools can link it without OpenCV/Metavision.
+//
+//   ShmStreamReader reader;
+//   reader.open("/ebv_live");
+//   ShmStreamReader::Record record;
+//   while (reader.next(record, std::chrono::milliseconds(100))) {
+//       process(record.payload, record.payloadBytes);   // zero-copy view into shared memory
+//       if (!reader.stillValid(record)) { /* overwritten while processing, discard */ }
+//   }
+class ShmStreamReader {
+public:
+    struct Record {
+        uint64_t sequence{0};
+        ebv_shm::RecordType type{ebv_shm::RecordType::Frame};
+        int cameraId{0};
+        uint64_t index{0};
+        int64_t timestampUs{0};
+        uint32_t width{0};
+        uint32_t height{0};
+        int32_t pixelType{0};
+        uint32_t eventCount{0};
+        const uint8_t* payload{nullptr}; // points into the mapped segment
+        size_t payloadBytes{0};
+    };
+
+    ShmStreamReader() = default;
+    ~ShmStreamReader();
+
+    ShmStreamReader(const ShmStreamReader&) = delete;
+    ShmStreamReader& operator=(const ShmStreamReader&) = delete;
+
+    // Map an existing segment read-only. Starts at the newest record unless fromOldest is set.
+    bool open(const std::string& name, bool fromOldest = false);
+    void close();
+    bool isOpen() const { return m_base != nullptr; }
+
+    // Non-blocking: fetch the next record if one is available
+    bool tryNext(Record& record);
+    // Poll until a record is available or the timeout expires
+    bool next(Record& record, std::chrono::milliseconds timeout);
+    // True if the record's slot has not been overwritten since it was returned
+    bool stillValid(const Record& record) const;
+
+    uint64_t lostCount() const { return m_lost; }
+    uint64_t readCount() const { return m_read; }
+    uint32_t slotCount() const { return m_slotCount; }
+
+private:
+    const ebv_shm::SlotHeader* slotFor(uint64_t sequence) const;
+
+    int m_fd{-1};
+    const uint8_t* m_base{nullptr};
+    size_t m_mappedBytes{0};
+    uint32_t m_slotCount{0};
+    uint64_t m_slotBytes{0};
+    uint64_t m_nextSequence{1};
+    uint64_t m_lost{0};
+    uint64_t m_read{0};
+};
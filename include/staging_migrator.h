@@ -0,0 +1,57 @@
+#pragma once
+
+#include "background_job_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Moves completed takes from a fast staging location (tmpfs / NVMe scratch) to their final
+// destination on a background thread. Files are copied with large sequential reads/writes,
+// optionally throttled so archival I/O does not starve a running capture, flushed with a
+// single syncfs() per take and only then renamed into place. The session manifest in the
+// destination is updated atomically (migrating -> complete); the staging copy is removed only
+// after every copied size matched and the destination directories were fsynced.
+class StagingMigrator {
+public:
+    struct Job {
+        std::filesystem::path stagingDir;
+        std::filesystem::path finalDir;
+    };
+    using CompletionCallback = BackgroundJobQueue<Job>::CompletionCallback;
+
+    static constexpr size_t COPY_BLOCK_SIZE = 8u << 20; // 8 MiB sequential I/O
+
+    explicit StagingMigrator(uint64_t bytesPerSecond = 0); // 0 = unthrottled
+    // The destructor finishes all queued jobs
+
+    StagingMigrator(const StagingMigrator&) = delete;
+    StagingMigrator& operator=(const StagingMigrator&) = delete;
+
+    void enqueue(Job job) { m_jobs.enqueue(std::move(job)); }
+    void setCompletionCallback(CompletionCallback callback) { m_jobs.setCompletionCallback(std::move(callback)); }
+    void setBytesPerSecond(uint64_t bytesPerSecond) { m_bytesPerSecond = bytesPerSecond; }
+
+    // Block until every queued job has finished
+    void waitIdle() { m_jobs.waitIdle(); }
+    size_t pendingJobs() const { return m_jobs.pendingJobs(); }
+    uint64_t bytesMigrated() const { return m_bytesMigrated.load(); }
+
+private:
+    bool migrate(const Job& job, std::string& message);
+    bool copyFile(const std::filesystem::path& source, const std::filesystem::path& destination,
+                  std::vector<char>& buffer);
+    void throttle(size_t bytes);
+
+    std::atomic<uint64_t> m_bytesPerSecond;
+    std::atomic<uint64_t> m_bytesMigrated{0};
+
+    // Token bucket for throttling
+    std::chrono::steady_clock::time_point m_throttleStart;
+    uint64_t m_throttleBytes{0};
+
+    BackgroundJobQueue<Job> m_jobs; // last: its worker uses the members above
+};
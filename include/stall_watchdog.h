@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Detects workers that are stuck inside a blocking call (WaitForFinishedBuffer, a disk
+// write, an SDK event callback, ...). Every long-running worker registers a stage and
+// brackets its blocking calls with begin()/end(); a watchdog thread reports a stall when a
+// call stays open longer than the stage's threshold, and again with the total duration
+// once it returns. Waiting for work (an empty queue) is not bracketed and never a stall.
+class StallWatchdog {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct StallEvent {
+        std::string stage;      // e.g. "frame_writer", "event_callback0"
+        std::string operation;  // call that blocked, e.g. "imwrite"
+        std::string detail;     // e.g. the directory / disk written to
+        Clock::time_point started;
+        std::chrono::milliseconds duration{0};
+        bool ongoing{true};     // false once the call returned (duration is final)
+    };
+    using StallCallback = std::function<void(const StallEvent& event)>;
+
+    // Heartbeat of one worker; begin()/end() are lock-free and cheap enough for per-event-batch use
+    class Heartbeat {
+    public:
+        explicit Heartbeat(std::string stage, std::chrono::milliseconds threshold)
+            : m_stage(std::move(stage)), m_threshold(threshold) {}
+
+        // operation must be a string literal (it is read by the watchdog thread)
+        void begin(const char* operation = nullptr) {
+            m_operation.store(operation, std::memory_order_relaxed);
+            m_busySince.store(nowNs(), std::memory_order_release);
+        }
+        void end() {
+            m_lastEnd.store(nowNs(), std::memory_order_relaxed);
+            m_busySince.store(0, std::memory_order_release);
+            m_progress.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Where the worker is working (e.g. output directory); takes a lock, set it on change only
+        void setDetail(const std::string& detail) {
+            std::lock_guard<std::mutex> lock(m_detailMutex);
+            m_detail = detail;
+        }
+
+        // Brackets one blocking call
+        class Scope {
+        public:
+            Scope(Heartbeat* heartbeat, const char* operation) : m_heartbeat(heartbeat) {
+                if (m_heartbeat) m_heartbeat->begin(operation);
+            }
+            ~Scope() {
+                if (m_heartbeat) m_heartbeat->end();
+            }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            Heartbeat* m_heartbeat;
+        };
+
+        const std::string& stage() const { return m_stage; }
+        std::chrono::milliseconds threshold() const { return m_threshold; }
+        uint64_t progress() const { return m_progress.load(std::memory_order_relaxed); }
+
+    private:
+        friend class StallWatchdog;
+
+        static int64_t nowNs() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+        }
+        std::string detail() const {
+            std::lock_guard<std::mutex> lock(m_detailMutex);
+            return m_detail;
+        }
+
+        const std::string m_stage;
+        const std::chrono::milliseconds m_threshold;
+        std::atomic<int64_t> m_busySince{0}; // 0 = not inside a blocking call
+        std::atomic<int64_t> m_lastEnd{0};
+        std::atomic<const char*> m_operation{nullptr};
+        std::atomic<uint64_t> m_progress{0};
+        mutable std::mutex m_detailMutex;
+        std::string m_detail;
+    };
+    using HeartbeatPtr = std::shared_ptr<Heartbeat>;
+
+    explicit StallWatchdog(std::chrono::milliseconds checkInterval = std::chrono::milliseconds(100));
+    ~StallWatchdog();
+
+    StallWatchdog(const StallWatchdog&) = delete;
+    StallWatchdog& operator=(const StallWatchdog&) = delete;
+
+    // The stage is watched for as long as the returned heartbeat is alive
+    HeartbeatPtr registerStage(const std::string& stage, std::chrono::milliseconds threshold);
+    void setStallCallback(StallCallback callback);
+
+    void start();
+    void stop();
+    // One check pass (called by the watchdog thread; public for tests)
+    void check(Clock::time_point now = Clock::now());
+
+    // Finished stalls that started at or after since, oldest first (bounded history)
+    std::vector<StallEvent> stallsSince(Clock::time_point since) const;
+    size_t stallCount() const;
+
+private:
+    struct Watched {
+        std::string stage;
+        std::weak_ptr<Heartbeat> heartbeat;
+        int64_t reportedBusySince{0}; // call already reported as stalled
+        std::string operation;
+        std::string detail;
+    };
+
+    void watchLoop();
+
+    const std::chrono::milliseconds m_checkInterval;
+    mutable std::mutex m_mutex;
+    std::vector<Watched> m_watched;
+    std::vector<StallEvent> m_history;
+    size_t m_stallCount{0};
+    StallCallback m_callback;
+
+    std::thread m_thread;
+    std::mutex m_threadMutex;
+    std::condition_variable m_threadCv;
+    bool m_running{false};
+
+    static constexpr size_t MAX_HISTORY = 256;
+};
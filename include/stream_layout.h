@@ -0,0 +1,32 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+// Decides where each stream of a take is written so that the frame and event writers can be
+// spread over several physical disks. A stream is one camera's output: "frame_cam<i>" (a
+// directory of images) or "ebv_cam_<i>" (one event file). Every stream is placed in
+// <root>/<take name>, so a striped take is a set of equally named directories on each disk.
+class StreamLayout {
+public:
+    static std::string frameStreamName(size_t cameraIndex) { return "frame_cam" + std::to_string(cameraIndex); }
+    static std::string eventStreamName(size_t cameraIndex) { return "ebv_cam_" + std::to_string(cameraIndex); }
+
+    // Stream names of a rig, interleaved (frame_cam0, ebv_cam_0, frame_cam1, ...) so that
+    // round-robin placement puts each camera's frame and event writers on different disks
+    static std::vector<std::string> streamNames(size_t frameCameras, size_t eventCameras);
+
+    // Directory for every stream. Explicit per-stream roots win; the remaining streams are
+    // distributed round-robin over roots; without roots everything stays in takeDirectory.
+    static std::map<std::string, std::filesystem::path> assign(
+        const std::vector<std::string>& streams,
+        const std::filesystem::path& takeDirectory,
+        const std::vector<std::string>& roots,
+        const std::map<std::string, std::string>& streamRoots = {});
+
+    // Per-camera directories for one stream kind (index i = camera i), for the writers
+    static std::vector<std::string> frameDirectories(const std::map<std::string, std::filesystem::path>& layout, size_t cameras);
+    static std::vector<std::string> eventDirectories(const std::map<std::string, std::filesystem::path>& layout, size_t cameras);
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QWidget>
+#include <QImage>
+#include <QVector>
+#include <QString>
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+class RecordingLoader;
+
+// Strip of small frame-camera and event previews at regular intervals above the timeline
+// slider. One background worker per row fills the slots coarse-to-fine (every 8th slot
+// first, then the gaps), so a usable overview appears quickly on long recordings.
+// Thumbnails are cached as JPEGs next to the render cache and reused on the next open.
+class TimelineThumbnailStrip : public QWidget {
+    Q_OBJECT
+
+public:
+    static constexpr int THUMB_WIDTH = 80;
+    static constexpr int ROW_HEIGHT = 45;
+
+    explicit TimelineThumbnailStrip(QWidget *parent = nullptr);
+    ~TimelineThumbnailStrip() override;
+
+    // Start generating for a loaded recording; the loader must stay valid until clear()
+    void setRecording(RecordingLoader *loader, const QString &recordingDir, size_t totalFrames);
+    // Cancel generation and drop all thumbnails (blocks until the workers have stopped)
+    void clear();
+    void setCurrentFrame(size_t frameIndex);
+
+    // Slot order in which thumbnails are generated: 0, 8, 16, ..., 4, 12, ..., 2, 6, ...
+    static std::vector<size_t> progressiveOrder(size_t slotCount);
+
+signals:
+    void frameRequested(int frameIndex);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    enum Row { FrameRow = 0, EventRow = 1, RowCount = 2 };
+
+    void workerMain(Row row, unsigned generation);
+    QImage renderThumbnail(Row row, size_t frameIndex) const;
+    size_t frameForSlot(size_t slot) const;
+    std::filesystem::path cacheDirectoryFor(const QString &recordingDir) const;
+
+    RecordingLoader *m_loader{nullptr};
+    size_t m_totalFrames{0};
+    size_t m_slotCount{0};
+    size_t m_currentFrame{0};
+    std::filesystem::path m_cacheDir; // empty = no disk cache
+    QVector<QImage> m_thumbnails[RowCount];
+
+    std::vector<std::thread> m_workers;
+    std::atomic<bool> m_cancel{false};
+    // Bumped on every clear(): results of an older generation are discarded
+    std::atomic<unsigned> m_generation{0};
+};
@@ -0,0 +1,327 @@
+#include "control_socket.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace ControlProtocol {
+
+namespace {
+bool needsEscape(unsigned char c) {
+    return c <= 0x20 || c == 0x7f || c == '%' || c == '=';
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Split on single spaces, skipping empty tokens
+std::vector<std::string> tokens(const std::string& line) {
+    std::vector<std::string> result;
+    size_t pos = 0;
+    while (pos < line.size()) {
+        const size_t end = line.find(' ', pos);
+        const size_t stop = end == std::string::npos ? line.size() : end;
+        if (stop > pos) result.push_back(line.substr(pos, stop - pos));
+        pos = stop + 1;
+    }
+    return result;
+}
+
+std::string stripLineEnd(const std::string& line) {
+    size_t end = line.size();
+    while (end > 0 && (line[end - 1] == '\n' || line[end - 1] == '\r')) --end;
+    return line.substr(0, end);
+}
+
+void parseArguments(const std::vector<std::string>& parts, size_t first, std::map<std::string, std::string>& args) {
+    for (size_t i = first; i < parts.size(); ++i) {
+        const auto eq = parts[i].find('=');
+        if (eq == std::string::npos || eq == 0) {
+            throw std::runtime_error("expected key=value, got '" + parts[i] + "'");
+        }
+        args[parts[i].substr(0, eq)] = decodeValue(parts[i].substr(eq + 1));
+    }
+}
+
+std::string formatArguments(const std::map<std::string, std::string>& args) {
+    std::string result;
+    for (const auto& [key, value] : args) {
+        result += ' ';
+        result += key;
+        result += '=';
+        result += encodeValue(value);
+    }
+    return result;
+}
+} // namespace
+
+std::string encodeValue(const std::string& value) {
+    std::string encoded;
+    encoded.reserve(value.size());
+    for (const char c : value) {
+        if (needsEscape(static_cast<unsigned char>(c))) {
+            char escape[4];
+            std::snprintf(escape, sizeof(escape), "%%%02X", static_cast<unsigned char>(c));
+            encoded += escape;
+        } else {
+            encoded += c;
+        }
+    }
+    return encoded;
+}
+
+std::string decodeValue(const std::string& value) {
+    std::string decoded;
+    decoded.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '%' && i + 2 < value.size() && hexValue(value[i + 1]) >= 0 && hexValue(value[i + 2]) >= 0) {
+            decoded += static_cast<char>(hexValue(value[i + 1]) * 16 + hexValue(value[i + 2]));
+            i += 2;
+        } else {
+            decoded += value[i];
+        }
+    }
+    return decoded;
+}
+
+std::string formatRequest(const Request& request) {
+    return request.command + formatArguments(request.args) + "\n";
+}
+
+Request parseRequest(const std::string& line) {
+    const auto parts = tokens(stripLineEnd(line));
+    if (parts.empty()) throw std::runtime_error("empty request");
+    Request request;
+    request.command = parts[0];
+    parseArguments(parts, 1, request.args);
+    return request;
+}
+
+std::string formatResponse(const Response& response) {
+    if (!response.ok) {
+        std::string message = response.error;
+        for (auto& c : message) {
+            if (c == '\n' || c == '\r') c = ' ';
+        }
+        return "error " + message + "\n";
+    }
+    return "ok" + formatArguments(response.fields) + "\n";
+}
+
+Response parseResponse(const std::string& line) {
+    const std::string stripped = stripLineEnd(line);
+    if (stripped.rfind("error", 0) == 0) {
+        return errorResponse(stripped.size() > 6 ? stripped.substr(6) : std::string("unknown error"));
+    }
+    const auto parts = tokens(stripped);
+    if (parts.empty() || parts[0] != "ok") {
+        return errorResponse("malformed response '" + stripped + "'");
+    }
+    Response response = okResponse();
+    try {
+        parseArguments(parts, 1, response.fields);
+    } catch (const std::exception& e) {
+        return errorResponse(std::string("malformed response: ") + e.what());
+    }
+    return response;
+}
+
+} // namespace ControlProtocol
+
+namespace {
+constexpr size_t MAX_LINE_BYTES = 64 * 1024;
+
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid control socket path '" + path + "'");
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+} // namespace
+
+ControlServer::ControlServer(std::string socketPath, Handler handler, std::chrono::milliseconds idleTimeout)
+    : m_socketPath(std::move(socketPath)), m_handler(std::move(handler)), m_idleTimeout(idleTimeout) {}
+
+ControlServer::~ControlServer() {
+    stop();
+}
+
+void ControlServer::start() {
+    if (m_running) return;
+    const sockaddr_un address = socketAddress(m_socketPath);
+
+    struct stat st{};
+    if (::stat(m_socketPath.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            throw std::runtime_error("Control socket path exists and is not a socket: " + m_socketPath);
+        }
+        // Refuse to steal the socket of a running daemon; a stale one is replaced
+        const int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const bool alive = probe >= 0 && ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        if (probe >= 0) ::close(probe);
+        if (alive) throw std::runtime_error("Another recorder is already listening on " + m_socketPath);
+        ::unlink(m_socketPath.c_str());
+    }
+
+    m_listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0) {
+        throw std::runtime_error("Failed to create control socket: " + std::string(std::strerror(errno)));
+    }
+    if (::bind(m_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(m_listenFd, 8) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        throw std::runtime_error("Failed to listen on " + m_socketPath + ": " + error);
+    }
+    if (::pipe2(m_wakeFd, O_CLOEXEC) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        ::unlink(m_socketPath.c_str());
+        throw std::runtime_error("Failed to create control wake pipe: " + error);
+    }
+
+    m_running = true;
+    m_thread = std::thread(&ControlServer::serveLoop, this);
+}
+
+void ControlServer::stop() {
+    if (!m_running.exchange(false)) return;
+    const char wake = 1;
+    (void)!::write(m_wakeFd[1], &wake, 1);
+    if (m_thread.joinable()) m_thread.join();
+    ::close(m_listenFd);
+    ::close(m_wakeFd[0]);
+    ::close(m_wakeFd[1]);
+    m_listenFd = m_wakeFd[0] = m_wakeFd[1] = -1;
+    ::unlink(m_socketPath.c_str());
+}
+
+void ControlServer::serveLoop() {
+    while (m_running) {
+        pollfd fds[2] = {{m_listenFd, POLLIN, 0}, {m_wakeFd[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) break;
+        if (!(fds[0].revents & POLLIN)) continue;
+        const int clientFd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (clientFd < 0) continue;
+        serveClient(clientFd);
+        ::close(clientFd);
+    }
+}
+
+void ControlServer::serveClient(int clientFd) {
+    std::string buffer;
+    char chunk[4096];
+    // Only complete lines count as activity; the handler's own run time does not
+    auto deadline = std::chrono::steady_clock::now() + m_idleTimeout;
+    while (m_running) {
+        size_t newline;
+        while ((newline = buffer.find('\n')) != std::string::npos) {
+            const std::string line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            ControlProtocol::Response response;
+            try {
+                response = m_handler(ControlProtocol::parseRequest(line));
+            } catch (const std::exception& e) {
+                response = ControlProtocol::errorResponse(e.what());
+            }
+            if (!sendAll(clientFd, ControlProtocol::formatResponse(response))) return;
+            deadline = std::chrono::steady_clock::now() + m_idleTimeout;
+        }
+        if (buffer.size() > MAX_LINE_BYTES) {
+            sendAll(clientFd, ControlProtocol::formatResponse(ControlProtocol::errorResponse("request too long")));
+            return;
+        }
+
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        pollfd fds[2] = {{clientFd, POLLIN, 0}, {m_wakeFd[0], POLLIN, 0}};
+        const int ready = remaining.count() > 0 ? ::poll(fds, 2, static_cast<int>(remaining.count())) : 0;
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (ready == 0) {
+            sendAll(clientFd, ControlProtocol::formatResponse(ControlProtocol::errorResponse("idle timeout")));
+            return;
+        }
+        if (fds[1].revents) return;
+        const ssize_t n = ::recv(clientFd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return; // client closed the connection
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+}
+
+ControlProtocol::Response ControlClient::request(const std::string& socketPath, const ControlProtocol::Request& request,
+                                                 std::chrono::milliseconds timeout) {
+    const sockaddr_un address = socketAddress(socketPath);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create socket: " + std::string(std::strerror(errno)));
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Cannot reach recorder at " + socketPath + ": " + error);
+    }
+    if (!sendAll(fd, ControlProtocol::formatRequest(request))) {
+        ::close(fd);
+        throw std::runtime_error("Failed to send request to " + socketPath);
+    }
+
+    std::string buffer;
+    char chunk[4096];
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (buffer.find('\n') == std::string::npos) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        pollfd pfd{fd, POLLIN, 0};
+        const int ready = remaining.count() > 0 ? ::poll(&pfd, 1, static_cast<int>(remaining.count())) : 0;
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0) {
+            ::close(fd);
+            throw std::runtime_error("No response from recorder within " + std::to_string(timeout.count()) + " ms");
+        }
+        const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            ::close(fd);
+            throw std::runtime_error("Recorder closed the connection without a response");
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return ControlProtocol::parseResponse(buffer.substr(0, buffer.find('\n')));
+}
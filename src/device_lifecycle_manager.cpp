@@ -0,0 +1,74 @@
+#include "device_lifecycle_manager.h"
+#include "logger.h"
+
+DeviceLifecycleManager::DeviceLifecycleManager(RecordingManager& manager)
+    : m_manager(manager) {}
+
+DeviceLifecycleManager::State DeviceLifecycleManager::state() const {
+    if (!m_manager.isConfigured()) return State::Released;
+    if (m_manager.isRecording()) return State::Recording;
+    if (m_manager.isPreviewing()) return State::Streaming;
+    return State::Idle;
+}
+
+const char* DeviceLifecycleManager::stateName(State state) {
+    switch (state) {
+        case State::Released: return "released";
+        case State::Idle: return "idle";
+        case State::Streaming: return "streaming";
+        case State::Recording: return "recording";
+    }
+    return "unknown";
+}
+
+bool DeviceLifecycleManager::open(const RecordingManager::RecordingConfig& config) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+    m_hasConfig = true;
+    // configure() reuses open devices when the topology is unchanged
+    return m_manager.invokeOnControlThread([this, &config] { return m_manager.configure(config); });
+}
+
+bool DeviceLifecycleManager::ensureOpen() {
+    if (m_manager.isConfigured()) return true;
+    EBV_LOG_INFO << "Device lifecycle: devices released, opening...";
+    const auto config = m_hasConfig ? m_config : RecordingManager::RecordingConfig{};
+    return m_manager.invokeOnControlThread([this, &config] { return m_manager.configure(config); });
+}
+
+bool DeviceLifecycleManager::startStreaming() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!ensureOpen()) return false;
+    return m_manager.invokeOnControlThread([this] { return m_manager.startPreview(); });
+}
+
+bool DeviceLifecycleManager::startTake(const std::string& outputDirectory) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto start = std::chrono::steady_clock::now();
+    if (!ensureOpen()) return false;
+    if (!m_manager.invokeOnControlThread([this, &outputDirectory] { return m_manager.startRecording(outputDirectory); })) {
+        return false;
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_lastTimeToTakeMs = ms;
+    EBV_LOG_INFO << "Device lifecycle: take started after " << ms << " ms";
+    return true;
+}
+
+void DeviceLifecycleManager::stopTake() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_manager.invokeOnControlThread([this] { m_manager.stopRecording(); });
+}
+
+void DeviceLifecycleManager::goIdle() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_manager.invokeOnControlThread([this] { m_manager.enterIdle(); }); // no-op while a take is running
+}
+
+void DeviceLifecycleManager::release() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_manager.isConfigured()) return;
+    EBV_LOG_INFO << "Device lifecycle: releasing cameras";
+    m_manager.invokeOnControlThread([this] { m_manager.closeDevices(); });
+}
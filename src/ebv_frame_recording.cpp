@@ -7,7 +7,13 @@
 #include <string>
 #include <csignal>
 #include <atomic>
+#include <algorithm>
+#include <map>
 #include "recording_manager.h"
+#include "hdf5_benchmark.h"
+#include "control_socket.h"
+#include "profiled_mutex.h"
+#include "memory_accounting.h"
 #include <filesystem>
 #include "CLI11.hpp"
 
@@ -19,8 +25,182 @@ void signal_handler(int signum) {
     shutdown_flag = true;
 }
 
+// Sleep until Ctrl+C or the deadline; memory usage goes to the bus stats once per second
+void waitForShutdown(RecordingManager& recordingManager,
+                     std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max()) {
+    auto nextMemoryReport = std::chrono::steady_clock::now();
+    while (!shutdown_flag && std::chrono::steady_clock::now() < deadline) {
+        if (std::chrono::steady_clock::now() >= nextMemoryReport) {
+            recordingManager.publishMemoryUsage();
+            nextMemoryReport += std::chrono::seconds(1);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+// ./recording/[<prefix>_]<timestamp>
+std::string takeDirectory(const std::string& prefix) {
+    std::string outputDir = "./recording/";
+    if (!prefix.empty()) {
+        outputDir += prefix + "_";
+    }
+    const auto now = std::chrono::system_clock::now();
+    const auto time_t = std::chrono::system_clock::to_time_t(now);
+    const auto tm = *std::localtime(&time_t);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y%m%d_%H%M%S", &tm);
+    return outputDir + std::string(timestamp);
+}
+
+uint64_t directoryBytes(const std::filesystem::path& directory) {
+    uint64_t bytes = 0;
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file(ec)) bytes += it->file_size(ec);
+    }
+    return bytes;
+}
+
+int parseInt(const std::string& key, const std::string& value) {
+    try {
+        size_t used = 0;
+        const int parsed = std::stoi(value, &used);
+        if (used == value.size()) return parsed;
+    } catch (const std::exception&) {
+    }
+    throw std::runtime_error("Invalid integer for " + key + ": '" + value + "'");
+}
+
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    size_t pos = 0;
+    while (pos <= value.size()) {
+        const size_t comma = std::min(value.find(',', pos), value.size());
+        if (comma > pos) items.push_back(value.substr(pos, comma - pos));
+        pos = comma + 1;
+    }
+    return items;
+}
+
+// Apply "reconfigure" overrides on top of the daemon's current configuration
+void applyOverrides(RecordingManager::RecordingConfig& config, const std::map<std::string, std::string>& args) {
+    for (const auto& [key, value] : args) {
+        if (key == "format") {
+            if (value != "raw" && value != "hdf5") throw std::runtime_error("Invalid format '" + value + "'");
+            config.eventFileFormat = value;
+        } else if (key == "prefix") {
+            config.outputPrefix = value;
+        } else if (key == "hdf5_level") {
+            config.hdf5CompressionLevel = parseInt(key, value);
+        } else if (key == "hdf5_chunk") {
+            config.hdf5ChunkEvents = static_cast<size_t>(std::max(1, parseInt(key, value)));
+        } else if (key == "serials") {
+            config.eventCameraSerials = splitList(value);
+        } else if (key.rfind("bias_", 0) == 0) {
+            std::vector<int> values;
+            for (const auto& item : splitList(value)) values.push_back(parseInt(key, item));
+            config.biases[key] = values;
+        } else {
+            throw std::runtime_error("Unknown setting '" + key + "'");
+        }
+    }
+}
+
+// Keep the devices configured and record takes on request from the control socket until
+// SIGINT or a "shutdown" command; saves the device setup and warm-up of a process per take
+int runControlDaemon(const std::string& socketPath, RecordingManager::RecordingConfig config) {
+    RecordingManager recordingManager;
+    recordingManager.setShutdownFlag(&shutdown_flag);
+
+    const auto configured = recordingManager.submitConfigure(config).get();
+    if (!configured.success) {
+        std::cerr << "Failed to configure cameras: " << configured.message << std::endl;
+        return 1;
+    }
+
+    size_t takes = 0;
+    auto pending = [&recordingManager](std::map<std::string, std::string> fields) {
+        fields["pending_migrations"] = std::to_string(recordingManager.pendingMigrations());
+        fields["pending_transcodes"] = std::to_string(recordingManager.pendingTranscodes());
+        return fields;
+    };
+
+    ControlServer server(socketPath, [&](const ControlProtocol::Request& request) {
+        const std::string& command = request.command;
+        if (command == "start" || command == "next") {
+            auto dirArg = request.args.find("dir");
+            auto prefixArg = request.args.find("prefix");
+            const std::string outputDir = dirArg != request.args.end()
+                ? dirArg->second
+                : takeDirectory(prefixArg != request.args.end() ? prefixArg->second : config.outputPrefix);
+            // "next" closes a running take and continues into the new one without a gap
+            const auto result = command == "next" ? recordingManager.submitNextTake(outputDir).get()
+                                                  : recordingManager.submitRecord(outputDir).get();
+            if (!result.success) return ControlProtocol::errorResponse(result.message);
+            ++takes;
+            std::cout << "Take " << takes << " recording to " << result.directory << std::endl;
+            std::map<std::string, std::string> fields{{"dir", result.directory}, {"final", recordingManager.getFinalOutputDirectory()}};
+            if (!result.closedDirectory.empty()) fields["closed"] = result.closedDirectory;
+            return ControlProtocol::okResponse(fields);
+        }
+        if (command == "stop") {
+            const double duration = recordingManager.getRecordingDurationSeconds();
+            const std::string finalDir = recordingManager.getFinalOutputDirectory();
+            const auto result = recordingManager.submitStop().get();
+            if (!result.success) return ControlProtocol::errorResponse(result.message);
+            if (result.directory.empty()) return ControlProtocol::okResponse(pending({{"state", RecordingManager::stateName(result.state)}}));
+            // The take may already be on its way to the final directory
+            const std::string dir = std::filesystem::exists(result.directory) ? result.directory : finalDir;
+            std::cout << "Take stopped: " << dir << std::endl;
+            return ControlProtocol::okResponse(pending({{"dir", result.directory},
+                                                        {"final", finalDir},
+                                                        {"duration_s", std::to_string(duration)},
+                                                        {"bytes", std::to_string(directoryBytes(dir))}}));
+        }
+        if (command == "status") {
+            const auto state = recordingManager.state();
+            std::map<std::string, std::string> fields{{"state", RecordingManager::stateName(state)},
+                                                      {"takes", std::to_string(takes)},
+                                                      {"memory_bytes", std::to_string(MemoryAccounting::totalBytes())},
+                                                      {"resident_bytes", std::to_string(MemoryAccounting::residentBytes())}};
+            if (state == RecordingManager::State::Recording) {
+                fields["dir"] = recordingManager.getCurrentOutputDirectory();
+                fields["duration_s"] = std::to_string(recordingManager.getRecordingDurationSeconds());
+            }
+            return ControlProtocol::okResponse(pending(fields));
+        }
+        if (command == "reconfigure") {
+            auto next = config;
+            applyOverrides(next, request.args);
+            const auto result = recordingManager.submitConfigure(next).get();
+            if (!result.success) return ControlProtocol::errorResponse(result.message);
+            config = next;
+            return ControlProtocol::okResponse({{"state", RecordingManager::stateName(result.state)}});
+        }
+        if (command == "shutdown") {
+            shutdown_flag = true;
+            return ControlProtocol::okResponse();
+        }
+        return ControlProtocol::errorResponse("Unknown command '" + command + "' (start, next, stop, status, reconfigure, shutdown)");
+    });
+    server.start();
+    std::cout << "Recorder ready, listening on " << socketPath << std::endl;
+
+    waitForShutdown(recordingManager);
+    server.stop();
+
+    if (recordingManager.state() == RecordingManager::State::Recording) {
+        recordingManager.submitStop().get();
+    }
+    if (recordingManager.pendingTranscodes() > 0 || recordingManager.pendingMigrations() > 0) {
+        std::cout << "Waiting for post-processing of finished takes..." << std::endl;
+    }
+    return 0;
+}
+
 int main(int argc, char** argv) {
     signal(SIGINT, signal_handler); // Register signal handler for Ctrl+C
+    LockProfiling::installExitReport(); // lock contention report on exit (EBV_PROFILE_LOCKS builds)
 
     CLI::App app{"EBV and Frame Camera Recording System"};
     app.footer(
@@ -48,6 +228,45 @@ int main(int argc, char** argv) {
     app.add_option("--bias_hpf", biases["bias_hpf"], "bias_hpf values");
     app.add_option("--bias_refr", biases["bias_refr"], "bias_refr values");
 
+    std::string live_export_name = "";
+    app.add_option("--live-export", live_export_name, "Publish live frames and event chunks to this POSIX shared-memory name (e.g. /ebv_live) for external readers");
+
+    uint32_t live_export_slots = 16;
+    app.add_option("--live-export-slots", live_export_slots, "Number of slots in the shared-memory live export ring");
+
+    size_t live_export_slot_mib = 32;
+    app.add_option("--live-export-slot-mib", live_export_slot_mib, "Size of each live export slot in MiB (must hold one full frame)");
+
+    std::string staging_dir = "";
+    app.add_option("--staging-dir", staging_dir, "Capture into this fast directory (tmpfs / NVMe) and migrate each finished take to the output directory in the background");
+
+    double migration_mbps = 0.0;
+    app.add_option("--migration-mbps", migration_mbps, "Bandwidth limit for background migration in MiB/s (0 = unlimited)");
+
+    bool transcode_hdf5 = false;
+    app.add_flag("--transcode-hdf5", transcode_hdf5, "With --format raw: convert each finished take to compressed HDF5 in the background");
+
+    bool keep_raw = false;
+    app.add_flag("--keep-raw", keep_raw, "Keep the RAW event files after successful transcoding");
+
+    int hdf5_level = -1;
+    app.add_option("--hdf5-level", hdf5_level, "HDF5 compression: -1 = SDK default (ECF), 0..9 = deflate level of the tunable writer");
+
+    size_t hdf5_chunk = 16384;
+    app.add_option("--hdf5-chunk", hdf5_chunk, "Events per HDF5 chunk for the tunable writer");
+
+    std::string benchmark_raw = "";
+    app.add_option("--benchmark-hdf5", benchmark_raw, "Replay this reference RAW file through several HDF5 settings, print throughput/CPU/size and exit");
+
+    std::vector<std::string> output_roots;
+    app.add_option("--output-root", output_roots, "Stripe the camera streams round-robin over these directories (one per disk); the recording directory keeps the session manifest");
+
+    std::vector<std::string> stream_roots;
+    app.add_option("--stream-root", stream_roots, "Pin a stream to a directory, e.g. ebv_cam_0=/mnt/disk2 (streams: frame_cam<i>, ebv_cam_<i>)");
+
+    std::string control_socket = "";
+    app.add_option("--control-socket", control_socket, "Daemon mode: configure once and record takes on command from this Unix socket (see ebv_recorder_ctl)");
+
     CLI11_PARSE(app, argc, argv);
 
     // Validate event file format
@@ -57,6 +276,21 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    if (!benchmark_raw.empty()) {
+        try {
+            auto settings = Hdf5Benchmark::defaultSettings();
+            if (hdf5_level >= 0) {
+                settings.push_back({"selected", hdf5_level, hdf5_chunk});
+            }
+            const auto results = Hdf5Benchmark::run(benchmark_raw, settings, "./recording/.hdf5_benchmark");
+            Hdf5Benchmark::printReport(std::cout, results, std::filesystem::file_size(benchmark_raw));
+            return 0;
+        } catch (const std::exception& e) {
+            std::cerr << "HDF5 benchmark failed: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     std::cout << "Starting EBV and Frame Camera Recording System" << std::endl;
     std::cout << "Event data will be saved in " << event_file_format << " format" << std::endl;
 
@@ -68,6 +302,28 @@ int main(int argc, char** argv) {
         config.eventFileFormat = event_file_format;
         config.outputPrefix = output_prefix;
         config.recordingLengthSeconds = recording_length;
+        config.liveExportName = live_export_name;
+        config.liveExportSlots = live_export_slots;
+        config.liveExportSlotBytes = live_export_slot_mib << 20;
+        config.stagingDirectory = staging_dir;
+        config.migrationBytesPerSecond = static_cast<uint64_t>(migration_mbps * (1 << 20));
+        config.outputRoots = output_roots;
+        config.transcodeRawToHdf5 = transcode_hdf5;
+        config.hdf5CompressionLevel = hdf5_level;
+        config.hdf5ChunkEvents = hdf5_chunk;
+        config.keepRawAfterTranscode = keep_raw;
+        for (const auto& entry : stream_roots) {
+            const auto eq = entry.find('=');
+            if (eq == std::string::npos || eq == 0) {
+                std::cerr << "Error: Invalid --stream-root '" << entry << "', expected <stream>=<directory>" << std::endl;
+                return 1;
+            }
+            config.streamOutputRoots[entry.substr(0, eq)] = entry.substr(eq + 1);
+        }
+
+        if (!control_socket.empty()) {
+            return runControlDaemon(control_socket, config);
+        }
 
         // Initialize and configure recording manager
         RecordingManager recordingManager;
@@ -80,18 +336,7 @@ int main(int argc, char** argv) {
         }
 
         // Generate output directory and start recording
-        std::string outputDir = "./recording/";
-        if (!output_prefix.empty()) {
-            outputDir += output_prefix + "_";
-        }
-        
-        // Add timestamp
-        const auto now = std::chrono::system_clock::now();
-        const auto time_t = std::chrono::system_clock::to_time_t(now);
-        const auto tm = *std::localtime(&time_t);
-        char timestamp[32];
-        std::strftime(timestamp, sizeof(timestamp), "%Y%m%d_%H%M%S", &tm);
-        outputDir += std::string(timestamp);
+        const std::string outputDir = takeDirectory(output_prefix);
 
         // Start recording
         if (!recordingManager.startRecording(outputDir)) {
@@ -100,18 +345,19 @@ int main(int argc, char** argv) {
         }
 
         if (recording_length > 0) {
-            auto end_time = std::chrono::steady_clock::now() + std::chrono::seconds(recording_length);
-            while (std::chrono::steady_clock::now() < end_time && !shutdown_flag) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
+            waitForShutdown(recordingManager, std::chrono::steady_clock::now() + std::chrono::seconds(recording_length));
         } else {
-            while (!shutdown_flag) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
+            waitForShutdown(recordingManager);
         }
 
         // Stop recording
         recordingManager.stopRecording();
+        if (recordingManager.pendingTranscodes() > 0) {
+            std::cout << "Waiting for RAW to HDF5 transcoding to finish..." << std::endl;
+        }
+        if (recordingManager.pendingMigrations() > 0) {
+            std::cout << "Waiting for migration to " << recordingManager.getFinalOutputDirectory() << " to finish..." << std::endl;
+        }
 
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -0,0 +1,60 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "control_socket.h"
+#include "CLI11.hpp"
+
+// Client for the recorder daemon (ebv_frame_recording --control-socket PATH)
+int main(int argc, char** argv) {
+    CLI::App app{"Control a running EBV recorder daemon"};
+    app.footer(
+        "Commands:\n"
+        "  start [prefix=NAME] [dir=PATH]   start a take, prints its directory\n"
+        "  next [prefix=NAME] [dir=PATH]    close the take and continue into a new one without a gap\n"
+        "  stop                             stop the take, prints directory, duration and size\n"
+        "  status                           current state and take statistics\n"
+        "  reconfigure [format=raw|hdf5] [prefix=NAME] [hdf5_level=N] [hdf5_chunk=N]\n"
+        "              [serials=A,B] [bias_diff_on=V1,V2] ...\n"
+        "  shutdown                         stop any take and exit the daemon"
+    );
+
+    std::string socket_path = "/tmp/ebv_recorder.sock";
+    app.add_option("--socket", socket_path, "Control socket of the recorder daemon");
+
+    int timeout_s = 60;
+    app.add_option("--timeout", timeout_s, "Seconds to wait for the daemon to answer (stopping a take waits for its files to close)");
+
+    std::string command;
+    app.add_option("command", command, "start, next, stop, status, reconfigure or shutdown")->required();
+
+    std::vector<std::string> arguments;
+    app.add_option("args", arguments, "key=value arguments of the command");
+
+    CLI11_PARSE(app, argc, argv);
+
+    ControlProtocol::Request request;
+    request.command = command;
+    for (const auto& argument : arguments) {
+        const auto eq = argument.find('=');
+        if (eq == std::string::npos || eq == 0) {
+            std::cerr << "Error: Invalid argument '" << argument << "', expected key=value" << std::endl;
+            return 2;
+        }
+        request.args[argument.substr(0, eq)] = argument.substr(eq + 1);
+    }
+
+    try {
+        const auto response = ControlClient::request(socket_path, request, std::chrono::seconds(timeout_s));
+        if (!response.ok) {
+            std::cerr << "Error: " << response.error << std::endl;
+            return 1;
+        }
+        for (const auto& [key, value] : response.fields) {
+            std::cout << key << "=" << value << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
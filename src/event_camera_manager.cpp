@@ -1,9 +1,17 @@
 #include "event_camera_manager.h"
-#include <iostream>
+#include "live_data_bus.h"
+#include "hdf5_event_writer.h"
+#include "overload_controller.h"
+#include "stream_layout.h"
+#include "logger.h"
 #include <stdexcept>
 #include <filesystem>
 #include <algorithm>
+#include <deque>
+#include <condition_variable>
+#include <iterator>
 #include <metavision/sdk/stream/camera_exception.h>
+#include <metavision/sdk/stream/hdf5_event_file_writer.h>
 #include <metavision/hal/device/device_discovery.h>
 #include <opencv2/opencv.hpp>
 
@@ -23,6 +31,8 @@ EventCameraManager::~EventCameraManager() {
 void EventCameraManager::openAndSetupDevices(const std::vector<CameraConfig>& cameraConfigs) {
     try {
         m_cameras.clear();
+        m_cameraSerials.clear();
+        m_appliedBiases.clear();
 
         const bool auto_discovery = cameraConfigs.empty();
         std::vector<CameraConfig> configs = auto_discovery ? createAutoDiscoveryConfigs() : cameraConfigs;
@@ -36,10 +46,12 @@ void EventCameraManager::openAndSetupDevices(const std::vector<CameraConfig>& ca
             const auto& [serial, biases] = configs[i];
             const bool isMaster = (i == 0);
             
-            std::cout << "Opening " << (isMaster ? "master" : "slave") << " camera with serial: " << serial << std::endl;
+            EBV_LOG_INFO << "Opening " << (isMaster ? "master" : "slave") << " camera with serial: " << serial;
             auto camera = std::make_unique<Metavision::Camera>(Metavision::Camera::from_serial(serial));
             setupDevice(camera, isMaster, biases);
             m_cameras.push_back(std::move(camera));
+            m_cameraSerials.push_back(serial);
+            m_appliedBiases.push_back(clipBiasValues(biases));
         }
         
         // Initialize live streaming structures
@@ -47,13 +59,16 @@ void EventCameraManager::openAndSetupDevices(const std::vector<CameraConfig>& ca
         m_eventBufferMutexes.resize(m_cameras.size());
         m_eventFrameCounters.resize(m_cameras.size());
     m_startedForStreaming.assign(m_cameras.size(), false);
+        std::lock_guard<std::mutex> pipelinesLock(m_pipelinesMutex);
+        m_pipelines.clear();
         for (size_t i = 0; i < m_cameras.size(); ++i) {
-            m_eventBufferMutexes[i] = std::make_unique<std::mutex>();
+            m_eventBufferMutexes[i] = std::make_unique<ProfiledMutex>("event_live_buffer");
             m_eventFrameCounters[i] = 0;
+            m_pipelines.push_back(std::make_unique<CameraPipeline>());
         }
         
-        std::cout << "Successfully opened and configured " << m_cameras.size() 
-                  << " event cameras (1 master, " << (m_cameras.size() - 1) << " slaves)" << std::endl;
+        EBV_LOG_INFO << "Successfully opened and configured " << m_cameras.size() 
+                  << " event cameras (1 master, " << (m_cameras.size() - 1) << " slaves)";
 
     } catch (const Metavision::CameraException& e) {
         throw std::runtime_error("Failed to open event cameras: " + std::string(e.what()));
@@ -62,6 +77,37 @@ void EventCameraManager::openAndSetupDevices(const std::vector<CameraConfig>& ca
     }
 }
 
+void EventCameraManager::applyBiases(const std::vector<CameraConfig>& cameraConfigs) {
+    if (cameraConfigs.size() != m_cameras.size()) {
+        throw std::runtime_error("Bias update requires " + std::to_string(m_cameras.size()) +
+                                 " camera configs, got " + std::to_string(cameraConfigs.size()));
+    }
+    validateCameraConfigs(cameraConfigs);
+
+    for (size_t i = 0; i < cameraConfigs.size(); ++i) {
+        if (cameraConfigs[i].serial != m_cameraSerials[i]) {
+            throw std::runtime_error("Bias update for serial " + cameraConfigs[i].serial +
+                                     " does not match opened camera " + m_cameraSerials[i]);
+        }
+
+        // Only touch registers whose value actually changes
+        BiasConfig changed;
+        for (const auto& [name, value] : clipBiasValues(cameraConfigs[i].biases)) {
+            const auto it = m_appliedBiases[i].find(name);
+            if (it == m_appliedBiases[i].end() || it->second != value) {
+                changed[name] = value;
+            }
+        }
+        if (changed.empty()) continue;
+
+        EBV_LOG_INFO << "Updating " << changed.size() << " biases on camera " << i << ":";
+        setBiases(m_cameras[i], changed);
+        for (const auto& [name, value] : changed) {
+            m_appliedBiases[i][name] = value;
+        }
+    }
+}
+
 void EventCameraManager::setupDevice(std::unique_ptr<Metavision::Camera>& camera, bool isMaster, const BiasConfig& biases) {
     auto& sync = camera->get_facility<Metavision::I_CameraSynchronization>();
     
@@ -71,8 +117,8 @@ void EventCameraManager::setupDevice(std::unique_ptr<Metavision::Camera>& camera
     }
     
     const std::string cameraType = isMaster ? "Master" : "Slave";
-    std::cout << "Camera set to " << (isMaster ? "master" : "slave") << " mode" << std::endl;
-    std::cout << "\nSetting biases for " << cameraType << " camera:" << std::endl;
+    EBV_LOG_INFO << "Camera set to " << (isMaster ? "master" : "slave") << " mode";
+    EBV_LOG_INFO << "Setting biases for " << cameraType << " camera:";
     setBiases(camera, biases);
 }
 
@@ -81,17 +127,17 @@ std::vector<std::string> EventCameraManager::discoverAvailableCameras() {
     
     auto device_serials = Metavision::DeviceDiscovery::list();
     
-    std::cout << "Discovering available event cameras..." << std::endl;
-    std::cout << "DeviceDiscovery::list() returned " << device_serials.size() << " configurations" << std::endl;
+    EBV_LOG_INFO << "Discovering available event cameras...";
+    EBV_LOG_INFO << "DeviceDiscovery::list() returned " << device_serials.size() << " configurations";
     
     if (device_serials.empty()) {
-        std::cout << "No event cameras detected via DeviceDiscovery" << std::endl;
+        EBV_LOG_INFO << "No event cameras detected via DeviceDiscovery";
         return serialNumbers;
     }
 
     size_t idx = 0;
     for (const auto& serial : device_serials) {
-        std::cout << "Device config " << idx++ << ": " << serial << std::endl;
+        EBV_LOG_INFO << "Device config " << idx++ << ": " << serial;
         serialNumbers.push_back(serial);
     }
     
@@ -105,11 +151,11 @@ std::vector<EventCameraManager::CameraConfig> EventCameraManager::createAutoDisc
     }
     
     std::sort(serials.begin(), serials.end());
-    std::cout << "Auto-discovered " << serials.size() << " event cameras" << std::endl;
-    std::cout << "Master camera (lowest serial): " << serials[0] << std::endl;
-    std::cout << "WARNING: No serial numbers for the event cameras with corresponding biases were provided! "
+    EBV_LOG_INFO << "Auto-discovered " << serials.size() << " event cameras";
+    EBV_LOG_INFO << "Master camera (lowest serial): " << serials[0];
+    EBV_LOG_WARN << "No serial numbers for the event cameras with corresponding biases were provided! "
               << "Therefore auto device-discovery and default biases are used. Each event camera requires "
-              << "distinct manual selection of its biases, so this setup is discouraged!" << std::endl;
+              << "distinct manual selection of its biases, so this setup is discouraged!";
     
     std::vector<CameraConfig> configs;
     for (const auto& serial : serials) {
@@ -140,12 +186,275 @@ void EventCameraManager::setBiases(std::unique_ptr<Metavision::Camera>& camera,
         }
         
         if (!bias_facility.set(bias_name, bias_value)) {
-            std::cerr << "Warning: Failed to set bias " << bias_name << " to " << bias_value << std::endl;
+            EBV_LOG_WARN << "Failed to set bias " << bias_name << " to " << bias_value;
+        } else {
+            EBV_LOG_INFO << "  " << bias_name << " = " << bias_value;
+        }
+    }
+}
+
+// One lock for every HDF5 call in the process
+std::mutex& EventCameraManager::hdf5Mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// HDF5 file sink for one camera. Events are handed over on the SDK callback thread and
+// written on the sink's own thread so a slow disk never stalls decoding.
+class EventCameraManager::EventRecordingSink {
+public:
+    EventRecordingSink(const std::string& path, const Metavision::Camera& camera, const Hdf5Settings& settings,
+                       StallWatchdog::HeartbeatPtr heartbeat)
+        : m_path(path), m_heartbeat(std::move(heartbeat)) {
+        if (m_heartbeat) m_heartbeat->setDetail(path);
+        std::lock_guard<std::mutex> hdf5Lock(EventCameraManager::hdf5Mutex());
+        if (settings.compressionLevel < 0) {
+            m_sdkWriter = std::make_unique<Metavision::HDF5EventFileWriter>(path);
         } else {
-            std::cout << "  " << bias_name << " = " << bias_value << std::endl;
+            Hdf5EventWriter::Options options;
+            options.chunkEvents = settings.chunkEvents;
+            options.compressionLevel = settings.compressionLevel;
+            m_tunedWriter = std::make_unique<Hdf5EventWriter>(path, options);
+        }
+        try {
+            if (m_sdkWriter) {
+                m_sdkWriter->add_metadata_map_from_camera(camera);
+            } else {
+                m_tunedWriter->addMetadata("serial_number", camera.get_camera_configuration().serial_number);
+                m_tunedWriter->addMetadata("geometry", std::to_string(camera.geometry().get_width()) + "x" +
+                                                       std::to_string(camera.geometry().get_height()));
+            }
+        } catch (const std::exception& e) {
+            EBV_LOG_WARN << "could not copy camera metadata to " << path << ": " << e.what();
+        }
+        m_thread = std::thread(&EventRecordingSink::writerLoop, this);
+    }
+
+    ~EventRecordingSink() { finish(); }
+
+    // Boundaries are only changed while the owning pipeline mutex is held
+    void setStartTimestamp(Metavision::timestamp ts) { m_startTs = ts; }
+    void setStopTimestamp(Metavision::timestamp ts) { m_stopTs = ts; }
+
+    // Called on the SDK thread with the pipeline mutex held. Chunks come from a recycling
+    // arena and go back to it once written, so the steady state does not allocate.
+    template <typename Event>
+    void offer(const Event* begin, const Event* end, EventBufferArena<std::vector<Event>>& arena,
+               std::vector<typename EventBufferArena<std::vector<Event>>::Handle>& queue) {
+        auto selected = arena.acquire();
+        const size_t count = static_cast<size_t>(end - begin);
+        if (selected->capacity() < count) selected->reserve(count);
+        std::copy_if(begin, end, std::back_inserter(*selected),
+                     [this](const Event& ev) { return ev.t >= m_startTs && ev.t < m_stopTs; });
+        if (selected->empty()) return;
+        m_backlogEvents.fetch_add(selected->size(), std::memory_order_relaxed);
+        m_queueMemory.add(selected->size() * sizeof(Event));
+        {
+            std::lock_guard<ProfiledMutex> lock(m_queueMutex);
+            queue.push_back(std::move(selected));
+        }
+        m_queueCondition.notify_one();
+    }
+    void offerEvents(const Metavision::EventCD* begin, const Metavision::EventCD* end) { offer(begin, end, m_cdArena, m_cdQueue); }
+    void offerTriggers(const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end) { offer(begin, end, m_triggerArena, m_triggerQueue); }
+    // Events handed to the sink but not yet in the file
+    size_t backlogEvents() const { return m_backlogEvents.load(std::memory_order_relaxed); }
+
+    // Drain everything queued so far, then close the file
+    void finish() {
+        {
+            std::lock_guard<ProfiledMutex> lock(m_queueMutex);
+            if (m_closing) return;
+            m_closing = true;
+        }
+        m_queueCondition.notify_one();
+        if (m_thread.joinable()) m_thread.join();
+        if (m_tunedWriter) m_tunedWriter->encodeChunks(true);
+        std::lock_guard<std::mutex> hdf5Lock(EventCameraManager::hdf5Mutex());
+        if (m_sdkWriter) m_sdkWriter->close();
+        if (m_tunedWriter) m_tunedWriter->close();
+        std::error_code ec;
+        const auto bytes = std::filesystem::file_size(m_path, ec);
+        if (!ec) m_statistics.setBytes(bytes);
+        EBV_LOG_INFO << "Closed " << m_path << " (" << m_eventsWritten << " events, "
+                  << m_triggersWritten << " triggers)";
+    }
+
+    StreamSummary summary(const std::string& stream) const { return m_statistics.summary(stream, true); }
+
+private:
+    using CdChunk = EventBufferArena<std::vector<Metavision::EventCD>>::Handle;
+    using TriggerChunk = EventBufferArena<std::vector<Metavision::EventExtTrigger>>::Handle;
+
+    void writerLoop() {
+        // Swapped with the shared queues each round; both keep their capacity
+        std::vector<CdChunk> cd;
+        std::vector<TriggerChunk> triggers;
+        ProfiledUniqueLock lock(m_queueMutex);
+        while (true) {
+            m_queueCondition.wait(lock, [this] { return m_closing || !m_cdQueue.empty() || !m_triggerQueue.empty(); });
+            if (m_cdQueue.empty() && m_triggerQueue.empty()) {
+                if (m_closing) break;
+                continue;
+            }
+            cd.swap(m_cdQueue);
+            triggers.swap(m_triggerQueue);
+            lock.unlock();
+            if (m_tunedWriter) {
+                // Compress before taking the shared HDF5 lock, which then only covers storing
+                StallWatchdog::Heartbeat::Scope watched(m_heartbeat.get(), "hdf5 compress");
+                for (const auto& chunk : cd) m_tunedWriter->bufferCdEvents(chunk->data(), chunk->data() + chunk->size());
+                for (const auto& chunk : triggers) m_tunedWriter->bufferTriggerEvents(chunk->data(), chunk->data() + chunk->size());
+                m_tunedWriter->encodeChunks();
+            }
+            {
+                // Includes waiting for the HDF5 lock: a transcode holding it stalls this writer too
+                StallWatchdog::Heartbeat::Scope watched(m_heartbeat.get(), "hdf5 write");
+                std::lock_guard<std::mutex> hdf5Lock(EventCameraManager::hdf5Mutex());
+                if (m_sdkWriter) {
+                    for (const auto& chunk : cd) m_sdkWriter->add_events(chunk->data(), chunk->data() + chunk->size());
+                    for (const auto& chunk : triggers) m_sdkWriter->add_events(chunk->data(), chunk->data() + chunk->size());
+                } else {
+                    m_tunedWriter->writeEncodedChunks();
+                }
+            }
+            for (const auto& chunk : cd) m_eventsWritten += chunk->size();
+            for (const auto& chunk : triggers) m_triggersWritten += chunk->size();
+            size_t written = 0;
+            size_t writtenBytes = 0;
+            for (const auto& chunk : cd) {
+                m_statistics.addEvents(chunk->data(), chunk->data() + chunk->size());
+                written += chunk->size();
+                writtenBytes += chunk->size() * sizeof(Metavision::EventCD);
+            }
+            for (const auto& chunk : triggers) {
+                m_statistics.addTriggers(chunk->size());
+                written += chunk->size();
+                writtenBytes += chunk->size() * sizeof(Metavision::EventExtTrigger);
+            }
+            m_backlogEvents.fetch_sub(written, std::memory_order_relaxed);
+            m_queueMemory.release(writtenBytes, cd.size() + triggers.size());
+            cd.clear(); // returns the chunks to their arenas
+            triggers.clear();
+            lock.lock();
+        }
+    }
+
+    const std::string m_path;
+    const StallWatchdog::HeartbeatPtr m_heartbeat;
+    // SDK writer (ECF codec, default) or the tunable writer when a compression level is set
+    std::unique_ptr<Metavision::HDF5EventFileWriter> m_sdkWriter;
+    std::unique_ptr<Hdf5EventWriter> m_tunedWriter;
+    Metavision::timestamp m_startTs{std::numeric_limits<Metavision::timestamp>::max()};
+    Metavision::timestamp m_stopTs{std::numeric_limits<Metavision::timestamp>::max()};
+
+    EventBufferArena<std::vector<Metavision::EventCD>> m_cdArena;
+    EventBufferArena<std::vector<Metavision::EventExtTrigger>> m_triggerArena{8, 16};
+    ProfiledMutex m_queueMutex{"event_sink_queue"};
+    MemoryCounter m_queueMemory{"event_writer_queue"}; // events handed over but not yet written
+    ProfiledConditionVariable m_queueCondition;
+    std::vector<CdChunk> m_cdQueue;
+    std::vector<TriggerChunk> m_triggerQueue;
+    bool m_closing{false};
+    std::thread m_thread;
+    size_t m_eventsWritten{0};
+    size_t m_triggersWritten{0};
+    std::atomic<size_t> m_backlogEvents{0};
+    StreamStatistics m_statistics; // of what was written, summarized once the file is closed
+};
+
+// Statistics of a native RAW take. The SDK writes the file itself, so the CD callback hands a
+// copy of every chunk to this worker, which does the per-event work (polarities, silences).
+// The hand-off is bounded: past MAX_BACKLOG_EVENTS a chunk only adds its count and time span,
+// and the summary reports how many events were counted that way.
+class EventCameraManager::RawTakeStatistics {
+public:
+    RawTakeStatistics() : m_thread(&RawTakeStatistics::worker, this) {}
+    ~RawTakeStatistics() { finish(); }
+
+    // Called on the SDK thread with the pipeline mutex held
+    void offerEvents(const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+        const size_t count = static_cast<size_t>(end - begin);
+        Item item{nullptr, count, begin->t, (end - 1)->t};
+        if (m_backlogEvents.load(std::memory_order_relaxed) + count <= MAX_BACKLOG_EVENTS) {
+            item.events = m_arena.acquire();
+            item.events->assign(begin, end);
+            m_backlogEvents.fetch_add(count, std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<ProfiledMutex> lock(m_queueMutex);
+            m_queue.push_back(std::move(item));
+        }
+        m_queueCondition.notify_one();
+    }
+    void addTriggers(uint64_t count) { m_statistics.addTriggers(count); }
+
+    // Process everything handed over so far, then stop
+    void finish() {
+        {
+            std::lock_guard<ProfiledMutex> lock(m_queueMutex);
+            m_closing = true;
+        }
+        m_queueCondition.notify_one();
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    StreamSummary summary(const std::string& stream, uint64_t bytes) {
+        m_statistics.setBytes(bytes);
+        return m_statistics.summary(stream, true);
+    }
+
+private:
+    static constexpr size_t MAX_BACKLOG_EVENTS = 20'000'000; // ~320 MB of copies
+
+    using Chunk = EventBufferArena<std::vector<Metavision::EventCD>>::Handle;
+    struct Item {
+        Chunk events; // null: over the backlog limit, count and span only
+        size_t count;
+        Metavision::timestamp firstTs;
+        Metavision::timestamp lastTs;
+    };
+
+    void worker() {
+        std::deque<Item> items;
+        ProfiledUniqueLock lock(m_queueMutex);
+        while (true) {
+            m_queueCondition.wait(lock, [this] { return m_closing || !m_queue.empty(); });
+            if (m_queue.empty()) break; // closing and drained
+            items.swap(m_queue);
+            lock.unlock();
+            for (auto& item : items) {
+                if (item.events) {
+                    m_statistics.addEvents(item.events->data(), item.events->data() + item.events->size());
+                    m_backlogEvents.fetch_sub(item.count, std::memory_order_relaxed);
+                } else {
+                    m_statistics.addEventChunk(item.count, item.firstTs, item.lastTs);
+                }
+            }
+            items.clear(); // returns the copies to the arena
+            lock.lock();
         }
     }
+
+    StreamStatistics m_statistics;
+    EventBufferArena<std::vector<Metavision::EventCD>> m_arena;
+    ProfiledMutex m_queueMutex{"raw_statistics_queue"};
+    ProfiledConditionVariable m_queueCondition;
+    std::deque<Item> m_queue;
+    bool m_closing{false};
+    std::atomic<size_t> m_backlogEvents{0};
+    std::thread m_thread; // last: the worker uses the members above
+};
+
+namespace {
+// Lock every pipeline in index order so a boundary can be applied to all cameras atomically
+std::vector<std::unique_lock<ProfiledMutex>> lockAll(std::vector<ProfiledMutex*> mutexes) {
+    std::vector<std::unique_lock<ProfiledMutex>> locks;
+    locks.reserve(mutexes.size());
+    for (auto* mutex : mutexes) locks.emplace_back(*mutex);
+    return locks;
 }
+} // namespace
 
 void EventCameraManager::startRecording(const std::string& outputPath, const std::string& fileFormat) {
     if (m_cameras.empty()) {
@@ -156,35 +465,40 @@ void EventCameraManager::startRecording(const std::string& outputPath, const std
     if (fileFormat != "raw" && fileFormat != "hdf5") {
         throw std::runtime_error("Invalid file format: " + fileFormat + ". Supported formats are 'raw' and 'hdf5'");
     }
+    if (m_recording) {
+        throw std::runtime_error("Event camera recording already in progress");
+    }
 
     m_outputPath = outputPath;
     std::filesystem::create_directories(outputPath);
 
+    // Recording is a sink on the capture pipeline; bring the pipeline up if needed
+    if (!m_liveStreaming && !startLiveStreaming()) {
+        throw std::runtime_error("Failed to start event capture pipeline for recording");
+    }
+
     try {
-        // Start recording and cameras
-        for (size_t i = 0; i < m_cameras.size(); ++i) {
-            const std::string filename = outputPath + "/ebv_cam_" + std::to_string(i) + "." + fileFormat;
-            const std::string cameraType = (i == 0) ? "master" : "slave";
-            
-            if (!m_cameras[i]->start_recording(filename)) {
-                throw std::runtime_error("Failed to start recording for camera " + std::to_string(i));
-            }
-            std::cout << "Started recording " << cameraType << " camera " << i << " to: " << filename << std::endl;
-            
-            // If camera is already running (e.g., due to live preview), don't try to start again
-            if (!m_cameras[i]->is_running()) {
-                if (!m_cameras[i]->start()) {
-                    throw std::runtime_error("Failed to start camera " + std::to_string(i));
+        if (fileFormat == "hdf5") {
+            auto sinks = openSinks(outputPath, 0);
+            std::vector<ProfiledMutex*> mutexes;
+            for (auto& pipeline : m_pipelines) mutexes.push_back(&pipeline->mutex);
+            {
+                auto locks = lockAll(mutexes);
+                const auto boundary = currentBoundary();
+                for (size_t i = 0; i < m_pipelines.size(); ++i) {
+                    sinks[i]->setStartTimestamp(boundary);
+                    m_pipelines[i]->activeSink = sinks[i];
                 }
-                const std::string capitalizedType = (i == 0) ? "Master" : "Slave";
-                std::cout << capitalizedType << " camera " << i << " started" << std::endl;
-            } else {
-                std::cout << "Camera " << i << " already running; continuing with recording" << std::endl;
+                m_lastBoundary = boundary;
             }
+            EBV_LOG_INFO << "Event recording attached at t=" << m_lastBoundary << " us";
+        } else {
+            startRawRecording(outputPath);
         }
 
+        m_fileFormat = fileFormat;
         m_recording = true;
-        std::cout << "Event camera recording started successfully for " << m_cameras.size() << " cameras in " << fileFormat << " format" << std::endl;
+        EBV_LOG_INFO << "Event camera recording started successfully for " << m_cameras.size() << " cameras in " << fileFormat << " format";
 
     } catch (const Metavision::CameraException& e) {
         throw std::runtime_error("Failed to start recording: " + std::string(e.what()));
@@ -197,58 +511,227 @@ void EventCameraManager::stopRecording() {
     }
     
     try {
-        // If live streaming is active, briefly pause to allow writer to flush events
-        bool resumeStreaming = false;
-        if (m_liveStreaming) {
-            stopLiveStreaming();
-            resumeStreaming = true;
-        }
-        for (size_t i = 0; i < m_cameras.size(); ++i) {
-            if (m_cameras[i]) {
-                m_cameras[i]->stop_recording();
-                // If live streaming is still active (preview mode), keep camera running
-                if (!m_liveStreaming) {
-                    m_cameras[i]->stop();
-                    const std::string cameraType = (i == 0) ? "master" : "slave";
-                    std::cout << "Stopped " << cameraType << " camera " << i << std::endl;
-                } else {
-                    std::cout << "Stopped recording on camera " << i << " (kept running for preview)" << std::endl;
-                }
+        if (m_fileFormat == "hdf5") {
+            std::vector<ProfiledMutex*> mutexes;
+            for (auto& pipeline : m_pipelines) mutexes.push_back(&pipeline->mutex);
+            Metavision::timestamp boundary = 0;
+            {
+                auto locks = lockAll(mutexes);
+                boundary = currentBoundary();
+                retireSinks(boundary);
             }
+            finishRetiredSinks(boundary);
+            m_lastBoundary = boundary;
+            EBV_LOG_INFO << "Event recording detached at t=" << boundary << " us";
+        } else {
+            stopRawRecording();
         }
         m_recording = false;
-        std::cout << "Event camera recording stopped successfully for " << m_cameras.size() << " cameras" << std::endl;
-        // Resume live streaming if it was active before
-        if (resumeStreaming) {
-            startLiveStreaming();
-        }
+        EBV_LOG_INFO << "Event camera recording stopped successfully for " << m_cameras.size() << " cameras";
     } catch (const std::exception& e) {
-        std::cerr << "Error stopping cameras: " << e.what() << std::endl;
+        m_recording = false;
+        EBV_LOG_ERROR << "Error stopping cameras: " << e.what();
+    }
+}
+
+void EventCameraManager::switchRecording(const std::string& outputPath, const std::string& fileFormat) {
+    if (!m_recording) {
+        startRecording(outputPath, fileFormat);
+        return;
+    }
+    // Raw recordings are byte streams owned by the SDK and cannot be split on a timestamp
+    if (fileFormat != "hdf5" || m_fileFormat != "hdf5") {
+        stopRecording();
+        startRecording(outputPath, fileFormat);
+        return;
+    }
+
+    std::filesystem::create_directories(outputPath);
+    auto sinks = openSinks(outputPath, 0);
+    std::vector<ProfiledMutex*> mutexes;
+    for (auto& pipeline : m_pipelines) mutexes.push_back(&pipeline->mutex);
+    Metavision::timestamp boundary = 0;
+    {
+        // Old take gets t < boundary, new take t >= boundary: no gap and no duplicates
+        auto locks = lockAll(mutexes);
+        boundary = currentBoundary();
+        retireSinks(boundary);
+        for (size_t i = 0; i < m_pipelines.size(); ++i) {
+            sinks[i]->setStartTimestamp(boundary);
+            m_pipelines[i]->activeSink = sinks[i];
+        }
+    }
+    finishRetiredSinks(boundary);
+    m_outputPath = outputPath;
+    m_lastBoundary = boundary;
+    EBV_LOG_INFO << "Event recording switched to " << outputPath << " at t=" << boundary << " us";
+}
+
+std::vector<std::shared_ptr<EventCameraManager::EventRecordingSink>>
+EventCameraManager::openSinks(const std::string& outputPath, Metavision::timestamp startTs) {
+    std::vector<std::shared_ptr<EventRecordingSink>> sinks;
+    for (size_t i = 0; i < m_cameras.size(); ++i) {
+        const std::string filename = eventFilePath(outputPath, i, ".hdf5");
+        auto heartbeat = m_watchdog ? m_watchdog->registerStage("event_writer" + std::to_string(i), WRITER_STALL_THRESHOLD) : nullptr;
+        auto sink = std::make_shared<EventRecordingSink>(filename, *m_cameras[i], m_hdf5Settings, std::move(heartbeat));
+        sink->setStartTimestamp(startTs);
+        sinks.push_back(std::move(sink));
+        EBV_LOG_INFO << "Recording " << ((i == 0) ? "master" : "slave") << " camera " << i << " to: " << filename;
+    }
+    return sinks;
+}
+
+Metavision::timestamp EventCameraManager::currentBoundary() const {
+    // Cameras share the master clock, so one boundary applies to all of them
+    Metavision::timestamp latest = -1;
+    for (const auto& pipeline : m_pipelines) {
+        latest = std::max(latest, pipeline->lastTimestamp.load());
+    }
+    return latest + 1;
+}
+
+void EventCameraManager::retireSinks(Metavision::timestamp stopTs) {
+    // Caller holds all pipeline mutexes
+    for (auto& pipeline : m_pipelines) {
+        if (!pipeline->activeSink) continue;
+        pipeline->activeSink->setStopTimestamp(stopTs);
+        pipeline->retiringSink = std::move(pipeline->activeSink);
+    }
+}
+
+void EventCameraManager::finishRetiredSinks(Metavision::timestamp stopTs) {
+    // Slaves may lag the master; keep feeding the old take until every camera has delivered
+    // an event at or past the boundary, so nothing before it is lost
+    const auto deadline = std::chrono::steady_clock::now() + SINK_DRAIN_TIMEOUT;
+    auto caughtUp = [this, stopTs] {
+        for (const auto& pipeline : m_pipelines) {
+            if (pipeline->lastTimestamp.load() < stopTs) return false;
+        }
+        return true;
+    };
+    while (!caughtUp() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    m_lastTakeSummaries.clear();
+    for (size_t i = 0; i < m_pipelines.size(); ++i) {
+        auto& pipeline = m_pipelines[i];
+        std::shared_ptr<EventRecordingSink> sink;
+        Metavision::timestamp last = 0;
+        {
+            std::lock_guard<ProfiledMutex> lock(pipeline->mutex);
+            sink = std::move(pipeline->retiringSink);
+            last = pipeline->lastTimestamp.load();
+            if (sink && last < stopTs) {
+                pipeline->lateBoundary = stopTs;
+                pipeline->lateEvents = 0;
+            }
+        }
+        if (!sink) continue;
+        const int64_t lag = last < stopTs ? stopTs - std::max<Metavision::timestamp>(last, 0) : 0;
+        if (lag > 0) {
+            EBV_LOG_WARN << "Event camera " << i << " did not reach the take boundary t=" << stopTs << " us within "
+                         << SINK_DRAIN_TIMEOUT.count() << " ms (last event at t=" << last
+                         << " us); closing its file, later events before the boundary are dropped";
+        }
+        sink->finish();
+        auto summary = sink->summary(StreamLayout::eventStreamName(i));
+        summary.boundaryLagUs = lag;
+        m_lastTakeSummaries.push_back(std::move(summary));
+    }
+}
+
+void EventCameraManager::countLateEvents(int cameraId, uint64_t late, Metavision::timestamp lastTs) {
+    auto& pipeline = *m_pipelines[cameraId];
+    pipeline.lateEvents += late;
+    if (lastTs < pipeline.lateBoundary) return;
+    if (pipeline.lateEvents > 0) {
+        EBV_LOG_WARN << "Dropped " << pipeline.lateEvents << " late events of event camera " << cameraId
+                     << " with t < " << pipeline.lateBoundary << " us, their take was already closed";
+    }
+    pipeline.lateBoundary = std::numeric_limits<Metavision::timestamp>::min();
+    pipeline.lateEvents = 0;
+}
+
+std::string EventCameraManager::eventFilePath(const std::string& outputPath, size_t cameraIndex,
+                                              const std::string& extension) const {
+    const bool striped = cameraIndex < m_streamDirectories.size() && !m_streamDirectories[cameraIndex].empty();
+    const std::filesystem::path directory = striped ? m_streamDirectories[cameraIndex] : outputPath;
+    std::filesystem::create_directories(directory);
+    return (directory / ("ebv_cam_" + std::to_string(cameraIndex) + extension)).string();
+}
+
+void EventCameraManager::startRawRecording(const std::string& outputPath) {
+    // Native RAW recording has no timestamp boundary; it is started on the running camera
+    for (size_t i = 0; i < m_cameras.size(); ++i) {
+        const std::string filename = eventFilePath(outputPath, i, ".raw");
+        if (!m_cameras[i]->start_recording(filename)) {
+            throw std::runtime_error("Failed to start recording for camera " + std::to_string(i));
+        }
+        // Counted from the first chunk delivered after the recorder started
+        if (i < m_pipelines.size()) {
+            auto statistics = std::make_shared<RawTakeStatistics>();
+            std::lock_guard<ProfiledMutex> lock(m_pipelines[i]->mutex);
+            m_pipelines[i]->rawStatistics = std::move(statistics);
+            m_pipelines[i]->rawPath = filename;
+        }
+        EBV_LOG_INFO << "Started recording " << ((i == 0) ? "master" : "slave") << " camera " << i << " to: " << filename;
+    }
+}
+
+void EventCameraManager::stopRawRecording() {
+    m_lastTakeSummaries.clear();
+    for (size_t i = 0; i < m_cameras.size(); ++i) {
+        if (m_cameras[i]) {
+            m_cameras[i]->stop_recording();
+            EBV_LOG_INFO << "Stopped recording on camera " << i << " (capture keeps running)";
+        }
+        if (i >= m_pipelines.size()) continue;
+        std::shared_ptr<RawTakeStatistics> statistics;
+        std::string path;
+        {
+            std::lock_guard<ProfiledMutex> lock(m_pipelines[i]->mutex);
+            statistics = std::move(m_pipelines[i]->rawStatistics);
+            path = m_pipelines[i]->rawPath;
+        }
+        if (!statistics) continue;
+        // Everything handed over before the detach is processed before summarizing
+        statistics->finish();
+        std::error_code ec;
+        const auto bytes = std::filesystem::file_size(path, ec);
+        m_lastTakeSummaries.push_back(statistics->summary(StreamLayout::eventStreamName(i), ec ? 0 : bytes));
     }
 }
 
 void EventCameraManager::closeDevices() {
     try {
-        // Stop recording if still active
+        // Stop recording and the capture pipeline before releasing the cameras
         if (m_recording) {
             stopRecording();
         }
+        stopLiveStreaming();
         
         // Close and release all cameras
         for (size_t i = 0; i < m_cameras.size(); ++i) {
             if (m_cameras[i]) {
                 const std::string cameraType = (i == 0) ? "master" : "slave";
-                std::cout << "Closing " << cameraType << " camera " << i << std::endl;
+                EBV_LOG_INFO << "Closing " << cameraType << " camera " << i;
                 // Camera destructor will handle proper cleanup
                 m_cameras[i].reset();
             }
         }
         
         m_cameras.clear();
-        std::cout << "All event cameras closed and resources released" << std::endl;
+        m_cameraSerials.clear();
+        m_appliedBiases.clear();
+        {
+            std::lock_guard<std::mutex> pipelinesLock(m_pipelinesMutex);
+            m_pipelines.clear();
+        }
+        EBV_LOG_INFO << "All event cameras closed and resources released";
         
     } catch (const std::exception& e) {
-        std::cerr << "Error closing cameras: " << e.what() << std::endl;
+        EBV_LOG_ERROR << "Error closing cameras: " << e.what();
     }
 }
 
@@ -265,9 +748,9 @@ EventCameraManager::BiasConfig EventCameraManager::clipBiasValues(const BiasConf
         bias_value = std::clamp(bias_value, it->second.min_value, it->second.max_value);
         
         if (bias_value != original_value) {
-            std::cerr << "Warning: Bias " << bias_name << " value " << original_value
+            EBV_LOG_WARN << "Bias " << bias_name << " value " << original_value
                       << " was clipped to " << bias_value << " (limits: ["
-                      << it->second.min_value << ", " << it->second.max_value << "])" << std::endl;
+                      << it->second.min_value << ", " << it->second.max_value << "])";
         }
     }
     
@@ -277,22 +760,22 @@ EventCameraManager::BiasConfig EventCameraManager::clipBiasValues(const BiasConf
 bool EventCameraManager::validateBiasLimits(const std::string& biasName, int value) {
     const auto it = DEFAULT_BIAS_LIMITS.find(biasName);
     if (it == DEFAULT_BIAS_LIMITS.end()) {
-        std::cerr << "Warning: Unknown bias name '" << biasName << "'; skipping validation." << std::endl;
+        EBV_LOG_WARN << "Unknown bias name '" << biasName << "'; skipping validation.";
         return true; // Unknown bias names are allowed to pass through
     }
     
     const bool isValid = (value >= it->second.min_value && value <= it->second.max_value);
     if (!isValid) {
-        std::cerr << "Warning: Bias " << biasName << " value " << value 
+        EBV_LOG_WARN << "Bias " << biasName << " value " << value 
                  << " is outside limits [" << it->second.min_value 
-                 << ", " << it->second.max_value << "]" << std::endl;
+                 << ", " << it->second.max_value << "]";
     }
     return isValid;
 }
 
 bool EventCameraManager::startLiveStreaming() {
     if (m_cameras.empty()) {
-        std::cerr << "Error: No cameras opened for live streaming" << std::endl;
+        EBV_LOG_ERROR << "Error: No cameras opened for live streaming";
         return false;
     }
     
@@ -301,17 +784,6 @@ bool EventCameraManager::startLiveStreaming() {
     }
     
     try {
-        // Ensure cameras are running to deliver events
-        for (size_t i = 0; i < m_cameras.size(); ++i) {
-            if (!m_recording && m_cameras[i]) {
-                if (!m_cameras[i]->is_running()) {
-                    if (!m_cameras[i]->start()) {
-                        throw std::runtime_error("Failed to start camera for live streaming: " + std::to_string(i));
-                    }
-                    m_startedForStreaming[i] = true;
-                }
-            }
-        }
         // Initialize buffers and counters for each camera
         // Resize and reset tracking vectors to match number of cameras
         m_liveEventBuffers.resize(m_cameras.size());
@@ -319,10 +791,11 @@ bool EventCameraManager::startLiveStreaming() {
         for (auto &q : m_liveEventBuffers) {
             while (!q.empty()) q.pop();
         }
+        m_liveFrameMemory.clear();
         m_eventBufferMutexes.resize(m_cameras.size());
         for (size_t i = 0; i < m_eventBufferMutexes.size(); ++i) {
             if (!m_eventBufferMutexes[i]) {
-                m_eventBufferMutexes[i] = std::make_unique<std::mutex>();
+                m_eventBufferMutexes[i] = std::make_unique<ProfiledMutex>("event_live_buffer");
             }
         }
         m_eventFrameCounters.resize(m_cameras.size());
@@ -333,6 +806,29 @@ bool EventCameraManager::startLiveStreaming() {
         if (m_startedForStreaming.size() != m_cameras.size()) {
             m_startedForStreaming.assign(m_cameras.size(), false);
         }
+        {
+            std::lock_guard<std::mutex> pipelinesLock(m_pipelinesMutex);
+            while (m_pipelines.size() < m_cameras.size()) {
+                m_pipelines.push_back(std::make_unique<CameraPipeline>());
+            }
+        }
+
+        // Callbacks stay attached for the whole lifetime of the pipeline; recording only
+        // adds/removes sinks. Attach before starting so no event is missed.
+        for (size_t i = 0; i < m_cameras.size(); ++i) {
+            attachPipelineCallbacks(static_cast<int>(i));
+        }
+
+        // Ensure cameras are running to deliver events
+        for (size_t i = 0; i < m_cameras.size(); ++i) {
+            if (m_cameras[i] && !m_cameras[i]->is_running()) {
+                if (!m_cameras[i]->start()) {
+                    throw std::runtime_error("Failed to start camera for live streaming: " + std::to_string(i));
+                }
+                m_startedForStreaming[i] = true;
+                EBV_LOG_INFO << ((i == 0) ? "Master" : "Slave") << " camera " << i << " started";
+            }
+        }
         
         // Start streaming threads for each camera
         m_liveStreaming = true;
@@ -340,11 +836,14 @@ bool EventCameraManager::startLiveStreaming() {
             m_eventStreamingThreads.emplace_back(&EventCameraManager::eventStreamingWorker, this, static_cast<int>(i));
         }
         
-        std::cout << "Started live streaming for " << m_cameras.size() << " event cameras" << std::endl;
+        EBV_LOG_INFO << "Started live streaming for " << m_cameras.size() << " event cameras";
         return true;
         
     } catch (const std::exception& e) {
-        std::cerr << "Error starting live streaming: " << e.what() << std::endl;
+        EBV_LOG_ERROR << "Error starting live streaming: " << e.what();
+        for (size_t i = 0; i < m_pipelines.size() && i < m_cameras.size(); ++i) {
+            detachPipelineCallbacks(static_cast<int>(i));
+        }
         m_liveStreaming = false;
         return false;
     }
@@ -354,6 +853,11 @@ void EventCameraManager::stopLiveStreaming() {
     if (!m_liveStreaming) {
         return;
     }
+
+    // The recording is fed by this pipeline; finalize it before tearing the pipeline down
+    if (m_recording) {
+        stopRecording();
+    }
     
     m_liveStreaming = false;
     
@@ -364,6 +868,10 @@ void EventCameraManager::stopLiveStreaming() {
         }
     }
     m_eventStreamingThreads.clear();
+
+    for (size_t i = 0; i < m_pipelines.size() && i < m_cameras.size(); ++i) {
+        detachPipelineCallbacks(static_cast<int>(i));
+    }
     
     // Clear buffers
     for (auto& buffer : m_liveEventBuffers) {
@@ -372,12 +880,13 @@ void EventCameraManager::stopLiveStreaming() {
         }
     }
     m_liveEventBuffers.clear();
+    m_liveFrameMemory.clear();
     m_eventBufferMutexes.clear();
     m_eventFrameCounters.clear();
     
     // If we started cameras solely for streaming, stop them
     for (size_t i = 0; i < m_cameras.size(); ++i) {
-        if (!m_recording && m_startedForStreaming.size() > i && m_startedForStreaming[i]) {
+        if (m_startedForStreaming.size() > i && m_startedForStreaming[i]) {
             try {
                 m_cameras[i]->stop();
             } catch (...) {}
@@ -386,11 +895,100 @@ void EventCameraManager::stopLiveStreaming() {
     }
     
         
-    std::cout << "Stopped live streaming for event cameras" << std::endl;
+    EBV_LOG_INFO << "Stopped live streaming for event cameras";
+}
+
+void EventCameraManager::attachPipelineCallbacks(int cameraId) {
+    auto& pipeline = *m_pipelines[cameraId];
+    if (m_watchdog && !pipeline.callbackHeartbeat) {
+        pipeline.callbackHeartbeat = m_watchdog->registerStage("event_callback" + std::to_string(cameraId), CALLBACK_STALL_THRESHOLD);
+        pipeline.callbackHeartbeat->setDetail(m_cameraSerials.size() > static_cast<size_t>(cameraId) ? m_cameraSerials[cameraId] : "");
+    }
+    if (!pipeline.hasCdCallback) {
+        pipeline.cdCallbackId = m_cameras[cameraId]->cd().add_callback(
+            [this, cameraId](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+                dispatchEvents(cameraId, begin, end);
+            });
+        pipeline.hasCdCallback = true;
+    }
+    if (!pipeline.hasTriggerCallback) {
+        try {
+            pipeline.triggerCallbackId = m_cameras[cameraId]->ext_trigger().add_callback(
+                [this, cameraId](const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end) {
+                    dispatchTriggers(cameraId, begin, end);
+                });
+            pipeline.hasTriggerCallback = true;
+        } catch (const Metavision::CameraException& e) {
+            EBV_LOG_WARN << "camera " << cameraId << " provides no trigger events: " << e.what();
+        }
+    }
+}
+
+void EventCameraManager::detachPipelineCallbacks(int cameraId) {
+    auto& pipeline = *m_pipelines[cameraId];
+    try {
+        if (pipeline.hasCdCallback && m_cameras[cameraId]) {
+            m_cameras[cameraId]->cd().remove_callback(pipeline.cdCallbackId);
+        }
+        if (pipeline.hasTriggerCallback && m_cameras[cameraId]) {
+            m_cameras[cameraId]->ext_trigger().remove_callback(pipeline.triggerCallbackId);
+        }
+    } catch (...) {
+        // Swallow any errors on teardown
+    }
+    pipeline.hasCdCallback = false;
+    pipeline.hasTriggerCallback = false;
+    std::lock_guard<ProfiledMutex> lock(pipeline.mutex);
+    pipeline.previewEvents.clear();
+}
+
+void EventCameraManager::dispatchEvents(int cameraId, const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+    if (begin == end) return;
+    auto& pipeline = *m_pipelines[cameraId];
+    StallWatchdog::Heartbeat::Scope watched(pipeline.callbackHeartbeat.get(), "cd callback");
+    {
+        std::lock_guard<ProfiledMutex> lock(pipeline.mutex);
+        if (pipeline.previewEvents.size() < MAX_PREVIEW_EVENTS) {
+            pipeline.previewEvents.append(begin, end);
+        }
+        if (pipeline.activeSink) pipeline.activeSink->offerEvents(begin, end);
+        if (pipeline.retiringSink) {
+            pipeline.retiringSink->offerEvents(begin, end);
+        } else if (pipeline.lateEvents > 0 || begin->t < pipeline.lateBoundary) {
+            const auto late = std::count_if(begin, end, [&pipeline](const Metavision::EventCD& ev) { return ev.t < pipeline.lateBoundary; });
+            countLateEvents(cameraId, static_cast<uint64_t>(late), (end - 1)->t);
+        }
+        if (pipeline.rawStatistics) pipeline.rawStatistics->offerEvents(begin, end);
+        pipeline.lastTimestamp.store((end - 1)->t);
+    }
+
+    // Raw chunks are only materialized when someone subscribed to them
+    if (m_liveBus && m_liveBus->eventChunks.hasSubscribers()) {
+        auto chunk = std::make_shared<LiveEventChunk>();
+        chunk->cameraId = cameraId;
+        chunk->events.assign(begin, end);
+        chunk->firstTimestamp = begin->t;
+        chunk->lastTimestamp = (end - 1)->t;
+        m_liveBus->eventChunks.publish(std::move(chunk));
+    }
+}
+
+void EventCameraManager::dispatchTriggers(int cameraId, const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end) {
+    if (begin == end) return;
+    auto& pipeline = *m_pipelines[cameraId];
+    std::lock_guard<ProfiledMutex> lock(pipeline.mutex);
+    if (pipeline.activeSink) pipeline.activeSink->offerTriggers(begin, end);
+    if (pipeline.retiringSink) {
+        pipeline.retiringSink->offerTriggers(begin, end);
+    } else if (pipeline.lateEvents > 0 || begin->t < pipeline.lateBoundary) {
+        const auto late = std::count_if(begin, end, [&pipeline](const Metavision::EventExtTrigger& ev) { return ev.t < pipeline.lateBoundary; });
+        countLateEvents(cameraId, static_cast<uint64_t>(late), (end - 1)->t);
+    }
+    if (pipeline.rawStatistics) pipeline.rawStatistics->addTriggers(static_cast<uint64_t>(end - begin));
 }
 
 void EventCameraManager::eventStreamingWorker(int cameraId) {
-    if (cameraId >= static_cast<int>(m_cameras.size())) {
+    if (cameraId >= static_cast<int>(m_cameras.size()) || cameraId >= static_cast<int>(m_pipelines.size())) {
         return;
     }
     if (cameraId < 0) {
@@ -398,60 +996,76 @@ void EventCameraManager::eventStreamingWorker(int cameraId) {
     }
     // Validate mutex and counters
     if (m_eventBufferMutexes.size() <= static_cast<size_t>(cameraId) || !m_eventBufferMutexes[cameraId]) {
-        std::cerr << "Streaming worker " << cameraId << ": missing mutex; aborting thread" << std::endl;
+        EBV_LOG_ERROR << "Streaming worker " << cameraId << ": missing mutex; aborting thread";
         return;
     }
     if (m_eventFrameCounters.size() <= static_cast<size_t>(cameraId)) {
-        std::cerr << "Streaming worker " << cameraId << ": frame counter out of range; aborting thread" << std::endl;
+        EBV_LOG_ERROR << "Streaming worker " << cameraId << ": frame counter out of range; aborting thread";
         return;
     }
     
-    std::vector<Metavision::EventCD> eventBuffer;
-    eventBuffer.reserve(100000); // Reserve space for events
+    auto& pipeline = *m_pipelines[cameraId];
+    // Double buffer with the pipeline: swapped every frame, capacity is kept on both sides
+    EventBlock eventBuffer;
+    const auto heartbeat = m_watchdog ? m_watchdog->registerStage("event_preview" + std::to_string(cameraId), PREVIEW_STALL_THRESHOLD) : nullptr;
     
     auto lastFrameTime = std::chrono::steady_clock::now();
-    const auto frameInterval = std::chrono::duration<double>(1.0 / EVENT_FRAME_RATE);
-    
-    // Add callback to collect events
-    auto callbackId = m_cameras[cameraId]->cd().add_callback(
-        [&eventBuffer](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
-            for (auto it = begin; it != end; ++it) {
-                eventBuffer.push_back(*it);
-            }
-        }
-    );
     
     try {
         while (m_liveStreaming) {
             auto currentTime = std::chrono::steady_clock::now();
+            // Under load the preview renders fewer frames with fewer events; events keep
+            // accumulating in between, so nothing but preview detail is lost
+            const PreviewBudget budget = m_overload ? m_overload->budget() : PreviewBudget{};
+            const auto frameInterval = std::chrono::duration<double>(1.0 / (EVENT_FRAME_RATE * budget.frameRateScale));
+            const size_t eventStride = budget.eventDensity < 1.0 ? static_cast<size_t>(1.0 / budget.eventDensity + 0.5) : 1;
             
             // Check if it's time to generate a new frame
             if (currentTime - lastFrameTime >= frameInterval) {
+                {
+                    // Take the accumulated events; the callback keeps appending to a fresh buffer
+                    std::lock_guard<ProfiledMutex> lock(pipeline.mutex);
+                    eventBuffer.swap(pipeline.previewEvents);
+                    pipeline.previewEvents.clear();
+                }
                 if (!eventBuffer.empty()) {
+                    StallWatchdog::Heartbeat::Scope watched(heartbeat.get(), "render preview");
                     // Generate frame from accumulated events
-                    cv::Mat frame = generateEventFrame(eventBuffer, EVENT_FRAME_WIDTH, EVENT_FRAME_HEIGHT);
+                    cv::Mat frame = generateEventFrame(eventBuffer, EVENT_FRAME_WIDTH, EVENT_FRAME_HEIGHT, eventStride);
                     
-                    // Create frame data
+                    // Create frame data (frame is freshly allocated, so it can be shared as-is)
                     EventFrameData frameData;
-                    frameData.frame = frame.clone(); // Clone to ensure thread safety
+                    frameData.frame = frame;
                     frameData.cameraId = cameraId;
                     frameData.frameIndex = m_eventFrameCounters[cameraId]++;
                     frameData.timestamp = currentTime;
                     frameData.isValid = !frame.empty();
+
+                    if (m_liveBus && frameData.isValid && m_liveBus->eventFrames.hasSubscribers()) {
+                        auto packet = std::make_shared<LiveEventFrame>();
+                        packet->frame = frame;
+                        packet->cameraId = cameraId;
+                        packet->frameIndex = frameData.frameIndex;
+                        packet->timestamp = currentTime;
+                        m_liveBus->eventFrames.publish(std::move(packet));
+                    }
                     
                     // Add to buffer
                     if (m_eventBufferMutexes.size() > static_cast<size_t>(cameraId) && m_eventBufferMutexes[cameraId]) {
-                        std::lock_guard<std::mutex> lock(*m_eventBufferMutexes[cameraId]);
+                        std::lock_guard<ProfiledMutex> lock(*m_eventBufferMutexes[cameraId]);
                         if (m_liveEventBuffers.size() > static_cast<size_t>(cameraId)) {
                             m_liveEventBuffers[cameraId].push(frameData);
+                            m_liveFrameMemory.add(frame.total() * frame.elemSize());
                             // Keep buffer size under control
                             while (m_liveEventBuffers[cameraId].size() > MAX_EVENT_BUFFER_SIZE) {
+                                const cv::Mat& oldest = m_liveEventBuffers[cameraId].front().frame;
+                                m_liveFrameMemory.release(oldest.total() * oldest.elemSize());
                                 m_liveEventBuffers[cameraId].pop();
                             }
                         }
                     }
                     
-                    // Clear event buffer for next frame
+                    // Clear event buffer for next frame (capacity is reused)
                     eventBuffer.clear();
                 }
                 
@@ -462,31 +1076,38 @@ void EventCameraManager::eventStreamingWorker(int cameraId) {
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error in event streaming worker " << cameraId << ": " << e.what() << std::endl;
+        EBV_LOG_ERROR << "Error in event streaming worker " << cameraId << ": " << e.what();
     }
-    
-    // Remove callback safely
-    try {
-        if (cameraId >= 0 && cameraId < static_cast<int>(m_cameras.size()) && m_cameras[cameraId]) {
-            m_cameras[cameraId]->cd().remove_callback(callbackId);
-        }
-    } catch (...) {
-        // Swallow any errors on teardown to avoid thread termination issues
+}
+
+double EventCameraManager::writerPressure() const {
+    std::lock_guard<std::mutex> pipelinesLock(m_pipelinesMutex);
+    size_t backlog = 0;
+    for (const auto& pipeline : m_pipelines) {
+        std::lock_guard<ProfiledMutex> lock(pipeline->mutex);
+        size_t pipelineBacklog = 0;
+        if (pipeline->activeSink) pipelineBacklog += pipeline->activeSink->backlogEvents();
+        if (pipeline->retiringSink) pipelineBacklog += pipeline->retiringSink->backlogEvents();
+        backlog = std::max(backlog, pipelineBacklog);
     }
+    return static_cast<double>(backlog) / MAX_SINK_BACKLOG_EVENTS;
 }
 
-cv::Mat EventCameraManager::generateEventFrame(const std::vector<Metavision::EventCD>& events, int width, int height) {
+cv::Mat EventCameraManager::generateEventFrame(const EventBlock& events, int width, int height, size_t stride) {
     // Create accumulation frame
     cv::Mat frame = cv::Mat::zeros(height, width, CV_8UC3);
     
     // Background color (dark gray)
     frame.setTo(cv::Scalar(64, 64, 64));
     
-    // Accumulate events with simple visualization
-    for (const auto& event : events) {
-        if (event.x >= 0 && event.x < width && event.y >= 0 && event.y < height) {
-            cv::Vec3b& pixel = frame.at<cv::Vec3b>(event.y, event.x);
-            if (event.p == 1) { // Positive event (white)
+    // Accumulate events with simple visualization (coordinates are unsigned in the block)
+    const size_t count = events.size();
+    for (size_t i = 0; i < count; i += stride) {
+        const int x = events.x[i];
+        const int y = events.y[i];
+        if (x < width && y < height) {
+            cv::Vec3b& pixel = frame.at<cv::Vec3b>(y, x);
+            if (events.p[i] == 1) { // Positive event (white)
                 pixel[0] = 255; pixel[1] = 255; pixel[2] = 255;
             } else { // Negative event (blue)  
                 pixel[0] = 255; pixel[1] = 0; pixel[2] = 0; // BGR format: Blue=255, Green=0, Red=0
@@ -508,7 +1129,7 @@ bool EventCameraManager::getLatestEventFrame(int cameraId, cv::Mat& eventFrame,
     if (m_liveEventBuffers.size() <= static_cast<size_t>(cameraId)) {
         return false;
     }
-    std::lock_guard<std::mutex> lock(*m_eventBufferMutexes[cameraId]);
+    std::lock_guard<ProfiledMutex> lock(*m_eventBufferMutexes[cameraId]);
     if (m_liveEventBuffers[cameraId].empty()) {
         return false;
     }
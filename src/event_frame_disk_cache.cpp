@@ -0,0 +1,312 @@
+#include "event_frame_disk_cache.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+uint64_t fnv1a(const std::string& text, uint64_t hash = 0xcbf29ce484222325ull) {
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+bool writeAll(int fd, const void* data, size_t size, uint64_t offset) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        const ssize_t written = ::pwrite(fd, bytes, size, static_cast<off_t>(offset));
+        if (written <= 0) return false;
+        bytes += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+} // namespace
+
+fs::path EventFrameDiskCache::defaultCacheDirectory() {
+    if (const char* custom = std::getenv("EBV_RENDER_CACHE")) {
+        const std::string value = custom;
+        if (value == "off" || value == "0") return {};
+        if (!value.empty()) return value;
+    }
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+        return fs::path(xdg) / "ebv_frame_recording" / "render";
+    }
+    if (const char* home = std::getenv("HOME"); home && *home) {
+        return fs::path(home) / ".cache" / "ebv_frame_recording" / "render";
+    }
+    return {};
+}
+
+std::string EventFrameDiskCache::fileNameFor(const Key& key) {
+    std::error_code ec;
+    const auto canonical = fs::weakly_canonical(key.sourcePath, ec);
+    std::ostringstream identity;
+    identity << (ec ? key.sourcePath : canonical.string()) << '|' << key.cameraId << '|' << key.windowUs << '|'
+             << key.overlapUs << '|' << key.renderMode << '|' << key.rendererVersion;
+    // A rewritten or transcoded source gets a new cache file
+    struct stat st{};
+    if (::stat(key.sourcePath.c_str(), &st) == 0) {
+        identity << '|' << st.st_size << '|' << st.st_mtim.tv_sec << '.' << st.st_mtim.tv_nsec;
+    }
+    std::ostringstream name;
+    name << fs::path(key.sourcePath).stem().string() << '_' << std::hex << std::setw(16) << std::setfill('0')
+         << fnv1a(identity.str()) << ".erc";
+    return name.str();
+}
+
+uint64_t EventFrameDiskCache::maxCacheBytes() {
+    if (const char* custom = std::getenv("EBV_RENDER_CACHE_MAX_GB")) {
+        const double gigabytes = std::strtod(custom, nullptr);
+        if (gigabytes > 0) return static_cast<uint64_t>(gigabytes * static_cast<double>(1ull << 30));
+    }
+    return DEFAULT_MAX_CACHE_BYTES;
+}
+
+void EventFrameDiskCache::enforceSizeLimit(const fs::path& cacheDirectory, uint64_t maxBytes, const fs::path& keep) {
+    // Opening a cache file touches its mtime, so the oldest mtime is the least recently used
+    std::vector<std::tuple<fs::file_time_type, uint64_t, fs::path>> files;
+    uint64_t totalBytes = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(cacheDirectory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() != ".erc" || !it->is_regular_file(ec)) continue;
+        const uint64_t size = it->file_size(ec);
+        if (ec) continue;
+        files.emplace_back(it->last_write_time(ec), size, it->path());
+        totalBytes += size;
+    }
+    std::sort(files.begin(), files.end());
+
+    for (const auto& [mtime, size, path] : files) {
+        if (totalBytes <= maxBytes) break;
+        if (!keep.empty() && path == keep) continue;
+        // Files with a writer lock belong to a running player
+        const int fd = ::open(path.c_str(), O_RDWR);
+        if (fd < 0) continue;
+        if (::flock(fd, LOCK_EX | LOCK_NB) == 0 && fs::remove(path, ec)) totalBytes -= size;
+        ::close(fd);
+    }
+}
+
+EventFrameDiskCache::EventFrameDiskCache(const fs::path& cacheDirectory, const Key& key,
+                                         int width, int height, size_t frameCapacity)
+    : m_width(width), m_height(height), m_frameCapacity(frameCapacity), m_key(key) {
+    if (cacheDirectory.empty() || width <= 0 || height <= 0 || frameCapacity == 0) return;
+    std::error_code ec;
+    fs::create_directories(cacheDirectory, ec);
+    const fs::path path = cacheDirectory / fileNameFor(key);
+    if (!openFile(path)) return;
+    if (m_writable) {
+        ::futimens(m_fd, nullptr); // most recently used
+        enforceSizeLimit(cacheDirectory, maxCacheBytes(), path);
+        m_writerThread = std::thread(&EventFrameDiskCache::writerLoop, this);
+    }
+}
+
+EventFrameDiskCache::~EventFrameDiskCache() {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_stopping = true;
+    }
+    m_queueCondition.notify_all();
+    if (m_writerThread.joinable()) m_writerThread.join();
+    if (m_map) ::munmap(const_cast<uint8_t*>(m_map), m_mappedBytes);
+    if (m_fd >= 0) ::close(m_fd); // also releases the writer lock
+}
+
+bool EventFrameDiskCache::openFile(const fs::path& path) {
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (m_fd >= 0 && ::flock(m_fd, LOCK_EX | LOCK_NB) == 0) {
+        m_writable = true;
+    } else {
+        // Another player owns the file (or no write permission): use it read-only
+        if (m_fd >= 0) ::close(m_fd);
+        m_fd = ::open(path.c_str(), O_RDONLY);
+        if (m_fd < 0) return false;
+    }
+
+    Header header{};
+    const bool valid = ::pread(m_fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                       header.magic == MAGIC && header.version == VERSION &&
+                       header.width == static_cast<uint32_t>(m_width) &&
+                       header.height == static_cast<uint32_t>(m_height) &&
+                       header.rendererVersion == m_key.rendererVersion &&
+                       header.frameCapacity == m_frameCapacity &&
+                       header.windowUs == m_key.windowUs && header.overlapUs == m_key.overlapUs;
+    if (!valid && !(m_writable && initializeFile())) {
+        ::close(m_fd);
+        m_fd = -1;
+        m_writable = false;
+        return false;
+    }
+
+    struct stat st{};
+    ::fstat(m_fd, &st);
+    m_fileSize = static_cast<uint64_t>(st.st_size);
+    return remapIfNeeded(sizeof(Header) + m_frameCapacity * sizeof(IndexEntry));
+}
+
+bool EventFrameDiskCache::initializeFile() {
+    // Layout changed or new file: start empty
+    if (::ftruncate(m_fd, 0) != 0) return false;
+    const uint64_t tableBytes = sizeof(Header) + m_frameCapacity * sizeof(IndexEntry);
+    if (::ftruncate(m_fd, static_cast<off_t>(tableBytes)) != 0) return false; // zero-filled index
+    const Header header{MAGIC, VERSION, static_cast<uint32_t>(m_width), static_cast<uint32_t>(m_height),
+                        m_key.rendererVersion, m_frameCapacity, m_key.windowUs, m_key.overlapUs};
+    return writeAll(m_fd, &header, sizeof(header), 0);
+}
+
+bool EventFrameDiskCache::remapIfNeeded(uint64_t requiredBytes) const {
+    // Caller holds m_mapMutex (or is the constructor)
+    if (m_map && requiredBytes <= m_mappedBytes) return true;
+    struct stat st{};
+    if (::fstat(m_fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < requiredBytes) return false;
+    if (m_map) ::munmap(const_cast<uint8_t*>(m_map), m_mappedBytes);
+    void* map = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, m_fd, 0);
+    if (map == MAP_FAILED) {
+        m_map = nullptr;
+        m_mappedBytes = 0;
+        return false;
+    }
+    ::madvise(map, static_cast<size_t>(st.st_size), MADV_RANDOM);
+    m_map = static_cast<const uint8_t*>(map);
+    m_mappedBytes = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+const EventFrameDiskCache::IndexEntry* EventFrameDiskCache::entry(size_t frameIndex) const {
+    if (!m_map || frameIndex >= m_frameCapacity) return nullptr;
+    const auto* table = reinterpret_cast<const IndexEntry*>(m_map + sizeof(Header));
+    const IndexEntry* e = &table[frameIndex];
+    return (e->offset != 0 && e->size != 0) ? e : nullptr;
+}
+
+bool EventFrameDiskCache::contains(size_t frameIndex) const {
+    std::lock_guard<std::mutex> lock(m_mapMutex);
+    return entry(frameIndex) != nullptr;
+}
+
+bool EventFrameDiskCache::read(size_t frameIndex, std::vector<uint8_t>& plane) const {
+    std::lock_guard<std::mutex> lock(m_mapMutex);
+    const IndexEntry* e = entry(frameIndex);
+    if (!e) return false;
+    const uint64_t offset = e->offset;
+    const uint32_t size = e->size;
+    if (!remapIfNeeded(offset + size)) return false;
+    plane.resize(static_cast<size_t>(m_width) * static_cast<size_t>(m_height));
+    return decodeRle(m_map + offset, size, plane.data(), plane.size());
+}
+
+size_t EventFrameDiskCache::cachedFrameCount() const {
+    std::lock_guard<std::mutex> lock(m_mapMutex);
+    size_t count = 0;
+    for (size_t i = 0; i < m_frameCapacity; ++i) {
+        if (entry(i)) ++count;
+    }
+    return count;
+}
+
+void EventFrameDiskCache::store(size_t frameIndex, std::vector<uint8_t> plane) {
+    if (!m_writable || frameIndex >= m_frameCapacity ||
+        plane.size() != static_cast<size_t>(m_width) * static_cast<size_t>(m_height)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (m_queue.size() >= MAX_PENDING_WRITES) return; // playback comes first
+        m_queue.emplace_back(frameIndex, std::move(plane));
+    }
+    m_queueCondition.notify_one();
+}
+
+void EventFrameDiskCache::flush() {
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    m_idleCondition.wait(lock, [this] { return m_queue.empty() && !m_writing; });
+}
+
+void EventFrameDiskCache::writerLoop() {
+    std::vector<uint8_t> encoded;
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    while (true) {
+        m_queueCondition.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+        if (m_queue.empty()) break; // stopping and drained
+        auto [frameIndex, plane] = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_writing = true;
+        lock.unlock();
+
+        bool alreadyCached = false;
+        {
+            std::lock_guard<std::mutex> mapLock(m_mapMutex);
+            alreadyCached = entry(frameIndex) != nullptr;
+        }
+        if (!alreadyCached) {
+            encodeRle(plane.data(), plane.size(), encoded);
+            const uint64_t offset = m_fileSize;
+            // Data first, then the index entry that makes it visible
+            if (writeAll(m_fd, encoded.data(), encoded.size(), offset)) {
+                m_fileSize += encoded.size();
+                const IndexEntry newEntry{offset, static_cast<uint32_t>(encoded.size()), 0};
+                std::lock_guard<std::mutex> mapLock(m_mapMutex);
+                writeAll(m_fd, &newEntry, sizeof(newEntry), sizeof(Header) + frameIndex * sizeof(IndexEntry));
+            }
+        }
+
+        lock.lock();
+        m_writing = false;
+        m_idleCondition.notify_all();
+    }
+}
+
+void EventFrameDiskCache::encodeRle(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    out.clear();
+    size_t i = 0;
+    while (i < size) {
+        const uint8_t value = data[i];
+        size_t run = 1;
+        while (i + run < size && data[i + run] == value) ++run;
+        out.push_back(value);
+        uint64_t length = run;
+        do {
+            uint8_t byte = length & 0x7f;
+            length >>= 7;
+            if (length) byte |= 0x80;
+            out.push_back(byte);
+        } while (length);
+        i += run;
+    }
+}
+
+bool EventFrameDiskCache::decodeRle(const uint8_t* data, size_t size, uint8_t* out, size_t outSize) {
+    size_t in = 0;
+    size_t written = 0;
+    while (in < size) {
+        const uint8_t value = data[in++];
+        uint64_t length = 0;
+        int shift = 0;
+        while (true) {
+            if (in >= size || shift > 56) return false;
+            const uint8_t byte = data[in++];
+            length |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) break;
+            shift += 7;
+        }
+        if (length > outSize - written) return false;
+        std::memset(out + written, value, static_cast<size_t>(length));
+        written += static_cast<size_t>(length);
+    }
+    return written == outSize;
+}
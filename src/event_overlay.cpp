@@ -0,0 +1,81 @@
+#include "event_overlay.h"
+
+#include <algorithm>
+#include <filesystem>
+
+EventOverlay::RemapTable EventOverlay::buildRemapTable(const cv::Matx33d &eventToFrame, cv::Size eventSize,
+                                                       cv::Size frameSize) {
+    RemapTable table;
+    table.frameSize = frameSize;
+    table.eventSize = eventSize;
+    if (frameSize.area() == 0 || eventSize.area() == 0) return table;
+
+    const cv::Matx33d frameToEvent = eventToFrame.inv();
+    cv::Mat mapX(frameSize, CV_32FC1);
+    cv::Mat mapY(frameSize, CV_32FC1);
+    for (int v = 0; v < frameSize.height; ++v) {
+        auto *xs = mapX.ptr<float>(v);
+        auto *ys = mapY.ptr<float>(v);
+        for (int u = 0; u < frameSize.width; ++u) {
+            const double w = frameToEvent(2, 0) * u + frameToEvent(2, 1) * v + frameToEvent(2, 2);
+            if (std::abs(w) < 1e-12) {
+                xs[u] = ys[u] = -1.0f; // maps to the border value
+                continue;
+            }
+            xs[u] = static_cast<float>((frameToEvent(0, 0) * u + frameToEvent(0, 1) * v + frameToEvent(0, 2)) / w);
+            ys[u] = static_cast<float>((frameToEvent(1, 0) * u + frameToEvent(1, 1) * v + frameToEvent(1, 2)) / w);
+        }
+    }
+    // Fixed-point maps are considerably faster to apply than float maps
+    cv::convertMaps(mapX, mapY, table.map1, table.map2, CV_16SC2);
+    return table;
+}
+
+cv::Matx33d EventOverlay::defaultHomography(cv::Size eventSize, cv::Size frameSize) {
+    if (eventSize.area() == 0 || frameSize.area() == 0) return cv::Matx33d::eye();
+    const double scale = std::min(static_cast<double>(frameSize.width) / eventSize.width,
+                                  static_cast<double>(frameSize.height) / eventSize.height);
+    const double offsetX = (frameSize.width - scale * eventSize.width) / 2.0;
+    const double offsetY = (frameSize.height - scale * eventSize.height) / 2.0;
+    return cv::Matx33d(scale, 0.0, offsetX,
+                       0.0, scale, offsetY,
+                       0.0, 0.0, 1.0);
+}
+
+std::string EventOverlay::calibrationKey(const std::string &eventStream, const std::string &frameStream) {
+    return eventStream + "_to_" + frameStream;
+}
+
+bool EventOverlay::loadHomography(const std::string &recordingDir, const std::string &eventStream,
+                                  const std::string &frameStream, cv::Matx33d &eventToFrame) {
+    const auto path = std::filesystem::path(recordingDir) / CALIBRATION_FILE;
+    if (!std::filesystem::exists(path)) return false;
+    try {
+        cv::FileStorage storage(path.string(), cv::FileStorage::READ);
+        cv::Mat matrix;
+        storage[calibrationKey(eventStream, frameStream)] >> matrix;
+        if (matrix.rows != 3 || matrix.cols != 3) return false;
+        matrix.convertTo(matrix, CV_64F);
+        eventToFrame = cv::Matx33d(matrix);
+        return true;
+    } catch (const cv::Exception &) {
+        return false;
+    }
+}
+
+void EventOverlay::blend(cv::Mat &frame, const cv::Mat &eventImage, const RemapTable &table,
+                         const cv::Scalar &background, double alpha) {
+    if (table.empty() || eventImage.empty() || frame.size() != table.frameSize) return;
+    if (frame.channels() == 1) {
+        cv::cvtColor(frame, frame, cv::COLOR_GRAY2BGR);
+    }
+    if (eventImage.type() != frame.type()) return;
+
+    cv::Mat warped;
+    cv::remap(eventImage, warped, table.map1, table.map2, cv::INTER_NEAREST, cv::BORDER_CONSTANT, background);
+    cv::Mat backgroundMask;
+    cv::inRange(warped, background, background, backgroundMask);
+    cv::Mat blended;
+    cv::addWeighted(frame, 1.0 - alpha, warped, alpha, 0.0, blended);
+    blended.copyTo(frame, ~backgroundMask);
+}
@@ -0,0 +1,165 @@
+#include "event_playback_engine.h"
+
+#include <algorithm>
+
+EventPlaybackEngine::EventPlaybackEngine(size_t streamCount, size_t frameCount, RenderFn render)
+    : EventPlaybackEngine(streamCount, frameCount, std::move(render), Options{}) {}
+
+EventPlaybackEngine::EventPlaybackEngine(size_t streamCount, size_t frameCount, RenderFn render, Options options)
+    : m_streamCount(streamCount), m_frameCount(frameCount), m_render(std::move(render)), m_options(options) {
+    const size_t workers = m_options.workers > 0 ? m_options.workers : std::max<size_t>(2, streamCount);
+    m_workers.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        m_workers.emplace_back(&EventPlaybackEngine::workerMain, this);
+    }
+}
+
+EventPlaybackEngine::~EventPlaybackEngine() {
+    stop();
+}
+
+void EventPlaybackEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+        m_stopping = true;
+    }
+    m_workCv.notify_all();
+    m_readyCv.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void EventPlaybackEngine::setFrameSetCallback(FrameSetCallback callback) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_callback = std::move(callback);
+}
+
+void EventPlaybackEngine::setCursor(size_t frameIndex) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cursor = frameIndex;
+        pruneBehind(frameIndex);
+    }
+    m_workCv.notify_all();
+}
+
+void EventPlaybackEngine::setPaused(bool paused) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paused = paused;
+    }
+    m_workCv.notify_all();
+}
+
+EventPlaybackEngine::FrameSet EventPlaybackEngine::waitForFrameSet(size_t frameIndex, std::chrono::milliseconds timeout) {
+    FrameSet set;
+    set.frameIndex = frameIndex;
+    set.ready.assign(m_streamCount, false);
+    if (frameIndex >= m_frameCount) {
+        set.late = true;
+        return set;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    // Requested outside the scheduled window (e.g. a seek not announced yet) or while paused
+    // (only the cursor frame is scheduled then): render it first
+    if (m_paused || frameIndex < m_cursor.load() || frameIndex >= m_cursor.load() + m_options.lookahead) {
+        m_cursor = frameIndex;
+        pruneBehind(frameIndex);
+    }
+    slotsFor(frameIndex);
+    m_workCv.notify_all();
+
+    const bool done = m_readyCv.wait_for(lock, timeout, [this, frameIndex] {
+        if (m_stopping) return true;
+        auto it = m_slots.find(frameIndex);
+        return it == m_slots.end() || isComplete(it->second);
+    });
+    auto it = m_slots.find(frameIndex);
+    if (it != m_slots.end()) {
+        for (size_t s = 0; s < m_streamCount; ++s) set.ready[s] = it->second[s] == SlotState::Ready;
+        set.complete = isComplete(it->second);
+    }
+    set.late = !done || !set.complete;
+    return set;
+}
+
+size_t EventPlaybackEngine::readyAhead() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (size_t frame = m_cursor.load(); frame < m_frameCount; ++frame, ++count) {
+        auto it = m_slots.find(frame);
+        if (it == m_slots.end() || !isComplete(it->second)) break;
+    }
+    return count;
+}
+
+bool EventPlaybackEngine::isComplete(const std::vector<SlotState>& slots) const {
+    return std::all_of(slots.begin(), slots.end(),
+                       [](SlotState s) { return s == SlotState::Ready || s == SlotState::Failed; });
+}
+
+std::vector<EventPlaybackEngine::SlotState>& EventPlaybackEngine::slotsFor(size_t frameIndex) {
+    auto it = m_slots.find(frameIndex);
+    if (it == m_slots.end()) {
+        it = m_slots.emplace(frameIndex, std::vector<SlotState>(m_streamCount, SlotState::Pending)).first;
+    }
+    return it->second;
+}
+
+void EventPlaybackEngine::pruneBehind(size_t cursor) {
+    // Frames behind the cursor or beyond the window are no longer scheduled; the stream
+    // caches keep what was rendered, so coming back to them is cheap
+    const size_t windowEnd = cursor + m_options.lookahead;
+    m_slots.erase(m_slots.begin(), m_slots.lower_bound(cursor));
+    m_slots.erase(m_slots.lower_bound(windowEnd), m_slots.end());
+}
+
+bool EventPlaybackEngine::nextJob(Job& job) {
+    // Earliest instant first and all streams of an instant together: the views stay in lockstep
+    const size_t cursor = m_cursor.load();
+    const size_t windowEnd = std::min(m_frameCount, cursor + (m_paused ? 1 : m_options.lookahead));
+    for (size_t frame = cursor; frame < windowEnd; ++frame) {
+        auto& slots = slotsFor(frame);
+        for (size_t stream = 0; stream < m_streamCount; ++stream) {
+            if (slots[stream] == SlotState::Pending) {
+                slots[stream] = SlotState::Rendering;
+                job = Job{stream, frame};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void EventPlaybackEngine::workerMain() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        Job job;
+        m_workCv.wait(lock, [this, &job] { return m_stopping || nextJob(job); });
+        if (m_stopping) break;
+
+        lock.unlock();
+        bool rendered = false;
+        try {
+            rendered = m_render(job.stream, job.frameIndex);
+        } catch (...) {
+            rendered = false;
+        }
+        lock.lock();
+
+        auto it = m_slots.find(job.frameIndex);
+        if (it == m_slots.end()) continue; // pruned by a seek while rendering
+        it->second[job.stream] = rendered ? SlotState::Ready : SlotState::Failed;
+        if (!isComplete(it->second)) continue;
+
+        m_readyCv.notify_all();
+        if (m_callback) {
+            const auto callback = m_callback;
+            lock.unlock();
+            callback(job.frameIndex);
+            lock.lock();
+        }
+    }
+}
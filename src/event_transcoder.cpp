@@ -0,0 +1,308 @@
+#include "event_transcoder.h"
+#include "event_camera_manager.h"
+#include "hdf5_event_writer.h"
+#include "session_manifest.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <hdf5.h>
+#include <metavision/sdk/stream/camera.h>
+#include <metavision/sdk/stream/file_config_hints.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr uint64_t WRITE_BATCH_EVENTS = 1u << 20; // events buffered per HDF5 write
+constexpr hsize_t VERIFY_BLOCK_EVENTS = 1u << 20;   // events read back per HDF5 call
+constexpr int TRANSCODE_NICE = 10;              // stay out of the way of the capture threads
+
+// Decode a recording from start to end as fast as possible
+template <typename OnCd, typename OnTrigger>
+void decodeFile(const fs::path& file, OnCd onCd, OnTrigger onTrigger) {
+    Metavision::Camera camera = Metavision::Camera::from_file(file.string(), Metavision::FileConfigHints().real_time_playback(false));
+    camera.cd().add_callback(onCd);
+    try {
+        camera.ext_trigger().add_callback(onTrigger);
+    } catch (const std::exception&) {
+        // No trigger facility in this file
+    }
+    camera.start();
+    while (camera.is_running()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    camera.stop();
+}
+
+// Read the timestamps of /<group>/events back in blocks, taking the shared HDF5 lock only per
+// library call so live sinks keep writing in between. Every chunk is decompressed on the way;
+// throws if a read fails or CD time goes backwards. Returns the number of rows read.
+uint64_t readBackEvents(hid_t file, const char* group, bool checkOrder) {
+    std::mutex& hdf5Mutex = EventCameraManager::hdf5Mutex();
+    const std::string name = std::string("/") + group + "/events";
+    hid_t dataset = -1;
+    hid_t space = -1;
+    hid_t timeType = -1;
+    hsize_t rows = 0;
+    {
+        std::lock_guard<std::mutex> hdf5Lock(hdf5Mutex);
+        dataset = H5Dopen2(file, name.c_str(), H5P_DEFAULT);
+        if (dataset < 0) throw std::runtime_error("missing " + name);
+        space = H5Dget_space(dataset);
+        H5Sget_simple_extent_dims(space, &rows, nullptr);
+        timeType = H5Tcreate(H5T_COMPOUND, sizeof(int64_t));
+        H5Tinsert(timeType, "t", 0, H5T_NATIVE_INT64);
+    }
+    auto release = [&] {
+        std::lock_guard<std::mutex> hdf5Lock(hdf5Mutex);
+        H5Tclose(timeType);
+        H5Sclose(space);
+        H5Dclose(dataset);
+    };
+
+    std::vector<int64_t> times;
+    int64_t previous = std::numeric_limits<int64_t>::min();
+    uint64_t read = 0;
+    while (read < rows) {
+        const hsize_t count[1] = {std::min<hsize_t>(rows - read, VERIFY_BLOCK_EVENTS)};
+        const hsize_t start[1] = {read};
+        times.resize(count[0]);
+        herr_t status = -1;
+        {
+            std::lock_guard<std::mutex> hdf5Lock(hdf5Mutex);
+            const hid_t memSpace = H5Screate_simple(1, count, nullptr);
+            H5Sselect_hyperslab(space, H5S_SELECT_SET, start, nullptr, count, nullptr);
+            status = H5Dread(dataset, timeType, memSpace, space, H5P_DEFAULT, times.data());
+            H5Sclose(memSpace);
+        }
+        if (status < 0) {
+            release();
+            throw std::runtime_error("reading " + name + " failed at row " + std::to_string(read));
+        }
+        if (checkOrder) {
+            for (const int64_t t : times) {
+                if (t < previous) {
+                    release();
+                    throw std::runtime_error(name + " goes back in time at row " + std::to_string(read));
+                }
+                previous = t;
+            }
+        }
+        read += count[0];
+    }
+    release();
+    return read;
+}
+
+void syncDirectory(const fs::path& directory) {
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+} // namespace
+
+EventTranscoder::EventTranscoder()
+    : m_jobs("take(s) to be transcoded to HDF5",
+             [this](const Job& job, std::string& message) { return transcodeTake(job, message); },
+             [](const Job& job, bool ok, const std::string& message) {
+                 if (ok) {
+                     EBV_LOG_INFO << "Transcoded " << job.takeDirectory << ": " << message;
+                 } else {
+                     EBV_LOG_ERROR << "Transcoding failed for " << job.takeDirectory << ": " << message;
+                 }
+             }) {}
+
+bool EventTranscoder::transcodeTake(const Job& job, std::string& message) {
+    const auto start = std::chrono::steady_clock::now();
+    SessionManifest manifest;
+    manifest.load(job.takeDirectory);
+
+    // RAW files live in the take directory or, for striped takes, in their stream directories
+    std::set<fs::path> directories{job.takeDirectory};
+    for (const auto& key : manifest.keysWithPrefix("stream.")) {
+        directories.insert(manifest.get(key));
+    }
+    std::vector<fs::path> rawFiles;
+    for (const auto& directory : directories) {
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(directory, ec)) {
+            const auto name = entry.path().filename().string();
+            if (entry.is_regular_file() && name.rfind("ebv_cam_", 0) == 0 && entry.path().extension() == ".raw") {
+                rawFiles.push_back(entry.path());
+            }
+        }
+    }
+    if (rawFiles.empty()) {
+        message = "no RAW event files";
+        return true;
+    }
+
+    // One thread per camera: decoding and compression run in parallel, HDF5 writes are serialized
+    std::vector<std::string> errors(rawFiles.size());
+    std::vector<uint64_t> counts(rawFiles.size(), 0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < rawFiles.size(); ++i) {
+        threads.emplace_back([&, i] {
+            ::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), TRANSCODE_NICE);
+            auto target = rawFiles[i];
+            target.replace_extension(".hdf5");
+            try {
+                counts[i] = transcodeFile(rawFiles[i], target);
+            } catch (const std::exception& e) {
+                errors[i] = e.what();
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    bool ok = true;
+    uint64_t totalEvents = 0;
+    for (size_t i = 0; i < rawFiles.size(); ++i) {
+        const auto stream = rawFiles[i].stem().string();
+        if (!errors[i].empty()) {
+            ok = false;
+            manifest.set("transcode." + stream, "failed");
+            message += stream + ": " + errors[i] + "; ";
+            continue;
+        }
+        manifest.set("transcode." + stream, "ok");
+        totalEvents += counts[i];
+    }
+    // The take switches format as a whole: if any camera failed, every RAW file stays and the
+    // verified .hdf5 of the others sit next to them (the loader prefers them per camera)
+    if (ok) manifest.set("event.format", "hdf5");
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    manifest.set("transcode.seconds", std::to_string(seconds));
+    manifest.save(job.takeDirectory);
+    if (ok && !job.keepRaw) {
+        for (const auto& rawFile : rawFiles) {
+            std::error_code ec;
+            fs::remove(rawFile, ec);
+        }
+    }
+
+    if (ok) {
+        message = std::to_string(rawFiles.size()) + " file(s), " + std::to_string(totalEvents) +
+                  " events in " + std::to_string(seconds) + " s";
+    }
+    return ok;
+}
+
+uint64_t EventTranscoder::transcodeFile(const fs::path& rawFile, const fs::path& hdf5File) {
+    // Keep the .hdf5 extension on the temporary name so it can be opened for verification
+    auto partial = hdf5File;
+    partial.replace_extension(".transcoding.hdf5");
+    std::error_code ec;
+    fs::remove(partial, ec);
+
+    uint64_t written = 0;
+    uint64_t triggers = 0;
+    std::unique_ptr<Hdf5EventWriter> writer;
+    auto closeWriter = [&writer] {
+        if (!writer) return;
+        writer->encodeChunks(true);
+        std::lock_guard<std::mutex> hdf5Lock(EventCameraManager::hdf5Mutex());
+        writer->close();
+        writer.reset();
+    };
+    try {
+        {
+            // Recording metadata comes from the source file
+            Metavision::Camera source = Metavision::Camera::from_file(rawFile.string(), Metavision::FileConfigHints().real_time_playback(false));
+            const auto serial = source.get_camera_configuration().serial_number;
+            const auto geometry = std::to_string(source.geometry().get_width()) + "x" +
+                                  std::to_string(source.geometry().get_height());
+            std::lock_guard<std::mutex> hdf5Lock(EventCameraManager::hdf5Mutex());
+            writer = std::make_unique<Hdf5EventWriter>(partial.string());
+            writer->addMetadata("serial_number", serial);
+            writer->addMetadata("geometry", geometry);
+        }
+
+        // Compression runs on this camera's thread; the shared lock only covers storing the chunks
+        uint64_t buffered = 0;
+        auto flush = [&] {
+            writer->encodeChunks();
+            std::lock_guard<std::mutex> hdf5Lock(EventCameraManager::hdf5Mutex());
+            writer->writeEncodedChunks();
+            buffered = 0;
+        };
+
+        decodeFile(rawFile,
+            [&](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+                writer->bufferCdEvents(begin, end);
+                written += static_cast<uint64_t>(end - begin);
+                buffered += static_cast<uint64_t>(end - begin);
+                if (buffered >= WRITE_BATCH_EVENTS) flush();
+            },
+            [&](const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end) {
+                writer->bufferTriggerEvents(begin, end);
+                triggers += static_cast<uint64_t>(end - begin);
+            });
+        closeWriter();
+    } catch (const std::exception& e) {
+        try {
+            closeWriter();
+        } catch (...) {
+            // The destructor closes the file without throwing, still under the lock
+            std::lock_guard<std::mutex> hdf5Lock(EventCameraManager::hdf5Mutex());
+            writer.reset();
+        }
+        fs::remove(partial, ec);
+        throw std::runtime_error("Failed to transcode " + rawFile.string() + ": " + e.what());
+    }
+
+    // Verify: the new file must read back exactly the CD and trigger events that were written
+    uint64_t verified = 0;
+    uint64_t verifiedTriggers = 0;
+    try {
+        hid_t file = -1;
+        {
+            std::lock_guard<std::mutex> hdf5Lock(EventCameraManager::hdf5Mutex());
+            file = H5Fopen(partial.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        }
+        if (file < 0) throw std::runtime_error("cannot open the file");
+        try {
+            verified = readBackEvents(file, "CD", true);
+            verifiedTriggers = readBackEvents(file, "EXT_TRIGGER", false);
+        } catch (...) {
+            std::lock_guard<std::mutex> hdf5Lock(EventCameraManager::hdf5Mutex());
+            H5Fclose(file);
+            throw;
+        }
+        std::lock_guard<std::mutex> hdf5Lock(EventCameraManager::hdf5Mutex());
+        H5Fclose(file);
+    } catch (const std::exception& e) {
+        fs::remove(partial, ec);
+        throw std::runtime_error("Verification of " + partial.string() + " failed: " + e.what());
+    }
+    if (verified != written || verifiedTriggers != triggers) {
+        fs::remove(partial, ec);
+        throw std::runtime_error("Verification of " + partial.string() + " failed: wrote " + std::to_string(written) +
+                                 " events and " + std::to_string(triggers) + " triggers, read back " +
+                                 std::to_string(verified) + " and " + std::to_string(verifiedTriggers));
+    }
+
+    // Durable before it becomes visible under the final name
+    const int fd = ::open(partial.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+    fs::rename(partial, hdf5File);
+    syncDirectory(hdf5File.parent_path());
+    EBV_LOG_INFO << "Transcoded " << rawFile << " -> " << hdf5File << " (" << written << " events, "
+              << triggers << " triggers)";
+    return written;
+}
@@ -1,9 +1,12 @@
 #include <filesystem>
 #include "frame_camera_manager.h"
-#include <iostream>
+#include "live_data_bus.h"
+#include "logger.h"
+#include "stream_layout.h"
 #include <stdexcept>
 #include <iomanip>
 #include <chrono>
+#include <algorithm>
 #include <peak/peak.hpp>
 #include <peak_ipl/peak_ipl.hpp>
 #include <peak/converters/peak_buffer_converter_ipl.hpp>
@@ -12,8 +15,8 @@
 FrameCameraManager::FrameCameraManager() {
     peak::Library::Initialize();
     const auto peakVersion = peak::Library::Version();
-    std::cout << "Using PEAK SDK version: " << peakVersion.Major() << "." 
-              << peakVersion.Minor() << "." << peakVersion.Subminor() << std::endl;
+    EBV_LOG_INFO << "Using PEAK SDK version: " << peakVersion.Major() << "." 
+              << peakVersion.Minor() << "." << peakVersion.Subminor();
 }
 
 FrameCameraManager::~FrameCameraManager() {
@@ -33,7 +36,7 @@ void FrameCameraManager::openAndSetupDevices() {
         auto device = deviceDescriptor->OpenDevice(peak::core::DeviceAccessType::Control);
         m_devices.push_back(device);
         setupDevice(device);
-        std::cout << "Set up frame camera with serial number: " << deviceDescriptor->SerialNumber() << std::endl;
+        EBV_LOG_INFO << "Set up frame camera with serial number: " << deviceDescriptor->SerialNumber();
     }
 }
 
@@ -59,9 +62,10 @@ void FrameCameraManager::setupDevice(std::shared_ptr<peak::core::Device> device)
     const auto payloadSize = remoteNodemap->FindNode<peak::core::nodes::IntegerNode>("PayloadSize")->Value();
     const auto bufferCountMax = dataStream->NumBuffersAnnouncedMinRequired();
 
+    // Buffers stay announced for the lifetime of the device; they are (re)queued on every
+    // acquisition start so the camera can be stopped and restarted without reallocation
     for (size_t i = 0; i < bufferCountMax; ++i) {
-        auto buffer = dataStream->AllocAndAnnounceBuffer(static_cast<size_t>(payloadSize), nullptr);
-        dataStream->QueueBuffer(buffer);
+        dataStream->AllocAndAnnounceBuffer(static_cast<size_t>(payloadSize), nullptr);
     }
 
     remoteNodemap->FindNode<peak::core::nodes::IntegerNode>("TLParamsLocked")->SetValue(1);
@@ -75,8 +79,7 @@ void FrameCameraManager::startRecording(const std::string& outputPath) {
     }
     // Start disk writer if not running
     if (!m_writingToDisk) {
-        m_writingToDisk = true;
-        m_diskWriterThread = std::thread(&FrameCameraManager::diskWriterWorker, this, outputPath);
+        beginWriting(outputPath);
     }
 }
 
@@ -88,6 +91,14 @@ void FrameCameraManager::stopRecording() {
         if (m_diskWriterThread.joinable()) {
             m_diskWriterThread.join();
         }
+        std::shared_ptr<WriterTake> take;
+        {
+            std::lock_guard<ProfiledMutex> lock(m_queueMutex);
+            const auto it = m_writerTakes.find(m_currentTake);
+            if (it != m_writerTakes.end()) take = it->second;
+            m_writerTakes.clear();
+        }
+        m_lastTakeSummaries = take ? summarize(*take) : std::vector<StreamSummary>{};
     }
     // If acquisition was started as part of recording and preview isn't desired, caller can stopPreview()
 }
@@ -106,8 +117,7 @@ void FrameCameraManager::stopPreview() {
 void FrameCameraManager::startRecordingToPath(const std::string& outputPath) {
     // assumes acquisition already running
     if (!m_writingToDisk) {
-        m_writingToDisk = true;
-        m_diskWriterThread = std::thread(&FrameCameraManager::diskWriterWorker, this, outputPath);
+        beginWriting(outputPath);
     }
 }
 
@@ -115,6 +125,55 @@ void FrameCameraManager::stopRecordingOnly() {
     stopRecording();
 }
 
+void FrameCameraManager::switchRecordingPath(const std::string& outputPath) {
+    if (!m_writingToDisk) {
+        beginWriting(outputPath);
+        return;
+    }
+    auto next = makeWriterTake(outputPath);
+    std::shared_ptr<WriterTake> previous;
+    {
+        ProfiledUniqueLock lock(m_queueMutex);
+        const uint64_t previousTake = m_currentTake;
+        previous = m_writerTakes[previousTake];
+        m_writerTakes[++m_currentTake] = std::move(next);
+        // Capture and writer keep running: new frames queue up behind the old take's frames
+        m_takeDrainedCondition.wait(lock, [&previous] { return !previous || previous->pendingFrames == 0; });
+        m_writerTakes.erase(previousTake);
+    }
+    m_lastTakeSummaries = previous ? summarize(*previous) : std::vector<StreamSummary>{};
+}
+
+void FrameCameraManager::beginWriting(const std::string& outputPath) {
+    auto take = makeWriterTake(outputPath);
+    {
+        std::lock_guard<ProfiledMutex> lock(m_queueMutex);
+        m_writerTakes.clear();
+        m_writerTakes[++m_currentTake] = std::move(take);
+    }
+    m_writingToDisk = true;
+    m_diskWriterThread = std::thread(&FrameCameraManager::diskWriterWorker, this);
+}
+
+std::shared_ptr<FrameCameraManager::WriterTake> FrameCameraManager::makeWriterTake(const std::string& outputPath) const {
+    auto take = std::make_shared<WriterTake>();
+    for (size_t i = 0; i < m_devices.size(); ++i) {
+        const bool striped = i < m_streamDirectories.size() && !m_streamDirectories[i].empty();
+        take->cameraDirs.push_back(std::filesystem::path(striped ? m_streamDirectories[i] : outputPath) / StreamLayout::frameStreamName(i));
+        std::filesystem::create_directories(take->cameraDirs.back());
+        take->statistics.push_back(std::make_unique<StreamStatistics>());
+    }
+    return take;
+}
+
+std::vector<StreamSummary> FrameCameraManager::summarize(const WriterTake& take) const {
+    std::vector<StreamSummary> summaries;
+    for (size_t i = 0; i < take.statistics.size(); ++i) {
+        summaries.push_back(take.statistics[i]->summary(StreamLayout::frameStreamName(i), false));
+    }
+    return summaries;
+}
+
 void FrameCameraManager::acquisitionWorker(int deviceId) {
     static std::vector<int> frameIndices(m_devices.size(), 0);
 
@@ -122,18 +181,26 @@ void FrameCameraManager::acquisitionWorker(int deviceId) {
     auto lastFpsReport = std::chrono::steady_clock::now();
     int framesSinceLastReport = 0;
     constexpr auto FPS_REPORT_INTERVAL = std::chrono::seconds(1);
+    const auto heartbeat = m_watchdog ? m_watchdog->registerStage("frame_capture" + std::to_string(deviceId), CAPTURE_STALL_THRESHOLD) : nullptr;
 
     while (m_acquiring) {
         try {
-            auto buffer = m_dataStreams[deviceId]->WaitForFinishedBuffer(1000);
+            // One scope per SDK call, so a stall report names the call that blocked
+            auto buffer = [&] {
+                StallWatchdog::Heartbeat::Scope watched(heartbeat.get(), "WaitForFinishedBuffer");
+                return m_dataStreams[deviceId]->WaitForFinishedBuffer(1000);
+            }();
             
             if (!m_acquiring) {
                 m_dataStreams[deviceId]->QueueBuffer(buffer);
                 break;
             }
             
-            const auto image = peak::BufferTo<peak::ipl::Image>(buffer).ConvertTo(
-                peak::ipl::PixelFormatName::BGRa8, peak::ipl::ConversionMode::Fast);
+            const auto image = [&] {
+                StallWatchdog::Heartbeat::Scope watched(heartbeat.get(), "ConvertTo");
+                return peak::BufferTo<peak::ipl::Image>(buffer).ConvertTo(
+                    peak::ipl::PixelFormatName::BGRa8, peak::ipl::ConversionMode::Fast);
+            }();
 
             cv::Mat cvImage(
                 image.Height(),
@@ -150,9 +217,19 @@ void FrameCameraManager::acquisitionWorker(int deviceId) {
             frameData.frameIndex = frameIndices[deviceId]++;
             frameData.timestamp = std::chrono::steady_clock::now();
             
+            // Fan out to bus subscribers; the packet shares the cloned pixel buffer
+            if (m_liveBus && m_liveBus->frames.hasSubscribers()) {
+                auto packet = std::make_shared<LiveFramePacket>();
+                packet->image = frameData.image;
+                packet->cameraId = deviceId;
+                packet->frameIndex = static_cast<size_t>(frameData.frameIndex);
+                packet->timestamp = frameData.timestamp;
+                m_liveBus->frames.publish(std::move(packet));
+            }
+
             // Update latest frame for preview access
             {
-                std::lock_guard<std::mutex> lm(m_latestMutex);
+                std::lock_guard<ProfiledMutex> lm(m_latestMutex);
                 if (deviceId >= 0 && deviceId < static_cast<int>(m_latestFrames.size())) {
                     m_latestFrames[deviceId] = frameData;
                 }
@@ -160,16 +237,33 @@ void FrameCameraManager::acquisitionWorker(int deviceId) {
             
             // If writing to disk, add frame to writer queue (with queue size limiting)
             if (m_writingToDisk) {
-                std::unique_lock<std::mutex> lock(m_queueMutex);
-                if (m_frameQueue.size() < MAX_QUEUE_SIZE) {
+                ProfiledUniqueLock lock(m_queueMutex);
+                const size_t frameBytes = frameData.image.total() * frameData.image.elemSize();
+                const auto current = m_writerTakes.find(m_currentTake);
+                if (current == m_writerTakes.end()) {
+                    // Writer is being stopped
+                } else if (m_frameQueue.size() < MAX_QUEUE_SIZE) {
+                    frameData.take = m_currentTake;
+                    ++current->second->pendingFrames;
                     m_frameQueue.push(frameData); // copy
+                    m_queueMemory.add(frameBytes);
                     m_queueCondition.notify_one();
                 } else {
                     // Queue is full, drop oldest frame to make space
-                    std::cerr << "Warning: Frame queue full for device " << deviceId 
-                             << ", dropping oldest frame" << std::endl;
+                    EBV_LOG_WARN_EVERY(1) << "Frame queue full for device " << deviceId 
+                             << ", dropping oldest frame";
+                    const FrameData& dropped = m_frameQueue.front();
+                    m_queueMemory.release(dropped.image.total() * dropped.image.elemSize());
+                    const auto droppedTake = m_writerTakes.find(dropped.take);
+                    if (droppedTake != m_writerTakes.end()) {
+                        droppedTake->second->statistics[dropped.deviceId]->addDroppedFrames();
+                        if (--droppedTake->second->pendingFrames == 0) m_takeDrainedCondition.notify_all();
+                    }
                     m_frameQueue.pop();
+                    frameData.take = m_currentTake;
+                    ++current->second->pendingFrames;
                     m_frameQueue.push(frameData);
+                    m_queueMemory.add(frameBytes);
                     m_queueCondition.notify_one();
                 }
             }
@@ -182,34 +276,33 @@ void FrameCameraManager::acquisitionWorker(int deviceId) {
             if (timeSinceLastReport >= FPS_REPORT_INTERVAL) {
                 double elapsed_seconds = std::chrono::duration<double>(timeSinceLastReport).count();
                 double fps = framesSinceLastReport / elapsed_seconds;
-                std::cout << "Frame Camera " << deviceId << " FPS: " << std::fixed << std::setprecision(2) 
+                EBV_LOG_INFO << "Frame Camera " << deviceId << " FPS: " << std::fixed << std::setprecision(2) 
                          << fps << " (frames: " << framesSinceLastReport << " in " 
-                         << std::setprecision(1) << elapsed_seconds << "s)" << std::endl;
+                         << std::setprecision(1) << elapsed_seconds << "s)";
+                if (m_liveBus) {
+                    m_liveBus->publishStat("frame_cam" + std::to_string(deviceId), "fps", fps);
+                }
                 
                 // Reset counters
                 lastFpsReport = currentTime;
                 framesSinceLastReport = 0;
             }
                     
+            StallWatchdog::Heartbeat::Scope watched(heartbeat.get(), "QueueBuffer");
             m_dataStreams[deviceId]->QueueBuffer(buffer);
         } catch (const std::exception& e) {
-            std::cerr << "Acquisition error on device " << deviceId << ": " << e.what() << std::endl;
+            EBV_LOG_ERROR << "Acquisition error on device " << deviceId << ": " << e.what();
         }
     }
 }
 
-void FrameCameraManager::diskWriterWorker(const std::string& outputPath) {
-    // Create output directories for each camera
-    std::vector<std::filesystem::path> cameraDirs(m_devices.size());
-    for (size_t i = 0; i < m_devices.size(); ++i) {
-        cameraDirs[i] = std::filesystem::path(outputPath) / ("frame_cam" + std::to_string(i));
-        std::filesystem::create_directories(cameraDirs[i]);
-    }
-
-    std::cout << "Disk writer thread started" << std::endl;
+void FrameCameraManager::diskWriterWorker() {
+    EBV_LOG_INFO << "Disk writer thread started";
+    const auto heartbeat = m_watchdog ? m_watchdog->registerStage("frame_writer", WRITER_STALL_THRESHOLD) : nullptr;
+    const std::filesystem::path* lastDir = nullptr;
 
     while (m_writingToDisk || !m_frameQueue.empty()) {
-        std::unique_lock<std::mutex> lock(m_queueMutex);
+        ProfiledUniqueLock lock(m_queueMutex);
         
         // Wait for frames or stop signal
         m_queueCondition.wait(lock, [this] { 
@@ -220,23 +313,56 @@ void FrameCameraManager::diskWriterWorker(const std::string& outputPath) {
         while (!m_frameQueue.empty()) {
             FrameData frameData = std::move(m_frameQueue.front());
             m_frameQueue.pop();
+            // Counted until written: the image stays alive while imwrite runs
+            const size_t frameBytes = frameData.image.total() * frameData.image.elemSize();
+            const auto found = m_writerTakes.find(frameData.take);
+            const std::shared_ptr<WriterTake> take = found != m_writerTakes.end() ? found->second : nullptr;
+            if (!take) {
+                // Queued while the writer was being stopped
+                m_queueMemory.release(frameBytes);
+                continue;
+            }
             lock.unlock(); // Release lock while doing I/O
 
             try {
                 // Write frame to disk
-                const std::string filename = (cameraDirs[frameData.deviceId] / 
+                const std::filesystem::path& cameraDir = take->cameraDirs[frameData.deviceId];
+                const std::string filename = (cameraDir / 
                     ("frame_" + std::to_string(frameData.frameIndex) + ".jpg")).string();
-                cv::imwrite(filename, frameData.image);
+                if (heartbeat && &cameraDir != lastDir) {
+                    heartbeat->setDetail(cameraDir.string());
+                    lastDir = &cameraDir;
+                }
+                StallWatchdog::Heartbeat::Scope watched(heartbeat.get(), "imwrite");
+                if (cv::imwrite(filename, frameData.image)) {
+                    std::error_code ec;
+                    const auto bytes = std::filesystem::file_size(filename, ec);
+                    const auto captured = std::chrono::duration_cast<std::chrono::microseconds>(frameData.timestamp.time_since_epoch());
+                    take->statistics[frameData.deviceId]->addFrame(captured.count(), ec ? 0 : bytes);
+                }
             } catch (const std::exception& e) {
-                std::cerr << "Error writing frame for device " << frameData.deviceId 
-                         << ", frame " << frameData.frameIndex << ": " << e.what() << std::endl;
+                EBV_LOG_ERROR << "Error writing frame for device " << frameData.deviceId 
+                         << ", frame " << frameData.frameIndex << ": " << e.what();
             }
 
+            m_queueMemory.release(frameBytes);
             lock.lock(); // Reacquire lock for next iteration
+            if (--take->pendingFrames == 0) {
+                m_takeDrainedCondition.notify_all();
+            }
         }
     }
 
-    std::cout << "Disk writer thread finished" << std::endl;
+    EBV_LOG_INFO << "Disk writer thread finished";
+}
+
+double FrameCameraManager::writerPressure() const {
+    std::lock_guard<ProfiledMutex> lock(m_queueMutex);
+    if (m_frameQueue.empty()) return 0.0;
+    const double fill = static_cast<double>(m_frameQueue.size()) / MAX_QUEUE_SIZE;
+    const double lag = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_frameQueue.front().timestamp).count() /
+                       std::chrono::duration<double>(MAX_WRITER_LAG).count();
+    return std::max(fill, lag);
 }
 
 void FrameCameraManager::closeDevices() {
@@ -245,15 +371,18 @@ void FrameCameraManager::closeDevices() {
     stopRecording();
     stopPreview();
         
-        std::cout << "Closing frame camera devices..." << std::endl;
+        EBV_LOG_INFO << "Closing frame camera devices...";
         
         // Close data streams first
         for (auto& dataStream : m_dataStreams) {
             if (dataStream) {
                 try {
                     dataStream->Flush(peak::core::DataStreamFlushMode::DiscardAll);
+                    for (const auto& buffer : dataStream->AnnouncedBuffers()) {
+                        dataStream->RevokeBuffer(buffer);
+                    }
                 } catch (const std::exception& e) {
-                    std::cerr << "Error flushing data stream: " << e.what() << std::endl;
+                    EBV_LOG_ERROR << "Error flushing data stream: " << e.what();
                 }
             }
         }
@@ -265,9 +394,9 @@ void FrameCameraManager::closeDevices() {
                 try {
                     auto remoteNodemap = m_devices[i]->RemoteDevice()->NodeMaps()[0];
                     remoteNodemap->FindNode<peak::core::nodes::IntegerNode>("TLParamsLocked")->SetValue(0);
-                    std::cout << "Closed frame camera device " << i << std::endl;
+                    EBV_LOG_INFO << "Closed frame camera device " << i;
                 } catch (const std::exception& e) {
-                    std::cerr << "Error closing frame camera device " << i << ": " << e.what() << std::endl;
+                    EBV_LOG_ERROR << "Error closing frame camera device " << i << ": " << e.what();
                 }
             }
         }
@@ -275,10 +404,10 @@ void FrameCameraManager::closeDevices() {
         // Clear device list
         m_devices.clear();
         
-        std::cout << "All frame camera devices closed and resources released" << std::endl;
+        EBV_LOG_INFO << "All frame camera devices closed and resources released";
         
     } catch (const std::exception& e) {
-        std::cerr << "Error closing frame camera devices: " << e.what() << std::endl;
+        EBV_LOG_ERROR << "Error closing frame camera devices: " << e.what();
     }
 }
 
@@ -287,7 +416,7 @@ bool FrameCameraManager::getLatestFrame(int deviceId, FrameData& frameData) {
         return false;
     }
     // Return snapshot of latest frame for this device
-    std::lock_guard<std::mutex> lm(m_latestMutex);
+    std::lock_guard<ProfiledMutex> lm(m_latestMutex);
     if (deviceId < static_cast<int>(m_latestFrames.size())) {
         const auto& latest = m_latestFrames[deviceId];
         if (!latest.image.empty()) {
@@ -301,11 +430,15 @@ bool FrameCameraManager::getLatestFrame(int deviceId, FrameData& frameData) {
 void FrameCameraManager::startAcquisition() {
     m_acquiring = true;
     {
-        std::lock_guard<std::mutex> lm(m_latestMutex);
+        std::lock_guard<ProfiledMutex> lm(m_latestMutex);
         m_latestFrames.clear();
         m_latestFrames.resize(m_devices.size());
     }
     for (size_t i = 0; i < m_dataStreams.size(); ++i) {
+        m_dataStreams[i]->Flush(peak::core::DataStreamFlushMode::DiscardAll);
+        for (const auto& buffer : m_dataStreams[i]->AnnouncedBuffers()) {
+            m_dataStreams[i]->QueueBuffer(buffer);
+        }
         m_dataStreams[i]->StartAcquisition();
         m_devices[i]->RemoteDevice()->NodeMaps()[0]->FindNode<peak::core::nodes::CommandNode>("AcquisitionStart")->Execute();
         m_devices[i]->RemoteDevice()->NodeMaps()[0]->FindNode<peak::core::nodes::CommandNode>("AcquisitionStart")->WaitUntilDone();
@@ -333,14 +466,10 @@ void FrameCameraManager::stopAcquisition() {
             m_devices[i]->RemoteDevice()->NodeMaps()[0]->FindNode<peak::core::nodes::CommandNode>("AcquisitionStop")->Execute();
             m_devices[i]->RemoteDevice()->NodeMaps()[0]->FindNode<peak::core::nodes::CommandNode>("AcquisitionStop")->WaitUntilDone();
             m_dataStreams[i]->StopAcquisition(peak::core::AcquisitionStopMode::Default);
+            // Keep buffers announced and TLParams locked: the device stays warm for the next start
             m_dataStreams[i]->Flush(peak::core::DataStreamFlushMode::DiscardAll);
-
-            for (const auto& buffer : m_dataStreams[i]->AnnouncedBuffers()) {
-                m_dataStreams[i]->RevokeBuffer(buffer);
-            }
-            m_devices[i]->RemoteDevice()->NodeMaps()[0]->FindNode<peak::core::nodes::IntegerNode>("TLParamsLocked")->SetValue(0);
         } catch (const std::exception& e) {
-            std::cerr << "Error stopping acquisition for device " << i << ": " << e.what() << std::endl;
+            EBV_LOG_ERROR << "Error stopping acquisition for device " << i << ": " << e.what();
         }
     }
 }
@@ -0,0 +1,116 @@
+#include "frame_quality_analyzer.h"
+#include "stream_layout.h"
+
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+
+FrameQualityAnalyzer::FrameQualityAnalyzer(LiveDataBus& bus) : FrameQualityAnalyzer(bus, Options{}) {}
+
+FrameQualityAnalyzer::FrameQualityAnalyzer(LiveDataBus& bus, Options options)
+    : m_bus(bus), m_options(options) {}
+
+FrameQualityAnalyzer::~FrameQualityAnalyzer() {
+    stop();
+}
+
+void FrameQualityAnalyzer::start() {
+    if (m_running) return;
+    // One slot: only the newest frame is of interest, everything older is dropped
+    m_subscription = m_bus.frames.subscribe("quality_analyzer", 1, DropPolicy::DropOldest);
+    m_running = true;
+    m_thread = std::thread(&FrameQualityAnalyzer::analysisWorker, this);
+}
+
+void FrameQualityAnalyzer::stop() {
+    if (!m_running.exchange(false)) return;
+    m_bus.frames.unsubscribe(m_subscription);
+    if (m_thread.joinable()) m_thread.join();
+    m_subscription.reset();
+}
+
+bool FrameQualityAnalyzer::latest(int cameraId, FrameQualityMetrics& metrics) const {
+    std::lock_guard<std::mutex> lock(m_resultsMutex);
+    auto it = m_results.find(cameraId);
+    if (it == m_results.end()) return false;
+    metrics = it->second;
+    return true;
+}
+
+void FrameQualityAnalyzer::analysisWorker() {
+    const auto minInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / std::max(0.1, m_options.maxRateHz)));
+    BusTopic<LiveFramePacket>::Ptr packet;
+
+    while (m_running) {
+        if (!m_subscription->waitPop(packet, std::chrono::milliseconds(50))) continue;
+        const auto now = std::chrono::steady_clock::now();
+        auto& last = m_lastAnalysis[packet->cameraId];
+        if (now - last < minInterval) continue;
+        last = now;
+
+        FrameQualityMetrics metrics = analyze(packet->image, m_options);
+        metrics.cameraId = packet->cameraId;
+        metrics.frameIndex = packet->frameIndex;
+        {
+            std::lock_guard<std::mutex> lock(m_resultsMutex);
+            m_results[packet->cameraId] = metrics;
+        }
+        const auto source = StreamLayout::frameStreamName(static_cast<size_t>(packet->cameraId));
+        m_bus.publishStat(source, "sharpness", metrics.sharpness);
+        m_bus.publishStat(source, "clipped_high", metrics.clippedHighRatio);
+        m_bus.publishStat(source, "clipped_low", metrics.clippedLowRatio);
+        m_bus.publishStat(source, "mean_level", metrics.meanLevel);
+    }
+}
+
+FrameQualityMetrics FrameQualityAnalyzer::analyze(const cv::Mat& image, const Options& options) {
+    FrameQualityMetrics metrics;
+    metrics.timestamp = std::chrono::steady_clock::now();
+    if (image.empty()) return metrics;
+
+    // Decimate first (nearest neighbour keeps the pixel statistics and the fine detail
+    // the focus measure looks at), then work on 8-bit grey
+    cv::Mat decimated = image;
+    if (options.analysisWidth > 0 && image.cols > options.analysisWidth) {
+        const double factor = static_cast<double>(options.analysisWidth) / image.cols;
+        cv::resize(image, decimated, cv::Size(), factor, factor, cv::INTER_NEAREST);
+    }
+    cv::Mat grey;
+    switch (decimated.channels()) {
+        case 4: cv::cvtColor(decimated, grey, cv::COLOR_BGRA2GRAY); break;
+        case 3: cv::cvtColor(decimated, grey, cv::COLOR_BGR2GRAY); break;
+        default: grey = decimated; break;
+    }
+    if (grey.depth() != CV_8U) {
+        double maxValue = 0.0;
+        cv::minMaxLoc(grey, nullptr, &maxValue);
+        grey.convertTo(grey, CV_8U, maxValue > 0.0 ? 255.0 / maxValue : 1.0);
+    }
+
+    cv::Mat laplacian;
+    cv::Laplacian(grey, laplacian, CV_32F);
+    cv::Scalar mean;
+    cv::Scalar stddev;
+    cv::meanStdDev(laplacian, mean, stddev);
+    metrics.sharpness = stddev[0] * stddev[0];
+
+    const double pixels = static_cast<double>(grey.total());
+    cv::Mat mask;
+    cv::compare(grey, static_cast<double>(options.clipHigh), mask, cv::CMP_GE);
+    metrics.clippedHighRatio = cv::countNonZero(mask) / pixels;
+    cv::compare(grey, static_cast<double>(options.clipLow), mask, cv::CMP_LE);
+    metrics.clippedLowRatio = cv::countNonZero(mask) / pixels;
+    metrics.meanLevel = cv::mean(grey)[0];
+
+    cv::Mat histogram;
+    const int channels[] = {0};
+    const int bins[] = {FrameQualityMetrics::HISTOGRAM_BINS};
+    const float range[] = {0.0f, 256.0f};
+    const float* ranges[] = {range};
+    cv::calcHist(&grey, 1, channels, cv::Mat(), histogram, 1, bins, ranges);
+    for (int i = 0; i < FrameQualityMetrics::HISTOGRAM_BINS; ++i) {
+        metrics.histogram[static_cast<size_t>(i)] = static_cast<float>(histogram.at<float>(i) / pixels);
+    }
+    return metrics;
+}
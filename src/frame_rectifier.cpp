@@ -0,0 +1,96 @@
+#include "frame_rectifier.h"
+#include "stream_layout.h"
+#include "logger.h"
+
+#include <filesystem>
+
+bool FrameRectifier::loadCalibration(const std::string &path, const std::string &stream, Calibration &calibration) {
+    if (!std::filesystem::exists(path)) return false;
+    try {
+        cv::FileStorage storage(path, cv::FileStorage::READ);
+        if (!storage.isOpened()) return false;
+        Calibration result;
+        storage[stream + "_K"] >> result.cameraMatrix;
+        storage[stream + "_D"] >> result.distCoeffs;
+        storage[stream + "_R"] >> result.rectification;
+        storage[stream + "_P"] >> result.projection;
+        int width = 0;
+        int height = 0;
+        storage["image_width"] >> width;
+        storage["image_height"] >> height;
+        if (result.cameraMatrix.rows != 3 || result.cameraMatrix.cols != 3 || width <= 0 || height <= 0) return false;
+        result.imageSize = cv::Size(width, height);
+        result.cameraMatrix.convertTo(result.cameraMatrix, CV_64F);
+        if (result.distCoeffs.empty()) result.distCoeffs = cv::Mat::zeros(1, 5, CV_64F);
+        if (result.rectification.empty()) result.rectification = cv::Mat::eye(3, 3, CV_64F);
+        if (result.projection.empty()) result.projection = result.cameraMatrix.clone();
+        result.distCoeffs.convertTo(result.distCoeffs, CV_64F);
+        result.rectification.convertTo(result.rectification, CV_64F);
+        result.projection.convertTo(result.projection, CV_64F);
+        calibration = result;
+        return true;
+    } catch (const cv::Exception &e) {
+        EBV_LOG_ERROR << "Failed to read rectification for " << stream << " from " << path << ": " << e.what();
+        return false;
+    }
+}
+
+std::shared_ptr<FrameRectifier> FrameRectifier::fromFile(const std::string &path, size_t cameraCount) {
+    std::vector<std::optional<Calibration>> calibrations(cameraCount);
+    bool any = false;
+    for (size_t camera = 0; camera < cameraCount; ++camera) {
+        Calibration calibration;
+        if (loadCalibration(path, StreamLayout::frameStreamName(camera), calibration)) {
+            calibrations[camera] = calibration;
+            any = true;
+        }
+    }
+    return any ? std::make_shared<FrameRectifier>(std::move(calibrations)) : nullptr;
+}
+
+FrameRectifier::FrameRectifier(std::vector<std::optional<Calibration>> calibrations)
+    : m_calibrations(std::move(calibrations)) {}
+
+bool FrameRectifier::hasCamera(int camera) const {
+    return camera >= 0 && static_cast<size_t>(camera) < m_calibrations.size() && m_calibrations[camera].has_value();
+}
+
+const FrameRectifier::Maps &FrameRectifier::mapsFor(int camera, cv::Size size) const {
+    std::lock_guard<std::mutex> lock(m_mapsMutex);
+    const auto key = std::make_tuple(camera, size.width, size.height);
+    auto it = m_maps.find(key);
+    if (it != m_maps.end()) return it->second;
+
+    // Intrinsics scale with the resolution; distortion and rotation do not
+    const Calibration &calibration = *m_calibrations[camera];
+    const double sx = static_cast<double>(size.width) / calibration.imageSize.width;
+    const double sy = static_cast<double>(size.height) / calibration.imageSize.height;
+    const cv::Matx33d scale(sx, 0.0, 0.0,
+                            0.0, sy, 0.0,
+                            0.0, 0.0, 1.0);
+    const cv::Mat cameraMatrix = cv::Mat(scale) * calibration.cameraMatrix;
+    const cv::Mat projection = cv::Mat(scale) * calibration.projection;
+
+    Maps maps;
+    cv::initUndistortRectifyMap(cameraMatrix, calibration.distCoeffs, calibration.rectification, projection,
+                                size, CV_16SC2, maps.map1, maps.map2);
+    return m_maps.emplace(key, std::move(maps)).first->second;
+}
+
+cv::Mat FrameRectifier::rectify(int camera, const cv::Mat &image) const {
+    if (image.empty() || !hasCamera(camera)) return image;
+    const Maps &maps = mapsFor(camera, image.size());
+    cv::Mat rectified;
+    cv::remap(image, rectified, maps.map1, maps.map2, cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+    return rectified;
+}
+
+cv::Mat FrameRectifier::rectifyPreview(int camera, const cv::Mat &image, int maxWidth) const {
+    if (image.empty() || !hasCamera(camera)) return image;
+    if (maxWidth <= 0 || image.cols <= maxWidth) return rectify(camera, image);
+    cv::Mat reduced;
+    const double factor = static_cast<double>(maxWidth) / image.cols;
+    cv::resize(image, reduced, cv::Size(maxWidth, std::max(1, static_cast<int>(image.rows * factor + 0.5))), 0, 0,
+               cv::INTER_AREA);
+    return rectify(camera, reduced);
+}
@@ -0,0 +1,123 @@
+#include "hdf5_benchmark.h"
+#include "event_camera_manager.h"
+#include "hdf5_event_writer.h"
+#include "logger.h"
+
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <sys/resource.h>
+#include <metavision/sdk/stream/camera.h>
+#include <metavision/sdk/stream/file_config_hints.h>
+#include <metavision/sdk/stream/hdf5_event_file_writer.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr size_t REPLAY_BATCH_EVENTS = 65536; // roughly one SDK callback worth of events
+
+double processCpuSeconds() {
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    const auto toSeconds = [](const timeval& tv) { return static_cast<double>(tv.tv_sec) + tv.tv_usec / 1e6; };
+    return toSeconds(usage.ru_utime) + toSeconds(usage.ru_stime);
+}
+
+std::vector<Metavision::EventCD> decodeReference(const std::string& rawFile, uint64_t maxEvents) {
+    std::vector<Metavision::EventCD> events;
+    Metavision::Camera camera = Metavision::Camera::from_file(rawFile, Metavision::FileConfigHints().real_time_playback(false));
+    camera.cd().add_callback([&](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+        const auto room = maxEvents - std::min<uint64_t>(maxEvents, events.size());
+        const auto count = std::min<uint64_t>(room, static_cast<uint64_t>(end - begin));
+        events.insert(events.end(), begin, begin + count);
+    });
+    camera.start();
+    while (camera.is_running() && events.size() < maxEvents) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    camera.stop();
+    return events;
+}
+} // namespace
+
+std::vector<Hdf5Benchmark::Setting> Hdf5Benchmark::defaultSettings() {
+    return {
+        {"sdk-ecf", -1, 16384},
+        {"none/16k", 0, 16384},
+        {"deflate1/16k", 1, 16384},
+        {"deflate4/4k", 4, 4096},
+        {"deflate4/16k", 4, 16384},
+        {"deflate4/64k", 4, 65536},
+        {"deflate9/16k", 9, 16384},
+    };
+}
+
+std::vector<Hdf5Benchmark::Result> Hdf5Benchmark::run(const std::string& rawFile, const std::vector<Setting>& settings,
+                                                      const std::string& scratchDirectory, uint64_t maxEvents) {
+    EBV_LOG_INFO << "HDF5 benchmark: decoding " << rawFile << "...";
+    const auto events = decodeReference(rawFile, maxEvents);
+    if (events.empty()) {
+        throw std::runtime_error("No CD events decoded from " + rawFile);
+    }
+    EBV_LOG_INFO << "HDF5 benchmark: " << events.size() << " events, " << settings.size() << " settings";
+
+    fs::create_directories(scratchDirectory);
+    std::vector<Result> results;
+    for (const auto& setting : settings) {
+        const auto path = fs::path(scratchDirectory) / ("ebv_hdf5_benchmark_" + std::to_string(results.size()) + ".hdf5");
+        Result result;
+        result.setting = setting;
+        result.events = events.size();
+
+        const double cpuStart = processCpuSeconds();
+        const auto wallStart = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> hdf5Lock(EventCameraManager::hdf5Mutex());
+            if (setting.compressionLevel < 0) {
+                Metavision::HDF5EventFileWriter writer(path.string());
+                for (size_t i = 0; i < events.size(); i += REPLAY_BATCH_EVENTS) {
+                    const size_t end = std::min(events.size(), i + REPLAY_BATCH_EVENTS);
+                    writer.add_events(events.data() + i, events.data() + end);
+                }
+                writer.close();
+            } else {
+                Hdf5EventWriter::Options options;
+                options.compressionLevel = setting.compressionLevel;
+                options.chunkEvents = setting.chunkEvents;
+                Hdf5EventWriter writer(path.string(), options);
+                for (size_t i = 0; i < events.size(); i += REPLAY_BATCH_EVENTS) {
+                    const size_t end = std::min(events.size(), i + REPLAY_BATCH_EVENTS);
+                    writer.addCdEvents(events.data() + i, events.data() + end);
+                }
+                writer.close();
+            }
+        }
+        result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+        result.cpuSeconds = processCpuSeconds() - cpuStart;
+        result.fileBytes = fs::file_size(path);
+        fs::remove(path);
+        results.push_back(result);
+        EBV_LOG_INFO << "  " << setting.name << " done";
+    }
+    return results;
+}
+
+void Hdf5Benchmark::printReport(std::ostream& out, const std::vector<Result>& results, uint64_t rawFileBytes) {
+    out << std::left << std::setw(16) << "setting" << std::right
+        << std::setw(12) << "Mev/s" << std::setw(12) << "cpu s" << std::setw(14) << "MiB"
+        << std::setw(12) << "B/event" << std::setw(12) << "vs RAW" << std::endl;
+    for (const auto& r : results) {
+        const double mevPerSecond = r.wallSeconds > 0 ? r.events / r.wallSeconds / 1e6 : 0.0;
+        const double bytesPerEvent = r.events > 0 ? static_cast<double>(r.fileBytes) / r.events : 0.0;
+        const double vsRaw = rawFileBytes > 0 ? static_cast<double>(r.fileBytes) / rawFileBytes : 0.0;
+        out << std::left << std::setw(16) << r.setting.name << std::right << std::fixed << std::setprecision(2)
+            << std::setw(12) << mevPerSecond << std::setw(12) << r.cpuSeconds
+            << std::setw(14) << r.fileBytes / (1024.0 * 1024.0) << std::setw(12) << bytesPerEvent
+            << std::setw(12) << vsRaw << std::endl;
+    }
+    out << "(vs RAW compares against the whole reference file; a partial replay understates it)" << std::endl;
+}
@@ -0,0 +1,290 @@
+#include "hdf5_event_writer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace {
+// Index rows per chunk; a take starting an hour into the camera clock has ~1.8 M leading rows
+constexpr size_t INDEX_CHUNK_ROWS = 16384;
+
+hid_t check(hid_t id, const std::string& what) {
+    if (id < 0) throw std::runtime_error("HDF5 event writer: " + what + " failed");
+    return id;
+}
+
+void closeType(hid_t& id) {
+    if (id >= 0) H5Tclose(id);
+    id = -1;
+}
+
+// Packed on-disk copy of a native compound type (drops alignment padding)
+hid_t packedCopy(hid_t memType) {
+    const hid_t fileType = check(H5Tcopy(memType), "H5Tcopy");
+    H5Tpack(fileType);
+    return fileType;
+}
+
+hid_t createAppendableDataset(hid_t group, const char* name, hid_t fileType, size_t chunk, int level, bool shuffle) {
+    const hsize_t dims[1] = {0};
+    const hsize_t maxDims[1] = {H5S_UNLIMITED};
+    const hsize_t chunkDims[1] = {static_cast<hsize_t>(std::max<size_t>(chunk, 1))};
+    const hid_t space = check(H5Screate_simple(1, dims, maxDims), "H5Screate_simple");
+    const hid_t dcpl = check(H5Pcreate(H5P_DATASET_CREATE), "H5Pcreate");
+    H5Pset_chunk(dcpl, 1, chunkDims);
+    if (level > 0) {
+        if (shuffle) H5Pset_shuffle(dcpl);
+        H5Pset_deflate(dcpl, static_cast<unsigned>(std::min(level, 9)));
+    }
+    const hid_t dataset = H5Dcreate2(group, name, fileType, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Pclose(dcpl);
+    H5Sclose(space);
+    return check(dataset, std::string("creating dataset ") + name);
+}
+
+// Same byte transposition as the HDF5 shuffle filter: byte j of element i goes to j * n + i
+std::vector<unsigned char> shuffleBytes(const std::vector<unsigned char>& data, size_t elementSize) {
+    const size_t elements = data.size() / elementSize;
+    if (elementSize <= 1 || elements <= 1) return data;
+    std::vector<unsigned char> shuffled(data.size());
+    for (size_t i = 0; i < elements; ++i) {
+        for (size_t j = 0; j < elementSize; ++j) {
+            shuffled[j * elements + i] = data[i * elementSize + j];
+        }
+    }
+    return shuffled;
+}
+
+// Same zlib stream as the HDF5 deflate filter
+std::vector<unsigned char> deflateBytes(const std::vector<unsigned char>& data, int level) {
+    uLongf size = compressBound(static_cast<uLong>(data.size()));
+    std::vector<unsigned char> compressed(size);
+    if (compress2(compressed.data(), &size, data.data(), static_cast<uLong>(data.size()), std::min(level, 9)) != Z_OK) {
+        throw std::runtime_error("HDF5 event writer: deflate failed");
+    }
+    compressed.resize(size);
+    return compressed;
+}
+
+void appendRows(hid_t dataset, hid_t memType, const void* rows, hsize_t offset, hsize_t count) {
+    const hsize_t newSize[1] = {offset + count};
+    check(H5Dset_extent(dataset, newSize), "H5Dset_extent");
+    const hid_t fileSpace = check(H5Dget_space(dataset), "H5Dget_space");
+    const hsize_t start[1] = {offset};
+    const hsize_t rowCount[1] = {count};
+    H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start, nullptr, rowCount, nullptr);
+    const hid_t memSpace = check(H5Screate_simple(1, rowCount, nullptr), "H5Screate_simple");
+    const herr_t status = H5Dwrite(dataset, memType, memSpace, fileSpace, H5P_DEFAULT, rows);
+    H5Sclose(memSpace);
+    H5Sclose(fileSpace);
+    check(status, "H5Dwrite");
+}
+} // namespace
+
+Hdf5EventWriter::Hdf5EventWriter(const std::string& path, Options options)
+    : m_path(path), m_options(options) {
+    if (m_options.chunkEvents == 0) m_options.chunkEvents = 1;
+    if (m_options.indexPeriodUs <= 0) m_options.indexPeriodUs = 2000;
+    m_file = check(H5Fcreate(path.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT), "creating " + path);
+
+    m_indexType = check(H5Tcreate(H5T_COMPOUND, sizeof(IndexEntry)), "H5Tcreate");
+    H5Tinsert(m_indexType, "id", HOFFSET(IndexEntry, id), H5T_NATIVE_UINT64);
+    H5Tinsert(m_indexType, "ts", HOFFSET(IndexEntry, ts), H5T_NATIVE_INT64);
+
+    const hid_t cdType = check(H5Tcreate(H5T_COMPOUND, sizeof(CdEvent)), "H5Tcreate");
+    H5Tinsert(cdType, "x", HOFFSET(CdEvent, x), H5T_NATIVE_UINT16);
+    H5Tinsert(cdType, "y", HOFFSET(CdEvent, y), H5T_NATIVE_UINT16);
+    H5Tinsert(cdType, "p", HOFFSET(CdEvent, p), H5T_NATIVE_INT16);
+    H5Tinsert(cdType, "t", HOFFSET(CdEvent, t), H5T_NATIVE_INT64);
+    createStream(m_cd, "CD", cdType);
+
+    const hid_t triggerType = check(H5Tcreate(H5T_COMPOUND, sizeof(TriggerEvent)), "H5Tcreate");
+    H5Tinsert(triggerType, "p", HOFFSET(TriggerEvent, p), H5T_NATIVE_INT16);
+    H5Tinsert(triggerType, "t", HOFFSET(TriggerEvent, t), H5T_NATIVE_INT64);
+    H5Tinsert(triggerType, "id", HOFFSET(TriggerEvent, id), H5T_NATIVE_INT16);
+    createStream(m_triggers, "EXT_TRIGGER", triggerType);
+
+    addMetadata("version", "1.0");
+    addMetadata("compression", m_options.compressionLevel > 0
+        ? (m_options.shuffle ? "shuffle+deflate-" : "deflate-") + std::to_string(m_options.compressionLevel)
+        : "none");
+}
+
+Hdf5EventWriter::~Hdf5EventWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; data written so far stays in the file
+    }
+}
+
+void Hdf5EventWriter::addMetadata(const std::string& key, const std::string& value) {
+    if (m_file < 0) throw std::runtime_error("HDF5 event writer: file is closed");
+    if (H5Aexists(m_file, key.c_str()) > 0) H5Adelete(m_file, key.c_str());
+
+    const hid_t type = check(H5Tcopy(H5T_C_S1), "H5Tcopy");
+    H5Tset_size(type, value.size() + 1);
+    H5Tset_strpad(type, H5T_STR_NULLTERM);
+    const hid_t space = check(H5Screate(H5S_SCALAR), "H5Screate");
+    const hid_t attribute = H5Acreate2(m_file, key.c_str(), type, space, H5P_DEFAULT, H5P_DEFAULT);
+    herr_t status = -1;
+    if (attribute >= 0) {
+        status = H5Awrite(attribute, type, value.c_str());
+        H5Aclose(attribute);
+    }
+    H5Sclose(space);
+    H5Tclose(type);
+    check(status, "writing attribute " + key);
+}
+
+template <typename Event>
+void Hdf5EventWriter::createStream(Stream<Event>& stream, const char* groupName, hid_t memType) {
+    stream.memType = memType;
+    stream.fileType = packedCopy(memType);
+    stream.group = check(H5Gcreate2(m_file, groupName, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+                         std::string("creating group ") + groupName);
+    stream.events = createAppendableDataset(stream.group, "events", stream.fileType, m_options.chunkEvents,
+                                            m_options.compressionLevel, m_options.shuffle);
+    stream.indexes = createAppendableDataset(stream.group, "indexes", m_indexType, INDEX_CHUNK_ROWS, 0, false);
+
+    // Member offsets for packing rows into the file layout without the HDF5 type conversion
+    stream.rowBytes = H5Tget_size(stream.fileType);
+    const int members = H5Tget_nmembers(memType);
+    for (int i = 0; i < members; ++i) {
+        const auto index = static_cast<unsigned>(i);
+        const hid_t memberType = check(H5Tget_member_type(memType, index), "H5Tget_member_type");
+        stream.members.push_back(MemberCopy{H5Tget_member_offset(memType, index),
+                                            H5Tget_member_offset(stream.fileType, index), H5Tget_size(memberType)});
+        H5Tclose(memberType);
+    }
+
+    // Timestamp shift applied by readers to the index table (none)
+    const hid_t space = check(H5Screate(H5S_SCALAR), "H5Screate");
+    const hid_t attribute = check(H5Acreate2(stream.indexes, "offset", H5T_NATIVE_INT64, space, H5P_DEFAULT, H5P_DEFAULT),
+                                  "creating offset attribute");
+    const int64_t offset = 0;
+    H5Awrite(attribute, H5T_NATIVE_INT64, &offset);
+    H5Aclose(attribute);
+    H5Sclose(space);
+    stream.pending.reserve(m_options.chunkEvents * 2);
+}
+
+void Hdf5EventWriter::checkBuffering(bool finalEncoded) {
+    if (finalEncoded) throw std::runtime_error("HDF5 event writer: events added after the final chunk was encoded");
+}
+
+void Hdf5EventWriter::flushCdChunks() {
+    flushStream(m_cd, false);
+}
+
+void Hdf5EventWriter::flushTriggerChunks() {
+    flushStream(m_triggers, false);
+}
+
+void Hdf5EventWriter::encodeChunks(bool final) {
+    encodeStream(m_cd, final);
+    encodeStream(m_triggers, final);
+}
+
+void Hdf5EventWriter::writeEncodedChunks() {
+    if (m_file < 0) throw std::runtime_error("HDF5 event writer: file is closed");
+    writeStream(m_cd);
+    writeStream(m_triggers);
+}
+
+template <typename Event>
+void Hdf5EventWriter::flushStream(Stream<Event>& stream, bool all) {
+    encodeStream(stream, all);
+    writeStream(stream);
+}
+
+template <typename Event>
+void Hdf5EventWriter::encodeStream(Stream<Event>& stream, bool all) {
+    // Whole chunks only while recording: every chunk is compressed and written exactly once
+    const size_t chunkEvents = m_options.chunkEvents;
+    const size_t count = all ? stream.pending.size() : (stream.pending.size() / chunkEvents) * chunkEvents;
+    if (all) stream.finalEncoded = true;
+    for (size_t first = 0; first < count; first += chunkEvents) {
+        const size_t rows = std::min(chunkEvents, count - first);
+        const Event* events = stream.pending.data() + first;
+        addIndexRows(stream, events, rows);
+
+        // Chunks are stored full size; rows past the dataset extent stay zero
+        std::vector<unsigned char> packed(chunkEvents * stream.rowBytes, 0);
+        for (size_t row = 0; row < rows; ++row) {
+            const auto* source = reinterpret_cast<const unsigned char*>(&events[row]);
+            unsigned char* target = packed.data() + row * stream.rowBytes;
+            for (const auto& member : stream.members) {
+                std::memcpy(target + member.fileOffset, source + member.memOffset, member.size);
+            }
+        }
+        if (m_options.compressionLevel > 0) {
+            if (m_options.shuffle) packed = shuffleBytes(packed, stream.rowBytes);
+            packed = deflateBytes(packed, m_options.compressionLevel);
+        }
+        stream.chunks.push_back(EncodedChunk{stream.encoded, rows, std::move(packed)});
+        stream.encoded += rows;
+    }
+    stream.pending.erase(stream.pending.begin(), stream.pending.begin() + static_cast<std::ptrdiff_t>(count));
+}
+
+template <typename Event>
+void Hdf5EventWriter::writeStream(Stream<Event>& stream) {
+    for (const auto& chunk : stream.chunks) {
+        const hsize_t newSize[1] = {chunk.firstRow + chunk.rows};
+        check(H5Dset_extent(stream.events, newSize), "H5Dset_extent");
+        const hsize_t offset[1] = {chunk.firstRow};
+        check(H5Dwrite_chunk(stream.events, H5P_DEFAULT, 0, offset, chunk.bytes.size(), chunk.bytes.data()),
+              "H5Dwrite_chunk");
+        stream.written += chunk.rows;
+    }
+    stream.chunks.clear();
+    if (!stream.indexRows.empty()) {
+        appendRows(stream.indexes, m_indexType, stream.indexRows.data(), stream.indexesWritten, stream.indexRows.size());
+        stream.indexesWritten += stream.indexRows.size();
+        stream.indexRows.clear();
+    }
+}
+
+template <typename Event>
+void Hdf5EventWriter::addIndexRows(Stream<Event>& stream, const Event* events, size_t count) {
+    const int64_t period = m_options.indexPeriodUs;
+    // Row k covers ts = k * period from t = 0, as readers look rows up by t / period: a take
+    // that starts late on the running camera clock gets leading rows pointing at event 0
+    for (size_t i = 0; i < count; ++i) {
+        const int64_t t = events[i].t;
+        while (t >= stream.nextIndexTs) {
+            stream.indexRows.push_back(IndexEntry{stream.encoded + i, stream.nextIndexTs});
+            stream.nextIndexTs += period;
+        }
+    }
+}
+
+template <typename Event>
+void Hdf5EventWriter::closeStream(Stream<Event>& stream) {
+    if (stream.group < 0) return;
+    flushStream(stream, true);
+    H5Dclose(stream.indexes);
+    H5Dclose(stream.events);
+    H5Gclose(stream.group);
+    stream.group = stream.events = stream.indexes = -1;
+    closeType(stream.fileType);
+    closeType(stream.memType);
+}
+
+void Hdf5EventWriter::close() {
+    if (m_file < 0) return;
+    try {
+        closeStream(m_cd);
+        closeStream(m_triggers);
+    } catch (...) {
+        closeType(m_indexType);
+        H5Fclose(m_file);
+        m_file = -1;
+        throw;
+    }
+    closeType(m_indexType);
+    check(H5Fclose(m_file), "closing " + m_path);
+    m_file = -1;
+}
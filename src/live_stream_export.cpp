@@ -0,0 +1,82 @@
+#include "live_stream_export.h"
+#include "logger.h"
+#include <algorithm>
+
+LiveStreamExport::LiveStreamExport(LiveDataBus& bus, ShmStreamExporter::Options options)
+    : m_bus(bus), m_exporter(std::move(options)) {}
+
+LiveStreamExport::~LiveStreamExport() {
+    stop();
+}
+
+bool LiveStreamExport::start() {
+    if (m_running) return true;
+    if (!m_exporter.open()) return false;
+
+    m_frameSubscription = m_bus.frames.subscribe("shm_export", FRAME_QUEUE_SIZE, DropPolicy::DropOldest);
+    m_eventSubscription = m_bus.eventChunks.subscribe("shm_export", EVENT_QUEUE_SIZE, DropPolicy::DropOldest);
+    m_running = true;
+    m_thread = std::thread(&LiveStreamExport::exportWorker, this);
+    return true;
+}
+
+void LiveStreamExport::stop() {
+    if (!m_running.exchange(false)) return;
+
+    m_bus.frames.unsubscribe(m_frameSubscription);
+    m_bus.eventChunks.unsubscribe(m_eventSubscription);
+    if (m_thread.joinable()) m_thread.join();
+    m_frameSubscription.reset();
+    m_eventSubscription.reset();
+
+    EBV_LOG_INFO << "Live export: " << m_exporter.publishedCount() << " records published, "
+              << m_exporter.rejectedCount() << " rejected";
+    m_exporter.close();
+}
+
+void LiveStreamExport::exportWorker() {
+    BusTopic<LiveFramePacket>::Ptr frame;
+    BusTopic<LiveEventChunk>::Ptr chunk;
+
+    while (m_running) {
+        bool didWork = false;
+        while (m_eventSubscription->tryPop(chunk)) {
+            exportEvents(*chunk);
+            didWork = true;
+        }
+        if (m_frameSubscription->tryPop(frame)) {
+            exportFrame(*frame);
+            didWork = true;
+        }
+        if (!didWork) {
+            // Frames are the rarer topic; event chunks are drained at least every 2 ms
+            if (m_frameSubscription->waitPop(frame, std::chrono::milliseconds(2))) {
+                exportFrame(*frame);
+            }
+        }
+    }
+}
+
+void LiveStreamExport::exportFrame(const LiveFramePacket& packet) {
+    if (packet.image.empty()) return;
+    // Bus frames are shared, never modified: only non-continuous images need a copy
+    const cv::Mat image = packet.image.isContinuous() ? packet.image : packet.image.clone();
+    const auto timestampUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        packet.timestamp.time_since_epoch()).count();
+    m_exporter.publishFrame(packet.cameraId, packet.frameIndex, timestampUs,
+                            static_cast<uint32_t>(image.cols), static_cast<uint32_t>(image.rows),
+                            image.type(), image.data, image.total() * image.elemSize());
+}
+
+void LiveStreamExport::exportEvents(const LiveEventChunk& chunk) {
+    if (chunk.events.empty()) return;
+    // Split callback chunks that exceed the slot payload size
+    const size_t maxEvents = std::max<size_t>(1, m_exporter.maxPayloadBytes() / sizeof(Metavision::EventCD));
+    uint64_t& counter = m_eventChunkCounters[chunk.cameraId];
+    for (size_t offset = 0; offset < chunk.events.size(); offset += maxEvents) {
+        const size_t count = std::min(maxEvents, chunk.events.size() - offset);
+        const auto* first = chunk.events.data() + offset;
+        m_exporter.publishEvents(chunk.cameraId, counter++, first->t, first,
+                                 static_cast<uint32_t>(count), count * sizeof(Metavision::EventCD));
+    }
+}
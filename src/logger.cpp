@@ -0,0 +1,358 @@
+#include "logger.h"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace Log {
+
+namespace detail {
+std::atomic<int> minimumLevel{static_cast<int>(Level::Info)};
+} // namespace detail
+
+namespace {
+constexpr size_t MAX_MESSAGE = 480;   // longer lines are truncated
+constexpr size_t RING_CAPACITY = 256; // lines per thread not yet written by the sink
+constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(50);
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+const char* baseName(const char* path) {
+    const char* slash = std::strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+struct Slot {
+    int64_t timeNs;
+    const char* file;
+    int line;
+    Level level;
+    uint16_t length;
+    char text[MAX_MESSAGE];
+};
+
+// Single producer (the owning thread), single consumer (the sink)
+struct ThreadRing {
+    explicit ThreadRing(uint32_t index) : thread(index) {}
+
+    const uint32_t thread;
+    std::array<Slot, RING_CAPACITY> slots;
+    std::atomic<uint64_t> head{0}; // next slot the owner writes
+    std::atomic<uint64_t> tail{0}; // next slot the sink reads
+    std::atomic<bool> orphaned{false}; // owner exited; removed once drained
+};
+
+void writeDefault(const Record& record) {
+    const std::string line = formatRecord(record) + "\n";
+    std::fputs(line.c_str(), record.level >= Level::Warning ? stderr : stdout);
+}
+
+class Logger {
+public:
+    // Intentionally leaked: threads may still log during static destruction
+    static Logger& instance() {
+        static Logger* logger = [] {
+            auto* created = new Logger();
+            std::atexit([] { Logger::instance().shutdown(); });
+            return created;
+        }();
+        return *logger;
+    }
+
+    void submit(Level level, const char* file, int line, const char* text, size_t length) {
+        ThreadRing& ring = ringForThisThread();
+        const uint64_t head = ring.head.load(std::memory_order_relaxed);
+        if (head - ring.tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Slot& slot = ring.slots[head % RING_CAPACITY];
+        slot.timeNs = nowNs();
+        slot.file = file;
+        slot.line = line;
+        slot.level = level;
+        slot.length = static_cast<uint16_t>(std::min(length, MAX_MESSAGE));
+        std::memcpy(slot.text, text, slot.length);
+        ring.head.store(head + 1, std::memory_order_release);
+        // After shutdown there is no sink thread; write through (exit path only)
+        if (!m_running.load(std::memory_order_acquire)) drain();
+    }
+
+    void setSink(Sink sink) {
+        std::lock_guard<std::mutex> lock(m_sinkMutex);
+        m_sink = std::move(sink);
+    }
+
+    void flush() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            lock.unlock();
+            drain();
+            return;
+        }
+        const uint64_t target = ++m_flushRequested;
+        m_cv.notify_one();
+        m_flushedCv.wait(lock, [this, target] { return m_flushDone >= target || !m_running; });
+    }
+
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_running) return;
+            m_stopping = true;
+        }
+        m_cv.notify_one();
+        if (m_thread.joinable()) m_thread.join();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_flushedCv.notify_all();
+        drain();
+    }
+
+private:
+    Logger() {
+        m_running = true;
+        m_thread = std::thread(&Logger::run, this);
+    }
+
+    ThreadRing& ringForThisThread() {
+        struct Holder {
+            std::shared_ptr<ThreadRing> ring;
+            ~Holder() {
+                if (ring) ring->orphaned.store(true, std::memory_order_release);
+            }
+        };
+        thread_local Holder holder;
+        if (!holder.ring) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            holder.ring = std::make_shared<ThreadRing>(m_nextThread++);
+            m_rings.push_back(holder.ring);
+        }
+        return *holder.ring;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stopping) {
+            m_cv.wait_for(lock, DRAIN_INTERVAL, [this] { return m_stopping || m_flushRequested != m_flushDone; });
+            const uint64_t target = m_flushRequested;
+            lock.unlock();
+            drain();
+            lock.lock();
+            m_flushDone = target;
+            m_flushedCv.notify_all();
+        }
+    }
+
+    // Move everything queued so far to the sink, oldest first
+    void drain() {
+        std::lock_guard<std::mutex> sinkLock(m_sinkMutex);
+        std::vector<std::shared_ptr<ThreadRing>> rings;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            rings = m_rings;
+        }
+        m_batch.clear();
+        for (const auto& ring : rings) {
+            const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            const uint64_t head = ring->head.load(std::memory_order_acquire);
+            for (uint64_t i = tail; i < head; ++i) {
+                const Slot& slot = ring->slots[i % RING_CAPACITY];
+                Record record;
+                record.time = std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(slot.timeNs)));
+                record.level = slot.level;
+                record.file = slot.file;
+                record.line = slot.line;
+                record.thread = ring->thread;
+                record.message.assign(slot.text, slot.length);
+                m_batch.push_back(std::move(record));
+            }
+            ring->tail.store(head, std::memory_order_release);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(),
+                                         [](const std::shared_ptr<ThreadRing>& ring) {
+                                             return ring->orphaned.load(std::memory_order_acquire) &&
+                                                    ring->tail.load(std::memory_order_relaxed) ==
+                                                        ring->head.load(std::memory_order_acquire);
+                                         }),
+                          m_rings.end());
+        }
+
+        const uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+        if (dropped != m_reportedDropped) {
+            Record record;
+            record.time = std::chrono::system_clock::now();
+            record.level = Level::Warning;
+            record.file = "logger.cpp";
+            record.message = std::to_string(dropped - m_reportedDropped) + " log lines dropped (thread log buffer full)";
+            m_batch.push_back(std::move(record));
+            m_reportedDropped = dropped;
+        }
+        if (m_batch.empty()) return;
+
+        std::stable_sort(m_batch.begin(), m_batch.end(), [](const Record& a, const Record& b) { return a.time < b.time; });
+        for (const auto& record : m_batch) {
+            try {
+                if (m_sink) m_sink(record);
+                else writeDefault(record);
+            } catch (...) {
+                // a failing sink must not take the logger down
+            }
+        }
+        if (!m_sink) {
+            std::fflush(stdout);
+            std::fflush(stderr);
+        }
+    }
+
+    std::mutex m_mutex; // rings, flush and stop state
+    std::condition_variable m_cv;
+    std::condition_variable m_flushedCv;
+    std::vector<std::shared_ptr<ThreadRing>> m_rings;
+    uint32_t m_nextThread{0};
+    uint64_t m_flushRequested{0};
+    uint64_t m_flushDone{0};
+    bool m_stopping{false};
+    std::atomic<bool> m_running{false};
+    std::thread m_thread;
+    std::atomic<uint64_t> m_dropped{0};
+
+    std::mutex m_sinkMutex; // sink, batch; one drain at a time
+    Sink m_sink;
+    std::vector<Record> m_batch;
+    uint64_t m_reportedDropped{0};
+};
+
+[[maybe_unused]] const bool LEVEL_FROM_ENVIRONMENT = [] {
+    const char* value = std::getenv("EBV_LOG_LEVEL");
+    if (!value) return false;
+    const std::string name(value);
+    if (name == "debug") setLevel(Level::Debug);
+    else if (name == "info") setLevel(Level::Info);
+    else if (name == "warning" || name == "warn") setLevel(Level::Warning);
+    else if (name == "error") setLevel(Level::Error);
+    return true;
+}();
+} // namespace
+
+namespace detail {
+// Fixed buffer; output beyond MAX_MESSAGE is cut off
+struct LineBuffer : std::streambuf {
+    LineBuffer() : stream(this) { reset(); }
+
+    void reset() {
+        setp(data, data + MAX_MESSAGE);
+        stream.clear();
+        stream.flags(std::ios_base::dec | std::ios_base::skipws);
+        stream.precision(6);
+        stream.width(0);
+        stream.fill(' ');
+    }
+    size_t length() const { return static_cast<size_t>(pptr() - pbase()); }
+
+    char data[MAX_MESSAGE];
+    std::ostream stream;
+    bool inUse{false};
+};
+
+LineBuffer* acquireBuffer() {
+    thread_local LineBuffer buffer;
+    if (buffer.inUse) return new LineBuffer(); // a line logged while formatting another one
+    buffer.inUse = true;
+    buffer.reset();
+    return &buffer;
+}
+
+void releaseBuffer(LineBuffer* buffer) {
+    if (buffer->inUse) buffer->inUse = false;
+    else delete buffer;
+}
+} // namespace detail
+
+void setLevel(Level level) {
+    detail::minimumLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+Level level() {
+    return static_cast<Level>(detail::minimumLevel.load(std::memory_order_relaxed));
+}
+
+void setSink(Sink sink) {
+    Logger::instance().setSink(std::move(sink));
+}
+
+void flush() {
+    Logger::instance().flush();
+}
+
+uint64_t droppedCount() {
+    return Logger::instance().dropped();
+}
+
+const char* levelName(Level level) {
+    switch (level) {
+    case Level::Debug: return "DEBUG";
+    case Level::Info: return "INFO";
+    case Level::Warning: return "WARN";
+    case Level::Error: return "ERROR";
+    }
+    return "?";
+}
+
+std::string formatRecord(const Record& record) {
+    const auto sinceEpoch = record.time.time_since_epoch();
+    const std::time_t seconds = std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch).count();
+    const int millis = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(sinceEpoch).count() % 1000);
+    std::tm local{};
+    localtime_r(&seconds, &local);
+    char prefix[96];
+    std::snprintf(prefix, sizeof(prefix), "%04d-%02d-%02d %02d:%02d:%02d.%03d %-5s [t%u] %s:%d ", local.tm_year + 1900,
+                  local.tm_mon + 1, local.tm_mday, local.tm_hour, local.tm_min, local.tm_sec, millis,
+                  levelName(record.level), record.thread, record.file, record.line);
+    return prefix + record.message;
+}
+
+bool RateLimit::allow() {
+    const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t start = m_windowStart.load(std::memory_order_relaxed);
+    if (now - start >= 1000000000LL && m_windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        m_count.store(0, std::memory_order_relaxed);
+    }
+    if (m_count.fetch_add(1, std::memory_order_relaxed) < m_perSecond) return true;
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+Line::Line(Level level, const char* file, int line, RateLimit* limit)
+    : m_level(level), m_file(baseName(file)), m_line(line), m_limit(limit), m_buffer(detail::acquireBuffer()),
+      m_stream(m_buffer->stream) {}
+
+Line::~Line() {
+    if (m_limit) {
+        const uint64_t suppressed = m_limit->takeSuppressed();
+        if (suppressed > 0) m_stream << " (" << suppressed << " similar suppressed)";
+    }
+    Logger::instance().submit(m_level, m_file, m_line, m_buffer->data, m_buffer->length());
+    detail::releaseBuffer(m_buffer);
+}
+
+} // namespace Log
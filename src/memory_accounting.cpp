@@ -0,0 +1,124 @@
+#include "memory_accounting.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+
+struct MemoryCounter::Pool {
+    explicit Pool(std::string poolName) : name(std::move(poolName)) {}
+
+    const std::string name;
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> peakBytes{0};
+    std::atomic<uint64_t> items{0};
+};
+
+namespace {
+// Pools are never freed: counters of objects destroyed during static destruction can still
+// release into them
+struct Registry {
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<MemoryCounter::Pool>> pools;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+MemoryCounter::Pool& poolFor(const char* name) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto& pool = reg.pools[name];
+    if (!pool) pool = std::make_unique<MemoryCounter::Pool>(name);
+    return *pool;
+}
+
+// Subtract without wrapping below zero (a release racing a clear must not underflow)
+void subtractClamped(std::atomic<uint64_t>& value, uint64_t amount) {
+    uint64_t current = value.load(std::memory_order_relaxed);
+    while (!value.compare_exchange_weak(current, current - std::min(current, amount), std::memory_order_relaxed)) {
+    }
+}
+} // namespace
+
+MemoryCounter::MemoryCounter(const char* pool) : m_pool(poolFor(pool)) {}
+
+MemoryCounter::~MemoryCounter() {
+    clear();
+}
+
+void MemoryCounter::add(uint64_t bytes, uint64_t items) {
+    m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    m_items.fetch_add(items, std::memory_order_relaxed);
+    const uint64_t total = m_pool.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    m_pool.items.fetch_add(items, std::memory_order_relaxed);
+    uint64_t peak = m_pool.peakBytes.load(std::memory_order_relaxed);
+    while (total > peak && !m_pool.peakBytes.compare_exchange_weak(peak, total, std::memory_order_relaxed)) {
+    }
+}
+
+void MemoryCounter::release(uint64_t bytes, uint64_t items) {
+    subtractClamped(m_bytes, bytes);
+    subtractClamped(m_items, items);
+    subtractClamped(m_pool.bytes, bytes);
+    subtractClamped(m_pool.items, items);
+}
+
+void MemoryCounter::clear() {
+    const uint64_t bytes = m_bytes.exchange(0, std::memory_order_relaxed);
+    const uint64_t items = m_items.exchange(0, std::memory_order_relaxed);
+    subtractClamped(m_pool.bytes, bytes);
+    subtractClamped(m_pool.items, items);
+}
+
+namespace MemoryAccounting {
+
+std::vector<PoolUsage> snapshot() {
+    std::vector<PoolUsage> result;
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& [name, pool] : reg.pools) {
+            result.push_back({name, pool->bytes.load(std::memory_order_relaxed),
+                              pool->peakBytes.load(std::memory_order_relaxed), pool->items.load(std::memory_order_relaxed)});
+        }
+    }
+    std::stable_sort(result.begin(), result.end(), [](const PoolUsage& a, const PoolUsage& b) { return a.bytes > b.bytes; });
+    return result;
+}
+
+uint64_t totalBytes() {
+    uint64_t total = 0;
+    for (const auto& pool : snapshot()) total += pool.bytes;
+    return total;
+}
+
+uint64_t residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t sizePages = 0;
+    uint64_t residentPages = 0;
+    if (!(statm >> sizePages >> residentPages)) return 0;
+    const long pageSize = sysconf(_SC_PAGE_SIZE);
+    return pageSize > 0 ? residentPages * static_cast<uint64_t>(pageSize) : 0;
+}
+
+std::string formatBytes(uint64_t bytes) {
+    static const char* const UNITS[] = {"B", "KB", "MB", "GB", "TB"};
+    if (bytes < 1024) return std::to_string(bytes) + " B";
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit + 1 < sizeof(UNITS) / sizeof(UNITS[0])) {
+        value /= 1024.0;
+        ++unit;
+    }
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1f %s", value, UNITS[unit]);
+    return text;
+}
+
+} // namespace MemoryAccounting
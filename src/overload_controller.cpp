@@ -0,0 +1,164 @@
+#include "overload_controller.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+namespace {
+// Cheapest reductions first; capture is never part of the ladder
+const std::array<PreviewBudget, 5> LEVELS = {{
+    {0, 1.0, 1.0, 1.0, false},
+    {1, 1.0, 1.0, 1.0, true},
+    {2, 0.5, 1.0, 1.0, true},
+    {3, 0.5, 0.5, 0.5, true},
+    {4, 0.25, 0.25, 0.25, true},
+}};
+
+// Aggregate busy/total jiffies from the first line of /proc/stat
+bool readCpuTimes(uint64_t& busy, uint64_t& total) {
+    std::ifstream stat("/proc/stat");
+    std::string line;
+    if (!stat || !std::getline(stat, line) || line.rfind("cpu ", 0) != 0) return false;
+    std::istringstream fields(line.substr(4));
+    uint64_t value = 0;
+    uint64_t idle = 0;
+    total = 0;
+    for (int i = 0; fields >> value; ++i) {
+        total += value;
+        if (i == 3 || i == 4) idle += value; // idle + iowait
+    }
+    busy = total - idle;
+    return total > 0;
+}
+} // namespace
+
+OverloadController::OverloadController() : OverloadController(Options{}) {}
+
+OverloadController::OverloadController(Options options) : m_options(options) {}
+
+OverloadController::~OverloadController() {
+    stop();
+}
+
+void OverloadController::addProbe(const std::string& name, Probe probe) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_probes.push_back({name, std::move(probe)});
+}
+
+void OverloadController::addCpuProbe(double busyLimit) {
+    struct Sample {
+        uint64_t busy{0};
+        uint64_t total{0};
+    };
+    auto last = std::make_shared<Sample>();
+    readCpuTimes(last->busy, last->total);
+    addProbe("cpu", [last, busyLimit]() {
+        Sample now;
+        if (!readCpuTimes(now.busy, now.total) || now.total <= last->total) return 0.0;
+        const double busy = static_cast<double>(now.busy - last->busy) / static_cast<double>(now.total - last->total);
+        *last = now;
+        return busyLimit > 0.0 ? busy / busyLimit : 0.0;
+    });
+}
+
+void OverloadController::setLevelCallback(LevelCallback callback) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_callback = std::move(callback);
+}
+
+void OverloadController::start() {
+    std::lock_guard<std::mutex> lock(m_threadMutex);
+    if (m_running) return;
+    m_running = true;
+    m_thread = std::thread(&OverloadController::monitorLoop, this);
+}
+
+void OverloadController::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_threadMutex);
+        if (!m_running) return;
+        m_running = false;
+    }
+    m_threadCv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void OverloadController::monitorLoop() {
+    std::unique_lock<std::mutex> lock(m_threadMutex);
+    while (m_running) {
+        lock.unlock();
+        evaluate();
+        lock.lock();
+        m_threadCv.wait_for(lock, m_options.interval, [this] { return !m_running; });
+    }
+}
+
+int OverloadController::evaluate(Clock::time_point now) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    double pressure = 0.0;
+    std::string dominant;
+    for (const auto& entry : m_probes) {
+        double value = 0.0;
+        try {
+            value = entry.probe();
+        } catch (...) {
+            continue; // a failing probe must not take the controller down
+        }
+        if (value > pressure) {
+            pressure = value;
+            dominant = entry.name;
+        }
+    }
+    m_pressure = pressure;
+    m_dominant = dominant;
+
+    const int previous = m_level.load(std::memory_order_relaxed);
+    int next = previous;
+    if (pressure > m_options.highWater) {
+        next = std::min(previous + 1, maxLevel());
+        m_calm = false;
+    } else if (pressure < m_options.lowWater) {
+        if (!m_calm) {
+            m_calm = true;
+            m_calmSince = now;
+        } else if (previous > 0 && now - m_calmSince >= m_options.recoverAfter) {
+            next = previous - 1;
+            m_calmSince = now; // the next step needs another calm period
+        }
+    } else {
+        m_calm = false;
+    }
+    if (next == previous) return next;
+
+    m_level.store(next, std::memory_order_relaxed);
+    const auto callback = m_callback;
+    lock.unlock();
+    if (callback) {
+        std::ostringstream reason;
+        reason.precision(2);
+        reason << std::fixed << (next > previous ? "pressure " : "recovered, pressure ") << pressure;
+        if (!dominant.empty() && next > previous) reason << " (" << dominant << ")";
+        callback(next, reason.str());
+    }
+    return next;
+}
+
+double OverloadController::pressure() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pressure;
+}
+
+std::string OverloadController::dominantProbe() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dominant;
+}
+
+PreviewBudget OverloadController::budgetForLevel(int level) {
+    return LEVELS[static_cast<size_t>(std::clamp(level, 0, maxLevel()))];
+}
+
+int OverloadController::maxLevel() {
+    return static_cast<int>(LEVELS.size()) - 1;
+}
@@ -11,11 +11,17 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QDir>
+#include <QFileInfo>
 #include <QPixmap>
 #include <QColor>
 #include <QPalette>
 #include <QMetaObject>
+#include <QPainter>
+#include <QStringList>
 #include "recording_manager.h"
+#include "device_lifecycle_manager.h"
+#include "frame_quality_analyzer.h"
+#include "memory_accounting.h"
 #include "recording_loader.h" // for cvMatToQImage utility function
 #include "utils_qt.h"
 
@@ -24,6 +30,7 @@
 #include <iostream>
 #include <chrono>
 #include <ctime>
+#include <cmath>
 
 // Utility function implementations
 Pane createPane(const QString &title, const QColor &color) {
@@ -57,6 +64,13 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
     connect(m_dataLoader, &RecordingLoader::loadingStarted, this, &PlayerWindow::onLoadingStarted);
     connect(m_dataLoader, &RecordingLoader::loadingFinished, this, &PlayerWindow::onLoadingFinished);
     connect(m_dataLoader, &RecordingLoader::loadingProgress, this, &PlayerWindow::onLoadingProgress);
+    connect(m_dataLoader, &RecordingLoader::eventFrameSetReady, this, [this](qulonglong frameIndex) {
+        // A late frame set caught up: show it if we are still on that instant
+        if (m_eventSetLate && frameIndex == m_currentIndex.load()) {
+            updateDisplays();
+            updateStatus();
+        }
+    });
 
     // Initialize recording buffer
     m_recordingBuffer = new RecordingBuffer(this);
@@ -72,11 +86,24 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
 
     // Initialize recording manager
     m_recordingManager = new RecordingManager();
+    m_deviceLifecycle = new DeviceLifecycleManager(*m_recordingManager);
+    m_qualityAnalyzer = std::make_unique<FrameQualityAnalyzer>(m_recordingManager->liveDataBus());
+    m_qualityAnalyzer->start();
     m_recordingManager->setStatusCallback([this](const std::string& message) {
         emit QMetaObject::invokeMethod(this, "onRecordingStatusUpdate", 
                                       Qt::QueuedConnection,
                                       Q_ARG(QString, QString::fromStdString(message)));
     });
+    // Post-processing moves (staging) or replaces (RAW -> HDF5) the files of a loaded take; reload it
+    m_recordingManager->setTakeFinalizedCallback([this](const std::string& finalDirectory, bool success) {
+        if (!success) return;
+        const QString finalDir = QString::fromStdString(finalDirectory);
+        QMetaObject::invokeMethod(this, [this, finalDir]{
+            if (!m_isRecording && QFileInfo(m_loadedDir).fileName() == QFileInfo(finalDir).fileName()) {
+                loadRecording(finalDir);
+            }
+        }, Qt::QueuedConnection);
+    });
 
     auto *rootLayout = new QVBoxLayout(this);
 
@@ -93,8 +120,14 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
     m_recordingStatusLabel->setStyleSheet("QLabel { color: red; font-weight: bold; }");
     m_stopShowRecButton = new QPushButton(tr("Stop (show recording)"));
     m_stopShowRecButton->setEnabled(false);
+    m_nextTakeButton = new QPushButton(tr("Next Take"));
+    m_nextTakeButton->setToolTip(tr("Close the current take and continue recording into a new folder without a gap"));
+    m_nextTakeButton->setEnabled(false);
     m_stopShowPrevButton = new QPushButton(tr("Stop (show preview)"));
     m_stopShowPrevButton->setEnabled(false);
+    m_releaseCamerasButton = new QPushButton(tr("Release Cameras"));
+    m_releaseCamerasButton->setToolTip(tr("Close all cameras so other applications can use them. "
+                                          "They are reopened automatically for the next recording."));
     
     topBar->addWidget(m_openButton);
     topBar->addSpacing(12);
@@ -105,6 +138,8 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
     topBar->addWidget(m_stopShowRecButton);
     topBar->addWidget(m_stopShowPrevButton);
     topBar->addSpacing(8);
+    topBar->addWidget(m_releaseCamerasButton);
+    topBar->addWidget(m_nextTakeButton);
     topBar->addWidget(m_recordButton);
     rootLayout->addLayout(topBar);
 
@@ -126,6 +161,10 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
     grid->setRowStretch(1, 1);
     rootLayout->addLayout(grid, 1);
 
+    // Thumbnail overview of the whole recording, filled in the background after loading
+    m_thumbnailStrip = new TimelineThumbnailStrip();
+    rootLayout->addWidget(m_thumbnailStrip);
+
     // Timeline slider
     m_timelineSlider = new CachedTimelineSlider(Qt::Horizontal);
     m_timelineSlider->setRange(0, 1000);
@@ -138,6 +177,10 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
     m_btnBack = new QPushButton("<<");
     m_btnPlay = new QPushButton("Play");
     m_btnFwd = new QPushButton(">>");
+    m_overlayCheck = new QCheckBox(tr("Overlay events"));
+    m_overlayCheck->setToolTip(tr("Blend each event camera's activity onto its frame camera (overlay_calibration.yml)"));
+    m_rectifyCheck = new QCheckBox(tr("Rectify"));
+    m_rectifyCheck->setToolTip(tr("Undistort/rectify frame cameras (rectification.yml)"));
     m_statusLabel = new QLabel("Frame 0 / 0    00:00.000 / 00:00.000");
     QFont mono = m_statusLabel->font();
     mono.setFamily("Monospace");
@@ -151,6 +194,19 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
     m_fpsLabel->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
     m_fpsLabel->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Preferred);
 
+    m_memoryLabel = new QLabel();
+    m_memoryLabel->setFont(mono);
+    m_memoryLabel->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    m_memoryLabel->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Preferred);
+
+    // Live image quality (focus, clipping, histogram) on the left
+    m_qualityLabel = new QLabel();
+    m_qualityLabel->setFont(mono);
+    m_histogramLabel = new QLabel();
+    m_histogramLabel->setFixedSize(128, 32);
+    controlsLayout->addWidget(m_histogramLabel);
+    controlsLayout->addWidget(m_qualityLabel);
+
     // Left stretch
     controlsLayout->addStretch(1);
     // Center button cluster
@@ -159,12 +215,17 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
     buttonCluster->addWidget(m_btnBack);
     buttonCluster->addWidget(m_btnPlay);
     buttonCluster->addWidget(m_btnFwd);
+    buttonCluster->addSpacing(16);
+    buttonCluster->addWidget(m_overlayCheck);
+    buttonCluster->addWidget(m_rectifyCheck);
     controlsLayout->addLayout(buttonCluster);
     // Right stretch then status label and FPS
     controlsLayout->addStretch(1);
     controlsLayout->addWidget(m_statusLabel, 0, Qt::AlignRight);
     controlsLayout->addSpacing(12);
     controlsLayout->addWidget(m_fpsLabel, 0, Qt::AlignRight);
+    controlsLayout->addSpacing(12);
+    controlsLayout->addWidget(m_memoryLabel, 0, Qt::AlignRight);
     rootLayout->addLayout(controlsLayout);
 
     // Timer for mock playback
@@ -180,6 +241,14 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
     });
 
     // Timer for updating cached frame display
+    m_qualityTimer.setInterval(500);
+    connect(&m_qualityTimer, &QTimer::timeout, this, &PlayerWindow::updateQualityDisplay);
+    m_qualityTimer.start();
+
+    m_memoryTimer.setInterval(1000);
+    connect(&m_memoryTimer, &QTimer::timeout, this, &PlayerWindow::updateMemoryDisplay);
+    m_memoryTimer.start();
+
     m_cacheUpdateTimer.setInterval(500); // Update every 500ms
     connect(&m_cacheUpdateTimer, &QTimer::timeout, this, &PlayerWindow::updateCachedFrames);
     m_cacheUpdateTimer.start();
@@ -200,10 +269,18 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
         m_timelineSlider->setValue(std::min(m_timelineSlider->maximum(), v + 50));
     });
 
+    connect(m_overlayCheck, &QCheckBox::toggled, this, [this]{ updateDisplays(); });
+    connect(m_rectifyCheck, &QCheckBox::toggled, this, [this]{
+        applyLiveRectifier();
+        updateDisplays();
+    });
+
     connect(m_openButton, &QPushButton::clicked, this, [this]{ selectAndLoadFolder(); });
     connect(m_recordButton, &QPushButton::clicked, this, &PlayerWindow::onRecordingToggle);
     connect(m_stopShowRecButton, &QPushButton::clicked, this, [this]{ if (m_isRecording) { stopRecording(); } });
     connect(m_stopShowPrevButton, &QPushButton::clicked, this, &PlayerWindow::stopRecordingShowPreview);
+    connect(m_nextTakeButton, &QPushButton::clicked, this, &PlayerWindow::startNextTake);
+    connect(m_releaseCamerasButton, &QPushButton::clicked, this, &PlayerWindow::onReleaseCameras);
 
     // Recording status timer
     m_recordingTimer.setInterval(1000); // Update every second
@@ -214,6 +291,7 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
         }
     });
 
+    connect(m_thumbnailStrip, &TimelineThumbnailStrip::frameRequested, m_timelineSlider, &QSlider::setValue);
     connect(m_timelineSlider, &QSlider::valueChanged, this, [this](int v){
         if (!m_dataLoader->isDataReady()) return;
         
@@ -221,6 +299,7 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
         updateFPS(v);
         
         m_currentIndex = v;
+        m_thumbnailStrip->setCurrentFrame(static_cast<size_t>(v));
         
         // Notify event camera loaders about frame change for prefetching
         m_dataLoader->notifyFrameChanged(v);
@@ -230,25 +309,43 @@ PlayerWindow::PlayerWindow(QWidget *parent) : QWidget(parent) {
     });
     // Start async configuration and preview
     RecordingManager::RecordingConfig defaultCfg;
+    defaultCfg.eventFileFormat = "hdf5";
     m_recordingManager->configureAsync(defaultCfg, [this](bool ok, const std::string& message){
         std::cout << message << std::endl;
         if (ok) {
-            // Start preview
-            m_recordingManager->startPreview();
-            // Switch buffer to live mode (preview)
-            QMetaObject::invokeMethod(this, [this]{
-                if (!m_isRecording) {
-                    m_recordingBuffer->setLiveMode(static_cast<void*>(m_recordingManager));
-                }
-            }, Qt::QueuedConnection);
+            // Start preview (queued behind the configure command, runs on the control thread)
+            m_recordingManager->submitPreview([this](const RecordingManager::CommandResult& result) {
+                if (!result.success) return;
+                // Switch buffer to live mode (preview)
+                QMetaObject::invokeMethod(this, [this]{
+                    if (!m_isRecording) {
+                        m_recordingBuffer->setLiveMode(static_cast<void*>(m_recordingManager));
+                    }
+                }, Qt::QueuedConnection);
+            });
         }
     });
 }
 
 PlayerWindow::~PlayerWindow() {
-    // Stop recording if it's running
-    if (m_isRecording) {
-        stopRecording();
+    // Thumbnail workers read through the data loader, which may be destroyed first
+    if (m_thumbnailStrip) {
+        m_thumbnailStrip->clear();
+    }
+    // Finish a running take (files are closed on return); no auto-load on exit
+    if (m_isRecording && m_deviceLifecycle) {
+        m_deviceLifecycle->stopTake();
+        m_isRecording = false;
+    }
+    // Detach the live buffer and the analyzer from the manager's bus before the manager goes away
+    if (m_recordingBuffer) {
+        m_recordingBuffer->stop();
+    }
+    m_qualityAnalyzer.reset();
+    // App exit is the only implicit point where the cameras are released
+    if (m_deviceLifecycle) {
+        m_deviceLifecycle->release();
+        delete m_deviceLifecycle;
     }
     // Clean up recording manager
     delete m_recordingManager;
@@ -273,19 +370,18 @@ void PlayerWindow::loadRecording(const QString &dirPath) {
     if (m_recordingBuffer && m_recordingBuffer->getCurrentMode() == RecordingBuffer::Mode::Live) {
         // Stop live buffer and preview to avoid resource contention
         m_recordingBuffer->stop();
-        if (m_recordingManager) {
-            m_recordingManager->stopPreview();
+        // Devices stay open (idle) so the next take starts without reconfiguration; a running
+        // take is left alone
+        if (m_recordingManager && !m_isRecording && !m_controlPending) {
+            m_recordingManager->submitStop();
         }
         m_isRecording = false;
-        if (m_recordButton) {
-            m_recordButton->setText(tr("Start Recording"));
-            m_recordButton->setStyleSheet("QPushButton { background-color: #4CAF50; color: white; font-weight: bold; }");
-        }
-        if (m_recordingStatusLabel) m_recordingStatusLabel->setText("");
+        applyRecordingUi(false);
         m_recordingTimer.stop();
     }
     
     // Abort any ongoing loading and clean up previous state
+    m_thumbnailStrip->clear();
     if (m_dataLoader->isLoading()) {
         std::cout << "Aborting previous loading operation..." << std::endl;
         m_dataLoader->abortLoading();
@@ -338,6 +434,12 @@ void PlayerWindow::onLoadingFinished(bool success, const QString &message) {
         
         // Start prefetching from frame 0
         m_dataLoader->notifyFrameChanged(0);
+        m_thumbnailStrip->setRecording(m_dataLoader, m_loadedDir, data.totalFrames);
+
+        // A calibration stored with the recording wins over the one given on the command line
+        const auto recordingRectifier = FrameRectifier::fromFile(
+            (std::filesystem::path(data.loadedPath) / FrameRectifier::CALIBRATION_FILE).string(), data.frameCams.size());
+        m_playbackRectifier = recordingRectifier ? recordingRectifier : m_configuredRectifier;
         
         updateDisplays();
     } else {
@@ -348,6 +450,67 @@ void PlayerWindow::onLoadingFinished(bool success, const QString &message) {
     updateStatus();
 }
 
+void PlayerWindow::setPreloadOptions(const PreloadOptions &options) {
+    m_dataLoader->setPreloadOptions(options);
+}
+
+void PlayerWindow::setRectificationFile(const QString &path) {
+    m_configuredRectifier = FrameRectifier::fromFile(path.toStdString(), 2);
+    if (!m_configuredRectifier) {
+        std::cerr << "No frame camera calibration found in " << path.toStdString() << std::endl;
+    }
+    applyLiveRectifier();
+}
+
+void PlayerWindow::updateQualityDisplay() {
+    const bool live = m_recordingBuffer && m_recordingBuffer->getCurrentMode() == RecordingBuffer::Mode::Live;
+    FrameQualityMetrics metrics[2];
+    const bool available[2] = {live && m_qualityAnalyzer->latest(0, metrics[0]),
+                               live && m_qualityAnalyzer->latest(1, metrics[1])};
+    if (!available[0] && !available[1]) {
+        m_qualityLabel->clear();
+        m_histogramLabel->clear();
+        return;
+    }
+
+    QStringList parts;
+    const char *names[2] = {"L", "R"};
+    for (int cam = 0; cam < 2; ++cam) {
+        if (!available[cam]) continue;
+        parts << QString("%1 focus %2  clip %3%/%4%")
+                     .arg(names[cam])
+                     .arg(metrics[cam].sharpness, 0, 'f', 0)
+                     .arg(metrics[cam].clippedHighRatio * 100.0, 0, 'f', 1)
+                     .arg(metrics[cam].clippedLowRatio * 100.0, 0, 'f', 1);
+    }
+    m_qualityLabel->setText(parts.join("   "));
+
+    // Both grey-level histograms overlaid (left blue, right orange), log scale
+    QPixmap histogram(m_histogramLabel->size());
+    histogram.fill(QColor(30, 30, 30));
+    QPainter painter(&histogram);
+    const QColor colors[2] = {QColor(70, 120, 200, 180), QColor(200, 140, 70, 180)};
+    const int bins = FrameQualityMetrics::HISTOGRAM_BINS;
+    const double binWidth = static_cast<double>(histogram.width()) / bins;
+    for (int cam = 0; cam < 2; ++cam) {
+        if (!available[cam]) continue;
+        for (int bin = 0; bin < bins; ++bin) {
+            const double value = std::log10(1.0 + 1000.0 * metrics[cam].histogram[static_cast<size_t>(bin)]) / 3.0;
+            const int barHeight = static_cast<int>(std::min(1.0, value) * histogram.height());
+            painter.fillRect(QRectF(bin * binWidth, histogram.height() - barHeight, binWidth, barHeight), colors[cam]);
+        }
+    }
+    painter.end();
+    m_histogramLabel->setPixmap(histogram);
+}
+
+void PlayerWindow::applyLiveRectifier() {
+    if (!m_recordingBuffer || !m_rectifyCheck || m_panes.empty()) return;
+    // Maps are built for the pane size, so the worker rectifies at preview resolution
+    const bool enabled = m_rectifyCheck->isChecked() && m_configuredRectifier;
+    m_recordingBuffer->setLiveRectifier(enabled ? m_configuredRectifier : nullptr, m_panes[0].content->width());
+}
+
 void PlayerWindow::onLoadingProgress(const QString &status) {
     m_pathLabel->setText(status);
 }
@@ -357,6 +520,9 @@ void PlayerWindow::updateDisplays() {
     if (m_recordingBuffer && m_recordingBuffer->getCurrentMode() == RecordingBuffer::Mode::Live) {
         // Use live data from recording buffer
         UnifiedFrameData liveData = m_recordingBuffer->getLatestLiveData();
+        // Smooth scaling is the most expensive part of the GUI path; drop it under load
+        const Qt::TransformationMode scaling = m_recordingManager->overloadController().budget().resolutionScale < 1.0
+            ? Qt::FastTransformation : Qt::SmoothTransformation;
         
         if (liveData.isValid) {
             // Frame cameras
@@ -364,7 +530,7 @@ void PlayerWindow::updateDisplays() {
                 const auto& frameData = liveData.frameData[cam];
                 if (frameData.isValid && !frameData.image.empty()) {
                     QPixmap pm = QPixmap::fromImage(cvMatToQImage(frameData.image)).scaled(
-                        m_panes[cam].content->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+                        m_panes[cam].content->size(), Qt::KeepAspectRatio, scaling);
                     m_panes[cam].content->setPixmap(pm);
                 } else {
                     m_panes[cam].content->setText("(live: no frame)");
@@ -377,7 +543,7 @@ void PlayerWindow::updateDisplays() {
                 const auto& eventData = liveData.eventData[cam];
                 if (eventData.isValid && !eventData.frame.isNull()) {
                     QPixmap pm = QPixmap::fromImage(eventData.frame).scaled(
-                        m_panes[paneIndex].content->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+                        m_panes[paneIndex].content->size(), Qt::KeepAspectRatio, scaling);
                     m_panes[paneIndex].content->setPixmap(pm);
                 } else {
                     m_panes[paneIndex].content->setText("(live: no events)");
@@ -392,9 +558,22 @@ void PlayerWindow::updateDisplays() {
     
     size_t idx = m_currentIndex;
     
+    // Event cameras, as one frame set of what the playback engine has already rendered; the
+    // GUI thread never waits for it. Missing images arrive with eventFrameSetReady.
+    const EventFrameSet eventSet = m_dataLoader->getEventFrameSet(idx, std::chrono::milliseconds(0));
+    m_eventSetLate = eventSet.late;
+    auto eventImage = [&eventSet](int cam) {
+        return cam < static_cast<int>(eventSet.images.size()) ? eventSet.images[cam] : QImage();
+    };
+
     // Frame cameras
+    const bool overlay = m_overlayCheck->isChecked();
     for (int cam = 0; cam < 2; ++cam) {
-        cv::Mat img = m_dataLoader->getFrameCameraFrame(cam, idx);
+        cv::Mat img = overlay ? m_dataLoader->getFrameCameraOverlay(cam, idx, eventImage(cam))
+                              : m_dataLoader->getFrameCameraFrame(cam, idx);
+        if (m_rectifyCheck->isChecked() && m_playbackRectifier) {
+            img = m_playbackRectifier->rectifyPreview(cam, img, m_panes[cam].content->width());
+        }
         if (!img.empty()) {
             QPixmap pm = QPixmap::fromImage(cvMatToQImage(img)).scaled(
                 m_panes[cam].content->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
@@ -404,22 +583,23 @@ void PlayerWindow::updateDisplays() {
         }
     }
     
-    // Event cameras
     for (int cam = 0; cam < 2; ++cam) {
         int paneIndex = 2 + cam; // bottom row
-        QImage eventImg = m_dataLoader->getEventCameraFrame(cam, idx);
+        const QImage eventImg = eventImage(cam);
         if (!eventImg.isNull()) {
             QPixmap pm = QPixmap::fromImage(eventImg).scaled(
                 m_panes[paneIndex].content->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
             m_panes[paneIndex].content->setPixmap(pm);
-        } else {
+        } else if (!eventSet.late) {
             m_panes[paneIndex].content->setText("(no events)");
         }
+        // Late and missing: keep the previous image until eventFrameSetReady arrives
     }
 }
 
 void PlayerWindow::resizeEvent(QResizeEvent *e) {
     QWidget::resizeEvent(e);
+    applyLiveRectifier();
     updateDisplays();
     updateStatus();
 }
@@ -446,14 +626,37 @@ void PlayerWindow::updateStatus() {
     double totTime = (total > 0 ? (total - 1) / m_assumedFps : 0.0);
     
     if (m_statusLabel) {
-        m_statusLabel->setText(QString("Frame %1 / %2    %3 / %4")
+        m_statusLabel->setText(QString("Frame %1 / %2    %3 / %4%5")
             .arg(cur).arg(total ? total - 1 : 0)
             .arg(formatTime(curTime))
-            .arg(formatTime(totTime)));
+            .arg(formatTime(totTime))
+            .arg(m_eventSetLate ? "    (events catching up)" : ""));
     }
 }
 
+void PlayerWindow::updateMemoryDisplay() {
+    const auto pools = MemoryAccounting::snapshot();
+    uint64_t total = 0;
+    QStringList lines;
+    for (const auto &pool : pools) {
+        total += pool.bytes;
+        lines << QString("%1: %2 in %3 entries (peak %4)")
+                     .arg(QString::fromStdString(pool.name))
+                     .arg(QString::fromStdString(MemoryAccounting::formatBytes(pool.bytes)))
+                     .arg(pool.items)
+                     .arg(QString::fromStdString(MemoryAccounting::formatBytes(pool.peakBytes)));
+    }
+    const uint64_t resident = MemoryAccounting::residentBytes();
+    m_memoryLabel->setText(QString("Mem: %1 / RSS %2")
+        .arg(QString::fromStdString(MemoryAccounting::formatBytes(total)))
+        .arg(QString::fromStdString(MemoryAccounting::formatBytes(resident))));
+    m_memoryLabel->setToolTip(lines.join('\n'));
+    if (m_recordingManager) m_recordingManager->publishMemoryUsage();
+}
+
 void PlayerWindow::updateCachedFrames() {
+    // Rendering ahead competes with live capture; the overload controller decides when to stop
+    m_dataLoader->setPrefetchPaused(m_recordingManager->overloadController().budget().prefetchPaused);
     if (!m_dataLoader->isDataReady()) {
         return;
     }
@@ -498,8 +701,8 @@ void PlayerWindow::updateFPS(size_t currentFrame) {
 }
 
 void PlayerWindow::startRecording() {
-    if (m_isRecording) {
-        return; // Already recording
+    if (m_isRecording || m_controlPending) {
+        return; // Already recording, or a start/stop is still in progress
     }
     
     // Create default recording configuration
@@ -514,89 +717,118 @@ void PlayerWindow::startRecording() {
     std::cout << "  Event file format: " << config.eventFileFormat << std::endl;
     std::cout << "  Biases provided: " << (config.biases.empty() ? "none (will use defaults)" : "yes") << std::endl;
     
-    try {
-        // If not configured yet, configure now
-        if (!m_recordingManager->isConfigured()) {
-            notifyStatus("Configuring cameras for first use...");
-            if (!m_recordingManager->configure(config)) {
-                QMessageBox::warning(this, tr("Recording Error"), 
-                                   tr("Failed to configure cameras. Please check camera connections."));
+    // Cameras are normally still open from the previous take; only (re)open if released.
+    // Both commands run in order on the manager's control thread: if configuring fails, the
+    // record command is rejected and reported below.
+    if (!m_recordingManager->isConfigured()) {
+        notifyStatus("Configuring cameras for first use...");
+        m_recordingManager->submitConfigure(config);
+    }
+    
+    // Generate output directory for this recording
+    const std::string outputDir = generateRecordingDirectory();
+    const auto requested = std::chrono::steady_clock::now();
+    m_controlPending = true;
+    m_recordButton->setEnabled(false);
+    m_recordingStatusLabel->setText(tr("Starting..."));
+    
+    m_recordingManager->submitRecord(outputDir, [this, requested](const RecordingManager::CommandResult& result) {
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - requested).count();
+        QMetaObject::invokeMethod(this, [this, result, ms] {
+            m_controlPending = false;
+            m_recordButton->setEnabled(true);
+            if (!result.success) {
+                m_recordingStatusLabel->setText("");
+                QMessageBox::warning(this, tr("Recording Error"),
+                                     tr("Failed to start recording (%1). Please check camera connections.")
+                                         .arg(QString::fromStdString(result.message)));
                 return;
             }
-        }
-        
-        // Generate output directory for this recording
-        std::string outputDir = generateRecordingDirectory();
-        
-        if (m_recordingManager->startRecording(outputDir)) {
+            notifyStatus("Recording started " + std::to_string(ms) + " ms after request");
             m_isRecording = true;
-            m_recordButton->setText(tr("Stop Recording"));
-            m_recordButton->setStyleSheet("QPushButton { background-color: #f44336; color: white; font-weight: bold; }");
+            applyRecordingUi(true);
             m_recordingStatusLabel->setText(tr("Recording: 0.0s"));
             m_recordingTimer.start();
             
             // Switch recording buffer to live mode
             m_recordingBuffer->setLiveMode(m_recordingManager);
-            
-        } else {
-            QMessageBox::warning(this, tr("Recording Error"), 
-                               tr("Failed to start recording. Please check camera connections."));
-        }
-    } catch (const std::exception& e) {
-        QMessageBox::critical(this, tr("Recording Error"), 
-                            tr("Error starting recording: %1").arg(QString::fromStdString(e.what())));
-    }
+        }, Qt::QueuedConnection);
+    });
 }
 
 void PlayerWindow::stopRecording() {
-    if (!m_isRecording) {
-        return; // Not recording
+    if (!m_isRecording || m_controlPending) {
+        return; // Not recording, or already stopping
     }
     
-    try {
-        QString recordingDir = QString::fromStdString(m_recordingManager->getCurrentOutputDirectory());
-        // Stop the recording (non-UI heavy), and stop the live buffer immediately
-        m_recordingManager->stopRecording();
-        m_recordingBuffer->stop();
-        
-        m_isRecording = false;
-        m_recordButton->setText(tr("Start Recording"));
-        m_recordButton->setStyleSheet("QPushButton { background-color: #4CAF50; color: white; font-weight: bold; }");
-        m_recordingStatusLabel->setText("");
-        m_recordingTimer.stop();
-        
-        // Close devices and auto-load the recorded folder in background to keep UI responsive
-        std::thread([this, recordingDir]() {
-            try {
-                std::cout << "Closing camera devices to release file handles..." << std::endl;
-                if (m_recordingManager) {
-                    m_recordingManager->closeDevices();
-                }
-                // Ensure files are flushed and closed before loading
-                std::this_thread::sleep_for(std::chrono::milliseconds(3000));
-                if (!recordingDir.isEmpty() && QDir(recordingDir).exists()) {
-                    QMetaObject::invokeMethod(this, [this, recordingDir]() {
-                        std::cout << "Auto-loading recorded folder after delay: " << recordingDir.toStdString() << std::endl;
-                        loadRecording(recordingDir);
-                    }, Qt::QueuedConnection);
-                }
-            } catch (const std::exception& e) {
-                QMetaObject::invokeMethod(this, [this, e]() {
-                    QMessageBox::critical(this, tr("Recording Error"), 
-                                          tr("Error closing devices: %1").arg(QString::fromStdString(e.what())));
-                }, Qt::QueuedConnection);
+    m_controlPending = true;
+    m_recordButton->setEnabled(false);
+    m_recordingStatusLabel->setText(tr("Stopping..."));
+    
+    // Closing the files can take a while; the UI stays responsive until the result arrives.
+    // Cameras stay open for the next take.
+    m_recordingManager->submitStop([this](const RecordingManager::CommandResult& result) {
+        QMetaObject::invokeMethod(this, [this, result] {
+            m_controlPending = false;
+            m_recordButton->setEnabled(true);
+            m_recordingBuffer->stop();
+            m_isRecording = false;
+            applyRecordingUi(false);
+            m_recordingTimer.stop();
+            if (!result.success) {
+                QMessageBox::critical(this, tr("Recording Error"),
+                                      tr("Error stopping recording: %1").arg(QString::fromStdString(result.message)));
+                return;
             }
-        }).detach();
-        
-    } catch (const std::exception& e) {
-        QMessageBox::critical(this, tr("Recording Error"), 
-                            tr("Error stopping recording: %1").arg(QString::fromStdString(e.what())));
-        // Reset UI state anyway
-        m_isRecording = false;
-        m_recordButton->setText(tr("Start Recording"));
-        m_recordButton->setStyleSheet("QPushButton { background-color: #4CAF50; color: white; font-weight: bold; }");
+            
+            // Files are complete, load the take right away (this idles the cameras)
+            const QString recordingDir = QString::fromStdString(result.directory);
+            if (!recordingDir.isEmpty() && QDir(recordingDir).exists()) {
+                std::cout << "Auto-loading recorded folder: " << recordingDir.toStdString() << std::endl;
+                loadRecording(recordingDir);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void PlayerWindow::startNextTake() {
+    if (!m_isRecording || m_controlPending) {
+        return;
+    }
+
+    m_controlPending = true;
+    m_recordButton->setEnabled(false);
+    m_nextTakeButton->setEnabled(false);
+
+    // Capture keeps running; the previous take is closed (and summarized) on the control thread
+    m_recordingManager->submitNextTake(generateRecordingDirectory(), [this](const RecordingManager::CommandResult& result) {
+        QMetaObject::invokeMethod(this, [this, result] {
+            m_controlPending = false;
+            m_recordButton->setEnabled(true);
+            m_nextTakeButton->setEnabled(m_isRecording);
+            if (!result.success) {
+                QMessageBox::warning(this, tr("Recording Error"),
+                                     tr("Failed to start the next take: %1").arg(QString::fromStdString(result.message)));
+                return;
+            }
+            notifyStatus("Take closed: " + result.closedDirectory + ", recording to " + result.directory);
+            m_recordingStatusLabel->setText(tr("Recording: 0.0s"));
+        }, Qt::QueuedConnection);
+    });
+}
+
+void PlayerWindow::applyRecordingUi(bool recording) {
+    if (m_nextTakeButton) {
+        m_nextTakeButton->setEnabled(recording);
+    }
+    if (m_recordButton) {
+        m_recordButton->setText(recording ? tr("Stop Recording") : tr("Start Recording"));
+        m_recordButton->setStyleSheet(recording
+            ? "QPushButton { background-color: #f44336; color: white; font-weight: bold; }"
+            : "QPushButton { background-color: #4CAF50; color: white; font-weight: bold; }");
+    }
+    if (!recording && m_recordingStatusLabel) {
         m_recordingStatusLabel->setText("");
-        m_recordingTimer.stop();
     }
 }
 
@@ -609,24 +841,44 @@ void PlayerWindow::onRecordingToggle() {
 }
 
 void PlayerWindow::stopRecordingShowPreview() {
-    if (!m_isRecording) return;
-    try {
-        m_recordingManager->stopRecording();
-        // Keep devices open and continue live preview
-        m_isRecording = false;
-        m_recordButton->setText(tr("Start Recording"));
-        m_recordButton->setStyleSheet("QPushButton { background-color: #4CAF50; color: white; font-weight: bold; }");
-        m_recordingStatusLabel->setText("");
-        m_recordingTimer.stop();
-        // Ensure preview is running and buffer is in live mode
-        m_recordingManager->startPreview();
-        m_recordingBuffer->setLiveMode(static_cast<void*>(m_recordingManager));
-        m_stopShowRecButton->setEnabled(false);
-        m_stopShowPrevButton->setEnabled(false);
-    } catch (const std::exception& e) {
-        QMessageBox::critical(this, tr("Recording Error"), 
-                            tr("Error stopping recording: %1").arg(QString::fromStdString(e.what())));
+    if (!m_isRecording || m_controlPending) return;
+    m_controlPending = true;
+    m_recordButton->setEnabled(false);
+    m_recordingStatusLabel->setText(tr("Stopping..."));
+    
+    // Stop the take, then make sure the preview runs (no-op if it kept running); devices stay open
+    m_recordingManager->submitStop();
+    m_recordingManager->submitPreview([this](const RecordingManager::CommandResult& result) {
+        QMetaObject::invokeMethod(this, [this, result] {
+            m_controlPending = false;
+            m_recordButton->setEnabled(true);
+            m_isRecording = m_recordingManager->isRecording();
+            applyRecordingUi(m_isRecording);
+            if (!m_isRecording) m_recordingTimer.stop();
+            if (!result.success) {
+                QMessageBox::critical(this, tr("Recording Error"),
+                                      tr("Error stopping recording: %1").arg(QString::fromStdString(result.message)));
+                return;
+            }
+            // Ensure buffer is in live mode
+            m_recordingBuffer->setLiveMode(static_cast<void*>(m_recordingManager));
+            m_stopShowRecButton->setEnabled(false);
+            m_stopShowPrevButton->setEnabled(false);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void PlayerWindow::onReleaseCameras() {
+    if (m_isRecording || m_controlPending) {
+        QMessageBox::information(this, tr("Release Cameras"), tr("Stop the recording before releasing the cameras."));
+        return;
+    }
+    if (m_recordingBuffer && m_recordingBuffer->getCurrentMode() == RecordingBuffer::Mode::Live) {
+        m_recordingBuffer->stop();
     }
+    m_recordingManager->submitClose([this](const RecordingManager::CommandResult& result) {
+        notifyStatus(result.success ? std::string("Cameras released") : result.message);
+    });
 }
 
 void PlayerWindow::onRecordingStatusUpdate(const QString &message) {
@@ -0,0 +1,293 @@
+#include "profiled_mutex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+
+namespace LockProfiling {
+
+namespace {
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void updateMax(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+// Locks are created from static initializers and worker threads alike; the registry is
+// intentionally leaked so the exit report can still read it
+struct Registry {
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<LockStats>> stats;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+std::string symbolize(uintptr_t address) {
+    if (address == 0) return "(other call sites)";
+    std::ostringstream out;
+    Dl_info info{};
+    if (dladdr(reinterpret_cast<void*>(address), &info) != 0 && info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        out << (status == 0 && demangled ? demangled : info.dli_sname);
+        std::free(demangled);
+        out << "+0x" << std::hex << (address - reinterpret_cast<uintptr_t>(info.dli_saddr));
+    } else {
+        out << "0x" << std::hex << address;
+        if (dladdr(reinterpret_cast<void*>(address), &info) != 0 && info.dli_fname) {
+            out << " in " << info.dli_fname << "+0x" << (address - reinterpret_cast<uintptr_t>(info.dli_fbase));
+        }
+    }
+    return out.str();
+}
+
+std::string formatDuration(uint64_t ns) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (ns >= 1000000000ULL) {
+        out << static_cast<double>(ns) / 1e9 << " s";
+    } else if (ns >= 1000000ULL) {
+        out << static_cast<double>(ns) / 1e6 << " ms";
+    } else {
+        out << static_cast<double>(ns) / 1e3 << " us";
+    }
+    return out.str();
+}
+
+std::string bucketLabel(size_t bucket) {
+    if (bucket == 0) return "<1us";
+    const uint64_t low = 1ULL << (bucket - 1);
+    if (bucket + 1 == HISTOGRAM_BUCKETS) return ">=" + std::to_string(low) + "us";
+    return std::to_string(low) + "-" + std::to_string(low * 2) + "us";
+}
+
+void writeHistogram(std::ostream& out, const char* label, const Histogram& histogram) {
+    out << "    " << label << ":";
+    for (size_t b = 0; b < histogram.size(); ++b) {
+        if (histogram[b] > 0) out << ' ' << bucketLabel(b) << '=' << histogram[b];
+    }
+    out << '\n';
+}
+} // namespace
+
+size_t histogramBucket(int64_t durationNs) {
+    if (durationNs < 1000) return 0;
+    uint64_t us = static_cast<uint64_t>(durationNs) / 1000;
+    size_t bucket = 1;
+    while (us > 1 && bucket + 1 < HISTOGRAM_BUCKETS) {
+        us >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+LockStats::Site& LockStats::site(uintptr_t address) {
+    for (auto& entry : m_sites) {
+        uintptr_t current = entry.address.load(std::memory_order_acquire);
+        if (current == address) return entry;
+        if (current == 0 && entry.address.compare_exchange_strong(current, address, std::memory_order_acq_rel)) {
+            return entry;
+        }
+        if (current == address) return entry; // claimed by another thread for the same site
+    }
+    return m_otherSites;
+}
+
+void LockStats::recordAcquire(uintptr_t siteAddress, int64_t waitNs, bool contended, uintptr_t blockingSite) {
+    const uint64_t wait = static_cast<uint64_t>(std::max<int64_t>(waitNs, 0));
+    m_acquisitions.fetch_add(1, std::memory_order_relaxed);
+    m_waitHistogram[histogramBucket(waitNs)].fetch_add(1, std::memory_order_relaxed);
+    Site& entry = site(siteAddress);
+    entry.acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (!contended) return;
+    m_contended.fetch_add(1, std::memory_order_relaxed);
+    m_totalWaitNs.fetch_add(wait, std::memory_order_relaxed);
+    updateMax(m_maxWaitNs, wait);
+    entry.waitNs.fetch_add(wait, std::memory_order_relaxed);
+    if (blockingSite != 0) site(blockingSite).blockedOthers.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LockStats::recordRelease(uintptr_t siteAddress, int64_t holdNs) {
+    const uint64_t hold = static_cast<uint64_t>(std::max<int64_t>(holdNs, 0));
+    m_totalHoldNs.fetch_add(hold, std::memory_order_relaxed);
+    updateMax(m_maxHoldNs, hold);
+    m_holdHistogram[histogramBucket(holdNs)].fetch_add(1, std::memory_order_relaxed);
+    Site& entry = site(siteAddress);
+    entry.holdNs.fetch_add(hold, std::memory_order_relaxed);
+    updateMax(entry.maxHoldNs, hold);
+}
+
+LockSnapshot LockStats::snapshot() const {
+    LockSnapshot result;
+    result.name = m_name;
+    result.acquisitions = m_acquisitions.load(std::memory_order_relaxed);
+    result.contended = m_contended.load(std::memory_order_relaxed);
+    result.totalWaitNs = m_totalWaitNs.load(std::memory_order_relaxed);
+    result.maxWaitNs = m_maxWaitNs.load(std::memory_order_relaxed);
+    result.totalHoldNs = m_totalHoldNs.load(std::memory_order_relaxed);
+    result.maxHoldNs = m_maxHoldNs.load(std::memory_order_relaxed);
+    for (size_t b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+        result.waitHistogram[b] = m_waitHistogram[b].load(std::memory_order_relaxed);
+        result.holdHistogram[b] = m_holdHistogram[b].load(std::memory_order_relaxed);
+    }
+    auto addSite = [&result](const Site& entry, uintptr_t address) {
+        const uint64_t acquisitions = entry.acquisitions.load(std::memory_order_relaxed);
+        if (acquisitions == 0 && entry.blockedOthers.load(std::memory_order_relaxed) == 0) return;
+        result.callSites.push_back({address, symbolize(address), acquisitions,
+                                    entry.waitNs.load(std::memory_order_relaxed),
+                                    entry.holdNs.load(std::memory_order_relaxed),
+                                    entry.maxHoldNs.load(std::memory_order_relaxed),
+                                    entry.blockedOthers.load(std::memory_order_relaxed)});
+    };
+    for (const auto& entry : m_sites) {
+        const uintptr_t address = entry.address.load(std::memory_order_acquire);
+        if (address != 0) addSite(entry, address);
+    }
+    addSite(m_otherSites, 0);
+    std::sort(result.callSites.begin(), result.callSites.end(), [](const CallSiteSnapshot& a, const CallSiteSnapshot& b) {
+        if (a.waitNs != b.waitNs) return a.waitNs > b.waitNs;
+        if (a.blockedOthers != b.blockedOthers) return a.blockedOthers > b.blockedOthers;
+        return a.holdNs > b.holdNs;
+    });
+    return result;
+}
+
+void LockStats::reset() {
+    m_acquisitions = 0;
+    m_contended = 0;
+    m_totalWaitNs = 0;
+    m_maxWaitNs = 0;
+    m_totalHoldNs = 0;
+    m_maxHoldNs = 0;
+    for (auto& bucket : m_waitHistogram) bucket = 0;
+    for (auto& bucket : m_holdHistogram) bucket = 0;
+    // Site addresses stay claimed; only their counters restart
+    auto clear = [](Site& entry) {
+        entry.acquisitions = 0;
+        entry.waitNs = 0;
+        entry.holdNs = 0;
+        entry.maxHoldNs = 0;
+        entry.blockedOthers = 0;
+    };
+    for (auto& entry : m_sites) clear(entry);
+    clear(m_otherSites);
+}
+
+LockStats& statsFor(const std::string& name) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto& entry = reg.stats[name];
+    if (!entry) entry = std::make_unique<LockStats>(name);
+    return *entry;
+}
+
+std::vector<LockSnapshot> snapshot() {
+    std::vector<LockSnapshot> result;
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& [name, stats] : reg.stats) result.push_back(stats->snapshot());
+    }
+    std::sort(result.begin(), result.end(), [](const LockSnapshot& a, const LockSnapshot& b) {
+        if (a.totalWaitNs != b.totalWaitNs) return a.totalWaitNs > b.totalWaitNs;
+        return a.totalHoldNs > b.totalHoldNs;
+    });
+    return result;
+}
+
+void reset() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& [name, stats] : reg.stats) stats->reset();
+}
+
+void writeReport(std::ostream& out) {
+    const auto locks = snapshot();
+    out << "Lock contention report (" << locks.size() << " lock names, highest total wait first)\n";
+    for (const auto& lock : locks) {
+        if (lock.acquisitions == 0) continue;
+        const double contendedPercent = 100.0 * static_cast<double>(lock.contended) / static_cast<double>(lock.acquisitions);
+        out << std::fixed << std::setprecision(2)
+            << lock.name << ": " << lock.acquisitions << " acquisitions, " << contendedPercent << "% contended, wait total "
+            << formatDuration(lock.totalWaitNs) << " max " << formatDuration(lock.maxWaitNs) << ", hold total "
+            << formatDuration(lock.totalHoldNs) << " max " << formatDuration(lock.maxHoldNs) << '\n';
+        writeHistogram(out, "wait", lock.waitHistogram);
+        writeHistogram(out, "hold", lock.holdHistogram);
+        for (const auto& site : lock.callSites) {
+            out << "    site " << site.symbol << ": " << site.acquisitions << " acquisitions, waited "
+                << formatDuration(site.waitNs) << ", held " << formatDuration(site.holdNs) << " (max "
+                << formatDuration(site.maxHoldNs) << "), blocked others " << site.blockedOthers << "x\n";
+        }
+    }
+}
+
+void installExitReport() {
+    if (!enabled()) return;
+    static std::once_flag once;
+    std::call_once(once, [] {
+        std::atexit([] {
+            const char* path = std::getenv("EBV_LOCK_REPORT");
+            if (path && *path) {
+                std::ofstream file(path);
+                if (file) {
+                    writeReport(file);
+                    return;
+                }
+            }
+            writeReport(std::cerr);
+        });
+    });
+}
+
+InstrumentedMutex::InstrumentedMutex(const char* name) : m_stats(&statsFor(name ? name : "unnamed")) {}
+
+__attribute__((noinline)) void InstrumentedMutex::lock() {
+    const auto site = reinterpret_cast<uintptr_t>(__builtin_return_address(0));
+    if (m_mutex.try_lock()) {
+        acquired(site, 0, false, 0);
+        return;
+    }
+    const uintptr_t blockingSite = m_ownerSite.load(std::memory_order_relaxed);
+    const int64_t start = nowNs();
+    m_mutex.lock();
+    acquired(site, nowNs() - start, true, blockingSite);
+}
+
+__attribute__((noinline)) bool InstrumentedMutex::try_lock() {
+    const auto site = reinterpret_cast<uintptr_t>(__builtin_return_address(0));
+    if (!m_mutex.try_lock()) return false;
+    acquired(site, 0, false, 0);
+    return true;
+}
+
+void InstrumentedMutex::unlock() {
+    const int64_t held = nowNs() - m_lockedAtNs;
+    const uintptr_t site = m_ownerSite.load(std::memory_order_relaxed);
+    m_ownerSite.store(0, std::memory_order_relaxed);
+    m_mutex.unlock();
+    m_stats->recordRelease(site, held);
+}
+
+void InstrumentedMutex::acquired(uintptr_t site, int64_t waitNs, bool contended, uintptr_t blockingSite) {
+    m_ownerSite.store(site, std::memory_order_relaxed);
+    m_stats->recordAcquire(site, waitNs, contended, blockingSite);
+    m_lockedAtNs = nowNs(); // hold time excludes the bookkeeping above
+}
+
+} // namespace LockProfiling
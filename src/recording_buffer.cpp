@@ -3,6 +3,8 @@
 #include "utils_qt.h"
 // Note: RecordingManager is included here to access its methods, but not in header
 #include "recording_manager.h"
+#include "live_data_bus.h"
+#include "frame_rectifier.h"
 #include <iostream>
 #include <algorithm>
 
@@ -67,9 +69,10 @@ void RecordingBuffer::stop() {
     }
     
     {
-        std::lock_guard<std::mutex> lock(m_liveBufferMutex);
+        std::lock_guard<ProfiledMutex> lock(m_liveBufferMutex);
         while (!m_liveFrameBuffer.empty()) m_liveFrameBuffer.pop();
         while (!m_liveEventBuffer.empty()) m_liveEventBuffer.pop();
+        m_liveBufferMemory.clear();
     }
     
     m_currentFrameIndex = 0;
@@ -85,7 +88,7 @@ cv::Mat RecordingBuffer::getFrameCameraFrame(int camera, size_t frameIndex) cons
         return m_dataLoader->getFrameCameraFrame(camera, frameIndex);
     } else if (m_currentMode == Mode::Live) {
         // For live mode, get the most recent frame for this camera
-        std::lock_guard<std::mutex> lock(m_liveBufferMutex);
+        std::lock_guard<ProfiledMutex> lock(m_liveBufferMutex);
         
         // Search backwards through the buffer for the most recent frame from this camera
         auto tempQueue = m_liveFrameBuffer;
@@ -116,7 +119,7 @@ QImage RecordingBuffer::getEventCameraFrame(int camera, size_t frameIndex) const
         return m_dataLoader->getEventCameraFrame(camera, frameIndex);
     } else if (m_currentMode == Mode::Live) {
         // For live mode, get the most recent event frame for this camera
-        std::lock_guard<std::mutex> lock(m_liveBufferMutex);
+        std::lock_guard<ProfiledMutex> lock(m_liveBufferMutex);
         
         // Search backwards through the buffer for the most recent frame from this camera
         auto tempQueue = m_liveEventBuffer;
@@ -206,7 +209,7 @@ QSet<int> RecordingBuffer::getCachedFrames() const {
 
 size_t RecordingBuffer::getBufferSize() const {
     if (m_currentMode == Mode::Live) {
-        std::lock_guard<std::mutex> lock(m_liveBufferMutex);
+        std::lock_guard<ProfiledMutex> lock(m_liveBufferMutex);
         return std::max(m_liveFrameBuffer.size(), m_liveEventBuffer.size());
     }
     return 0;
@@ -221,6 +224,14 @@ bool RecordingBuffer::isBufferHealthy() const {
 }
 
 void RecordingBuffer::startLiveBuffering() {
+    RecordingManager* manager = static_cast<RecordingManager*>(m_recordingManager);
+    if (manager) {
+        auto& bus = manager->liveDataBus();
+        m_frameSubscription = bus.frames.subscribe("recording_buffer", LIVE_BUS_QUEUE_SIZE, DropPolicy::DropOldest);
+        m_eventFrameSubscription = bus.eventFrames.subscribe("recording_buffer", LIVE_BUS_QUEUE_SIZE, DropPolicy::DropOldest);
+    }
+    m_busFramesSeen = false;
+    m_busEventFramesSeen = false;
     m_stopBuffering = false;
     m_liveBufferThread = std::thread(&RecordingBuffer::liveBufferWorker, this);
 }
@@ -232,6 +243,14 @@ void RecordingBuffer::stopLiveBuffering() {
     if (m_liveBufferThread.joinable()) {
         m_liveBufferThread.join();
     }
+
+    RecordingManager* manager = static_cast<RecordingManager*>(m_recordingManager);
+    if (manager) {
+        manager->liveDataBus().frames.unsubscribe(m_frameSubscription);
+        manager->liveDataBus().eventFrames.unsubscribe(m_eventFrameSubscription);
+    }
+    m_frameSubscription.reset();
+    m_eventFrameSubscription.reset();
 }
 
 void RecordingBuffer::liveBufferWorker() {
@@ -242,9 +261,11 @@ void RecordingBuffer::liveBufferWorker() {
     // Run the live buffering loop during recording or previewing
     while (!m_stopBuffering && manager && (manager->isRecording() || manager->isPreviewing())) {
         auto now = std::chrono::steady_clock::now();
+        // Fewer preview updates while capture is under pressure
+        const double rateScale = manager->overloadController().budget().frameRateScale;
         
         // Process new data periodically
-        if (now - lastUpdateTime >= updateInterval) {
+        if (now - lastUpdateTime >= updateInterval / rateScale) {
             processLiveFrameData();
             processLiveEventData();
             updateFPS();
@@ -279,26 +300,72 @@ void RecordingBuffer::processLiveFrameData() {
         return;
     }
     
-    std::lock_guard<std::mutex> lock(m_liveBufferMutex);
+    // Drain pushed frames first, keeping only the newest one per camera
+    std::shared_ptr<const LiveFramePacket> pushed[2];
+    if (m_frameSubscription) {
+        std::shared_ptr<const LiveFramePacket> packet;
+        while (m_frameSubscription->tryPop(packet)) {
+            if (packet->cameraId >= 0 && packet->cameraId < 2) {
+                pushed[packet->cameraId] = packet;
+            }
+            m_busFramesSeen = true;
+        }
+    }
+    
+    std::shared_ptr<const FrameRectifier> rectifier;
+    int previewWidth = 0;
+    {
+        std::lock_guard<std::mutex> rectifierLock(m_rectifierMutex);
+        rectifier = m_liveRectifier;
+        previewWidth = m_rectifyPreviewWidth;
+    }
+    const double scale = manager->overloadController().budget().resolutionScale;
+    const auto prepare = [&](int camera, const cv::Mat &image) {
+        cv::Mat prepared = rectifier ? rectifier->rectifyPreview(camera, image, previewWidth) : image;
+        if (scale < 1.0 && !prepared.empty()) {
+            cv::resize(prepared, prepared, cv::Size(), scale, scale, cv::INTER_NEAREST);
+        }
+        return prepared;
+    };
+    
+    std::lock_guard<ProfiledMutex> lock(m_liveBufferMutex);
     
     // Get frames from both frame cameras
     for (int camera = 0; camera < 2; ++camera) {
         cv::Mat frame;
         size_t frameIndex;
         
-        if (manager->getLiveFrameData(camera, frame, frameIndex)) {
+        if (pushed[camera]) {
+            BufferedFrameData frameData;
+            frameData.image = prepare(camera, pushed[camera]->image);
+            frameData.cameraId = camera;
+            frameData.frameIndex = pushed[camera]->frameIndex;
+            frameData.timestamp = pushed[camera]->timestamp;
+            frameData.isValid = !frameData.image.empty();
+            
+            m_liveFrameBuffer.push(frameData);
+            m_liveBufferMemory.add(frameData.image.total() * frameData.image.elemSize());
+        } else if (!m_busFramesSeen && manager->getLiveFrameData(camera, frame, frameIndex)) {
+            // Polling fallback for managers that do not publish on the bus
             BufferedFrameData frameData;
-            frameData.image = frame;
+            frameData.image = prepare(camera, frame);
             frameData.cameraId = camera;
             frameData.frameIndex = frameIndex;
             frameData.timestamp = std::chrono::steady_clock::now();
             frameData.isValid = true;
             
             m_liveFrameBuffer.push(frameData);
+            m_liveBufferMemory.add(frameData.image.total() * frameData.image.elemSize());
         }
     }
 }
 
+void RecordingBuffer::setLiveRectifier(std::shared_ptr<const FrameRectifier> rectifier, int previewWidth) {
+    std::lock_guard<std::mutex> lock(m_rectifierMutex);
+    m_liveRectifier = std::move(rectifier);
+    m_rectifyPreviewWidth = previewWidth;
+}
+
 void RecordingBuffer::processLiveEventData() {
     // Get live event data from RecordingManager
     RecordingManager* manager = static_cast<RecordingManager*>(m_recordingManager);
@@ -306,14 +373,35 @@ void RecordingBuffer::processLiveEventData() {
         return;
     }
     
-    std::lock_guard<std::mutex> lock(m_liveBufferMutex);
+    std::shared_ptr<const LiveEventFrame> pushed[2];
+    if (m_eventFrameSubscription) {
+        std::shared_ptr<const LiveEventFrame> packet;
+        while (m_eventFrameSubscription->tryPop(packet)) {
+            if (packet->cameraId >= 0 && packet->cameraId < 2) {
+                pushed[packet->cameraId] = packet;
+            }
+            m_busEventFramesSeen = true;
+        }
+    }
+    
+    std::lock_guard<ProfiledMutex> lock(m_liveBufferMutex);
     
     // Get event frames from both event cameras
     for (int camera = 0; camera < 2; ++camera) {
         cv::Mat eventMat;
         size_t frameIndex;
         
-        if (manager->getLiveEventData(camera, eventMat, frameIndex)) {
+        if (pushed[camera]) {
+            BufferedEventData eventData;
+            eventData.frame = cvMatToQImage(pushed[camera]->frame);
+            eventData.cameraId = camera;
+            eventData.frameIndex = pushed[camera]->frameIndex;
+            eventData.timestamp = pushed[camera]->timestamp;
+            eventData.isValid = !eventData.frame.isNull();
+            
+            m_liveEventBuffer.push(eventData);
+            m_liveBufferMemory.add(static_cast<uint64_t>(eventData.frame.sizeInBytes()));
+        } else if (!m_busEventFramesSeen && manager->getLiveEventData(camera, eventMat, frameIndex)) {
             BufferedEventData eventData;
             eventData.frame = cvMatToQImage(eventMat); // Convert cv::Mat to QImage
             eventData.cameraId = camera;
@@ -322,6 +410,7 @@ void RecordingBuffer::processLiveEventData() {
             eventData.isValid = !eventMat.empty();
             
             m_liveEventBuffer.push(eventData);
+            m_liveBufferMemory.add(static_cast<uint64_t>(eventData.frame.sizeInBytes()));
         }
     }
 }
@@ -364,14 +453,17 @@ void RecordingBuffer::updateFPS() {
 }
 
 void RecordingBuffer::cleanupOldFrames() {
-    std::lock_guard<std::mutex> lock(m_liveBufferMutex);
+    std::lock_guard<ProfiledMutex> lock(m_liveBufferMutex);
     
     // Remove old frames to keep buffer size manageable
     while (m_liveFrameBuffer.size() > MAX_LIVE_BUFFER_SIZE) {
+        const cv::Mat& oldest = m_liveFrameBuffer.front().image;
+        m_liveBufferMemory.release(oldest.total() * oldest.elemSize());
         m_liveFrameBuffer.pop();
     }
     
     while (m_liveEventBuffer.size() > MAX_LIVE_BUFFER_SIZE) {
+        m_liveBufferMemory.release(static_cast<uint64_t>(m_liveEventBuffer.front().frame.sizeInBytes()));
         m_liveEventBuffer.pop();
     }
 }
@@ -1,12 +1,15 @@
 #include "recording_loader.h"
 #include "utils_qt.h"
+#include "session_manifest.h"
+#include "stream_layout.h"
+#include "logger.h"
 
 #include <QMetaObject>
 #include <QString>
 
 #include <filesystem>
 #include <algorithm>
-#include <iostream>
+#include <fstream>
 #include <mutex>
 #include <chrono>
 #include <thread>
@@ -30,22 +33,12 @@ long long extract_frame_index(const std::string &pathStr) {
 }
 
 // EventCameraLoader implementation
-EventCameraLoader::EventCameraLoader(const std::string &filePath) 
-    : m_filePath(filePath) {
+EventCameraLoader::EventCameraLoader(const std::string &filePath, int cameraId) 
+    : m_filePath(filePath), m_cameraId(cameraId) {
     initialize();
-    
-    // Start prefetch thread
-    m_prefetchThread = std::thread(&EventCameraLoader::prefetchThreadMain, this);
 }
 
-EventCameraLoader::~EventCameraLoader() {
-    // Stop prefetch thread
-    m_stopPrefetch = true;
-    m_prefetchCv.notify_all();
-    if (m_prefetchThread.joinable()) {
-        m_prefetchThread.join();
-    }
-}
+EventCameraLoader::~EventCameraLoader() = default;
 
 void EventCameraLoader::initialize() {
     try {
@@ -59,20 +52,20 @@ void EventCameraLoader::initialize() {
         
         // Estimate frame count based on file duration and assumed fps
         auto duration_us = camera.offline_streaming_control().get_duration();
+        m_durationUs = duration_us;
         if (duration_us > 0) {
-            // Assume 30 fps for estimation
-            m_estimatedFrameCount = static_cast<size_t>(std::ceil(duration_us / 33333.0)); // 33.333ms per frame
+            m_estimatedFrameCount = static_cast<size_t>(std::ceil(duration_us / (1000000.0 / PLAYBACK_FPS)));
         } else {
             m_estimatedFrameCount = 1000; // fallback estimate
         }
         
         m_isValid = true;
-        std::cout << "EventCameraLoader initialized: " << m_width << "x" << m_height 
+        EBV_LOG_INFO << "EventCameraLoader initialized: " << m_width << "x" << m_height 
                   << ", estimated frames: " << m_estimatedFrameCount 
-                  << ", duration: " << duration_us << " us" << std::endl;
+                  << ", duration: " << duration_us << " us";
                   
     } catch (const std::exception &e) {
-        std::cout << "Failed to initialize EventCameraLoader: " << e.what() << std::endl;
+        EBV_LOG_ERROR << "Failed to initialize EventCameraLoader: " << e.what();
         m_isValid = false;
     }
 }
@@ -82,7 +75,7 @@ QImage EventCameraLoader::getFrame(size_t frameIndex, double fps) {
         return QImage(m_width > 0 ? m_width : 640, m_height > 0 ? m_height : 480, QImage::Format_RGBA8888);
     }
     
-    std::lock_guard<std::mutex> lock(m_frameMutex);
+    std::lock_guard<ProfiledMutex> lock(m_frameMutex);
     
     // Check frame cache first
     auto it = m_frameCache.find(frameIndex);
@@ -90,17 +83,21 @@ QImage EventCameraLoader::getFrame(size_t frameIndex, double fps) {
         return it->second;
     }
     
-    // Calculate time range for this frame
-    Metavision::timestamp frameDuration = static_cast<Metavision::timestamp>(1000000.0 / fps); // microseconds
-    // Use slight overlap to avoid gaps at boundaries
-    Metavision::timestamp frameStartTime = (frameIndex == 0) ? 0 : frameIndex * frameDuration - frameDuration / 10;
-    Metavision::timestamp frameEndTime = (frameIndex + 1) * frameDuration + frameDuration / 10;
-    
     // Generate frame on-demand using streaming approach (no pre-loading)
-    QImage frame = generateFrameFromTimeRange(frameStartTime, frameEndTime);
+    const auto window = frameWindow(frameIndex, fps);
+    QImage frame = loadOrGenerateFrame(frameIndex, fps, window.first, window.second);
     
     // Cache the frame
-    m_frameCache[frameIndex] = frame;
+    cacheFrameLocked(frameIndex, frame);
+    
+    return frame;
+}
+
+void EventCameraLoader::cacheFrameLocked(size_t frameIndex, const QImage &frame) {
+    QImage &slot = m_frameCache[frameIndex];
+    if (!slot.isNull()) m_cacheMemory.release(static_cast<uint64_t>(slot.sizeInBytes()));
+    slot = frame;
+    m_cacheMemory.add(static_cast<uint64_t>(frame.sizeInBytes()));
     
     // Limit cache size to prevent memory bloat
     if (m_frameCache.size() > MAX_CACHE_SIZE) {
@@ -110,13 +107,71 @@ QImage EventCameraLoader::getFrame(size_t frameIndex, double fps) {
                 oldest = it;
             }
         }
+        m_cacheMemory.release(static_cast<uint64_t>(oldest->second.sizeInBytes()));
         m_frameCache.erase(oldest);
     }
-    
+}
+
+std::pair<Metavision::timestamp, Metavision::timestamp> EventCameraLoader::frameWindow(size_t frameIndex, double fps) {
+    const Metavision::timestamp frameDuration = frameDurationUs(fps);
+    const Metavision::timestamp overlap = frameOverlapUs(fps);
+    const auto index = static_cast<Metavision::timestamp>(frameIndex);
+    const Metavision::timestamp start = (frameIndex == 0) ? 0 : index * frameDuration - overlap;
+    const Metavision::timestamp end = (index + 1) * frameDuration + overlap;
+    return {start, end};
+}
+
+QImage EventCameraLoader::renderThumbnail(size_t frameIndex, int maxWidth, double fps) {
+    if (!m_isValid) return {};
+    const auto window = frameWindow(frameIndex, fps);
+    const QImage frame = loadOrGenerateFrame(frameIndex, fps, window.first, window.second);
+    return frame.width() > maxWidth ? frame.scaledToWidth(maxWidth, Qt::SmoothTransformation) : frame;
+}
+
+QImage EventCameraLoader::loadOrGenerateFrame(size_t frameIndex, double fps, Metavision::timestamp startTime,
+                                              Metavision::timestamp endTime, bool *fromDisk) {
+    std::vector<uint8_t> plane;
+    const auto diskCache = diskCacheFor(fps);
+    if (diskCache && diskCache->read(frameIndex, plane)) {
+        if (fromDisk) *fromDisk = true;
+        return renderClassPlane(plane);
+    }
+    if (fromDisk) *fromDisk = false;
+
+    if (!generatePlaneFromTimeRange(startTime, endTime, plane)) {
+        QImage errorFrame(m_width, m_height, QImage::Format_RGBA8888);
+        errorFrame.fill(Qt::darkGray);
+        return errorFrame;
+    }
+    QImage frame = renderClassPlane(plane);
+    if (diskCache) diskCache->store(frameIndex, std::move(plane));
     return frame;
 }
 
-QImage EventCameraLoader::generateFrameFromTimeRange(Metavision::timestamp startTime, Metavision::timestamp endTime) {
+std::shared_ptr<EventFrameDiskCache> EventCameraLoader::diskCacheFor(double fps) {
+    // One cache file per frame window; switching playback fps switches files
+    const int64_t windowUs = frameDurationUs(fps);
+    std::lock_guard<std::mutex> lock(m_diskCacheMutex);
+    if (windowUs != m_diskCacheWindowUs) {
+        m_diskCache.reset();
+        m_diskCacheWindowUs = windowUs;
+        const auto directory = EventFrameDiskCache::defaultCacheDirectory();
+        if (!directory.empty() && m_isValid && windowUs > 0) {
+            const size_t capacity = (m_durationUs > 0 ? static_cast<size_t>(m_durationUs / windowUs) : m_estimatedFrameCount) + 2;
+            m_diskCache = std::make_shared<EventFrameDiskCache>(
+                directory, EventFrameDiskCache::Key{m_filePath, m_cameraId, windowUs, frameOverlapUs(fps), RENDER_MODE, RENDERER_VERSION}, m_width, m_height, capacity);
+            if (!m_diskCache->isOpen()) m_diskCache.reset();
+        }
+    }
+    return m_diskCache;
+}
+
+bool EventCameraLoader::generatePlaneFromTimeRange(Metavision::timestamp startTime, Metavision::timestamp endTime,
+                                                   std::vector<uint8_t> &plane) {
+    if (m_preloaded) {
+        plane = classifyPreloadedEvents(startTime, endTime);
+        return true;
+    }
     try {
         // Use a streaming approach: create a temporary camera instance for this frame
         Metavision::Camera camera = Metavision::Camera::from_file(m_filePath);
@@ -124,14 +179,14 @@ QImage EventCameraLoader::generateFrameFromTimeRange(Metavision::timestamp start
         // Seek to the start time
         camera.offline_streaming_control().seek(startTime);
         
-        // Collect events in the time range
-        std::vector<Metavision::EventCD> frameEvents;
-        frameEvents.reserve(100000); // Reserve reasonable space
+        // Collect events in the time range into a recycled buffer (sized from previous windows)
+        auto frameEvents = EventBufferArena<EventBlock>::threadLocal().acquire();
+        EventBlock &block = *frameEvents;
         
-        auto callbackId = camera.cd().add_callback([&frameEvents, startTime, endTime](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+        auto callbackId = camera.cd().add_callback([&block, startTime, endTime](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
             for (auto it = begin; it != end; ++it) {
                 if (it->t >= startTime && it->t < endTime) {
-                    frameEvents.push_back(*it);
+                    block.push(*it);
                 } else if (it->t >= endTime) {
                     // We've gone past our time window, stop collecting
                     break;
@@ -162,34 +217,63 @@ QImage EventCameraLoader::generateFrameFromTimeRange(Metavision::timestamp start
         camera.stop();
         camera.cd().remove_callback(callbackId);
         
-        // Generate frame from collected events
-        return generateFrameFromEvents(frameEvents);
+        // Classify pixels from collected events
+        plane = classifyEvents(block);
+        return true;
         
     } catch (const std::exception &e) {
-        std::cout << "Error generating frame for time " << startTime << ": " << e.what() << std::endl;
+        EBV_LOG_WARN << "Error generating frame for time " << startTime << ": " << e.what();
     }
     
-    // Return error frame
-    QImage errorFrame(m_width, m_height, QImage::Format_RGBA8888);
-    errorFrame.fill(Qt::darkGray);
-    return errorFrame;
+    return false;
 }
 
-QImage EventCameraLoader::generateFrameFromEvents(const std::vector<Metavision::EventCD> &events) {
+std::vector<uint8_t> EventCameraLoader::classifyEvents(const EventBlock &events) const {
+    // Last event per pixel wins, as in the rendered frame
+    std::vector<uint8_t> plane(static_cast<size_t>(m_width) * static_cast<size_t>(m_height), EventFrameDiskCache::NoEvent);
+    const size_t count = events.size();
+    for (size_t i = 0; i < count; ++i) {
+        const int x = events.x[i];
+        const int y = events.y[i];
+        if (x < m_width && y < m_height) {
+            plane[static_cast<size_t>(y) * m_width + x] =
+                (events.p[i] == 1) ? EventFrameDiskCache::Positive : EventFrameDiskCache::Negative;
+        }
+    }
+    return plane;
+}
+
+std::vector<uint8_t> EventCameraLoader::classifyPreloadedEvents(Metavision::timestamp startTime,
+                                                                Metavision::timestamp endTime) const {
+    std::vector<uint8_t> plane(static_cast<size_t>(m_width) * static_cast<size_t>(m_height), EventFrameDiskCache::NoEvent);
+    const auto range = m_preloaded->range(startTime, endTime);
+    for (size_t i = range.first; i < range.second; ++i) {
+        const int x = m_preloaded->x(i);
+        const int y = m_preloaded->y(i);
+        if (x < m_width && y < m_height) {
+            plane[static_cast<size_t>(y) * m_width + x] =
+                (m_preloaded->p(i) == 1) ? EventFrameDiskCache::Positive : EventFrameDiskCache::Negative;
+        }
+    }
+    return plane;
+}
+
+QImage EventCameraLoader::renderClassPlane(const std::vector<uint8_t> &plane) const {
     // Create accumulation frame
     cv::Mat frame = cv::Mat::zeros(m_height, m_width, CV_8UC3);
     
     // Background color (dark gray)
     frame.setTo(cv::Scalar(64, 64, 64));
     
-    // Accumulate events with simple visualization
-    for (const auto &event : events) {
-        if (event.x >= 0 && event.x < m_width && event.y >= 0 && event.y < m_height) {
-            cv::Vec3b &pixel = frame.at<cv::Vec3b>(event.y, event.x);
-            if (event.p == 1) { // Positive event (white)
-                pixel[0] = 255; pixel[1] = 255; pixel[2] = 255;
-            } else { // Negative event (blue)
-                pixel[0] = 255; pixel[1] = 0; pixel[2] = 0; // BGR format: Blue=255, Green=0, Red=0
+    // Simple visualization: positive white, negative blue (BGR)
+    for (int y = 0; y < m_height; ++y) {
+        const uint8_t *row = plane.data() + static_cast<size_t>(y) * m_width;
+        auto *pixels = frame.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < m_width; ++x) {
+            if (row[x] == EventFrameDiskCache::Positive) {
+                pixels[x] = cv::Vec3b(255, 255, 255);
+            } else if (row[x] == EventFrameDiskCache::Negative) {
+                pixels[x] = cv::Vec3b(255, 0, 0);
             }
         }
     }
@@ -198,7 +282,7 @@ QImage EventCameraLoader::generateFrameFromEvents(const std::vector<Metavision::
 }
 
 QSet<int> EventCameraLoader::getCachedFrames() const {
-    std::lock_guard<std::mutex> lock(m_frameMutex);
+    std::lock_guard<ProfiledMutex> lock(m_frameMutex);
     QSet<int> cachedIndices;
     
     for (const auto &pair : m_frameCache) {
@@ -211,117 +295,42 @@ QSet<int> EventCameraLoader::getCachedFrames() const {
 void EventCameraLoader::setCurrentFrameIndex(size_t frameIndex) {
     size_t oldFrame = m_currentFrameIndex.exchange(frameIndex);
     
-    // If we jumped significantly (more than a few frames), interrupt current prefetching
+    // After a significant jump, drop cache entries that are far from the new position
     if (abs(static_cast<long long>(frameIndex) - static_cast<long long>(oldFrame)) > 10) {
-        // Signal the prefetch thread to restart from new position
-        {
-            std::lock_guard<std::mutex> lock(m_prefetchMutex);
-            m_prefetchRestart = true;
-            m_prefetchDirty = true;
+        std::lock_guard<ProfiledMutex> cacheLock(m_frameMutex);
+        auto it = m_frameCache.begin();
+        while (it != m_frameCache.end()) {
+            size_t cachedFrame = it->first;
+            // Keep frames within a reasonable range around current position
+            const bool farBehind = cachedFrame < frameIndex && (frameIndex - cachedFrame) > CACHE_KEEP_FRAMES;
+            const bool farAhead = cachedFrame > frameIndex && (cachedFrame - frameIndex) > CACHE_KEEP_FRAMES * 2;
+            if (farBehind || farAhead) {
+                m_cacheMemory.release(static_cast<uint64_t>(it->second.sizeInBytes()));
+                it = m_frameCache.erase(it);
+            } else {
+                ++it;
+            }
         }
-        m_prefetchCv.notify_one();
-    } else {
-        // Small change, just update normally
-        requestPrefetch();
     }
 }
 
-void EventCameraLoader::setPlaybackFps(double fps) {
-    m_fps = fps;
+bool EventCameraLoader::hasFrame(size_t frameIndex) const {
+    std::lock_guard<ProfiledMutex> lock(m_frameMutex);
+    return m_frameCache.find(frameIndex) != m_frameCache.end();
 }
 
-void EventCameraLoader::requestPrefetch() {
-    {
-        std::lock_guard<std::mutex> lock(m_prefetchMutex);
-        m_prefetchDirty = true;
-    }
-    m_prefetchCv.notify_one();
-}
+bool EventCameraLoader::prepareFrame(size_t frameIndex) {
+    if (!m_isValid || frameIndex >= m_estimatedFrameCount) return false;
+    if (hasFrame(frameIndex)) return true;
 
-void EventCameraLoader::prefetchThreadMain() {
-    while (!m_stopPrefetch) {
-        std::unique_lock<std::mutex> lock(m_prefetchMutex);
-        
-        // Wait for prefetch request or stop signal
-        m_prefetchCv.wait(lock, [this] { return m_prefetchDirty || m_stopPrefetch; });
-        
-        if (m_stopPrefetch) break;
-        
-        bool shouldRestart = m_prefetchRestart;
-        m_prefetchDirty = false;
-        m_prefetchRestart = false;
-        lock.unlock();
-        
-        // Get current frame index
-        size_t currentFrame = m_currentFrameIndex.load();
-        double fps = m_fps.load();
-        
-        // If restarting, we might want to clear some cache entries that are far from current position
-        if (shouldRestart) {
-            std::lock_guard<std::mutex> cacheLock(m_frameMutex);
-            // Remove cache entries that are too far from current position to make room
-            auto it = m_frameCache.begin();
-            while (it != m_frameCache.end()) {
-                size_t cachedFrame = it->first;
-                // Keep frames within a reasonable range around current position
-                if (cachedFrame < currentFrame && (currentFrame - cachedFrame) > PREFETCH_AHEAD_FRAMES) {
-                    it = m_frameCache.erase(it);
-                } else if (cachedFrame > currentFrame && (cachedFrame - currentFrame) > PREFETCH_AHEAD_FRAMES * 2) {
-                    it = m_frameCache.erase(it);
-                } else {
-                    ++it;
-                }
-            }
-        }
-        
-        // Prefetch ahead frames
-        for (size_t i = 1; i <= PREFETCH_AHEAD_FRAMES; ++i) {
-            if (m_stopPrefetch) break;
-            
-            // Check if we got a restart request during prefetching
-            {
-                std::lock_guard<std::mutex> restartLock(m_prefetchMutex);
-                if (m_prefetchRestart) {
-                    // Restart requested, break out of current prefetch loop
-                    break;
-                }
-            }
-            
-            size_t frameIndex = currentFrame + i;
-            if (frameIndex >= m_estimatedFrameCount) break;
-            
-            // Check if frame is already cached
-            {
-                std::lock_guard<std::mutex> cacheLock(m_frameMutex);
-                if (m_frameCache.find(frameIndex) != m_frameCache.end()) {
-                    continue; // Already cached
-                }
-            }
-            
-            // Generate frame in background
-            try {
-                QImage frame = generateFrameFromTimeRange(
-                    frameIndex * static_cast<Metavision::timestamp>(1000000.0 / fps),
-                    (frameIndex + 1) * static_cast<Metavision::timestamp>(1000000.0 / fps)
-                );
-                
-                // Cache the frame
-                {
-                    std::lock_guard<std::mutex> cacheLock(m_frameMutex);
-                    if (m_frameCache.size() < MAX_CACHE_SIZE) {
-                        m_frameCache[frameIndex] = frame;
-                    }
-                }
-                
-                // Small delay to prevent overwhelming the system
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                
-            } catch (const std::exception &e) {
-                std::cout << "Prefetch error for frame " << frameIndex << ": " << e.what() << std::endl;
-                break; // Stop prefetching on error
-            }
-        }
-    }
+    // Rendered without holding the cache lock, so several frames of this stream can be in
+    // flight on the playback engine's workers at once
+    const auto window = frameWindow(frameIndex, PLAYBACK_FPS);
+    QImage frame = loadOrGenerateFrame(frameIndex, PLAYBACK_FPS, window.first, window.second);
+
+    std::lock_guard<ProfiledMutex> lock(m_frameMutex);
+    cacheFrameLocked(frameIndex, frame);
+    return true;
 }
 
 // RecordingLoader implementation
@@ -336,8 +345,13 @@ void RecordingLoader::loadRecording(const std::string &dirPath) {
     // Abort any existing loading
     abortLoading();
     
-    // Reset state
+    // Reset state (releases the previous recording's preloaded memory)
+    m_eventPlayback.reset();
     m_data = RecordingData{};
+    {
+        std::lock_guard<std::mutex> lock(m_overlayMutex);
+        m_overlayTables.clear();
+    }
     m_dataReady = false;
     m_abortLoading = false;
     m_loading = true;
@@ -378,6 +392,77 @@ QImage RecordingLoader::getEventCameraFrame(int camera, size_t frameIndex) const
     return eventCam.loader->getFrame(frameIndex);
 }
 
+EventFrameSet RecordingLoader::getEventFrameSet(size_t frameIndex, std::chrono::milliseconds timeout) const {
+    EventFrameSet set;
+    if (!m_dataReady.load() || !m_eventPlayback) {
+        return set;
+    }
+    const auto status = m_eventPlayback->waitForFrameSet(frameIndex, timeout);
+    set.late = status.late;
+    set.images.resize(m_data.eventCams.size());
+    for (size_t cam = 0; cam < m_data.eventCams.size(); ++cam) {
+        // Ready means cached: this is a lookup, not a render
+        if (status.ready[cam]) {
+            set.images[cam] = m_data.eventCams[cam].loader->getFrame(frameIndex);
+        }
+    }
+    return set;
+}
+
+cv::Mat RecordingLoader::getFrameCameraOverlay(int camera, size_t frameIndex, const QImage &events, double alpha) const {
+    cv::Mat frame = getFrameCameraFrame(camera, frameIndex);
+    if (frame.empty() || events.isNull()) return frame;
+
+    const QImage rgb = events.convertToFormat(QImage::Format_RGB888);
+    const cv::Mat rgbView(rgb.height(), rgb.width(), CV_8UC3, const_cast<uchar *>(rgb.constBits()),
+                          static_cast<size_t>(rgb.bytesPerLine()));
+    cv::Mat eventBgr;
+    cv::cvtColor(rgbView, eventBgr, cv::COLOR_RGB2BGR);
+
+    const auto &table = overlayTableFor(camera, frame.size(), eventBgr.size());
+    // Background of the event renderer (see renderClassPlane)
+    EventOverlay::blend(frame, eventBgr, table, cv::Scalar(64, 64, 64), alpha);
+    return frame;
+}
+
+const EventOverlay::RemapTable &RecordingLoader::overlayTableFor(int camera, cv::Size frameSize, cv::Size eventSize) const {
+    std::lock_guard<std::mutex> lock(m_overlayMutex);
+    if (m_overlayTables.size() <= static_cast<size_t>(camera)) {
+        m_overlayTables.resize(static_cast<size_t>(camera) + 1);
+    }
+    auto &table = m_overlayTables[static_cast<size_t>(camera)];
+    if (table.empty() || table.frameSize != frameSize || table.eventSize != eventSize) {
+        const auto eventStream = StreamLayout::eventStreamName(static_cast<size_t>(camera));
+        const auto frameStream = StreamLayout::frameStreamName(static_cast<size_t>(camera));
+        cv::Matx33d eventToFrame = EventOverlay::defaultHomography(eventSize, frameSize);
+        if (!EventOverlay::loadHomography(m_data.loadedPath, eventStream, frameStream, eventToFrame)) {
+            EBV_LOG_INFO << "No overlay calibration for " << EventOverlay::calibrationKey(eventStream, frameStream)
+                      << ", scaling the event sensor onto the frame";
+        }
+        table = EventOverlay::buildRemapTable(eventToFrame, eventSize, frameSize);
+    }
+    return table;
+}
+
+cv::Mat RecordingLoader::getFrameCameraThumbnail(int camera, size_t frameIndex) const {
+    if (!m_dataReady.load() || camera < 0 || camera >= static_cast<int>(m_data.frameCams.size())) {
+        return {};
+    }
+    // JPEG decoders scale down during decoding, which is several times faster than a full decode
+    return m_data.frameCams[camera].loadFrame(frameIndex, cv::IMREAD_REDUCED_COLOR_8);
+}
+
+QImage RecordingLoader::getEventCameraThumbnail(int camera, size_t frameIndex, int maxWidth) const {
+    if (!m_dataReady.load() || camera < 0 || camera >= static_cast<int>(m_data.eventCams.size())) {
+        return {};
+    }
+    const auto &eventCam = m_data.eventCams[camera];
+    if (!eventCam.loader || !eventCam.isValid) {
+        return {};
+    }
+    return eventCam.loader->renderThumbnail(frameIndex, maxWidth);
+}
+
 QSet<int> RecordingLoader::getCachedEventFrames(int camera) const {
     if (!m_dataReady.load() || camera < 0 || camera >= static_cast<int>(m_data.eventCams.size())) {
         return {};
@@ -405,7 +490,10 @@ QSet<int> RecordingLoader::getAllCachedFrames() const {
 void RecordingLoader::notifyFrameChanged(size_t frameIndex) {
     if (!m_dataReady.load()) return;
     
-    // Notify all event camera loaders about the frame change for prefetching
+    // Move the shared cursor: rendering ahead restarts from here for all event cameras
+    if (m_eventPlayback) {
+        m_eventPlayback->setCursor(frameIndex);
+    }
     for (auto &eventCam : m_data.eventCams) {
         if (eventCam.loader && eventCam.isValid) {
             eventCam.loader->setCurrentFrameIndex(frameIndex);
@@ -413,6 +501,13 @@ void RecordingLoader::notifyFrameChanged(size_t frameIndex) {
     }
 }
 
+void RecordingLoader::setPrefetchPaused(bool paused) {
+    m_prefetchPaused = paused;
+    if (m_dataReady.load() && m_eventPlayback && m_eventPlayback->isPaused() != paused) {
+        m_eventPlayback->setPaused(paused);
+    }
+}
+
 void RecordingLoader::loadDataWorker(const std::string &dirPath) {
     namespace fs = std::filesystem;
     
@@ -437,6 +532,22 @@ void RecordingLoader::loadDataWorker(const std::string &dirPath) {
 
         // Calculate total frames
         m_data.totalFrames = calculateTotalFrames();
+
+        if (m_preloadOptions.enabled) {
+            preloadStreams();
+            if (m_abortLoading) return;
+        }
+
+        // One engine renders ahead for all event cameras against the shared playback cursor
+        m_eventPlayback = std::make_unique<EventPlaybackEngine>(
+            m_data.eventCams.size(), m_data.totalFrames, [this](size_t stream, size_t frameIndex) {
+                const auto &eventCam = m_data.eventCams[stream];
+                return eventCam.loader && eventCam.isValid && eventCam.loader->prepareFrame(frameIndex);
+            });
+        m_eventPlayback->setFrameSetCallback([this](size_t frameIndex) {
+            emit eventFrameSetReady(static_cast<qulonglong>(frameIndex));
+        });
+        m_eventPlayback->setPaused(m_prefetchPaused.load());
         m_data.isValid = true;
 
         // Notify completion on main thread
@@ -466,7 +577,11 @@ void RecordingLoader::loadDataWorker(const std::string &dirPath) {
 void RecordingLoader::loadFrameCameraData(const std::string &dirPath, int camera, FrameCameraData &data) {
     namespace fs = std::filesystem;
     
-    fs::path camDir = fs::path(dirPath) / ("frame_cam" + std::to_string(camera));
+    // Striped recordings keep streams on other disks; the session manifest says where
+    SessionManifest manifest;
+    manifest.load(dirPath);
+    const auto stream = StreamLayout::frameStreamName(static_cast<size_t>(camera));
+    fs::path camDir = manifest.streamDirectory(stream, dirPath) / stream;
     if (fs::exists(camDir) && fs::is_directory(camDir)) {
         for (auto &entry : fs::directory_iterator(camDir)) {
             if (m_abortLoading) return;
@@ -493,29 +608,33 @@ void RecordingLoader::loadFrameCameraData(const std::string &dirPath, int camera
 
     // Debug output
     for (const auto &fname : data.image_files) {
-        std::cout << "FrameCam" << camera << ": " << fname << std::endl;
+        EBV_LOG_DEBUG << "FrameCam" << camera << ": " << fname;
     }
 }
 
 void RecordingLoader::loadEventCameraData(const std::string &dirPath, int camera, EventCameraData &data) {
     namespace fs = std::filesystem;
     
-    fs::path fileH5 = fs::path(dirPath) / ("ebv_cam_" + std::to_string(camera) + ".hdf5");
-    fs::path fileRaw = fs::path(dirPath) / ("ebv_cam_" + std::to_string(camera) + ".raw");
+    SessionManifest manifest;
+    manifest.load(dirPath);
+    const auto stream = StreamLayout::eventStreamName(static_cast<size_t>(camera));
+    const fs::path streamDir = manifest.streamDirectory(stream, dirPath);
+    fs::path fileH5 = streamDir / (stream + ".hdf5");
+    fs::path fileRaw = streamDir / (stream + ".raw");
     fs::path useFile;
     
     if (fs::exists(fileH5)) {
         useFile = fileH5;
-        std::cout << "Found HDF5 file for camera " << camera << ": " << useFile << std::endl;
+        EBV_LOG_INFO << "Found HDF5 file for camera " << camera << ": " << useFile;
     } else if (fs::exists(fileRaw)) {
         useFile = fileRaw;
-        std::cout << "Found RAW file for camera " << camera << ": " << useFile << std::endl;
+        EBV_LOG_INFO << "Found RAW file for camera " << camera << ": " << useFile;
     }
     
     if (!useFile.empty()) {
         // Initialize lazy loader instead of pre-generating all frames
         data.filePath = useFile.string();
-        data.loader = std::make_unique<EventCameraLoader>(useFile.string());
+        data.loader = std::make_unique<EventCameraLoader>(useFile.string(), camera);
         
         if (data.loader->isValid()) {
             data.width = data.loader->getWidth();
@@ -523,15 +642,15 @@ void RecordingLoader::loadEventCameraData(const std::string &dirPath, int camera
             data.estimatedFrameCount = data.loader->getEstimatedFrameCount();
             data.isValid = true;
             
-            std::cout << "EventCamera " << camera << " loaded: " 
+            EBV_LOG_INFO << "EventCamera " << camera << " loaded: " 
                       << data.width << "x" << data.height 
-                      << ", estimated frames: " << data.estimatedFrameCount << std::endl;
+                      << ", estimated frames: " << data.estimatedFrameCount;
         } else {
-            std::cout << "Failed to load event camera " << camera << std::endl;
+            EBV_LOG_WARN << "Failed to load event camera " << camera;
             data.isValid = false;
         }
     } else {
-        std::cout << "No event data file found for camera " << camera << std::endl;
+        EBV_LOG_INFO << "No event data file found for camera " << camera;
         data.isValid = false;
     }
 }
@@ -552,3 +671,160 @@ size_t RecordingLoader::calculateTotalFrames() const {
     size_t total = std::max(maxFrameCount, maxEventCount);
     return (total == 0) ? 1 : total;
 }
+
+namespace {
+// Rough event density of the file formats, used to size the in-memory event arrays before
+// decoding (EVT3 RAW vs. ECF-compressed HDF5). Decoding still enforces the real ceiling.
+constexpr double RAW_FILE_BYTES_PER_EVENT = 2.0;
+constexpr double HDF5_FILE_BYTES_PER_EVENT = 1.0;
+
+QString megabytes(uint64_t bytes) {
+    return QString::number(static_cast<double>(bytes) / (1024.0 * 1024.0), 'f', 0);
+}
+} // namespace
+
+void RecordingLoader::preloadStreams() {
+    namespace fs = std::filesystem;
+
+    m_preloadBudget = std::make_unique<PreloadBudget>(PreloadMemory::ceilingFor(m_preloadOptions));
+    const bool hugePages = m_preloadOptions.hugePages;
+
+    // One task per stream; each reads its file(s) sequentially on its own thread
+    struct Task {
+        std::string name;
+        int frameCam{-1};
+        int eventCam{-1};
+        uint64_t fileBytes{0};
+        uint64_t estimatedBytes{0};
+    };
+    std::vector<Task> tasks;
+    std::vector<std::string> streamed;
+    uint64_t planned = 0;
+    const auto plan = [&](Task task) {
+        if (planned + task.estimatedBytes > m_preloadBudget->ceiling()) {
+            streamed.push_back(task.name);
+            return;
+        }
+        planned += task.estimatedBytes;
+        tasks.push_back(std::move(task));
+    };
+
+    for (size_t cam = 0; cam < m_data.frameCams.size(); ++cam) {
+        const auto &files = m_data.frameCams[cam].image_files;
+        if (files.empty()) continue;
+        Task task{StreamLayout::frameStreamName(cam), static_cast<int>(cam), -1, 0, 0};
+        for (const auto &file : files) {
+            std::error_code ec;
+            const auto size = fs::file_size(file, ec);
+            if (!ec) task.fileBytes += size;
+        }
+        task.estimatedBytes = task.fileBytes + (files.size() + 1) * sizeof(uint64_t);
+        plan(std::move(task));
+    }
+    for (size_t cam = 0; cam < m_data.eventCams.size(); ++cam) {
+        const auto &eventCam = m_data.eventCams[cam];
+        if (!eventCam.isValid || !eventCam.loader) continue;
+        Task task{StreamLayout::eventStreamName(cam), -1, static_cast<int>(cam), 0, 0};
+        std::error_code ec;
+        task.fileBytes = fs::file_size(eventCam.filePath, ec);
+        const bool isHdf5 = fs::path(eventCam.filePath).extension() == ".hdf5";
+        const double estimatedEvents = static_cast<double>(task.fileBytes) /
+            (isHdf5 ? HDF5_FILE_BYTES_PER_EVENT : RAW_FILE_BYTES_PER_EVENT);
+        task.estimatedBytes = static_cast<uint64_t>(estimatedEvents) * PreloadedEventStore::BYTES_PER_EVENT;
+        plan(std::move(task));
+    }
+    if (tasks.empty()) {
+        emit loadingProgress("Preload: nothing fits the memory ceiling, streaming from disk");
+        return;
+    }
+
+    // Progress in units of estimated bytes per task
+    std::vector<std::atomic<uint64_t>> progress(tasks.size());
+    std::vector<std::string> failed(tasks.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        workers.emplace_back([this, &tasks, &progress, &failed, hugePages, i]() {
+            const Task &task = tasks[i];
+            try {
+                if (task.frameCam >= 0) {
+                    auto &cam = m_data.frameCams[static_cast<size_t>(task.frameCam)];
+                    auto store = std::make_shared<PreloadedFrameStore>(*m_preloadBudget, hugePages, task.fileBytes,
+                                                                       cam.image_files.size());
+                    std::vector<uint8_t> buffer;
+                    for (const auto &file : cam.image_files) {
+                        if (m_abortLoading) return;
+                        std::ifstream in(file, std::ios::binary | std::ios::ate);
+                        if (!in) throw std::runtime_error("cannot read " + file);
+                        buffer.resize(static_cast<size_t>(in.tellg()));
+                        in.seekg(0);
+                        in.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+                        if (!store->append(buffer.data(), buffer.size())) {
+                            failed[i] = "memory ceiling reached";
+                            return;
+                        }
+                        progress[i] += buffer.size();
+                    }
+                    cam.preloaded = std::move(store);
+                } else {
+                    auto &cam = m_data.eventCams[static_cast<size_t>(task.eventCam)];
+                    const size_t expectedEvents = task.estimatedBytes / PreloadedEventStore::BYTES_PER_EVENT;
+                    auto store = std::make_shared<PreloadedEventStore>(*m_preloadBudget, hugePages, expectedEvents);
+                    std::atomic<bool> rejected{false};
+                    Metavision::Camera camera = Metavision::Camera::from_file(
+                        cam.filePath, Metavision::FileConfigHints().real_time_playback(false));
+                    camera.cd().add_callback([&](const Metavision::EventCD *begin, const Metavision::EventCD *end) {
+                        if (!rejected && !store->append(begin, end)) rejected = true;
+                    });
+                    const double durationUs = static_cast<double>(std::max<int64_t>(cam.loader->getDurationUs(), 1));
+                    camera.start();
+                    while (camera.is_running() && !rejected && !m_abortLoading) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                        const double fraction = std::min(1.0, static_cast<double>(camera.get_last_timestamp()) / durationUs);
+                        progress[i] = static_cast<uint64_t>(fraction * static_cast<double>(task.estimatedBytes));
+                    }
+                    camera.stop();
+                    if (m_abortLoading) return;
+                    if (rejected || !store->isComplete()) {
+                        failed[i] = "memory ceiling reached";
+                        return;
+                    }
+                    cam.loader->setPreloadedEvents(std::move(store));
+                }
+                progress[i] = task.estimatedBytes;
+            } catch (const std::exception &e) {
+                failed[i] = e.what();
+            }
+        });
+    }
+
+    // Report aggregate progress until every stream is done
+    const auto allDone = [&]() {
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            if (progress[i].load() < tasks[i].estimatedBytes && failed[i].empty()) return false;
+        }
+        return true;
+    };
+    while (!m_abortLoading && !allDone()) {
+        uint64_t done = 0;
+        for (size_t i = 0; i < tasks.size(); ++i) done += std::min(progress[i].load(), tasks[i].estimatedBytes);
+        emit loadingProgress(QString("Preloading into memory: %1% (%2 of %3 MB)")
+                                 .arg(planned ? static_cast<int>(100.0 * done / planned) : 100)
+                                 .arg(megabytes(done))
+                                 .arg(megabytes(planned)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+    for (auto &worker : workers) worker.join();
+
+    for (const auto &name : streamed) {
+        EBV_LOG_INFO << "Preload: " << name << " exceeds the memory ceiling, streaming from disk";
+    }
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        if (!failed[i].empty()) {
+            EBV_LOG_WARN << "Preload of " << tasks[i].name << " failed (" << failed[i] << "), streaming from disk";
+            streamed.push_back(tasks[i].name);
+        }
+    }
+    emit loadingProgress(QString("Preloaded %1 MB into memory (%2 stream(s) streaming from disk)")
+                             .arg(megabytes(m_preloadBudget->used()))
+                             .arg(streamed.size()));
+}
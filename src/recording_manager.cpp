@@ -1,11 +1,19 @@
 #include "recording_manager.h"
-#include <iostream>
+#include "live_stream_export.h"
+#include "session_manifest.h"
+#include "staging_migrator.h"
+#include "event_transcoder.h"
+#include "stream_layout.h"
+#include "memory_accounting.h"
+#include "recording_summary.h"
+#include "logger.h"
 #include <filesystem>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
 #include <stdexcept>
 #include <thread>
+#include <utility>
 
 // Adapter implementations to satisfy interface when using concrete managers
 namespace {
@@ -21,6 +29,13 @@ public:
     void stopPreview() override { impl->stopPreview(); }
     void startRecordingToPath(const std::string& outputPath) override { impl->startRecordingToPath(outputPath); }
     void stopRecordingOnly() override { impl->stopRecordingOnly(); }
+    void switchRecordingPath(const std::string& outputPath) override { impl->switchRecordingPath(outputPath); }
+    void setLiveDataBus(LiveDataBus* bus) override { impl->setLiveDataBus(bus); }
+    size_t deviceCount() const override { return impl->deviceCount(); }
+    void setStreamDirectories(const std::vector<std::string>& directories) override { impl->setStreamDirectories(directories); }
+    double writerPressure() const override { return impl->writerPressure(); }
+    void setWatchdog(StallWatchdog* watchdog) override { impl->setWatchdog(watchdog); }
+    std::vector<StreamSummary> lastTakeSummaries() const override { return impl->lastTakeSummaries(); }
 private:
     std::unique_ptr<FrameCameraManager> impl;
 };
@@ -29,12 +44,22 @@ class EventCameraManagerAdapter : public RecordingManager::IEventCameraManager {
 public:
     EventCameraManagerAdapter() : impl(std::make_unique<EventCameraManager>()) {}
     void openAndSetupDevices(const std::vector<CameraConfig>& cameraConfigs) override { impl->openAndSetupDevices(cameraConfigs); }
+    void applyBiases(const std::vector<CameraConfig>& cameraConfigs) override { impl->applyBiases(cameraConfigs); }
     void startRecording(const std::string& outputPath, const std::string& fileFormat) override { impl->startRecording(outputPath, fileFormat); }
     void stopRecording() override { impl->stopRecording(); }
+    void switchRecording(const std::string& outputPath, const std::string& fileFormat) override { impl->switchRecording(outputPath, fileFormat); }
     void closeDevices() override { impl->closeDevices(); }
     bool startLiveStreaming() override { return impl->startLiveStreaming(); }
     void stopLiveStreaming() override { impl->stopLiveStreaming(); }
     bool getLatestEventFrame(int cameraId, cv::Mat& eventFrame, size_t& frameIndex) override { return impl->getLatestEventFrame(cameraId, eventFrame, frameIndex); }
+    void setLiveDataBus(LiveDataBus* bus) override { impl->setLiveDataBus(bus); }
+    size_t deviceCount() const override { return impl->cameraCount(); }
+    void setStreamDirectories(const std::vector<std::string>& directories) override { impl->setStreamDirectories(directories); }
+    void setHdf5Settings(const EventCameraManager::Hdf5Settings& settings) override { impl->setHdf5Settings(settings); }
+    double writerPressure() const override { return impl->writerPressure(); }
+    void setOverloadController(const OverloadController* controller) override { impl->setOverloadController(controller); }
+    void setWatchdog(StallWatchdog* watchdog) override { impl->setWatchdog(watchdog); }
+    std::vector<StreamSummary> lastTakeSummaries() const override { return impl->lastTakeSummaries(); }
 private:
     std::unique_ptr<EventCameraManager> impl;
 };
@@ -52,18 +77,83 @@ const std::unordered_map<std::string, int> RecordingManager::DEFAULT_BIASES = {
 RecordingManager::RecordingManager() 
     : m_frameCameraManager(std::make_unique<FrameCameraManagerAdapter>())
     , m_eventCameraManager(std::make_unique<EventCameraManagerAdapter>()) {
+    m_frameCameraManager->setLiveDataBus(&m_liveBus);
+    m_eventCameraManager->setLiveDataBus(&m_liveBus);
+    setupOverloadControl();
+    setupStallWatchdog();
 }
 
 RecordingManager::RecordingManager(std::unique_ptr<IFrameCameraManager> frameMgr,
                                    std::unique_ptr<IEventCameraManager> eventMgr)
     : m_frameCameraManager(std::move(frameMgr))
     , m_eventCameraManager(std::move(eventMgr)) {
+    if (m_frameCameraManager) m_frameCameraManager->setLiveDataBus(&m_liveBus);
+    if (m_eventCameraManager) m_eventCameraManager->setLiveDataBus(&m_liveBus);
+    setupOverloadControl();
+    setupStallWatchdog();
+}
+
+void RecordingManager::setupStallWatchdog() {
+    if (m_frameCameraManager) m_frameCameraManager->setWatchdog(&m_watchdog);
+    if (m_eventCameraManager) m_eventCameraManager->setWatchdog(&m_watchdog);
+    m_watchdog.setStallCallback([this](const StallWatchdog::StallEvent& event) {
+        const std::string where = event.operation + (event.detail.empty() ? "" : " on " + event.detail);
+        if (event.ongoing) {
+            notifyStatus("Warning: " + event.stage + " stalled in " + where + " for " +
+                         std::to_string(event.duration.count()) + " ms");
+        } else {
+            notifyStatus(event.stage + " resumed after " + std::to_string(event.duration.count()) + " ms in " + where);
+            m_liveBus.publishStat(event.stage, "stall_ms", static_cast<double>(event.duration.count()));
+        }
+    });
+    m_watchdog.start();
+}
+
+void RecordingManager::setupOverloadControl() {
+    if (m_frameCameraManager) {
+        m_overload.addProbe("frame_writer", [this] { return m_frameCameraManager->writerPressure(); });
+    }
+    if (m_eventCameraManager) {
+        m_overload.addProbe("event_writer", [this] { return m_eventCameraManager->writerPressure(); });
+        m_eventCameraManager->setOverloadController(&m_overload);
+    }
+    m_overload.addCpuProbe();
+    m_overload.setLevelCallback([this](int level, const std::string& reason) {
+        m_liveBus.publishStat("overload", "level", level);
+        notifyStatus(level > 0 ? "Preview reduced to protect capture (level " + std::to_string(level) + ", " + reason + ")"
+                               : "Preview back to full quality (" + reason + ")");
+    });
+    m_overload.start();
+}
+
+void RecordingManager::publishMemoryUsage() {
+    if (!m_liveBus.stats.hasSubscribers()) return;
+    uint64_t total = 0;
+    for (const auto& pool : MemoryAccounting::snapshot()) {
+        m_liveBus.publishStat("memory", pool.name, static_cast<double>(pool.bytes));
+        total += pool.bytes;
+    }
+    m_liveBus.publishStat("memory", "total", static_cast<double>(total));
+    m_liveBus.publishStat("memory", "resident", static_cast<double>(MemoryAccounting::residentBytes()));
 }
 
 RecordingManager::~RecordingManager() {
+    m_overload.stop();
+    m_watchdog.stop();
+    stopControlThread();
     if (m_recording) {
         try { stopRecording(); } catch (...) {}
     }
+    // Finish post-processing while the status/finalized callbacks are still alive;
+    // transcoding first, it may still queue migrations
+    if (m_transcoder) {
+        m_transcoder->waitIdle();
+        m_transcoder.reset();
+    }
+    if (m_migrator) {
+        m_migrator->waitIdle();
+        m_migrator.reset();
+    }
     // Avoid invoking closeDevices() here to prevent double cleanup in test + production;
     // unique_ptr destructors will release resources safely.
 }
@@ -76,6 +166,10 @@ bool RecordingManager::configure(const RecordingConfig& config) {
 
     try {
         validateConfig(config);
+
+        if (m_configured && !requiresDeviceReopen(m_currentConfig, config)) {
+            return reconfigureInPlace(config);
+        }
         
         // Close any previously opened devices
         closeDevices();
@@ -95,6 +189,7 @@ bool RecordingManager::configure(const RecordingConfig& config) {
         m_eventCameraManager->openAndSetupDevices(eventConfigs);
         
     m_configured = true;
+        startLiveExport();
         notifyStatus("Camera configuration completed successfully");
         return true;
         
@@ -105,6 +200,32 @@ bool RecordingManager::configure(const RecordingConfig& config) {
     }
 }
 
+bool RecordingManager::requiresDeviceReopen(const RecordingConfig& current, const RecordingConfig& next) {
+    // Only the set and order of event cameras (master first) defines the device topology
+    return current.eventCameraSerials != next.eventCameraSerials;
+}
+
+bool RecordingManager::reconfigureInPlace(const RecordingConfig& config) {
+    notifyStatus("Applying configuration changes to open cameras...");
+
+    // Auto-discovered cameras always run with default biases, nothing to write
+    if (config.biases != m_currentConfig.biases && !config.eventCameraSerials.empty()) {
+        m_eventCameraManager->applyBiases(createEventCameraConfigs(config));
+    }
+
+    const bool exportChanged = config.liveExportName != m_currentConfig.liveExportName ||
+                               config.liveExportSlots != m_currentConfig.liveExportSlots ||
+                               config.liveExportSlotBytes != m_currentConfig.liveExportSlotBytes;
+    if (exportChanged) stopLiveExport();
+
+    // Format, prefix and length are read when the next recording starts
+    m_currentConfig = config;
+    if (exportChanged) startLiveExport();
+
+    notifyStatus("Camera configuration updated without reopening devices");
+    return true;
+}
+
 bool RecordingManager::startRecording(const std::string& outputDirectory) {
     if (m_recording) {
         notifyStatus("Error: Recording is already in progress");
@@ -117,28 +238,30 @@ bool RecordingManager::startRecording(const std::string& outputDirectory) {
     }
 
     try {
-        // Create output directory
-        std::filesystem::create_directories(outputDirectory);
-        m_currentOutputDir = outputDirectory;
+        // With staging enabled the take is captured on the fast tier and migrated afterwards
+        const std::string captureDirectory = captureDirectoryFor(outputDirectory);
+        std::filesystem::create_directories(captureDirectory);
+        setCurrentTake(captureDirectory, outputDirectory);
         
-        notifyStatus("Starting recording to: " + outputDirectory);
-        m_recordingStartTime = std::chrono::steady_clock::now();
+        notifyStatus("Starting recording to: " + captureDirectory);
+        m_eventCameraManager->setHdf5Settings({m_currentConfig.hdf5CompressionLevel, m_currentConfig.hdf5ChunkEvents});
+        beginTakeManifest(captureDirectory, outputDirectory, applyStreamLayout(captureDirectory));
         
+        // The event capture pipeline keeps running across takes; recording attaches a sink
+        if (!m_eventCameraManager->startLiveStreaming()) {
+            notifyStatus("Warning: Failed to start event camera live streaming");
+        }
+
         // Start recording on both managers (devices are already configured)
         notifyStatus("Starting event camera recording...");
-        m_eventCameraManager->startRecording(outputDirectory, m_currentConfig.eventFileFormat);
+        m_eventCameraManager->startRecording(captureDirectory, m_currentConfig.eventFileFormat);
         
         notifyStatus("Starting frame camera recording...");
         if (m_previewing) {
             // If preview already running, just start disk writing
-            m_frameCameraManager->startRecordingToPath(outputDirectory);
+            m_frameCameraManager->startRecordingToPath(captureDirectory);
         } else {
-            m_frameCameraManager->startRecording(outputDirectory);
-        }
-        
-        // Start live streaming for both cameras
-        if (!m_eventCameraManager->startLiveStreaming()) {
-            notifyStatus("Warning: Failed to start event camera live streaming");
+            m_frameCameraManager->startRecording(captureDirectory);
         }
         
         m_recording = true;
@@ -186,26 +309,17 @@ void RecordingManager::stopRecording() {
             else m_frameCameraManager->stopRecording();
         }
         
-        // Stop event camera recording and ensure flushing
+        // Detach the event recording sinks; the capture pipeline keeps running for the next take.
+        // This returns once every file is closed, so no extra flush delay is needed.
         notifyStatus("Stopping event camera recording and flushing data...");
         if (m_eventCameraManager) {
-            // First stop recording streams (file close may require cameras to stop)
             m_eventCameraManager->stopRecording();
         }
 
-        // Mark recording ended before stopping live streaming so cameras can be stopped
         m_recording = false;
-
-        // Stop live streaming only if not previewing (finalize files by stopping cameras)
-        if (m_eventCameraManager && !m_previewing) {
-            m_eventCameraManager->stopLiveStreaming();
-        }
-        
-        // Give extra time for buffers to flush to disk
-        notifyStatus("Waiting for data flush to complete...");
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
         
         auto duration = getRecordingDurationSeconds();
+        finishTake(m_currentOutputDir, m_finalOutputDir, duration);
         notifyStatus("Recording completed successfully! Duration: " + 
                     std::to_string(duration) + " seconds");
                     
@@ -217,6 +331,42 @@ void RecordingManager::stopRecording() {
     }
 }
 
+bool RecordingManager::startNextTake(const std::string& outputDirectory) {
+    return invokeOnControlThread([this, &outputDirectory] { return switchToNextTake(outputDirectory); });
+}
+
+bool RecordingManager::switchToNextTake(const std::string& outputDirectory) {
+    if (!m_recording) {
+        return startRecording(outputDirectory);
+    }
+    if (outputDirectory == m_finalOutputDir) {
+        notifyStatus("Next take needs a new directory, already recording to: " + outputDirectory);
+        return false;
+    }
+
+    try {
+        const std::string captureDirectory = captureDirectoryFor(outputDirectory);
+        std::filesystem::create_directories(captureDirectory);
+        notifyStatus("Switching recording to: " + captureDirectory);
+        m_eventCameraManager->setHdf5Settings({m_currentConfig.hdf5CompressionLevel, m_currentConfig.hdf5ChunkEvents});
+        beginTakeManifest(captureDirectory, outputDirectory, applyStreamLayout(captureDirectory));
+
+        // Event cameras switch at a single timestamp boundary (no gap, no duplicates)
+        m_eventCameraManager->switchRecording(captureDirectory, m_currentConfig.eventFileFormat);
+
+        // Frame cameras keep acquiring and the writer keeps running; frames queued from now on
+        // go to the new take
+        m_frameCameraManager->switchRecordingPath(captureDirectory);
+
+        finishTake(m_currentOutputDir, m_finalOutputDir, getRecordingDurationSeconds());
+        setCurrentTake(captureDirectory, outputDirectory);
+        return true;
+    } catch (const std::exception& e) {
+        notifyStatus("Error switching recording: " + std::string(e.what()));
+        return false;
+    }
+}
+
 void RecordingManager::closeDevices() {
     try {
         notifyStatus("Closing and releasing camera resources...");
@@ -230,6 +380,8 @@ void RecordingManager::closeDevices() {
             stopPreview();
         }
         
+        stopLiveExport();
+
         // Close event cameras
     if (m_eventCameraManager) m_eventCameraManager->closeDevices();
         
@@ -243,13 +395,205 @@ void RecordingManager::closeDevices() {
     }
 }
 
+std::string RecordingManager::captureDirectoryFor(const std::string& outputDirectory) const {
+    if (m_currentConfig.stagingDirectory.empty()) return outputDirectory;
+    const auto normalized = std::filesystem::path(outputDirectory).lexically_normal();
+    const auto name = normalized.has_filename() ? normalized.filename() : normalized.parent_path().filename();
+    return (std::filesystem::path(m_currentConfig.stagingDirectory) / name).string();
+}
+
+std::map<std::string, std::filesystem::path> RecordingManager::applyStreamLayout(const std::string& captureDirectory) {
+    const auto& config = m_currentConfig;
+    const bool striped = !config.outputRoots.empty() || !config.streamOutputRoots.empty();
+    if (striped && !config.stagingDirectory.empty()) {
+        notifyStatus("Warning: output striping is ignored while staging is enabled");
+    }
+
+    const size_t frameCameras = m_frameCameraManager->deviceCount();
+    const size_t eventCameras = m_eventCameraManager->deviceCount();
+    const auto streams = StreamLayout::streamNames(frameCameras, eventCameras);
+    const auto layout = config.stagingDirectory.empty()
+        ? StreamLayout::assign(streams, captureDirectory, config.outputRoots, config.streamOutputRoots)
+        : StreamLayout::assign(streams, captureDirectory, {});
+
+    m_frameCameraManager->setStreamDirectories(StreamLayout::frameDirectories(layout, frameCameras));
+    m_eventCameraManager->setStreamDirectories(StreamLayout::eventDirectories(layout, eventCameras));
+    for (const auto& [stream, directory] : layout) {
+        if (directory != captureDirectory) {
+            std::filesystem::create_directories(directory);
+            notifyStatus("Stream " + stream + " -> " + directory.string());
+        }
+    }
+    return layout;
+}
+
+void RecordingManager::beginTakeManifest(const std::string& captureDirectory, const std::string& finalDirectory,
+                                         const std::map<std::string, std::filesystem::path>& streamLayout) {
+    const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::ostringstream started;
+    started << std::put_time(std::localtime(&now), "%Y-%m-%dT%H:%M:%S");
+
+    SessionManifest manifest;
+    manifest.set(SessionManifest::KEY_STATE, "recording");
+    manifest.set(SessionManifest::KEY_CAPTURE_DIR, std::filesystem::absolute(captureDirectory).string());
+    manifest.set(SessionManifest::KEY_FINAL_DIR, std::filesystem::absolute(finalDirectory).string());
+    manifest.set("session.started", started.str());
+    manifest.set("event.format", m_currentConfig.eventFileFormat);
+    if (m_currentConfig.eventFileFormat == "hdf5") {
+        manifest.set("event.hdf5_compression", m_currentConfig.hdf5CompressionLevel < 0
+            ? "ecf" : "deflate-" + std::to_string(m_currentConfig.hdf5CompressionLevel));
+        manifest.set("event.hdf5_chunk_events", std::to_string(m_currentConfig.hdf5ChunkEvents));
+    }
+    for (const auto& [stream, directory] : streamLayout) {
+        if (directory != captureDirectory) {
+            manifest.set(SessionManifest::streamKey(stream), std::filesystem::absolute(directory).string());
+        }
+    }
+    if (!manifest.save(captureDirectory)) {
+        notifyStatus("Warning: could not write session manifest to " + captureDirectory);
+    }
+}
+
+void RecordingManager::finishTake(const std::string& captureDirectory, const std::string& finalDirectory,
+                                  double durationSeconds) {
+    SessionManifest manifest;
+    manifest.load(captureDirectory);
+    manifest.set("session.duration_s", std::to_string(durationSeconds));
+    // Stalls during the take, e.g. "stall.0=frame_writer 812 ms imwrite /mnt/ssd1/.../frame_cam0"
+    const auto stalls = m_watchdog.stallsSince(m_recordingStartTime);
+    manifest.set("session.stalls", std::to_string(stalls.size()));
+    for (size_t i = 0; i < stalls.size(); ++i) {
+        manifest.set("stall." + std::to_string(i), stalls[i].stage + " " + std::to_string(stalls[i].duration.count()) + " ms " +
+                                                   stalls[i].operation + (stalls[i].detail.empty() ? "" : " " + stalls[i].detail));
+    }
+
+    const bool staged = captureDirectory != finalDirectory;
+    const bool transcode = m_currentConfig.transcodeRawToHdf5 && m_currentConfig.eventFileFormat == "raw";
+    manifest.set(SessionManifest::KEY_STATE, transcode ? "transcoding" : (staged ? "captured" : "complete"));
+    manifest.save(captureDirectory);
+
+    // Both managers have closed the take's files, so their statistics are final
+    std::vector<StreamSummary> streams;
+    if (m_frameCameraManager) streams = m_frameCameraManager->lastTakeSummaries();
+    if (m_eventCameraManager) {
+        for (auto& stream : m_eventCameraManager->lastTakeSummaries()) streams.push_back(std::move(stream));
+    }
+    const RecordingSummary summary(durationSeconds, std::move(streams));
+    if (summary.save(captureDirectory)) {
+        for (const auto& stream : summary.streams()) {
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(1) << "Take summary " << stream.stream << ": ";
+            if (stream.events) line << (stream.eventsOn + stream.eventsOff) << " events, " << stream.gaps << " gaps";
+            else line << stream.frames << " frames, " << stream.droppedFrames << " dropped, " << stream.fpsAvg << " fps avg";
+            notifyStatus(line.str());
+        }
+    }
+
+    // Post-processing chain: [transcode RAW -> HDF5] -> [migrate staged take] -> finalized
+    if (staged) {
+        if (!m_migrator) {
+            m_migrator = std::make_unique<StagingMigrator>(m_currentConfig.migrationBytesPerSecond);
+            m_migrator->setCompletionCallback([this](const StagingMigrator::Job& job, bool ok, const std::string& message) {
+                notifyStatus((ok ? "Migration complete: " : "Migration failed: ") + job.finalDir.string() + " (" + message + ")");
+                if (m_takeFinalizedCallback) m_takeFinalizedCallback(job.finalDir.string(), ok);
+            });
+        }
+        m_migrator->setBytesPerSecond(m_currentConfig.migrationBytesPerSecond);
+    }
+
+    if (transcode) {
+        if (!m_transcoder) {
+            m_transcoder = std::make_unique<EventTranscoder>();
+            m_transcoder->setCompletionCallback([this](const EventTranscoder::Job& job, bool ok, const std::string& message) {
+                onTranscodeFinished(job.takeDirectory.string(), ok, message);
+            });
+        }
+        notifyStatus("Queued RAW to HDF5 transcoding of " + captureDirectory);
+        m_transcoder->enqueue({captureDirectory, m_currentConfig.keepRawAfterTranscode});
+    } else if (staged) {
+        notifyStatus("Queued migration " + captureDirectory + " -> " + finalDirectory);
+        m_migrator->enqueue({captureDirectory, finalDirectory});
+    }
+}
+
+void RecordingManager::onTranscodeFinished(const std::string& captureDirectory, bool success, const std::string& message) {
+    // Runs on the transcoder thread. A failed transcode keeps the RAW files, the take is still usable.
+    notifyStatus((success ? "Transcoding complete: " : "Transcoding failed: ") + captureDirectory + " (" + message + ")");
+
+    SessionManifest manifest;
+    manifest.load(captureDirectory);
+    const std::string finalDirectory = manifest.get(SessionManifest::KEY_FINAL_DIR, captureDirectory);
+    const bool staged = std::filesystem::absolute(captureDirectory) != std::filesystem::absolute(finalDirectory);
+    manifest.set(SessionManifest::KEY_STATE, staged ? "captured" : "complete");
+    manifest.save(captureDirectory);
+
+    if (staged && m_migrator) {
+        m_migrator->enqueue({captureDirectory, finalDirectory});
+    } else if (m_takeFinalizedCallback) {
+        m_takeFinalizedCallback(finalDirectory, success);
+    }
+}
+
+size_t RecordingManager::pendingTranscodes() const {
+    return m_transcoder ? m_transcoder->pendingJobs() : 0;
+}
+
+size_t RecordingManager::pendingMigrations() const {
+    return m_migrator ? m_migrator->pendingJobs() : 0;
+}
+
+void RecordingManager::startLiveExport() {
+    if (m_currentConfig.liveExportName.empty() || m_liveExport) return;
+
+    ShmStreamExporter::Options options;
+    options.name = m_currentConfig.liveExportName;
+    options.slotCount = m_currentConfig.liveExportSlots;
+    options.slotBytes = m_currentConfig.liveExportSlotBytes;
+    auto liveExport = std::make_unique<LiveStreamExport>(m_liveBus, options);
+    if (!liveExport->start()) {
+        notifyStatus("Warning: Failed to start live export to " + m_currentConfig.liveExportName);
+        return;
+    }
+    m_liveExport = std::move(liveExport);
+    notifyStatus("Live export available at shared memory " + m_liveExport->exporter().name());
+}
+
+void RecordingManager::stopLiveExport() {
+    if (!m_liveExport) return;
+    m_liveExport->stop();
+    m_liveExport.reset();
+}
+
+void RecordingManager::setCurrentTake(const std::string& captureDirectory, const std::string& finalDirectory) {
+    std::lock_guard<std::mutex> lock(m_takeMutex);
+    m_currentOutputDir = captureDirectory;
+    m_finalOutputDir = finalDirectory;
+    m_recordingStartTime = std::chrono::steady_clock::now();
+}
+
+std::string RecordingManager::getCurrentOutputDirectory() const {
+    std::lock_guard<std::mutex> lock(m_takeMutex);
+    return m_currentOutputDir;
+}
+
+std::string RecordingManager::getFinalOutputDirectory() const {
+    std::lock_guard<std::mutex> lock(m_takeMutex);
+    return m_finalOutputDir;
+}
+
+std::chrono::steady_clock::time_point RecordingManager::getRecordingStartTime() const {
+    std::lock_guard<std::mutex> lock(m_takeMutex);
+    return m_recordingStartTime;
+}
+
 double RecordingManager::getRecordingDurationSeconds() const {
-    if (!m_recording && m_recordingStartTime == std::chrono::steady_clock::time_point{}) {
+    const auto start = getRecordingStartTime();
+    if (!m_recording && start == std::chrono::steady_clock::time_point{}) {
         return 0.0;
     }
     
     auto now = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_recordingStartTime);
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - start);
     return duration.count() / 1000.0;
 }
 
@@ -310,6 +654,13 @@ void RecordingManager::validateConfig(const RecordingConfig& config) const {
         throw std::runtime_error("Invalid event file format '" + config.eventFileFormat + 
                                 "'. Supported formats are 'raw' and 'hdf5'.");
     }
+    if (config.hdf5CompressionLevel > 9) {
+        throw std::runtime_error("Invalid HDF5 compression level " + std::to_string(config.hdf5CompressionLevel) +
+                                 ". Use -1 (SDK default) or 0..9.");
+    }
+    if (config.hdf5ChunkEvents == 0) {
+        throw std::runtime_error("HDF5 chunk size must be at least one event");
+    }
     
     // Additional validation can be added here as needed
 }
@@ -319,7 +670,7 @@ void RecordingManager::notifyStatus(const std::string& message) const {
         m_statusCallback(message);
     } else {
         // Default behavior: print to console
-        std::cout << message << std::endl;
+        EBV_LOG_INFO << message;
     }
 }
 
@@ -363,20 +714,225 @@ bool RecordingManager::startPreview() {
 void RecordingManager::stopPreview() {
     if (!m_previewing) return;
     notifyStatus("Stopping live preview...");
-    // Stop live streaming on event cameras
-    m_eventCameraManager->stopLiveStreaming();
+    // Stop live streaming on event cameras, unless a recording is still fed by the pipeline
+    if (!m_recording) {
+        m_eventCameraManager->stopLiveStreaming();
+    }
     // Stop acquisition on frame cameras
     m_frameCameraManager->stopPreview();
     m_previewing = false;
 }
 
+void RecordingManager::enterIdle() {
+    if (m_recording || !m_configured) return;
+    if (m_previewing) {
+        stopPreview();
+        return;
+    }
+    // A take started without preview leaves the capture pipeline running; stop it too
+    m_eventCameraManager->stopLiveStreaming();
+    m_frameCameraManager->stopPreview();
+}
+
 void RecordingManager::configureAsync(const RecordingConfig& config, SetupCallback onComplete) {
-    // Launch on background thread
-    std::thread([this, config, onComplete](){
-        bool ok = configure(config);
+    submitConfigure(config, [onComplete](const CommandResult& result) {
+        if (onComplete) {
+            onComplete(result.success, result.success ? std::string("Camera configuration completed successfully")
+                                                      : result.message);
+        }
+    });
+}
+
+// ---- Asynchronous control ----
+
+RecordingManager::State RecordingManager::state() const {
+    if (m_recording) return State::Recording;
+    if (!m_configured) return State::Closed;
+    if (m_previewing) return State::Previewing;
+    return State::Idle;
+}
+
+bool RecordingManager::isValidTransition(State from, Command command) {
+    switch (command) {
+        case Command::Configure: return from != State::Recording;
+        case Command::Preview: return from == State::Idle || from == State::Previewing;
+        case Command::Record: return from == State::Idle || from == State::Previewing;
+        case Command::NextTake: return from == State::Idle || from == State::Previewing || from == State::Recording;
+        case Command::Stop: return from != State::Closed;
+        case Command::Close: return from != State::Closed;
+    }
+    return false;
+}
+
+const char* RecordingManager::stateName(State state) {
+    switch (state) {
+        case State::Closed: return "closed";
+        case State::Idle: return "idle";
+        case State::Previewing: return "previewing";
+        case State::Recording: return "recording";
+    }
+    return "unknown";
+}
+
+const char* RecordingManager::commandName(Command command) {
+    switch (command) {
+        case Command::Configure: return "configure";
+        case Command::Preview: return "preview";
+        case Command::Record: return "record";
+        case Command::NextTake: return "next";
+        case Command::Stop: return "stop";
+        case Command::Close: return "close";
+    }
+    return "unknown";
+}
+
+std::future<RecordingManager::CommandResult> RecordingManager::submitConfigure(const RecordingConfig& config,
+                                                                                CommandCallback onComplete) {
+    return submit(Command::Configure, config, {}, std::move(onComplete));
+}
+
+std::future<RecordingManager::CommandResult> RecordingManager::submitPreview(CommandCallback onComplete) {
+    return submit(Command::Preview, {}, {}, std::move(onComplete));
+}
+
+std::future<RecordingManager::CommandResult> RecordingManager::submitRecord(const std::string& outputDirectory,
+                                                                             CommandCallback onComplete) {
+    return submit(Command::Record, {}, outputDirectory, std::move(onComplete));
+}
+
+std::future<RecordingManager::CommandResult> RecordingManager::submitNextTake(const std::string& outputDirectory,
+                                                                               CommandCallback onComplete) {
+    return submit(Command::NextTake, {}, outputDirectory, std::move(onComplete));
+}
+
+std::future<RecordingManager::CommandResult> RecordingManager::submitStop(CommandCallback onComplete) {
+    return submit(Command::Stop, {}, {}, std::move(onComplete));
+}
+
+std::future<RecordingManager::CommandResult> RecordingManager::submitClose(CommandCallback onComplete) {
+    return submit(Command::Close, {}, {}, std::move(onComplete));
+}
+
+std::future<RecordingManager::CommandResult> RecordingManager::submit(Command command, RecordingConfig config,
+                                                                      std::string outputDirectory,
+                                                                      CommandCallback onComplete) {
+    auto promise = std::make_shared<std::promise<CommandResult>>();
+    auto future = promise->get_future();
+    auto finish = [promise, onComplete](const CommandResult& result) {
         if (onComplete) {
-            onComplete(ok, ok ? std::string("Camera configuration completed successfully")
-                              : std::string("Failed to configure cameras"));
+            try { onComplete(result); } catch (...) {}
         }
-    }).detach();
+        promise->set_value(result);
+    };
+    enqueueControlTask(
+        [this, command, config = std::move(config), outputDirectory = std::move(outputDirectory), finish] {
+            finish(executeCommand(command, config, outputDirectory));
+        },
+        [this, command, finish] {
+            CommandResult result;
+            result.message = std::string(commandName(command)) + " cancelled: recording manager shut down";
+            result.state = state();
+            finish(result);
+        });
+    return future;
+}
+
+RecordingManager::CommandResult RecordingManager::executeCommand(Command command, const RecordingConfig& config,
+                                                                 const std::string& outputDirectory) {
+    CommandResult result;
+    const State from = state();
+    if (!isValidTransition(from, command)) {
+        result.message = std::string("Cannot ") + commandName(command) + " while " + stateName(from);
+        result.state = from;
+        notifyStatus("Rejected command: " + result.message);
+        return result;
+    }
+
+    try {
+        switch (command) {
+            case Command::Configure:
+                result.success = configure(config);
+                break;
+            case Command::Preview:
+                result.success = startPreview();
+                break;
+            case Command::Record:
+                result.success = startRecording(outputDirectory);
+                result.directory = m_currentOutputDir;
+                break;
+            case Command::NextTake:
+                if (from == State::Recording) result.closedDirectory = m_currentOutputDir;
+                result.success = switchToNextTake(outputDirectory);
+                result.directory = m_currentOutputDir;
+                break;
+            case Command::Stop:
+                if (from == State::Recording) {
+                    result.directory = m_currentOutputDir;
+                    stopRecording(); // returns once every file is closed
+                    result.success = !m_recording;
+                } else {
+                    enterIdle();
+                    result.success = true;
+                }
+                break;
+            case Command::Close:
+                closeDevices();
+                result.success = !m_configured;
+                break;
+        }
+        result.message = std::string(commandName(command)) + (result.success ? " completed" : " failed");
+    } catch (const std::exception& e) {
+        result.success = false;
+        result.message = std::string(commandName(command)) + " failed: " + e.what();
+    }
+    result.state = state();
+    return result;
+}
+
+void RecordingManager::enqueueControlTask(std::function<void()> run, std::function<void()> cancel) {
+    {
+        std::unique_lock<std::mutex> lock(m_controlMutex);
+        if (m_controlStopping) {
+            lock.unlock();
+            cancel();
+            return;
+        }
+        m_controlQueue.push_back({std::move(run), std::move(cancel)});
+        if (!m_controlThread.joinable()) {
+            m_controlThread = std::thread(&RecordingManager::controlThreadMain, this);
+            m_controlThreadId = m_controlThread.get_id();
+        }
+    }
+    m_controlCv.notify_one();
+}
+
+bool RecordingManager::onControlThread() {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    return m_controlThread.joinable() && std::this_thread::get_id() == m_controlThreadId;
+}
+
+void RecordingManager::controlThreadMain() {
+    std::unique_lock<std::mutex> lock(m_controlMutex);
+    while (true) {
+        m_controlCv.wait(lock, [this] { return m_controlStopping || !m_controlQueue.empty(); });
+        if (m_controlStopping) break;
+        ControlTask task = std::move(m_controlQueue.front());
+        m_controlQueue.pop_front();
+        lock.unlock();
+        task.run();
+        lock.lock();
+    }
+}
+
+void RecordingManager::stopControlThread() {
+    std::deque<ControlTask> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        m_controlStopping = true;
+        pending.swap(m_controlQueue);
+    }
+    m_controlCv.notify_all();
+    // The command in progress finishes; everything still queued is cancelled
+    if (m_controlThread.joinable()) m_controlThread.join();
+    for (auto& task : pending) task.cancel();
 }
@@ -0,0 +1,144 @@
+#include "recording_preload.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+void* PreloadMemory::allocate(size_t bytes, bool hugePages) {
+    if (bytes < MAPPING_THRESHOLD) return ::operator new(bytes);
+    void* pointer = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pointer == MAP_FAILED) throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+    // Advisory only: without THP support the mapping simply stays on normal pages
+    if (hugePages) madvise(pointer, bytes, MADV_HUGEPAGE);
+#else
+    (void)hugePages;
+#endif
+    return pointer;
+}
+
+void PreloadMemory::release(void* pointer, size_t bytes) noexcept {
+    if (!pointer) return;
+    if (bytes < MAPPING_THRESHOLD) {
+        ::operator delete(pointer);
+    } else {
+        munmap(pointer, bytes);
+    }
+}
+
+uint64_t PreloadMemory::physicalMemoryBytes() {
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGE_SIZE);
+    if (pages <= 0 || pageSize <= 0) return 0;
+    return static_cast<uint64_t>(pages) * static_cast<uint64_t>(pageSize);
+}
+
+uint64_t PreloadMemory::ceilingFor(const PreloadOptions& options) {
+    if (options.memoryCeilingBytes > 0) return options.memoryCeilingBytes;
+    return physicalMemoryBytes() / 2;
+}
+
+bool PreloadBudget::tryReserve(uint64_t bytes) {
+    uint64_t used = m_used.load();
+    do {
+        if (used + bytes > m_ceiling) return false;
+    } while (!m_used.compare_exchange_weak(used, used + bytes));
+    m_memory.add(bytes, 0);
+    return true;
+}
+
+void PreloadBudget::release(uint64_t bytes) {
+    m_used.fetch_sub(bytes);
+    m_memory.release(bytes, 0);
+}
+
+// ---- PreloadedFrameStore ----
+
+PreloadedFrameStore::PreloadedFrameStore(PreloadBudget& budget, bool hugePages, uint64_t expectedBytes,
+                                         size_t expectedFrames)
+    : m_budget(budget), m_bytes(PreloadAllocator<uint8_t>(hugePages)) {
+    // File sizes are known up front, so the buffer normally never grows
+    if (charge(static_cast<size_t>(expectedBytes), expectedFrames)) {
+        m_bytes.reserve(static_cast<size_t>(expectedBytes));
+        m_offsets.reserve(expectedFrames + 1);
+    }
+}
+
+PreloadedFrameStore::~PreloadedFrameStore() {
+    m_budget.release(m_charged);
+}
+
+bool PreloadedFrameStore::charge(size_t bytes, size_t frames) {
+    const uint64_t wanted = bytes + (frames + 1) * sizeof(uint64_t);
+    if (wanted <= m_charged) return true;
+    if (!m_budget.tryReserve(wanted - m_charged)) return false;
+    m_charged = wanted;
+    return true;
+}
+
+bool PreloadedFrameStore::append(const uint8_t* data, size_t size) {
+    const size_t needed = m_bytes.size() + size;
+    if (needed > m_bytes.capacity()) {
+        // A file grew after it was sized: grow by half to keep appends amortized
+        const size_t grown = std::max(needed, m_bytes.capacity() + m_bytes.capacity() / 2);
+        if (!charge(grown, std::max(m_offsets.capacity(), m_offsets.size() + 1))) return false;
+        m_bytes.reserve(grown);
+    } else if (!charge(m_bytes.capacity(), std::max(m_offsets.capacity(), m_offsets.size() + 1))) {
+        return false;
+    }
+    m_bytes.insert(m_bytes.end(), data, data + size);
+    m_offsets.push_back(m_bytes.size());
+    return true;
+}
+
+std::pair<const uint8_t*, size_t> PreloadedFrameStore::frame(size_t index) const {
+    if (index + 1 >= m_offsets.size()) return {nullptr, 0};
+    return {m_bytes.data() + m_offsets[index], static_cast<size_t>(m_offsets[index + 1] - m_offsets[index])};
+}
+
+// ---- PreloadedEventStore ----
+
+PreloadedEventStore::PreloadedEventStore(PreloadBudget& budget, bool hugePages, size_t expectedEvents)
+    : m_budget(budget),
+      m_x(PreloadAllocator<uint16_t>(hugePages)),
+      m_y(PreloadAllocator<uint16_t>(hugePages)),
+      m_p(PreloadAllocator<uint8_t>(hugePages)),
+      m_t(PreloadAllocator<uint32_t>(hugePages)) {
+    if (expectedEvents > 0) ensureCapacity(expectedEvents);
+}
+
+PreloadedEventStore::~PreloadedEventStore() {
+    m_budget.release(m_charged);
+}
+
+bool PreloadedEventStore::ensureCapacity(size_t events) {
+    if (events <= m_t.capacity()) return true;
+    // Grow by a quarter: the estimate is usually close, and doubling a multi-GB array
+    // would overshoot the ceiling long before it is actually needed
+    const size_t grown = std::max(events, m_t.capacity() + m_t.capacity() / 4);
+    const uint64_t wanted = static_cast<uint64_t>(grown) * BYTES_PER_EVENT;
+    if (!m_budget.tryReserve(wanted - m_charged)) return false;
+    m_charged = wanted;
+    m_x.reserve(grown);
+    m_y.reserve(grown);
+    m_p.reserve(grown);
+    m_t.reserve(grown);
+    return true;
+}
+
+std::pair<size_t, size_t> PreloadedEventStore::range(int64_t startUs, int64_t endUs) const {
+    const auto toOffset = [this](int64_t timeUs) -> uint64_t {
+        const int64_t offset = timeUs - m_baseTime;
+        if (offset <= 0) return 0;
+        return static_cast<uint64_t>(offset);
+    };
+    const uint64_t start = toOffset(startUs);
+    const uint64_t end = toOffset(endUs);
+    const auto first = std::lower_bound(m_t.begin(), m_t.end(), start,
+                                        [](uint32_t t, uint64_t value) { return t < value; });
+    const auto last = std::lower_bound(first, m_t.end(), end,
+                                       [](uint32_t t, uint64_t value) { return t < value; });
+    return {static_cast<size_t>(first - m_t.begin()), static_cast<size_t>(last - m_t.begin())};
+}
@@ -0,0 +1,185 @@
+#include "recording_summary.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+constexpr int64_t SECOND_US = 1'000'000;
+
+std::string fixed(double value, int precision) {
+    char text[48];
+    std::snprintf(text, sizeof(text), "%.*f", precision, value);
+    return text;
+}
+} // namespace
+
+void StreamStatistics::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_started = false;
+    m_items = m_on = m_off = m_triggers = m_dropped = m_bytes = 0;
+    m_firstUs = m_lastUs = 0;
+    m_windowStartUs = 0;
+    m_windowCount = m_windows = m_windowMin = m_windowMax = 0;
+    m_gaps = 0;
+    m_maxGapUs = 0;
+    m_countedOnly = 0;
+}
+
+void StreamStatistics::addFrame(int64_t timestampUs, uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_items >= 2) {
+        const double average = static_cast<double>(m_lastUs - m_firstUs) / static_cast<double>(m_items - 1);
+        const int64_t interval = timestampUs - m_lastUs;
+        if (interval > GAP_FACTOR * average) {
+            ++m_gaps;
+            m_maxGapUs = std::max(m_maxGapUs, interval);
+        }
+    }
+    m_bytes += bytes;
+    advance(timestampUs, 1);
+}
+
+void StreamStatistics::addEventChunk(uint64_t count, int64_t firstUs, int64_t lastUs) {
+    if (count == 0) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    advance(firstUs, 0);
+    advance(lastUs, count);
+    m_countedOnly += count;
+}
+
+void StreamStatistics::addDroppedFrames(uint64_t frames) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dropped += frames;
+}
+
+void StreamStatistics::addTriggers(uint64_t count) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_triggers += count;
+}
+
+void StreamStatistics::setBytes(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bytes = bytes;
+}
+
+void StreamStatistics::advance(int64_t timestampUs, uint64_t count) {
+    if (!m_started) {
+        m_started = true;
+        m_firstUs = m_lastUs = m_windowStartUs = timestampUs;
+    }
+    // Close every whole second before this timestamp; seconds without data count as 0
+    while (timestampUs - m_windowStartUs >= SECOND_US) {
+        m_windowMin = m_windows == 0 ? m_windowCount : std::min(m_windowMin, m_windowCount);
+        m_windowMax = std::max(m_windowMax, m_windowCount);
+        ++m_windows;
+        m_windowCount = 0;
+        m_windowStartUs += SECOND_US;
+    }
+    m_items += count;
+    m_windowCount += count;
+    m_lastUs = std::max(m_lastUs, timestampUs);
+}
+
+StreamSummary StreamStatistics::summary(const std::string& stream, bool events) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    StreamSummary result;
+    result.stream = stream;
+    result.events = events;
+    result.durationSeconds = static_cast<double>(m_lastUs - m_firstUs) / SECOND_US;
+    result.bytes = m_bytes;
+    result.gaps = m_gaps;
+    result.maxGapMs = static_cast<double>(m_maxGapUs) / 1000.0;
+    const double span = result.durationSeconds;
+    if (events) {
+        result.eventsOn = m_on;
+        result.eventsOff = m_off;
+        // Chunks counted without their events: scale the split of the others to the total
+        result.eventsCountedOnly = m_countedOnly;
+        if (m_on + m_off != m_items && m_on + m_off > 0) {
+            result.eventsOn = static_cast<uint64_t>(static_cast<double>(m_items) * m_on / (m_on + m_off) + 0.5);
+            result.eventsOff = m_items - result.eventsOn;
+        }
+        result.triggers = m_triggers;
+        if (span > 0.0) {
+            result.rateOn = static_cast<double>(result.eventsOn) / span;
+            result.rateOff = static_cast<double>(result.eventsOff) / span;
+        }
+        result.rateMax = m_windows > 0 ? static_cast<double>(m_windowMax) : result.rateOn + result.rateOff;
+    } else {
+        result.frames = m_items;
+        result.droppedFrames = m_dropped;
+        // n frames span n - 1 intervals
+        if (span > 0.0 && m_items > 1) result.fpsAvg = static_cast<double>(m_items - 1) / span;
+        // Takes shorter than a second have no whole window
+        result.fpsMin = m_windows > 0 ? static_cast<double>(m_windowMin) : result.fpsAvg;
+        result.fpsMax = m_windows > 0 ? static_cast<double>(m_windowMax) : result.fpsAvg;
+    }
+    return result;
+}
+
+std::string RecordingSummary::format() const {
+    std::ostringstream out;
+    out << "# ebv_frame_recording take summary\n";
+    out << "duration_s=" << fixed(m_durationSeconds, 3) << '\n';
+    for (const auto& s : m_streams) {
+        const std::string key = s.stream + ".";
+        out << key << "span_s=" << fixed(s.durationSeconds, 3) << '\n';
+        if (s.events) {
+            out << key << "events=" << (s.eventsOn + s.eventsOff) << '\n';
+            out << key << "events_on=" << s.eventsOn << '\n';
+            out << key << "events_off=" << s.eventsOff << '\n';
+            out << key << "triggers=" << s.triggers << '\n';
+            out << key << "rate_on_per_s=" << fixed(s.rateOn, 0) << '\n';
+            out << key << "rate_off_per_s=" << fixed(s.rateOff, 0) << '\n';
+            out << key << "rate_max_per_s=" << fixed(s.rateMax, 0) << '\n';
+            out << key << "boundary_lag_us=" << s.boundaryLagUs << '\n';
+            out << key << "events_counted_only=" << s.eventsCountedOnly << '\n';
+        } else {
+            out << key << "frames=" << s.frames << '\n';
+            out << key << "dropped=" << s.droppedFrames << '\n';
+            out << key << "fps_min=" << fixed(s.fpsMin, 2) << '\n';
+            out << key << "fps_avg=" << fixed(s.fpsAvg, 2) << '\n';
+            out << key << "fps_max=" << fixed(s.fpsMax, 2) << '\n';
+        }
+        out << key << "gaps=" << s.gaps << '\n';
+        out << key << "max_gap_ms=" << fixed(s.maxGapMs, 1) << '\n';
+        out << key << "bytes=" << s.bytes << '\n';
+    }
+    return out.str();
+}
+
+bool RecordingSummary::save(const std::filesystem::path& directory) const {
+    // Same write-fsync-rename as SessionManifest::save: never a truncated summary after a crash
+    const std::string data = format();
+    const auto target = directory / FILE_NAME;
+    const auto temp = directory / (std::string(FILE_NAME) + ".tmp");
+
+    const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        EBV_LOG_ERROR << "Failed to write recording summary in " << directory;
+        return false;
+    }
+    size_t written = 0;
+    while (written < data.size()) {
+        const ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n <= 0) {
+            ::close(fd);
+            std::remove(temp.c_str());
+            EBV_LOG_ERROR << "Failed to write recording summary in " << directory;
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    const bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    if (!synced || std::rename(temp.c_str(), target.c_str()) != 0) {
+        std::remove(temp.c_str());
+        EBV_LOG_ERROR << "Failed to write recording summary in " << directory;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,91 @@
+#include "session_manifest.h"
+#include "logger.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+std::string SessionManifest::get(const std::string& key, const std::string& fallback) const {
+    const auto it = m_entries.find(key);
+    return it == m_entries.end() ? fallback : it->second;
+}
+
+std::vector<std::string> SessionManifest::keysWithPrefix(const std::string& prefix) const {
+    std::vector<std::string> keys;
+    for (auto it = m_entries.lower_bound(prefix); it != m_entries.end(); ++it) {
+        if (it->first.compare(0, prefix.size(), prefix) != 0) break;
+        keys.push_back(it->first);
+    }
+    return keys;
+}
+
+std::filesystem::path SessionManifest::streamDirectory(const std::string& stream,
+                                                       const std::filesystem::path& takeDirectory) const {
+    const auto it = m_entries.find(streamKey(stream));
+    if (it == m_entries.end() || it->second.empty()) return takeDirectory;
+    return it->second;
+}
+
+bool SessionManifest::exists(const std::filesystem::path& directory) {
+    std::error_code ec;
+    return std::filesystem::exists(directory / FILE_NAME, ec);
+}
+
+bool SessionManifest::save(const std::filesystem::path& directory) const {
+    std::ostringstream content;
+    content << "# ebv_frame_recording session manifest\n";
+    for (const auto& [key, value] : m_entries) {
+        content << key << '=' << value << '\n';
+    }
+    const std::string data = content.str();
+
+    const auto target = directory / FILE_NAME;
+    const auto temp = directory / (std::string(FILE_NAME) + ".tmp");
+
+    const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        EBV_LOG_ERROR << "Failed to write session manifest in " << directory;
+        return false;
+    }
+    size_t written = 0;
+    while (written < data.size()) {
+        const ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n <= 0) {
+            ::close(fd);
+            std::remove(temp.c_str());
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    const bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    if (!synced || std::rename(temp.c_str(), target.c_str()) != 0) {
+        std::remove(temp.c_str());
+        return false;
+    }
+
+    // Persist the rename itself
+    const int dirFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+}
+
+bool SessionManifest::load(const std::filesystem::path& directory) {
+    std::ifstream in(directory / FILE_NAME);
+    if (!in) return false;
+
+    m_entries.clear();
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        const auto eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        m_entries[line.substr(0, eq)] = line.substr(eq + 1);
+    }
+    return true;
+}
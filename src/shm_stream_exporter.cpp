@@ -0,0 +1,158 @@
+#include "shm_stream_exporter.h"
+#include "logger.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ebv_shm;
+
+ShmStreamExporter::ShmStreamExporter(Options options) : m_options(std::move(options)) {
+    if (m_options.slotCount == 0) m_options.slotCount = 1;
+    if (m_options.slotBytes < kSlotHeaderBytes * 2) m_options.slotBytes = kSlotHeaderBytes * 2;
+    // Keep every slot 64-byte aligned
+    m_options.slotBytes = (m_options.slotBytes + 63) & ~static_cast<size_t>(63);
+    if (m_options.name.empty() || m_options.name[0] != '/') {
+        m_options.name = "/" + m_options.name;
+    }
+}
+
+ShmStreamExporter::~ShmStreamExporter() {
+    close();
+}
+
+bool ShmStreamExporter::open() {
+    if (isOpen()) return true;
+
+    // Replace stale segments left behind by a crashed recorder, never a live one
+    if (ownerAlive(m_options.name)) {
+        EBV_LOG_ERROR << "Live export: " << m_options.name << " is in use by another running recorder";
+        return false;
+    }
+    ::shm_unlink(m_options.name.c_str());
+    m_fd = ::shm_open(m_options.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (m_fd < 0) {
+        EBV_LOG_ERROR << "Live export: shm_open(" << m_options.name << ") failed: " << std::strerror(errno);
+        return false;
+    }
+
+    m_mappedBytes = kRingHeaderBytes + static_cast<size_t>(m_options.slotCount) * m_options.slotBytes;
+    if (::ftruncate(m_fd, static_cast<off_t>(m_mappedBytes)) != 0) {
+        EBV_LOG_ERROR << "Live export: ftruncate failed: " << std::strerror(errno);
+        close();
+        return false;
+    }
+
+    void* base = ::mmap(nullptr, m_mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (base == MAP_FAILED) {
+        EBV_LOG_ERROR << "Live export: mmap failed: " << std::strerror(errno);
+        close();
+        return false;
+    }
+    m_base = base;
+
+    auto* header = new (m_base) RingHeader{};
+    header->slotCount = m_options.slotCount;
+    header->headerBytes = kRingHeaderBytes;
+    header->slotBytes = m_options.slotBytes;
+    header->writeSequence.store(0, std::memory_order_relaxed);
+    header->writerPid = static_cast<uint64_t>(::getpid());
+    for (uint32_t i = 0; i < m_options.slotCount; ++i) {
+        auto* slot = reinterpret_cast<SlotHeader*>(static_cast<uint8_t*>(m_base) + kRingHeaderBytes + i * m_options.slotBytes);
+        new (slot) SlotHeader{};
+        slot->sequence.store(0, std::memory_order_relaxed);
+    }
+    header->version = kRingVersion;
+    // Magic last: readers treat the segment as valid only once it is fully initialized
+    header->magic.store(kRingMagic, std::memory_order_release);
+
+    m_nextSequence = 1;
+    EBV_LOG_INFO << "Live export: publishing to shared memory " << m_options.name << " ("
+              << m_options.slotCount << " slots x " << (m_options.slotBytes >> 10) << " KiB)";
+    return true;
+}
+
+bool ShmStreamExporter::ownerAlive(const std::string& name) {
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat st{};
+    void* base = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= kRingHeaderBytes) {
+        base = ::mmap(nullptr, kRingHeaderBytes, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+
+    const auto* header = static_cast<const RingHeader*>(base);
+    // Without the magic the writer never finished initializing (or it is not our segment)
+    const bool initialized = header->magic.load(std::memory_order_acquire) == kRingMagic;
+    const auto pid = static_cast<pid_t>(header->writerPid);
+    ::munmap(base, kRingHeaderBytes);
+    if (!initialized || pid <= 0) return false;
+    return ::kill(pid, 0) == 0 || errno == EPERM;
+}
+
+void ShmStreamExporter::close() {
+    if (m_base) {
+        ::munmap(m_base, m_mappedBytes);
+        m_base = nullptr;
+        m_mappedBytes = 0;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+        ::shm_unlink(m_options.name.c_str());
+    }
+}
+
+bool ShmStreamExporter::publishFrame(int cameraId, uint64_t index, int64_t timestampUs,
+                                     uint32_t width, uint32_t height, int32_t pixelType,
+                                     const void* data, size_t bytes) {
+    return publish(RecordType::Frame, cameraId, index, timestampUs, width, height, pixelType, 0, data, bytes);
+}
+
+bool ShmStreamExporter::publishEvents(int cameraId, uint64_t index, int64_t firstTimestampUs,
+                                      const void* events, uint32_t eventCount, size_t bytes) {
+    return publish(RecordType::EventChunk, cameraId, index, firstTimestampUs, 0, 0, 0, eventCount, events, bytes);
+}
+
+bool ShmStreamExporter::publish(RecordType type, int cameraId, uint64_t index, int64_t timestampUs,
+                                uint32_t width, uint32_t height, int32_t pixelType, uint32_t eventCount,
+                                const void* payload, size_t bytes) {
+    if (!m_base || bytes > maxPayloadBytes()) {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    auto* header = static_cast<RingHeader*>(m_base);
+    const uint64_t sequence = m_nextSequence++;
+    const size_t slotIndex = static_cast<size_t>((sequence - 1) % m_options.slotCount);
+    auto* slotBase = static_cast<uint8_t*>(m_base) + kRingHeaderBytes + slotIndex * m_options.slotBytes;
+    auto* slot = reinterpret_cast<SlotHeader*>(slotBase);
+
+    // Seqlock write: invalidate, fill, publish
+    slot->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->type = static_cast<uint32_t>(type);
+    slot->cameraId = cameraId;
+    slot->index = index;
+    slot->timestampUs = timestampUs;
+    slot->width = width;
+    slot->height = height;
+    slot->pixelType = pixelType;
+    slot->eventCount = eventCount;
+    slot->payloadBytes = bytes;
+    if (bytes > 0) {
+        std::memcpy(slotBase + kSlotHeaderBytes, payload, bytes);
+    }
+    slot->sequence.store(sequence, std::memory_order_release);
+    header->writeSequence.store(sequence, std::memory_order_release);
+
+    m_published.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
@@ -0,0 +1,142 @@
+#include "shm_stream_reader.h"
+
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ebv_shm;
+
+ShmStreamReader::~ShmStreamReader() {
+    close();
+}
+
+bool ShmStreamReader::open(const std::string& name, bool fromOldest) {
+    close();
+    const std::string shmName = (!name.empty() && name[0] == '/') ? name : "/" + name;
+
+    m_fd = ::shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (m_fd < 0) return false;
+
+    struct stat st{};
+    if (::fstat(m_fd, &st) != 0 || static_cast<size_t>(st.st_size) < kRingHeaderBytes) {
+        close();
+        return false;
+    }
+    m_mappedBytes = static_cast<size_t>(st.st_size);
+    void* base = ::mmap(nullptr, m_mappedBytes, PROT_READ, MAP_SHARED, m_fd, 0);
+    if (base == MAP_FAILED) {
+        close();
+        return false;
+    }
+    m_base = static_cast<const uint8_t*>(base);
+
+    const auto* header = reinterpret_cast<const RingHeader*>(m_base);
+    // Acquire pairs with the writer's release store: the fields below are initialized
+    if (header->magic.load(std::memory_order_acquire) != kRingMagic || header->version != kRingVersion || header->slotCount == 0 ||
+        kRingHeaderBytes + header->slotCount * header->slotBytes > m_mappedBytes) {
+        close();
+        return false;
+    }
+    m_slotCount = header->slotCount;
+    m_slotBytes = header->slotBytes;
+
+    const uint64_t written = header->writeSequence.load(std::memory_order_acquire);
+    if (fromOldest) {
+        m_nextSequence = written > m_slotCount ? written - m_slotCount + 1 : 1;
+    } else {
+        m_nextSequence = written + 1;
+    }
+    m_lost = 0;
+    m_read = 0;
+    return true;
+}
+
+void ShmStreamReader::close() {
+    if (m_base) {
+        ::munmap(const_cast<uint8_t*>(m_base), m_mappedBytes);
+        m_base = nullptr;
+        m_mappedBytes = 0;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+const SlotHeader* ShmStreamReader::slotFor(uint64_t sequence) const {
+    const size_t slotIndex = static_cast<size_t>((sequence - 1) % m_slotCount);
+    return reinterpret_cast<const SlotHeader*>(m_base + kRingHeaderBytes + slotIndex * m_slotBytes);
+}
+
+bool ShmStreamReader::tryNext(Record& record) {
+    if (!m_base) return false;
+    const auto* header = reinterpret_cast<const RingHeader*>(m_base);
+
+    while (true) {
+        const uint64_t written = header->writeSequence.load(std::memory_order_acquire);
+        if (written < m_nextSequence) return false;
+
+        // Fell behind by more than the ring: skip to the oldest record still present
+        if (written - m_nextSequence >= m_slotCount) {
+            const uint64_t oldest = written - m_slotCount + 1;
+            m_lost += oldest - m_nextSequence;
+            m_nextSequence = oldest;
+        }
+
+        const SlotHeader* slot = slotFor(m_nextSequence);
+        const uint64_t before = slot->sequence.load(std::memory_order_acquire);
+        if (before != m_nextSequence) {
+            // Overwritten (or being rewritten) before we got to it
+            ++m_lost;
+            ++m_nextSequence;
+            continue;
+        }
+
+        record.sequence = before;
+        record.type = static_cast<RecordType>(slot->type);
+        record.cameraId = slot->cameraId;
+        record.index = slot->index;
+        record.timestampUs = slot->timestampUs;
+        record.width = slot->width;
+        record.height = slot->height;
+        record.pixelType = slot->pixelType;
+        record.eventCount = slot->eventCount;
+        record.payloadBytes = static_cast<size_t>(slot->payloadBytes);
+        record.payload = reinterpret_cast<const uint8_t*>(slot) + kSlotHeaderBytes;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) != before ||
+            record.payloadBytes > m_slotBytes - kSlotHeaderBytes) {
+            ++m_lost;
+            ++m_nextSequence;
+            continue;
+        }
+
+        ++m_nextSequence;
+        ++m_read;
+        return true;
+    }
+}
+
+bool ShmStreamReader::next(Record& record, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    int spins = 0;
+    while (!tryNext(record)) {
+        if (std::chrono::steady_clock::now() >= deadline) return false;
+        // Spin briefly for low latency, then back off to avoid burning a core
+        if (++spins < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    return true;
+}
+
+bool ShmStreamReader::stillValid(const Record& record) const {
+    if (!m_base || record.sequence == 0) return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slotFor(record.sequence)->sequence.load(std::memory_order_relaxed) == record.sequence;
+}
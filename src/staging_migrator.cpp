@@ -0,0 +1,165 @@
+#include "staging_migrator.h"
+#include "session_manifest.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+// Makes the directory's entries (renames, new files) durable
+bool syncDirectory(const fs::path& directory) {
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    const bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+} // namespace
+
+StagingMigrator::StagingMigrator(uint64_t bytesPerSecond)
+    : m_bytesPerSecond(bytesPerSecond),
+      m_jobs("staged take(s) to be migrated",
+             [this](const Job& job, std::string& message) { return migrate(job, message); },
+             [](const Job& job, bool ok, const std::string& message) {
+                 if (ok) {
+                     EBV_LOG_INFO << "Migrated " << job.stagingDir << " -> " << job.finalDir << ": " << message;
+                 } else {
+                     EBV_LOG_ERROR << "Migration failed for " << job.stagingDir << " -> " << job.finalDir << ": " << message;
+                 }
+             }) {}
+
+bool StagingMigrator::migrate(const Job& job, std::string& message) {
+    const auto start = std::chrono::steady_clock::now();
+    fs::create_directories(job.finalDir);
+
+    SessionManifest manifest;
+    manifest.load(job.stagingDir);
+    manifest.set(SessionManifest::KEY_STATE, "migrating");
+    manifest.set(SessionManifest::KEY_FINAL_DIR, fs::absolute(job.finalDir).string());
+    manifest.save(job.finalDir);
+
+    // Collect regular files (largest first keeps the disk streaming)
+    std::vector<std::pair<fs::path, uintmax_t>> files;
+    for (const auto& entry : fs::recursive_directory_iterator(job.stagingDir)) {
+        if (!entry.is_regular_file()) continue;
+        if (entry.path().filename() == SessionManifest::FILE_NAME) continue;
+        files.emplace_back(fs::relative(entry.path(), job.stagingDir), entry.file_size());
+    }
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+
+    // Any failure leaves the staging copy in place and marks the destination as failed
+    auto fail = [&](const std::string& reason) {
+        manifest.set(SessionManifest::KEY_STATE, "failed");
+        manifest.save(job.finalDir);
+        message = reason;
+        return false;
+    };
+
+    std::vector<char> buffer(COPY_BLOCK_SIZE);
+    m_throttleStart = std::chrono::steady_clock::now();
+    m_throttleBytes = 0;
+    uint64_t totalBytes = 0;
+    for (const auto& [relative, size] : files) {
+        const auto destination = job.finalDir / relative;
+        const std::string partial = destination.string() + ".partial";
+        fs::create_directories(destination.parent_path());
+        if (!copyFile(job.stagingDir / relative, partial, buffer)) {
+            return fail("copy failed for " + relative.string());
+        }
+        std::error_code ec;
+        const auto copied = fs::file_size(partial, ec);
+        if (ec || copied != size) {
+            return fail("size mismatch for " + relative.string() + " (" + std::to_string(ec ? 0 : copied) +
+                        " of " + std::to_string(size) + " bytes)");
+        }
+        totalBytes += size;
+    }
+
+    // One filesystem-wide flush per take instead of an fsync per (small) file
+    const int dirFd = ::open(job.finalDir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd < 0 || ::syncfs(dirFd) != 0) {
+        const std::string error = std::strerror(errno);
+        if (dirFd >= 0) ::close(dirFd);
+        return fail("flushing " + job.finalDir.string() + " failed: " + error);
+    }
+    ::close(dirFd);
+    for (const auto& [relative, size] : files) {
+        const auto destination = job.finalDir / relative;
+        std::error_code ec;
+        fs::rename(destination.string() + ".partial", destination, ec);
+        if (ec) return fail("rename failed for " + relative.string() + ": " + ec.message());
+        manifest.set("file." + relative.generic_string(), std::to_string(size));
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    manifest.set(SessionManifest::KEY_STATE, "complete");
+    manifest.set(SessionManifest::KEY_CAPTURE_DIR, fs::absolute(job.finalDir).string());
+    manifest.set("migration.bytes", std::to_string(totalBytes));
+    manifest.set("migration.seconds", std::to_string(seconds));
+    if (!manifest.save(job.finalDir)) {
+        return fail("could not write manifest");
+    }
+
+    // The renames and the manifest only survive a crash once their directories are synced
+    bool synced = syncDirectory(job.finalDir);
+    for (const auto& entry : fs::recursive_directory_iterator(job.finalDir)) {
+        if (entry.is_directory()) synced = syncDirectory(entry.path()) && synced;
+    }
+    if (!synced) {
+        return fail("syncing the directories of " + job.finalDir.string() + " failed");
+    }
+
+    fs::remove_all(job.stagingDir);
+    message = std::to_string(files.size()) + " files, " + std::to_string(totalBytes >> 20) + " MiB in " +
+              std::to_string(seconds) + " s";
+    return true;
+}
+
+bool StagingMigrator::copyFile(const fs::path& source, const fs::path& destination, std::vector<char>& buffer) {
+    const int in = ::open(source.c_str(), O_RDONLY);
+    if (in < 0) return false;
+    const int out = ::open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        ::close(in);
+        return false;
+    }
+    ::posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    bool ok = true;
+    while (true) {
+        const ssize_t n = ::read(in, buffer.data(), buffer.size());
+        if (n < 0) { ok = false; break; }
+        if (n == 0) break;
+        ssize_t written = 0;
+        while (written < n) {
+            const ssize_t w = ::write(out, buffer.data() + written, static_cast<size_t>(n - written));
+            if (w <= 0) { ok = false; break; }
+            written += w;
+        }
+        if (!ok) break;
+        m_bytesMigrated += static_cast<uint64_t>(n);
+        throttle(static_cast<size_t>(n));
+    }
+
+    // Staged data will not be read again; let the page cache drop it
+    ::posix_fadvise(in, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(in);
+    if (::close(out) != 0) ok = false;
+    return ok;
+}
+
+void StagingMigrator::throttle(size_t bytes) {
+    const uint64_t rate = m_bytesPerSecond.load();
+    if (rate == 0) return;
+    m_throttleBytes += bytes;
+    const auto due = m_throttleStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(m_throttleBytes) / static_cast<double>(rate)));
+    const auto now = std::chrono::steady_clock::now();
+    if (due > now) std::this_thread::sleep_until(due);
+}
@@ -0,0 +1,114 @@
+#include "stall_watchdog.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+StallWatchdog::Clock::time_point fromNs(int64_t ns) {
+    return StallWatchdog::Clock::time_point(std::chrono::duration_cast<StallWatchdog::Clock::duration>(std::chrono::nanoseconds(ns)));
+}
+} // namespace
+
+StallWatchdog::StallWatchdog(std::chrono::milliseconds checkInterval) : m_checkInterval(checkInterval) {}
+
+StallWatchdog::~StallWatchdog() {
+    stop();
+}
+
+StallWatchdog::HeartbeatPtr StallWatchdog::registerStage(const std::string& stage, std::chrono::milliseconds threshold) {
+    auto heartbeat = std::make_shared<Heartbeat>(stage, threshold);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_watched.push_back({stage, heartbeat, 0, {}, {}});
+    return heartbeat;
+}
+
+void StallWatchdog::setStallCallback(StallCallback callback) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_callback = std::move(callback);
+}
+
+void StallWatchdog::start() {
+    std::lock_guard<std::mutex> lock(m_threadMutex);
+    if (m_running) return;
+    m_running = true;
+    m_thread = std::thread(&StallWatchdog::watchLoop, this);
+}
+
+void StallWatchdog::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_threadMutex);
+        if (!m_running) return;
+        m_running = false;
+    }
+    m_threadCv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void StallWatchdog::watchLoop() {
+    std::unique_lock<std::mutex> lock(m_threadMutex);
+    while (m_running) {
+        lock.unlock();
+        check();
+        lock.lock();
+        m_threadCv.wait_for(lock, m_checkInterval, [this] { return !m_running; });
+    }
+}
+
+void StallWatchdog::check(Clock::time_point now) {
+    std::vector<StallEvent> events;
+    StallCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_watched.begin(); it != m_watched.end();) {
+            const auto heartbeat = it->heartbeat.lock();
+            const int64_t busySince = heartbeat ? heartbeat->m_busySince.load(std::memory_order_acquire) : 0;
+
+            // A reported call has returned (or its worker is gone): report the final duration
+            if (it->reportedBusySince != 0 && busySince != it->reportedBusySince) {
+                const auto started = fromNs(it->reportedBusySince);
+                const int64_t lastEnd = heartbeat ? heartbeat->m_lastEnd.load(std::memory_order_relaxed) : 0;
+                const auto ended = lastEnd >= it->reportedBusySince ? fromNs(lastEnd) : now;
+                StallEvent event{it->stage, it->operation, it->detail, started,
+                                 std::chrono::duration_cast<std::chrono::milliseconds>(ended - started), false};
+                m_history.push_back(event);
+                if (m_history.size() > MAX_HISTORY) m_history.erase(m_history.begin());
+                events.push_back(std::move(event));
+                it->reportedBusySince = 0;
+            }
+            if (!heartbeat) {
+                it = m_watched.erase(it);
+                continue;
+            }
+
+            if (busySince != 0 && it->reportedBusySince == 0) {
+                const auto started = fromNs(busySince);
+                if (now - started > heartbeat->threshold()) {
+                    const char* operation = heartbeat->m_operation.load(std::memory_order_relaxed);
+                    it->reportedBusySince = busySince;
+                    it->operation = operation ? operation : "";
+                    it->detail = heartbeat->detail();
+                    ++m_stallCount;
+                    events.push_back({it->stage, it->operation, it->detail, started,
+                                      std::chrono::duration_cast<std::chrono::milliseconds>(now - started), true});
+                }
+            }
+            ++it;
+        }
+        callback = m_callback;
+    }
+    if (!callback) return;
+    for (const auto& event : events) callback(event);
+}
+
+std::vector<StallWatchdog::StallEvent> StallWatchdog::stallsSince(Clock::time_point since) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<StallEvent> result;
+    std::copy_if(m_history.begin(), m_history.end(), std::back_inserter(result),
+                 [since](const StallEvent& event) { return event.started >= since; });
+    return result;
+}
+
+size_t StallWatchdog::stallCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stallCount;
+}
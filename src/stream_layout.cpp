@@ -0,0 +1,55 @@
+#include "stream_layout.h"
+
+#include <algorithm>
+
+std::vector<std::string> StreamLayout::streamNames(size_t frameCameras, size_t eventCameras) {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < std::max(frameCameras, eventCameras); ++i) {
+        if (i < frameCameras) names.push_back(frameStreamName(i));
+        if (i < eventCameras) names.push_back(eventStreamName(i));
+    }
+    return names;
+}
+
+std::map<std::string, std::filesystem::path> StreamLayout::assign(
+    const std::vector<std::string>& streams,
+    const std::filesystem::path& takeDirectory,
+    const std::vector<std::string>& roots,
+    const std::map<std::string, std::string>& streamRoots) {
+    auto takeName = takeDirectory.lexically_normal().filename();
+    if (takeName.empty()) takeName = takeDirectory.lexically_normal().parent_path().filename(); // trailing '/'
+
+    std::map<std::string, std::filesystem::path> layout;
+    size_t next = 0;
+    for (const auto& stream : streams) {
+        const auto it = streamRoots.find(stream);
+        if (it != streamRoots.end() && !it->second.empty()) {
+            layout[stream] = std::filesystem::path(it->second) / takeName;
+        } else if (!roots.empty()) {
+            layout[stream] = std::filesystem::path(roots[next++ % roots.size()]) / takeName;
+        } else {
+            layout[stream] = takeDirectory;
+        }
+    }
+    return layout;
+}
+
+namespace {
+std::vector<std::string> directoriesFor(const std::map<std::string, std::filesystem::path>& layout, size_t cameras,
+                                        std::string (*name)(size_t)) {
+    std::vector<std::string> dirs(cameras);
+    for (size_t i = 0; i < cameras; ++i) {
+        const auto it = layout.find(name(i));
+        if (it != layout.end()) dirs[i] = it->second.string();
+    }
+    return dirs;
+}
+} // namespace
+
+std::vector<std::string> StreamLayout::frameDirectories(const std::map<std::string, std::filesystem::path>& layout, size_t cameras) {
+    return directoriesFor(layout, cameras, &StreamLayout::frameStreamName);
+}
+
+std::vector<std::string> StreamLayout::eventDirectories(const std::map<std::string, std::filesystem::path>& layout, size_t cameras) {
+    return directoriesFor(layout, cameras, &StreamLayout::eventStreamName);
+}
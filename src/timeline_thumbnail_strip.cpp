@@ -0,0 +1,174 @@
+#include "timeline_thumbnail_strip.h"
+#include "recording_loader.h"
+#include "utils_qt.h"
+#include "logger.h"
+
+#include <QMetaObject>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+constexpr size_t FIRST_PASS_STRIDE = 8;
+constexpr int WORKER_NICE = 10;
+const char *ROW_PREFIX[] = {"frame", "event"};
+} // namespace
+
+TimelineThumbnailStrip::TimelineThumbnailStrip(QWidget *parent) : QWidget(parent) {
+    setFixedHeight(ROW_HEIGHT * RowCount);
+    setCursor(Qt::PointingHandCursor);
+}
+
+TimelineThumbnailStrip::~TimelineThumbnailStrip() {
+    clear();
+}
+
+std::vector<size_t> TimelineThumbnailStrip::progressiveOrder(size_t slotCount) {
+    std::vector<size_t> order;
+    order.reserve(slotCount);
+    for (size_t slot = 0; slot < slotCount; slot += FIRST_PASS_STRIDE) order.push_back(slot);
+    for (size_t stride = FIRST_PASS_STRIDE / 2; stride >= 1; stride /= 2) {
+        // Odd multiples of the stride: exactly the slots between the previous pass
+        for (size_t slot = stride; slot < slotCount; slot += 2 * stride) order.push_back(slot);
+    }
+    return order;
+}
+
+void TimelineThumbnailStrip::setRecording(RecordingLoader *loader, const QString &recordingDir, size_t totalFrames) {
+    clear();
+    if (!loader || totalFrames == 0) return;
+
+    m_loader = loader;
+    m_totalFrames = totalFrames;
+    m_slotCount = std::max<size_t>(1, std::min<size_t>(totalFrames, static_cast<size_t>(width() / THUMB_WIDTH)));
+    for (auto &row : m_thumbnails) row = QVector<QImage>(static_cast<int>(m_slotCount));
+    m_cacheDir = cacheDirectoryFor(recordingDir);
+
+    m_cancel = false;
+    const unsigned generation = m_generation.load();
+    for (int row = 0; row < RowCount; ++row) {
+        m_workers.emplace_back(&TimelineThumbnailStrip::workerMain, this, static_cast<Row>(row), generation);
+    }
+    update();
+}
+
+void TimelineThumbnailStrip::clear() {
+    m_cancel = true;
+    ++m_generation;
+    for (auto &worker : m_workers) {
+        if (worker.joinable()) worker.join();
+    }
+    m_workers.clear();
+    m_loader = nullptr;
+    m_totalFrames = 0;
+    m_slotCount = 0;
+    for (auto &row : m_thumbnails) row.clear();
+    update();
+}
+
+void TimelineThumbnailStrip::setCurrentFrame(size_t frameIndex) {
+    m_currentFrame = frameIndex;
+    update();
+}
+
+size_t TimelineThumbnailStrip::frameForSlot(size_t slot) const {
+    // Middle of the slot's time span
+    return std::min(m_totalFrames - 1, (2 * slot + 1) * m_totalFrames / (2 * m_slotCount));
+}
+
+std::filesystem::path TimelineThumbnailStrip::cacheDirectoryFor(const QString &recordingDir) const {
+    namespace fs = std::filesystem;
+    const auto renderCache = EventFrameDiskCache::defaultCacheDirectory();
+    if (renderCache.empty()) return {};
+    // Directory path + modification time, so a re-recorded or migrated take gets new thumbnails
+    std::error_code ec;
+    const fs::path dir = fs::absolute(recordingDir.toStdString(), ec);
+    const auto mtime = fs::last_write_time(dir, ec).time_since_epoch().count();
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0')
+         << std::hash<std::string>{}(dir.string() + "|" + std::to_string(mtime));
+    const fs::path cacheDir = renderCache / "thumbnails" / name.str();
+    fs::create_directories(cacheDir, ec);
+    return ec ? fs::path{} : cacheDir;
+}
+
+QImage TimelineThumbnailStrip::renderThumbnail(Row row, size_t frameIndex) const {
+    if (row == FrameRow) {
+        const cv::Mat reduced = m_loader->getFrameCameraThumbnail(0, frameIndex);
+        if (reduced.empty()) return {};
+        const QImage image = cvMatToQImage(reduced);
+        return image.width() > THUMB_WIDTH ? image.scaledToWidth(THUMB_WIDTH, Qt::SmoothTransformation) : image;
+    }
+    return m_loader->getEventCameraThumbnail(0, frameIndex, THUMB_WIDTH);
+}
+
+void TimelineThumbnailStrip::workerMain(Row row, unsigned generation) {
+    // Low priority: playback and prefetching come first
+    ::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), WORKER_NICE);
+    for (size_t slot : progressiveOrder(m_slotCount)) {
+        if (m_cancel) return;
+        const size_t frameIndex = frameForSlot(slot);
+
+        QImage thumbnail;
+        QString cacheFile;
+        if (!m_cacheDir.empty()) {
+            const auto file = m_cacheDir / (std::string(ROW_PREFIX[row]) + "_" + std::to_string(frameIndex) + ".jpg");
+            cacheFile = QString::fromStdString(file.string());
+            thumbnail.load(cacheFile);
+        }
+        if (thumbnail.isNull()) {
+            try {
+                thumbnail = renderThumbnail(row, frameIndex);
+            } catch (const std::exception &e) {
+                EBV_LOG_WARN << "Thumbnail generation failed for frame " << frameIndex << ": " << e.what();
+            }
+            if (thumbnail.isNull()) continue;
+            if (!cacheFile.isEmpty()) thumbnail.save(cacheFile, "JPG", 85);
+        }
+        if (m_cancel) return;
+
+        QMetaObject::invokeMethod(this, [this, row, slot, generation, thumbnail]() {
+            if (generation != m_generation.load() || static_cast<int>(slot) >= m_thumbnails[row].size()) return;
+            m_thumbnails[row][static_cast<int>(slot)] = thumbnail;
+            update();
+        }, Qt::QueuedConnection);
+    }
+}
+
+void TimelineThumbnailStrip::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(40, 40, 40));
+    if (m_slotCount == 0) return;
+
+    const double slotWidth = static_cast<double>(width()) / static_cast<double>(m_slotCount);
+    for (int row = 0; row < RowCount; ++row) {
+        for (int slot = 0; slot < m_thumbnails[row].size(); ++slot) {
+            const QImage &image = m_thumbnails[row][slot];
+            if (image.isNull()) continue;
+            const QRectF target(slot * slotWidth, row * ROW_HEIGHT, slotWidth - 1.0, ROW_HEIGHT - 1.0);
+            painter.drawImage(target, image);
+        }
+    }
+
+    // Playback position
+    if (m_totalFrames > 1) {
+        const int x = static_cast<int>(static_cast<double>(m_currentFrame) / static_cast<double>(m_totalFrames - 1) * (width() - 1));
+        painter.setPen(QPen(QColor(255, 80, 80), 2));
+        painter.drawLine(x, 0, x, height());
+    }
+}
+
+void TimelineThumbnailStrip::mousePressEvent(QMouseEvent *event) {
+    if (m_totalFrames == 0 || width() <= 0) return;
+    const double fraction = std::clamp(event->position().x() / width(), 0.0, 1.0);
+    emit frameRequested(static_cast<int>(fraction * static_cast<double>(m_totalFrames - 1) + 0.5));
+}
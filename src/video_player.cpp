@@ -1,18 +1,47 @@
 #include <QApplication>
 #include <QCommandLineParser>
 #include "player_window.h"
+#include "profiled_mutex.h"
 
 int main(int argc, char *argv[]) {
+    LockProfiling::installExitReport();
     QApplication app(argc, argv);
 
     QCommandLineParser parser;
     parser.setApplicationDescription("EBV Multi-Camera Player Mockup");
     parser.addHelpOption();
     parser.addPositionalArgument("recording_dir", "Optional path to a recording directory to load on startup.");
+    const QCommandLineOption preloadOption("preload", "Load whole recordings into RAM before playback.");
+    const QCommandLineOption preloadLimitOption("preload-limit-gb",
+        "Memory ceiling for --preload in GB (default: half of the physical memory); streams beyond it play from disk.", "gb");
+    const QCommandLineOption hugePagesOption("huge-pages", "Back preloaded data with transparent huge pages.");
+    parser.addOption(preloadOption);
+    parser.addOption(preloadLimitOption);
+    parser.addOption(hugePagesOption);
+    const QCommandLineOption rectificationOption("rectification",
+        "Calibration file (rectification.yml format) for rectified live views.", "file");
+    parser.addOption(rectificationOption);
     parser.process(app);
     const QString recordingDir = parser.positionalArguments().isEmpty() ? QString() : parser.positionalArguments().first();
 
+    PreloadOptions preload;
+    preload.enabled = parser.isSet(preloadOption);
+    preload.hugePages = parser.isSet(hugePagesOption);
+    if (parser.isSet(preloadLimitOption)) {
+        bool ok = false;
+        const double gigabytes = parser.value(preloadLimitOption).toDouble(&ok);
+        if (!ok || gigabytes <= 0.0) {
+            qCritical("--preload-limit-gb expects a positive number");
+            return 1;
+        }
+        preload.memoryCeilingBytes = static_cast<uint64_t>(gigabytes * 1024.0 * 1024.0 * 1024.0);
+    }
+
     PlayerWindow w;
+    w.setPreloadOptions(preload);
+    if (parser.isSet(rectificationOption)) {
+        w.setRectificationFile(parser.value(rectificationOption));
+    }
     w.show();
     w.autoLoadIfProvided(recordingDir);
     return app.exec();
@@ -15,15 +15,25 @@ public:
     MOCK_METHOD(void, stopPreview, (), (override));
     MOCK_METHOD(void, startRecordingToPath, (const std::string&), (override));
     MOCK_METHOD(void, stopRecordingOnly, (), (override));
+    MOCK_METHOD(void, switchRecordingPath, (const std::string&), (override));
+    MOCK_METHOD(void, setLiveDataBus, (LiveDataBus* bus), (override));
+    MOCK_METHOD(size_t, deviceCount, (), (const, override));
+    MOCK_METHOD(void, setStreamDirectories, (const std::vector<std::string>& directories), (override));
 };
 
 class MockEventCameraManager : public RecordingManager::IEventCameraManager {
 public:
     MOCK_METHOD(void, openAndSetupDevices, (const std::vector<CameraConfig>& cameraConfigs), (override));
+    MOCK_METHOD(void, applyBiases, (const std::vector<CameraConfig>& cameraConfigs), (override));
     MOCK_METHOD(void, startRecording, (const std::string& outputPath, const std::string& fileFormat), (override));
     MOCK_METHOD(void, stopRecording, (), (override));
+    MOCK_METHOD(void, switchRecording, (const std::string& outputPath, const std::string& fileFormat), (override));
     MOCK_METHOD(void, closeDevices, (), (override));
     MOCK_METHOD(bool, startLiveStreaming, (), (override));
     MOCK_METHOD(void, stopLiveStreaming, (), (override));
     MOCK_METHOD(bool, getLatestEventFrame, (int cameraId, cv::Mat& eventFrame, size_t& frameIndex), (override));
+    MOCK_METHOD(void, setLiveDataBus, (LiveDataBus* bus), (override));
+    MOCK_METHOD(size_t, deviceCount, (), (const, override));
+    MOCK_METHOD(void, setStreamDirectories, (const std::vector<std::string>& directories), (override));
+    MOCK_METHOD(void, setHdf5Settings, (const EventCameraManager::Hdf5Settings& settings), (override));
 };
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "control_socket.h"
+
+#include <cstring>
+#include <filesystem>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+std::string socketPath(const char* tag) {
+    return (std::filesystem::temp_directory_path() / ("ebv_ctl_" + std::string(tag) + "_" + std::to_string(::getpid()) + ".sock")).string();
+}
+} // namespace
+
+TEST(ControlProtocol, RoundTripsRequestsAndResponses) {
+    ControlProtocol::Request request{"start", {{"prefix", "take 1=a%b"}, {"dir", "/tmp/x"}}};
+    const auto line = ControlProtocol::formatRequest(request);
+    EXPECT_EQ(line, "start dir=/tmp/x prefix=take%201%3Da%25b\n");
+    const auto parsed = ControlProtocol::parseRequest(line);
+    EXPECT_EQ(parsed.command, "start");
+    EXPECT_EQ(parsed.args, request.args);
+
+    EXPECT_THROW(ControlProtocol::parseRequest("   \n"), std::runtime_error);
+    EXPECT_THROW(ControlProtocol::parseRequest("start prefix"), std::runtime_error);
+
+    const auto ok = ControlProtocol::parseResponse(ControlProtocol::formatResponse(ControlProtocol::okResponse({{"dir", "a b"}})));
+    EXPECT_TRUE(ok.ok);
+    EXPECT_EQ(ok.fields.at("dir"), "a b");
+    const auto error = ControlProtocol::parseResponse(ControlProtocol::formatResponse(ControlProtocol::errorResponse("no\ncameras")));
+    EXPECT_FALSE(error.ok);
+    EXPECT_EQ(error.error, "no cameras");
+}
+
+TEST(ControlServer, ServesRequestsOverUnixSocket) {
+    const auto path = socketPath("serve");
+    int takes = 0;
+    ControlServer server(path, [&takes](const ControlProtocol::Request& request) {
+        if (request.command == "start") {
+            return ControlProtocol::okResponse({{"dir", "./recording/" + request.args.at("prefix") + std::to_string(++takes)}});
+        }
+        throw std::runtime_error("unknown command '" + request.command + "'");
+    });
+    server.start();
+
+    const auto first = ControlClient::request(path, {"start", {{"prefix", "calib"}}});
+    ASSERT_TRUE(first.ok);
+    EXPECT_EQ(first.fields.at("dir"), "./recording/calib1");
+    EXPECT_EQ(ControlClient::request(path, {"start", {{"prefix", "calib"}}}).fields.at("dir"), "./recording/calib2");
+
+    const auto unknown = ControlClient::request(path, {"explode", {}});
+    EXPECT_FALSE(unknown.ok);
+    EXPECT_EQ(unknown.error, "unknown command 'explode'");
+
+    // A second daemon on the same socket is refused
+    ControlServer second(path, [](const ControlProtocol::Request&) { return ControlProtocol::okResponse(); });
+    EXPECT_THROW(second.start(), std::runtime_error);
+
+    server.stop();
+    EXPECT_FALSE(std::filesystem::exists(path));
+    EXPECT_THROW(ControlClient::request(path, {"status", {}}), std::runtime_error);
+}
+
+TEST(ControlServer, IdleClientDoesNotBlockOthers) {
+    const auto path = socketPath("idle");
+    ControlServer server(path, [](const ControlProtocol::Request&) { return ControlProtocol::okResponse(); },
+                         std::chrono::milliseconds(100));
+    server.start();
+
+    // Connects and sends half a line, then goes quiet
+    const int idle = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    ASSERT_EQ(::connect(idle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+    ASSERT_EQ(::send(idle, "sta", 3, MSG_NOSIGNAL), 3);
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(ControlClient::request(path, {"status", {}}, std::chrono::seconds(2)).ok);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+    char reply[64] = {};
+    const ssize_t n = ::recv(idle, reply, sizeof(reply) - 1, 0);
+    EXPECT_GT(n, 0);
+    EXPECT_EQ(ControlProtocol::parseResponse(reply).error, "idle timeout");
+    ::close(idle);
+    server.stop();
+}
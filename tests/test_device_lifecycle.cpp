@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "device_lifecycle_manager.h"
+#include "mocks/mock_camera_managers.h"
+#include <filesystem>
+
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::_;
+
+struct DeviceLifecycleFixture : public ::testing::Test {
+    std::unique_ptr<NiceMock<MockFrameCameraManager>> frameMock;
+    std::unique_ptr<NiceMock<MockEventCameraManager>> eventMock;
+    MockFrameCameraManager* frameRaw{}; MockEventCameraManager* eventRaw{};
+    std::unique_ptr<RecordingManager> mgr;
+    void SetUp() override {
+        frameMock = std::make_unique<NiceMock<MockFrameCameraManager>>();
+        eventMock = std::make_unique<NiceMock<MockEventCameraManager>>();
+        frameRaw = frameMock.get(); eventRaw = eventMock.get();
+        ON_CALL(*eventRaw, startLiveStreaming()).WillByDefault(Return(true));
+        mgr = std::make_unique<RecordingManager>(std::move(frameMock), std::move(eventMock));
+    }
+};
+
+TEST_F(DeviceLifecycleFixture, DevicesStayOpenBetweenTakes) {
+    DeviceLifecycleManager lifecycle(*mgr);
+    EXPECT_EQ(lifecycle.state(), DeviceLifecycleManager::State::Released);
+
+    // Opened exactly once for two takes with idle in between
+    EXPECT_CALL(*frameRaw, openAndSetupDevices()).Times(1);
+    EXPECT_CALL(*eventRaw, openAndSetupDevices(_)).Times(1);
+    ASSERT_TRUE(lifecycle.open({}));
+    ASSERT_TRUE(lifecycle.startStreaming());
+    EXPECT_EQ(lifecycle.state(), DeviceLifecycleManager::State::Streaming);
+
+    EXPECT_CALL(*frameRaw, closeDevices()).Times(0);
+    EXPECT_CALL(*eventRaw, closeDevices()).Times(0);
+    ASSERT_TRUE(lifecycle.startTake("./tmp_lifecycle_take1"));
+    EXPECT_EQ(lifecycle.state(), DeviceLifecycleManager::State::Recording);
+    lifecycle.goIdle(); // ignored while recording
+    EXPECT_EQ(lifecycle.state(), DeviceLifecycleManager::State::Recording);
+    lifecycle.stopTake();
+    lifecycle.goIdle();
+    EXPECT_EQ(lifecycle.state(), DeviceLifecycleManager::State::Idle);
+
+    ASSERT_TRUE(lifecycle.startTake("./tmp_lifecycle_take2"));
+    lifecycle.stopTake();
+    ::testing::Mock::VerifyAndClearExpectations(frameRaw);
+    ::testing::Mock::VerifyAndClearExpectations(eventRaw);
+    std::filesystem::remove_all("./tmp_lifecycle_take1");
+    std::filesystem::remove_all("./tmp_lifecycle_take2");
+}
+
+TEST_F(DeviceLifecycleFixture, ReleaseClosesAndNextTakeReopens) {
+    DeviceLifecycleManager lifecycle(*mgr);
+    ASSERT_TRUE(lifecycle.open({}));
+
+    EXPECT_CALL(*frameRaw, closeDevices()).Times(1);
+    EXPECT_CALL(*eventRaw, closeDevices()).Times(1);
+    lifecycle.release();
+    EXPECT_EQ(lifecycle.state(), DeviceLifecycleManager::State::Released);
+    ::testing::Mock::VerifyAndClearExpectations(frameRaw);
+    ::testing::Mock::VerifyAndClearExpectations(eventRaw);
+
+    EXPECT_CALL(*frameRaw, openAndSetupDevices()).Times(1);
+    EXPECT_CALL(*eventRaw, openAndSetupDevices(_)).Times(1);
+    ASSERT_TRUE(lifecycle.startTake("./tmp_lifecycle_take3"));
+    lifecycle.stopTake();
+    std::filesystem::remove_all("./tmp_lifecycle_take3");
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "event_buffer_arena.h"
+
+#include <thread>
+
+namespace {
+struct TestEvent {
+    uint16_t x;
+    uint16_t y;
+    int16_t p;
+    int64_t t;
+};
+} // namespace
+
+TEST(EventBufferArena, SteadyStateReusesBuffers) {
+    EventBufferArena<std::vector<TestEvent>> arena(4, 16);
+    for (int round = 0; round < 100; ++round) {
+        auto buffer = arena.acquire();
+        EXPECT_TRUE(buffer->empty());
+        for (int i = 0; i < 1000; ++i) buffer->push_back(TestEvent{1, 2, 1, i});
+    }
+    EXPECT_EQ(arena.allocations(), 1u);
+    EXPECT_EQ(arena.reuses(), 99u);
+    EXPECT_EQ(arena.freeBuffers(), 1u);
+
+    // The typical size follows what the buffers actually hold, so fresh buffers come pre-sized
+    EXPECT_GT(arena.typicalSize(), 900u);
+    EXPECT_LE(arena.typicalSize(), 1000u);
+    auto a = arena.acquire();
+    auto b = arena.acquire();
+    EXPECT_EQ(arena.allocations(), 2u);
+    EXPECT_GE(b->capacity(), arena.typicalSize());
+}
+
+TEST(EventBufferArena, BuffersReturnFromOtherThreads) {
+    EventBufferArena<EventBlock> arena(2);
+    std::vector<EventBufferArena<EventBlock>::Handle> handles;
+    for (int i = 0; i < 3; ++i) handles.push_back(arena.acquire());
+    std::thread releaser([&handles] { handles.clear(); });
+    releaser.join();
+    EXPECT_EQ(arena.freeBuffers(), 2u); // capped, the third is freed
+
+    // Handles keep the pool alive past the arena
+    EventBufferArena<EventBlock>::Handle orphan;
+    {
+        EventBufferArena<EventBlock> shortLived;
+        orphan = shortLived.acquire();
+    }
+    orphan->push(TestEvent{3, 4, 0, 5});
+    orphan.reset();
+}
+
+TEST(EventBlock, AppendsStructureOfArrays) {
+    const std::vector<TestEvent> events = {{1, 2, 1, 10}, {3, 4, 0, 20}, {5, 6, 1, 30}};
+    EventBlock block;
+    block.appendIf(events.begin(), events.end(), [](const TestEvent& e) { return e.t >= 20; });
+    ASSERT_EQ(block.size(), 2u);
+    EXPECT_EQ(block.x[0], 3);
+    EXPECT_EQ(block.y[1], 6);
+    EXPECT_EQ(block.p[0], 0);
+    EXPECT_EQ(block.t[1], 30);
+
+    EventBlock other;
+    other.append(events.begin(), events.begin() + 1);
+    block.swap(other);
+    EXPECT_EQ(block.size(), 1u);
+    EXPECT_EQ(other.size(), 2u);
+    block.clear();
+    EXPECT_TRUE(block.empty());
+}
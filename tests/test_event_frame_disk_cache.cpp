@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "event_frame_disk_cache.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace {
+struct CacheFixture : public ::testing::Test {
+    std::filesystem::path dir;
+    std::filesystem::path source;
+    EventFrameDiskCache::Key key;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / ("ebv_render_cache_" + std::to_string(::getpid()));
+        std::filesystem::create_directories(dir);
+        source = dir / "ebv_cam_0.hdf5";
+        std::ofstream(source) << "events";
+        key = {source.string(), 0, 33333, 3333, "polarity", 1};
+    }
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    static std::vector<uint8_t> plane(int width, int height, size_t seed) {
+        std::vector<uint8_t> p(static_cast<size_t>(width * height), EventFrameDiskCache::NoEvent);
+        for (size_t i = seed; i < p.size(); i += 97 + seed) p[i] = (i % 2) ? EventFrameDiskCache::Positive : EventFrameDiskCache::Negative;
+        return p;
+    }
+};
+} // namespace
+
+TEST(EventFrameDiskCacheCodec, RleRoundTrip) {
+    std::vector<uint8_t> data(100000, 0);
+    data[5] = 1; data[6] = 1; data[99999] = 2;
+    std::vector<uint8_t> encoded;
+    EventFrameDiskCache::encodeRle(data.data(), data.size(), encoded);
+    EXPECT_LT(encoded.size(), 32u);
+    std::vector<uint8_t> decoded(data.size());
+    ASSERT_TRUE(EventFrameDiskCache::decodeRle(encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+    EXPECT_EQ(decoded, data);
+    // Wrong target size is rejected instead of overrunning
+    EXPECT_FALSE(EventFrameDiskCache::decodeRle(encoded.data(), encoded.size(), decoded.data(), 10));
+}
+
+TEST_F(CacheFixture, FramesPersistAcrossReopen) {
+    {
+        EventFrameDiskCache cache(dir / "cache", key, 64, 48, 100);
+        ASSERT_TRUE(cache.isOpen());
+        ASSERT_TRUE(cache.isWritable());
+        cache.store(3, plane(64, 48, 1));
+        cache.store(7, plane(64, 48, 2));
+        cache.flush();
+        EXPECT_TRUE(cache.contains(3));
+        EXPECT_FALSE(cache.contains(4));
+    }
+    EventFrameDiskCache reopened(dir / "cache", key, 64, 48, 100);
+    ASSERT_TRUE(reopened.isOpen());
+    EXPECT_EQ(reopened.cachedFrameCount(), 2u);
+    std::vector<uint8_t> out;
+    ASSERT_TRUE(reopened.read(7, out));
+    EXPECT_EQ(out, plane(64, 48, 2));
+    EXPECT_FALSE(reopened.read(4, out));
+}
+
+TEST_F(CacheFixture, DifferentWindowOrChangedSourceMissesCache) {
+    {
+        EventFrameDiskCache cache(dir / "cache", key, 64, 48, 100);
+        cache.store(1, plane(64, 48, 1));
+    }
+    auto otherWindow = key;
+    otherWindow.windowUs = 16666;
+    EventFrameDiskCache byWindow(dir / "cache", otherWindow, 64, 48, 100);
+    EXPECT_EQ(byWindow.cachedFrameCount(), 0u);
+
+    EXPECT_NE(EventFrameDiskCache::fileNameFor(key), EventFrameDiskCache::fileNameFor(otherWindow));
+    auto otherOverlap = key;
+    otherOverlap.overlapUs = 0;
+    EXPECT_NE(EventFrameDiskCache::fileNameFor(key), EventFrameDiskCache::fileNameFor(otherOverlap));
+    auto otherRenderer = key;
+    otherRenderer.rendererVersion = 2;
+    EXPECT_NE(EventFrameDiskCache::fileNameFor(key), EventFrameDiskCache::fileNameFor(otherRenderer));
+
+    const auto before = EventFrameDiskCache::fileNameFor(key);
+    std::ofstream(source, std::ios::app) << "more events";
+    EXPECT_NE(EventFrameDiskCache::fileNameFor(key), before);
+}
+
+TEST_F(CacheFixture, SizeLimitEvictsLeastRecentlyUsedFiles) {
+    const auto cacheDir = dir / "cache";
+    std::vector<std::filesystem::path> files;
+    for (int64_t windowUs : {10000, 20000, 30000}) {
+        auto other = key;
+        other.windowUs = windowUs;
+        {
+            EventFrameDiskCache cache(cacheDir, other, 64, 48, 100);
+            for (size_t i = 0; i < 10; ++i) cache.store(i, plane(64, 48, i + 1));
+        }
+        files.push_back(cacheDir / EventFrameDiskCache::fileNameFor(other));
+        ASSERT_TRUE(std::filesystem::exists(files.back()));
+    }
+    // Oldest first: files[0] was opened longest ago
+    const auto now = std::filesystem::file_time_type::clock::now();
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::filesystem::last_write_time(files[i], now - std::chrono::minutes(10 - static_cast<int>(i)));
+    }
+    const uint64_t newest = std::filesystem::file_size(files[2]);
+
+    // A file still open in a player is never removed
+    auto busyKey = key;
+    busyKey.windowUs = 10000;
+    {
+        EventFrameDiskCache busy(cacheDir, busyKey, 64, 48, 100);
+        EventFrameDiskCache::enforceSizeLimit(cacheDir, 2 * newest);
+        EXPECT_TRUE(std::filesystem::exists(files[0]));
+        EXPECT_FALSE(std::filesystem::exists(files[1]));
+        EXPECT_TRUE(std::filesystem::exists(files[2]));
+    }
+
+    std::filesystem::last_write_time(files[0], now - std::chrono::minutes(20));
+    EventFrameDiskCache::enforceSizeLimit(cacheDir, newest);
+    EXPECT_FALSE(std::filesystem::exists(files[0]));
+    EXPECT_TRUE(std::filesystem::exists(files[2]));
+}
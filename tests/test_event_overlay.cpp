@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include "event_overlay.h"
+
+TEST(EventOverlay, DefaultHomographyFitsAndCenters) {
+    // 640x480 events onto a 1280x1024 frame: scale 2, 32 px vertical margin
+    const cv::Matx33d h = EventOverlay::defaultHomography(cv::Size(640, 480), cv::Size(1280, 1024));
+    EXPECT_DOUBLE_EQ(h(0, 0), 2.0);
+    EXPECT_DOUBLE_EQ(h(0, 2), 0.0);
+    EXPECT_DOUBLE_EQ(h(1, 2), 32.0);
+    EXPECT_EQ(EventOverlay::calibrationKey("ebv_cam_0", "frame_cam0"), "ebv_cam_0_to_frame_cam0");
+}
+
+TEST(EventOverlay, BlendsOnlyEventPixels) {
+    const cv::Size eventSize(8, 6);
+    const cv::Size frameSize(16, 12);
+    const auto table = EventOverlay::buildRemapTable(EventOverlay::defaultHomography(eventSize, frameSize), eventSize, frameSize);
+    ASSERT_FALSE(table.empty());
+
+    const cv::Scalar background(64, 64, 64);
+    cv::Mat events(eventSize, CV_8UC3, background);
+    events.at<cv::Vec3b>(2, 3) = cv::Vec3b(255, 255, 255);
+
+    cv::Mat frame(frameSize, CV_8UC1, cv::Scalar(0)); // grayscale frames are promoted to BGR
+    EventOverlay::blend(frame, events, table, background, 0.5);
+    ASSERT_EQ(frame.type(), CV_8UC3);
+
+    // Event pixel (3, 2) covers frame pixels (6..7, 4..5) at scale 2
+    EXPECT_NEAR(frame.at<cv::Vec3b>(4, 6)[0], 128, 1);
+    EXPECT_NEAR(frame.at<cv::Vec3b>(5, 7)[2], 128, 1);
+    // Background stays untouched
+    EXPECT_EQ(frame.at<cv::Vec3b>(0, 0), cv::Vec3b(0, 0, 0));
+    EXPECT_EQ(frame.at<cv::Vec3b>(4, 8), cv::Vec3b(0, 0, 0));
+}
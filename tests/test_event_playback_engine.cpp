@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "event_playback_engine.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+TEST(EventPlaybackEngine, PublishesCompleteFrameSetsInLockstep) {
+    std::mutex mutex;
+    std::vector<std::pair<size_t, size_t>> order; // (frame, stream)
+    auto render = [&](size_t stream, size_t frame) {
+        // Stream 1 is much slower; the shared workers cover for it
+        if (stream == 1) std::this_thread::sleep_for(2ms);
+        std::lock_guard<std::mutex> lock(mutex);
+        order.emplace_back(frame, stream);
+        return true;
+    };
+    EventPlaybackEngine::Options options;
+    options.workers = 2;
+    options.lookahead = 10;
+    EventPlaybackEngine engine(2, 100, render, options);
+
+    const auto set = engine.waitForFrameSet(0, 2000ms);
+    EXPECT_TRUE(set.complete);
+    EXPECT_FALSE(set.late);
+    EXPECT_EQ(set.ready, std::vector<bool>({true, true}));
+
+    // The window fills and the scheduler never runs ahead of it
+    for (int i = 0; i < 200 && engine.readyAhead() < 10; ++i) std::this_thread::sleep_for(5ms);
+    EXPECT_EQ(engine.readyAhead(), 10u);
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(order.size(), 20u);
+    for (const auto& [frame, stream] : order) EXPECT_LT(frame, 10u);
+    const std::set<std::pair<size_t, size_t>> distinct(order.begin(), order.end());
+    EXPECT_EQ(distinct.size(), 20u); // nothing rendered twice
+}
+
+TEST(EventPlaybackEngine, LateSetsAndSeeks) {
+    std::atomic<bool> releaseSlowStream{false};
+    std::atomic<size_t> published{0};
+    auto render = [&](size_t stream, size_t frame) {
+        if (stream == 1 && frame == 50) {
+            while (!releaseSlowStream) std::this_thread::sleep_for(1ms);
+        }
+        return stream != 2; // stream 2 has no data
+    };
+    EventPlaybackEngine::Options options;
+    options.workers = 3;
+    options.lookahead = 4;
+    EventPlaybackEngine engine(3, 60, render, options);
+    engine.setFrameSetCallback([&](size_t frame) {
+        if (frame == 50) published = 1;
+    });
+
+    // Seek: the waited frame becomes the cursor and stream 1 holds it back
+    const auto late = engine.waitForFrameSet(50, 20ms);
+    EXPECT_EQ(engine.cursor(), 50u);
+    EXPECT_TRUE(late.late);
+    EXPECT_FALSE(late.complete);
+    EXPECT_TRUE(late.ready[0]);
+    EXPECT_FALSE(late.ready[1]);
+    EXPECT_EQ(published.load(), 0u);
+
+    releaseSlowStream = true;
+    const auto set = engine.waitForFrameSet(50, 2000ms);
+    EXPECT_TRUE(set.complete);
+    EXPECT_FALSE(set.late);
+    EXPECT_EQ(set.ready, std::vector<bool>({true, true, false})); // failed streams complete the set
+    for (int i = 0; i < 200 && published == 0; ++i) std::this_thread::sleep_for(1ms);
+    EXPECT_EQ(published.load(), 1u);
+
+    // Past the end of the recording nothing is scheduled
+    EXPECT_TRUE(engine.waitForFrameSet(60, 1ms).late);
+    engine.stop();
+}
+
+TEST(EventPlaybackEngine, PausedRendersOnlyTheCursorFrame) {
+    std::atomic<size_t> rendered{0};
+    EventPlaybackEngine::Options options;
+    options.workers = 2;
+    options.lookahead = 10;
+    EventPlaybackEngine engine(1, 100, [&rendered](size_t, size_t) { ++rendered; return true; }, options);
+    engine.setPaused(true);
+
+    EXPECT_TRUE(engine.waitForFrameSet(5, 2000ms).complete);
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(rendered.load(), 1u);
+    EXPECT_EQ(engine.readyAhead(), 1u);
+
+    engine.setPaused(false);
+    for (int i = 0; i < 200 && engine.readyAhead() < 10; ++i) std::this_thread::sleep_for(5ms);
+    EXPECT_EQ(engine.readyAhead(), 10u);
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include "event_transcoder.h"
+#include "session_manifest.h"
+
+#include <cstdint>
+#include <fstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+fs::path makeTempRoot(const char* tag) {
+    auto root = fs::temp_directory_path() / ("ebv_" + std::string(tag) + "_" + std::to_string(::getpid()));
+    fs::remove_all(root);
+    fs::create_directories(root);
+    return root;
+}
+
+// Not a valid RAW recording: decoding it fails like a file that does not verify
+void writeBrokenRaw(const fs::path& path) {
+    std::ofstream out(path, std::ios::binary);
+    out << "% not an event recording\n" << std::string(4096, '\x5a');
+}
+
+// Small but valid EVT2 recording: CD events every 5 us with alternating polarity and a
+// rising/falling trigger pair every 100 events
+void writeEvt2Raw(const fs::path& path, uint32_t cdEvents) {
+    std::ofstream out(path, std::ios::binary);
+    out << "% camera_integrator_name Prophesee\n"
+        << "% evt 2.0\n"
+        << "% format EVT2;height=480;width=640\n"
+        << "% geometry 640x480\n"
+        << "% integrator_name Prophesee\n"
+        << "% plugin_integrator_name Prophesee\n"
+        << "% plugin_name hal_plugin_imx636\n"
+        << "% serial_number 00ebv000\n"
+        << "% end\n";
+    auto word = [&out](uint32_t value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    uint64_t timeHigh = UINT64_MAX;
+    for (uint32_t i = 0; i < cdEvents; ++i) {
+        const uint64_t t = 1000 + uint64_t{i} * 5;
+        if ((t >> 6) != timeHigh) {
+            timeHigh = t >> 6;
+            word((0x8u << 28) | static_cast<uint32_t>(timeHigh & 0x0fffffffu));
+        }
+        const uint32_t low = static_cast<uint32_t>(t & 63) << 22;
+        word(((i % 2) << 28) | low | ((i % 640) << 11) | ((i / 640) % 480));
+        if (i % 100 == 0) word((0xAu << 28) | low | ((i / 100) % 2));
+    }
+}
+
+struct TranscodeResult {
+    bool ok{false};
+    std::string message;
+};
+
+TranscodeResult transcode(const fs::path& take, bool keepRaw = false) {
+    TranscodeResult result;
+    EventTranscoder transcoder;
+    transcoder.setCompletionCallback([&result](const EventTranscoder::Job&, bool ok, const std::string& message) {
+        result.ok = ok;
+        result.message = message;
+    });
+    transcoder.enqueue({take, keepRaw});
+    transcoder.waitIdle();
+    return result;
+}
+} // namespace
+
+TEST(EventTranscoder, TakeWithoutRawFilesIsLeftAlone) {
+    const auto take = makeTempRoot("transcode_empty");
+    SessionManifest captured;
+    captured.set(SessionManifest::KEY_STATE, "complete");
+    ASSERT_TRUE(captured.save(take));
+
+    const auto result = transcode(take);
+    EXPECT_TRUE(result.ok);
+    EXPECT_EQ(result.message, "no RAW event files");
+    SessionManifest manifest;
+    ASSERT_TRUE(manifest.load(take));
+    EXPECT_TRUE(manifest.keysWithPrefix("transcode.").empty());
+    fs::remove_all(take);
+}
+
+TEST(EventTranscoder, FailedFilesKeepRawAndAreRecordedPerStream) {
+    // ebv_cam_1 is striped to another directory, only the manifest points there
+    const auto root = makeTempRoot("transcode_failed");
+    const auto take = root / "take";
+    const auto stripe = root / "stripe1";
+    fs::create_directories(take);
+    fs::create_directories(stripe);
+    writeBrokenRaw(take / "ebv_cam_0.raw");
+    writeBrokenRaw(stripe / "ebv_cam_1.raw");
+    SessionManifest captured;
+    captured.set(SessionManifest::streamKey("ebv_cam_1"), stripe.string());
+    captured.set("event.format", "raw");
+    ASSERT_TRUE(captured.save(take));
+
+    const auto result = transcode(take);
+    EXPECT_FALSE(result.ok);
+    EXPECT_NE(result.message.find("ebv_cam_0: "), std::string::npos);
+    EXPECT_NE(result.message.find("ebv_cam_1: "), std::string::npos);
+
+    SessionManifest manifest;
+    ASSERT_TRUE(manifest.load(take));
+    EXPECT_EQ(manifest.get("transcode.ebv_cam_0"), "failed");
+    EXPECT_EQ(manifest.get("transcode.ebv_cam_1"), "failed");
+    EXPECT_FALSE(manifest.get("transcode.seconds").empty());
+    EXPECT_EQ(manifest.get("event.format"), "raw");
+
+    // Nothing is replaced or left half-written
+    EXPECT_TRUE(fs::exists(take / "ebv_cam_0.raw"));
+    EXPECT_TRUE(fs::exists(stripe / "ebv_cam_1.raw"));
+    EXPECT_FALSE(fs::exists(take / "ebv_cam_0.hdf5"));
+    EXPECT_FALSE(fs::exists(stripe / "ebv_cam_1.hdf5"));
+    EXPECT_FALSE(fs::exists(take / "ebv_cam_0.transcoding.hdf5"));
+    EXPECT_FALSE(fs::exists(stripe / "ebv_cam_1.transcoding.hdf5"));
+    fs::remove_all(root);
+}
+
+TEST(EventTranscoder, VerifiedTakeReplacesRawWithHdf5) {
+    const auto take = makeTempRoot("transcode_ok");
+    writeEvt2Raw(take / "ebv_cam_0.raw", 5000);
+    SessionManifest captured;
+    captured.set("event.format", "raw");
+    ASSERT_TRUE(captured.save(take));
+
+    const auto result = transcode(take);
+    EXPECT_TRUE(result.ok) << result.message;
+    // The count in the message is the one read back from the new file
+    EXPECT_NE(result.message.find("5000 events"), std::string::npos) << result.message;
+
+    SessionManifest manifest;
+    ASSERT_TRUE(manifest.load(take));
+    EXPECT_EQ(manifest.get("transcode.ebv_cam_0"), "ok");
+    EXPECT_EQ(manifest.get("event.format"), "hdf5");
+    EXPECT_TRUE(fs::exists(take / "ebv_cam_0.hdf5"));
+    EXPECT_FALSE(fs::exists(take / "ebv_cam_0.transcoding.hdf5"));
+    EXPECT_FALSE(fs::exists(take / "ebv_cam_0.raw"));
+    fs::remove_all(take);
+}
+
+TEST(EventTranscoder, PartialFailureKeepsEveryRawFile) {
+    const auto take = makeTempRoot("transcode_partial");
+    writeEvt2Raw(take / "ebv_cam_0.raw", 5000);
+    writeBrokenRaw(take / "ebv_cam_1.raw");
+    SessionManifest captured;
+    captured.set("event.format", "raw");
+    ASSERT_TRUE(captured.save(take));
+
+    const auto result = transcode(take);
+    EXPECT_FALSE(result.ok);
+    EXPECT_EQ(result.message.find("ebv_cam_0: "), std::string::npos);
+    EXPECT_NE(result.message.find("ebv_cam_1: "), std::string::npos);
+
+    SessionManifest manifest;
+    ASSERT_TRUE(manifest.load(take));
+    EXPECT_EQ(manifest.get("transcode.ebv_cam_0"), "ok");
+    EXPECT_EQ(manifest.get("transcode.ebv_cam_1"), "failed");
+    EXPECT_EQ(manifest.get("event.format"), "raw");
+
+    // The good camera is converted, but the take stays complete in RAW
+    EXPECT_TRUE(fs::exists(take / "ebv_cam_0.hdf5"));
+    EXPECT_TRUE(fs::exists(take / "ebv_cam_0.raw"));
+    EXPECT_TRUE(fs::exists(take / "ebv_cam_1.raw"));
+    EXPECT_FALSE(fs::exists(take / "ebv_cam_1.hdf5"));
+    fs::remove_all(take);
+}
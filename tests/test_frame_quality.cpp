@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include "frame_quality_analyzer.h"
+
+#include <numeric>
+#include <opencv2/imgproc.hpp>
+
+TEST(FrameQualityAnalyzer, BlurLowersSharpness) {
+    cv::Mat sharp(240, 320, CV_8UC3, cv::Scalar(0, 0, 0));
+    for (int x = 0; x < sharp.cols; x += 8) {
+        cv::rectangle(sharp, cv::Rect(x, 0, 4, sharp.rows), cv::Scalar(200, 200, 200), cv::FILLED);
+    }
+    cv::Mat blurred;
+    cv::GaussianBlur(sharp, blurred, cv::Size(15, 15), 5.0);
+
+    const FrameQualityAnalyzer::Options options;
+    const auto sharpMetrics = FrameQualityAnalyzer::analyze(sharp, options);
+    const auto blurredMetrics = FrameQualityAnalyzer::analyze(blurred, options);
+    EXPECT_GT(sharpMetrics.sharpness, 10.0 * blurredMetrics.sharpness);
+
+    const float histogramSum = std::accumulate(sharpMetrics.histogram.begin(), sharpMetrics.histogram.end(), 0.0f);
+    EXPECT_NEAR(histogramSum, 1.0f, 1e-4f);
+    EXPECT_NEAR(sharpMetrics.clippedLowRatio, 0.5, 0.01); // black stripes
+}
+
+TEST(FrameQualityAnalyzer, ReportsClippingOnDecimatedFrames) {
+    // Wider than the analysis width: decimated before analysis, ratios unchanged
+    cv::Mat frame(1000, 2000, CV_8UC4, cv::Scalar(128, 128, 128, 255));
+    frame(cv::Rect(0, 0, 500, 1000)).setTo(cv::Scalar(255, 255, 255, 255));
+
+    const auto metrics = FrameQualityAnalyzer::analyze(frame, FrameQualityAnalyzer::Options{});
+    EXPECT_NEAR(metrics.clippedHighRatio, 0.25, 0.01);
+    EXPECT_DOUBLE_EQ(metrics.clippedLowRatio, 0.0);
+    EXPECT_NEAR(metrics.histogram[128 / 4], 0.75f, 0.01f);
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "frame_rectifier.h"
+
+#include <filesystem>
+#include <unistd.h>
+
+namespace {
+FrameRectifier::Calibration pinhole(cv::Size size) {
+    FrameRectifier::Calibration calibration;
+    calibration.cameraMatrix = (cv::Mat_<double>(3, 3) << 500, 0, size.width / 2.0, 0, 500, size.height / 2.0, 0, 0, 1);
+    calibration.distCoeffs = cv::Mat::zeros(1, 5, CV_64F);
+    calibration.rectification = cv::Mat::eye(3, 3, CV_64F);
+    calibration.projection = calibration.cameraMatrix.clone();
+    calibration.imageSize = size;
+    return calibration;
+}
+} // namespace
+
+TEST(FrameRectifier, DistortionFreeCalibrationKeepsImage) {
+    FrameRectifier rectifier({pinhole(cv::Size(64, 48)), std::nullopt});
+    cv::Mat image(48, 64, CV_8UC3);
+    cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(255));
+
+    const cv::Mat rectified = rectifier.rectify(0, image);
+    ASSERT_EQ(rectified.size(), image.size());
+    EXPECT_EQ(cv::norm(rectified(cv::Rect(1, 1, 62, 46)), image(cv::Rect(1, 1, 62, 46)), cv::NORM_INF), 0.0);
+
+    // Preview: downscaled first, maps built for the reduced size
+    const cv::Mat preview = rectifier.rectifyPreview(0, image, 32);
+    EXPECT_EQ(preview.size(), cv::Size(32, 24));
+
+    // Cameras without calibration pass through
+    EXPECT_FALSE(rectifier.hasCamera(1));
+    EXPECT_EQ(rectifier.rectify(1, image).data, image.data);
+}
+
+TEST(FrameRectifier, LoadsCalibrationFile) {
+    const auto path = std::filesystem::temp_directory_path() / ("ebv_rectification_" + std::to_string(::getpid()) + ".yml");
+    {
+        const auto calibration = pinhole(cv::Size(640, 480));
+        cv::FileStorage storage(path.string(), cv::FileStorage::WRITE);
+        storage << "image_width" << 640 << "image_height" << 480;
+        storage << "frame_cam1_K" << calibration.cameraMatrix;
+        storage << "frame_cam1_D" << (cv::Mat_<double>(1, 5) << -0.1, 0.01, 0, 0, 0);
+    }
+    const auto rectifier = FrameRectifier::fromFile(path.string(), 2);
+    ASSERT_NE(rectifier, nullptr);
+    EXPECT_FALSE(rectifier->hasCamera(0));
+    EXPECT_TRUE(rectifier->hasCamera(1));
+
+    FrameRectifier::Calibration loaded;
+    ASSERT_TRUE(FrameRectifier::loadCalibration(path.string(), "frame_cam1", loaded));
+    EXPECT_EQ(loaded.imageSize, cv::Size(640, 480));
+    EXPECT_DOUBLE_EQ(loaded.rectification.at<double>(1, 1), 1.0); // defaulted
+    EXPECT_DOUBLE_EQ(loaded.distCoeffs.at<double>(0, 0), -0.1);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(FrameRectifier::fromFile(path.string(), 2), nullptr);
+}
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include "hdf5_event_writer.h"
+
+#include <filesystem>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+std::filesystem::path tempFile(const std::string& name) {
+    return std::filesystem::temp_directory_path() / ("ebv_h5_" + std::to_string(::getpid()) + "_" + name);
+}
+
+struct TestEvent { uint16_t x, y; int16_t p; int64_t t; };
+
+std::vector<TestEvent> syntheticEvents(size_t count) {
+    std::vector<TestEvent> events(count);
+    for (size_t i = 0; i < count; ++i) {
+        events[i] = TestEvent{static_cast<uint16_t>(i % 640), static_cast<uint16_t>((i / 640) % 480),
+                              static_cast<int16_t>(i % 2), static_cast<int64_t>(1'000'000 + i * 3)};
+    }
+    return events;
+}
+} // namespace
+
+TEST(Hdf5EventWriter, RoundTripWithChunkingAndCompression) {
+    const auto path = tempFile("roundtrip.hdf5");
+    Hdf5EventWriter::Options options;
+    options.chunkEvents = 1000;
+    options.compressionLevel = 6;
+    const auto events = syntheticEvents(2500);
+    {
+        Hdf5EventWriter writer(path.string(), options);
+        writer.addMetadata("serial_number", "TEST123");
+        writer.addCdEvents(events.data(), events.data() + 1200);          // flushes one chunk
+        writer.addCdEvents(events.data() + 1200, events.data() + events.size());
+        EXPECT_EQ(writer.cdEventsWritten(), 2000u);                        // 500 still buffered
+        writer.close();
+        EXPECT_EQ(writer.cdEventsWritten(), 2500u);
+    }
+
+    const hid_t file = H5Fopen(path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    ASSERT_GE(file, 0);
+    const hid_t dataset = H5Dopen2(file, "/CD/events", H5P_DEFAULT);
+    ASSERT_GE(dataset, 0);
+
+    const hid_t space = H5Dget_space(dataset);
+    hsize_t rows = 0;
+    H5Sget_simple_extent_dims(space, &rows, nullptr);
+    EXPECT_EQ(rows, 2500u);
+
+    const hid_t dcpl = H5Dget_create_plist(dataset);
+    hsize_t chunk = 0;
+    EXPECT_EQ(H5Pget_chunk(dcpl, 1, &chunk), 1);
+    EXPECT_EQ(chunk, 1000u);
+    EXPECT_EQ(H5Pget_nfilters(dcpl), 2); // shuffle + deflate
+
+    const hid_t memType = H5Tcreate(H5T_COMPOUND, sizeof(Hdf5EventWriter::CdEvent));
+    H5Tinsert(memType, "x", HOFFSET(Hdf5EventWriter::CdEvent, x), H5T_NATIVE_UINT16);
+    H5Tinsert(memType, "y", HOFFSET(Hdf5EventWriter::CdEvent, y), H5T_NATIVE_UINT16);
+    H5Tinsert(memType, "p", HOFFSET(Hdf5EventWriter::CdEvent, p), H5T_NATIVE_INT16);
+    H5Tinsert(memType, "t", HOFFSET(Hdf5EventWriter::CdEvent, t), H5T_NATIVE_INT64);
+    std::vector<Hdf5EventWriter::CdEvent> readBack(rows);
+    ASSERT_GE(H5Dread(dataset, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, readBack.data()), 0);
+    for (size_t i = 0; i < events.size(); ++i) {
+        ASSERT_EQ(readBack[i].x, events[i].x);
+        ASSERT_EQ(readBack[i].t, events[i].t);
+    }
+
+    // One index entry per 2 ms from t = 0 up to the last event at 1.007497 s
+    const hid_t indexes = H5Dopen2(file, "/CD/indexes", H5P_DEFAULT);
+    const hid_t indexSpace = H5Dget_space(indexes);
+    hsize_t indexRows = 0;
+    H5Sget_simple_extent_dims(indexSpace, &indexRows, nullptr);
+    EXPECT_EQ(indexRows, 504u);
+    EXPECT_GT(H5Aexists(file, "serial_number"), 0);
+
+    H5Sclose(indexSpace);
+    H5Dclose(indexes);
+    H5Tclose(memType);
+    H5Pclose(dcpl);
+    H5Sclose(space);
+    H5Dclose(dataset);
+    H5Fclose(file);
+    std::filesystem::remove(path);
+}
+
+TEST(Hdf5EventWriter, CompressionLevelTradesSize) {
+    const auto events = syntheticEvents(200000);
+    auto writeWith = [&](int level) {
+        const auto path = tempFile("level" + std::to_string(level) + ".hdf5");
+        Hdf5EventWriter::Options options;
+        options.compressionLevel = level;
+        {
+            Hdf5EventWriter writer(path.string(), options);
+            writer.addCdEvents(events.data(), events.data() + events.size());
+        }
+        const auto size = std::filesystem::file_size(path);
+        std::filesystem::remove(path);
+        return size;
+    };
+    const auto uncompressed = writeWith(0);
+    const auto compressed = writeWith(6);
+    EXPECT_GT(uncompressed, events.size() * 14); // packed rows, no compression
+    EXPECT_LT(compressed, uncompressed / 2);
+}
+
+TEST(Hdf5EventWriter, ChunksEncodedOutsideHdf5ReadBackThroughItsFilters) {
+    const auto events = syntheticEvents(2500);
+    struct Trigger { int16_t p; int64_t t; int16_t id; };
+    const std::vector<Trigger> triggers{{1, 1'000'100, 0}, {0, 1'000'200, 0}, {1, 1'004'000, 3}};
+    for (const int level : {0, 6}) {
+        const auto path = tempFile("encoded" + std::to_string(level) + ".hdf5");
+        Hdf5EventWriter::Options options;
+        options.chunkEvents = 1000;
+        options.compressionLevel = level;
+        {
+            Hdf5EventWriter writer(path.string(), options);
+            writer.bufferCdEvents(events.data(), events.data() + 1500);
+            writer.encodeChunks();
+            writer.writeEncodedChunks();
+            EXPECT_EQ(writer.cdEventsWritten(), 1000u);
+            writer.bufferCdEvents(events.data() + 1500, events.data() + events.size());
+            writer.bufferTriggerEvents(triggers.data(), triggers.data() + triggers.size());
+            writer.encodeChunks(true);
+            EXPECT_THROW(writer.bufferCdEvents(events.data(), events.data() + 1), std::runtime_error);
+            writer.writeEncodedChunks();
+            EXPECT_EQ(writer.cdEventsWritten(), 2500u);
+            EXPECT_EQ(writer.triggerEventsWritten(), 3u);
+            writer.close();
+        }
+
+        const hid_t file = H5Fopen(path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        ASSERT_GE(file, 0);
+        const hid_t dataset = H5Dopen2(file, "/CD/events", H5P_DEFAULT);
+        const hid_t space = H5Dget_space(dataset);
+        hsize_t rows = 0;
+        H5Sget_simple_extent_dims(space, &rows, nullptr);
+        EXPECT_EQ(rows, 2500u);
+        const hid_t memType = H5Tcreate(H5T_COMPOUND, sizeof(Hdf5EventWriter::CdEvent));
+        H5Tinsert(memType, "x", HOFFSET(Hdf5EventWriter::CdEvent, x), H5T_NATIVE_UINT16);
+        H5Tinsert(memType, "y", HOFFSET(Hdf5EventWriter::CdEvent, y), H5T_NATIVE_UINT16);
+        H5Tinsert(memType, "p", HOFFSET(Hdf5EventWriter::CdEvent, p), H5T_NATIVE_INT16);
+        H5Tinsert(memType, "t", HOFFSET(Hdf5EventWriter::CdEvent, t), H5T_NATIVE_INT64);
+        std::vector<Hdf5EventWriter::CdEvent> readBack(rows);
+        ASSERT_GE(H5Dread(dataset, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, readBack.data()), 0);
+        for (size_t i = 0; i < events.size(); ++i) {
+            ASSERT_EQ(readBack[i].x, events[i].x);
+            ASSERT_EQ(readBack[i].y, events[i].y);
+            ASSERT_EQ(readBack[i].p, events[i].p);
+            ASSERT_EQ(readBack[i].t, events[i].t);
+        }
+
+        const hid_t triggerSet = H5Dopen2(file, "/EXT_TRIGGER/events", H5P_DEFAULT);
+        const hid_t triggerType = H5Tcreate(H5T_COMPOUND, sizeof(Hdf5EventWriter::TriggerEvent));
+        H5Tinsert(triggerType, "p", HOFFSET(Hdf5EventWriter::TriggerEvent, p), H5T_NATIVE_INT16);
+        H5Tinsert(triggerType, "t", HOFFSET(Hdf5EventWriter::TriggerEvent, t), H5T_NATIVE_INT64);
+        H5Tinsert(triggerType, "id", HOFFSET(Hdf5EventWriter::TriggerEvent, id), H5T_NATIVE_INT16);
+        std::vector<Hdf5EventWriter::TriggerEvent> triggerBack(triggers.size());
+        ASSERT_GE(H5Dread(triggerSet, triggerType, H5S_ALL, H5S_ALL, H5P_DEFAULT, triggerBack.data()), 0);
+        EXPECT_EQ(triggerBack[2].t, 1'004'000);
+        EXPECT_EQ(triggerBack[2].id, 3);
+
+        H5Tclose(triggerType);
+        H5Dclose(triggerSet);
+        H5Tclose(memType);
+        H5Sclose(space);
+        H5Dclose(dataset);
+        H5Fclose(file);
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(Hdf5EventWriter, IndexTableLayoutForATakeStartingLate) {
+    // The take starts 1 s into the camera clock, like any take after the first
+    const auto path = tempFile("indexes.hdf5");
+    const auto events = syntheticEvents(2500); // t = 1'000'000 + 3 i
+    {
+        Hdf5EventWriter::Options options;
+        options.chunkEvents = 1000;
+        Hdf5EventWriter writer(path.string(), options);
+        writer.addCdEvents(events.data(), events.data() + events.size());
+    }
+
+    const hid_t file = H5Fopen(path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    ASSERT_GE(file, 0);
+    EXPECT_GT(H5Aexists(file, "version"), 0);
+    EXPECT_GT(H5Aexists(file, "compression"), 0);
+    const hid_t indexes = H5Dopen2(file, "/CD/indexes", H5P_DEFAULT);
+    ASSERT_GE(indexes, 0);
+
+    // Compound {id uint64, ts int64}
+    const hid_t fileType = H5Dget_type(indexes);
+    ASSERT_EQ(H5Tget_nmembers(fileType), 2);
+    char* first = H5Tget_member_name(fileType, 0);
+    char* second = H5Tget_member_name(fileType, 1);
+    EXPECT_STREQ(first, "id");
+    EXPECT_STREQ(second, "ts");
+    H5free_memory(first);
+    H5free_memory(second);
+
+    // Timestamp offset attribute, 0: ts values are absolute
+    ASSERT_GT(H5Aexists(indexes, "offset"), 0);
+    const hid_t offsetAttribute = H5Aopen(indexes, "offset", H5P_DEFAULT);
+    int64_t offset = -1;
+    ASSERT_GE(H5Aread(offsetAttribute, H5T_NATIVE_INT64, &offset), 0);
+    EXPECT_EQ(offset, 0);
+    H5Aclose(offsetAttribute);
+
+    struct Row { uint64_t id; int64_t ts; };
+    const hid_t rowType = H5Tcreate(H5T_COMPOUND, sizeof(Row));
+    H5Tinsert(rowType, "id", HOFFSET(Row, id), H5T_NATIVE_UINT64);
+    H5Tinsert(rowType, "ts", HOFFSET(Row, ts), H5T_NATIVE_INT64);
+    const hid_t space = H5Dget_space(indexes);
+    hsize_t count = 0;
+    H5Sget_simple_extent_dims(space, &count, nullptr);
+    ASSERT_EQ(count, 504u);
+    std::vector<Row> rows(count);
+    ASSERT_GE(H5Dread(indexes, rowType, H5S_ALL, H5S_ALL, H5P_DEFAULT, rows.data()), 0);
+
+    // Row k: ts = k * 2000, id = first event with t >= ts
+    for (size_t k = 0; k < rows.size(); ++k) {
+        const int64_t ts = static_cast<int64_t>(k) * 2000;
+        ASSERT_EQ(rows[k].ts, ts) << "row " << k;
+        uint64_t id = 0;
+        while (id < events.size() && events[id].t < ts) ++id;
+        ASSERT_EQ(rows[k].id, id) << "row " << k;
+    }
+    EXPECT_EQ(rows[500].id, 0u);    // t = 1.000 s, the first event
+    EXPECT_EQ(rows[501].id, 667u);  // t = 1.002 s
+    EXPECT_EQ(rows[503].id, 2000u); // t = 1.006 s
+
+    H5Sclose(space);
+    H5Tclose(rowType);
+    H5Tclose(fileType);
+    H5Dclose(indexes);
+    H5Fclose(file);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "bus_topic.h"
+#include <thread>
+
+namespace {
+struct Payload { int value; };
+}
+
+TEST(LiveDataBus, FanOutSharesSinglePayload) {
+    BusTopic<Payload> topic;
+    auto a = topic.subscribe("a", 4);
+    auto b = topic.subscribe("b", 4);
+    EXPECT_TRUE(topic.hasSubscribers());
+    auto item = std::make_shared<const Payload>(Payload{7});
+    topic.publish(item);
+    std::shared_ptr<const Payload> outA, outB;
+    ASSERT_TRUE(a->tryPop(outA));
+    ASSERT_TRUE(b->tryPop(outB));
+    // Same object delivered to both subscribers, no copies
+    EXPECT_EQ(outA.get(), item.get());
+    EXPECT_EQ(outB.get(), item.get());
+}
+
+TEST(LiveDataBus, DropOldestKeepsNewestItems) {
+    BusTopic<Payload> topic;
+    auto sub = topic.subscribe("gui", 2, DropPolicy::DropOldest);
+    for (int i = 0; i < 5; ++i) topic.publish(std::make_shared<const Payload>(Payload{i}));
+    EXPECT_EQ(sub->size(), 2u);
+    EXPECT_EQ(sub->dropped(), 3u);
+    std::shared_ptr<const Payload> out;
+    ASSERT_TRUE(sub->tryPop(out));
+    EXPECT_EQ(out->value, 3);
+    ASSERT_TRUE(sub->tryPop(out));
+    EXPECT_EQ(out->value, 4);
+}
+
+TEST(LiveDataBus, DropNewestKeepsBacklog) {
+    BusTopic<Payload> topic;
+    auto sub = topic.subscribe("writer", 2, DropPolicy::DropNewest);
+    for (int i = 0; i < 5; ++i) topic.publish(std::make_shared<const Payload>(Payload{i}));
+    std::shared_ptr<const Payload> out;
+    ASSERT_TRUE(sub->tryPop(out));
+    EXPECT_EQ(out->value, 0);
+    ASSERT_TRUE(sub->tryPop(out));
+    EXPECT_EQ(out->value, 1);
+    EXPECT_FALSE(sub->tryPop(out));
+}
+
+TEST(LiveDataBus, SlowSubscriberDoesNotAffectOthers) {
+    BusTopic<Payload> topic;
+    auto slow = topic.subscribe("slow", 1, DropPolicy::DropOldest);
+    auto fast = topic.subscribe("fast", 100, DropPolicy::DropOldest);
+    for (int i = 0; i < 50; ++i) topic.publish(std::make_shared<const Payload>(Payload{i}));
+    EXPECT_EQ(fast->size(), 50u);
+    EXPECT_EQ(fast->dropped(), 0u);
+    EXPECT_EQ(slow->size(), 1u);
+    auto latest = slow->takeLatest();
+    ASSERT_TRUE(latest);
+    EXPECT_EQ(latest->value, 49);
+}
+
+TEST(LiveDataBus, UnsubscribeStopsDeliveryAndWakesWaiter) {
+    BusTopic<Payload> topic;
+    auto sub = topic.subscribe("consumer", 4);
+    std::thread waiter([&] {
+        std::shared_ptr<const Payload> out;
+        EXPECT_FALSE(sub->waitPop(out, std::chrono::seconds(5)));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    topic.unsubscribe(sub);
+    waiter.join();
+    EXPECT_FALSE(topic.hasSubscribers());
+    topic.publish(std::make_shared<const Payload>(Payload{1}));
+    EXPECT_EQ(sub->size(), 0u);
+}
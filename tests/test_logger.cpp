@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "logger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+struct Collector {
+    std::mutex mutex;
+    std::vector<Log::Record> records;
+
+    void install() {
+        Log::setSink([this](const Log::Record& record) {
+            std::lock_guard<std::mutex> lock(mutex);
+            records.push_back(record);
+        });
+    }
+    std::vector<Log::Record> take() {
+        Log::flush();
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::move(records);
+    }
+};
+} // namespace
+
+TEST(Logger, DeliversFormattedLinesAboveTheLevel) {
+    Collector collector;
+    collector.install();
+    Log::setLevel(Log::Level::Info);
+
+    EBV_LOG_DEBUG << "hidden";
+    EBV_LOG_INFO << "camera " << 2 << " at " << std::fixed << 29.97 << " fps";
+    const int line = __LINE__ + 1;
+    EBV_LOG_ERROR << "disk full";
+    std::thread([] { EBV_LOG_WARN << "from another thread"; }).join();
+
+    const auto records = collector.take();
+    Log::setSink(nullptr);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records[0].message, "camera 2 at 29.970000 fps");
+    EXPECT_EQ(records[1].message, "disk full");
+    EXPECT_EQ(records[1].level, Log::Level::Error);
+    EXPECT_STREQ(records[1].file, "test_logger.cpp");
+    EXPECT_EQ(records[1].line, line);
+    EXPECT_EQ(records[2].message, "from another thread");
+    EXPECT_NE(records[2].thread, records[0].thread);
+    // Stream state does not leak into the next line
+    EXPECT_NE(Log::formatRecord(records[1]).find("ERROR"), std::string::npos);
+}
+
+TEST(Logger, RateLimitsRepeatedWarnings) {
+    Collector collector;
+    collector.install();
+    auto warn = [](int i) { EBV_LOG_WARN_EVERY(5) << "queue full " << i; };
+    for (int i = 0; i < 20; ++i) warn(i);
+    std::this_thread::sleep_for(1100ms);
+    warn(20);
+
+    const auto records = collector.take();
+    Log::setSink(nullptr);
+    ASSERT_EQ(records.size(), 6u);
+    EXPECT_EQ(records[4].message, "queue full 4");
+    EXPECT_EQ(records[5].message, "queue full 20 (15 similar suppressed)");
+}
+
+TEST(Logger, SlowSinkDropsInsteadOfBlocking) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool entered = false;
+    bool release = false;
+    std::vector<Log::Record> records;
+    Log::setSink([&](const Log::Record& record) {
+        std::unique_lock<std::mutex> lock(mutex);
+        records.push_back(record);
+        entered = true;
+        cv.notify_all();
+        cv.wait(lock, [&] { return release; });
+    });
+    const uint64_t droppedBefore = Log::droppedCount();
+
+    EBV_LOG_INFO << "first";
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, 2s, [&] { return entered; }));
+    }
+    // The sink is stuck (a blocked terminal); logging must not wait for it
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; ++i) EBV_LOG_INFO << "line " << i;
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+    EXPECT_GT(Log::droppedCount(), droppedBefore);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    cv.notify_all();
+    Log::flush();
+    Log::setSink(nullptr);
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_FALSE(records.empty());
+    EXPECT_NE(records.back().message.find("log lines dropped"), std::string::npos);
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "memory_accounting.h"
+
+namespace {
+MemoryAccounting::PoolUsage usageOf(const std::string& name) {
+    for (const auto& pool : MemoryAccounting::snapshot()) {
+        if (pool.name == name) return pool;
+    }
+    return {};
+}
+} // namespace
+
+TEST(MemoryAccounting, CountersOfOnePoolAddUpAndReleaseOnDestruction) {
+    MemoryCounter first("test_cache");
+    first.add(1000);
+    first.add(500);
+    first.release(500);
+    {
+        MemoryCounter second("test_cache");
+        second.add(4000, 2);
+        const auto pool = usageOf("test_cache");
+        EXPECT_EQ(pool.bytes, 5000u);
+        EXPECT_EQ(pool.items, 3u);
+        EXPECT_EQ(pool.peakBytes, 5000u);
+    }
+    // The destroyed owner's entries no longer count, the peak stays
+    auto pool = usageOf("test_cache");
+    EXPECT_EQ(pool.bytes, 1000u);
+    EXPECT_EQ(pool.items, 1u);
+    EXPECT_EQ(pool.peakBytes, 5000u);
+
+    first.clear();
+    EXPECT_EQ(usageOf("test_cache").bytes, 0u);
+    EXPECT_EQ(first.bytes(), 0u);
+    first.release(10); // never wraps below zero
+    EXPECT_EQ(usageOf("test_cache").bytes, 0u);
+}
+
+TEST(MemoryAccounting, SnapshotIsLargestFirstAndFormatsBytes) {
+    MemoryCounter small("test_small");
+    MemoryCounter large("test_large");
+    small.add(10);
+    large.add(10u << 20);
+    const auto pools = MemoryAccounting::snapshot();
+    ASSERT_GE(pools.size(), 2u);
+    EXPECT_EQ(pools.front().name, "test_large");
+    EXPECT_GE(MemoryAccounting::totalBytes(), (10u << 20) + 10u);
+
+    EXPECT_EQ(MemoryAccounting::formatBytes(512), "512 B");
+    EXPECT_EQ(MemoryAccounting::formatBytes(3u << 20), "3.0 MB");
+    EXPECT_EQ(MemoryAccounting::formatBytes(uint64_t(12) << 30), "12.0 GB");
+}
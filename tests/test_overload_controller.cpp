@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "overload_controller.h"
+
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(OverloadController, DegradesStepwiseAndRecoversWithHysteresis) {
+    OverloadController::Options options;
+    options.recoverAfter = 1000ms;
+    OverloadController controller(options);
+    double writerPressure = 0.0;
+    controller.addProbe("event_writer", [&writerPressure] { return writerPressure; });
+    std::vector<int> levels;
+    std::string lastReason;
+    controller.setLevelCallback([&](int level, const std::string& reason) {
+        levels.push_back(level);
+        lastReason = reason;
+    });
+
+    const auto t0 = OverloadController::Clock::time_point{} + 1h;
+    EXPECT_EQ(controller.evaluate(t0), 0);
+
+    // Saturated writer: one step per evaluation, capped at the last level
+    writerPressure = 0.9;
+    for (int i = 1; i <= OverloadController::maxLevel() + 2; ++i) {
+        controller.evaluate(t0 + i * 250ms);
+    }
+    EXPECT_EQ(controller.level(), OverloadController::maxLevel());
+    EXPECT_EQ(controller.dominantProbe(), "event_writer");
+    EXPECT_NE(lastReason.find("event_writer"), std::string::npos);
+
+    // Between the water marks nothing changes
+    writerPressure = 0.45;
+    EXPECT_EQ(controller.evaluate(t0 + 5s), OverloadController::maxLevel());
+
+    // Calm: one step back per calm period
+    writerPressure = 0.1;
+    EXPECT_EQ(controller.evaluate(t0 + 6s), OverloadController::maxLevel());
+    EXPECT_EQ(controller.evaluate(t0 + 6500ms), OverloadController::maxLevel());
+    EXPECT_EQ(controller.evaluate(t0 + 7s), OverloadController::maxLevel() - 1);
+    EXPECT_EQ(controller.evaluate(t0 + 7500ms), OverloadController::maxLevel() - 1);
+    EXPECT_EQ(controller.evaluate(t0 + 8s), OverloadController::maxLevel() - 2);
+
+    const std::vector<int> expected{1, 2, 3, 4, 3, 2};
+    EXPECT_EQ(levels, expected);
+}
+
+TEST(OverloadController, BudgetsOnlyEverGetCheaper) {
+    const auto full = OverloadController::budgetForLevel(0);
+    EXPECT_EQ(full.frameRateScale, 1.0);
+    EXPECT_EQ(full.resolutionScale, 1.0);
+    EXPECT_EQ(full.eventDensity, 1.0);
+    EXPECT_FALSE(full.prefetchPaused);
+
+    // Prefetch is the first thing to go
+    EXPECT_TRUE(OverloadController::budgetForLevel(1).prefetchPaused);
+    for (int level = 1; level <= OverloadController::maxLevel(); ++level) {
+        const auto previous = OverloadController::budgetForLevel(level - 1);
+        const auto current = OverloadController::budgetForLevel(level);
+        EXPECT_EQ(current.level, level);
+        EXPECT_LE(current.frameRateScale, previous.frameRateScale);
+        EXPECT_LE(current.resolutionScale, previous.resolutionScale);
+        EXPECT_LE(current.eventDensity, previous.eventDensity);
+        EXPECT_GT(current.frameRateScale, 0.0);
+    }
+    EXPECT_EQ(OverloadController::budgetForLevel(99).level, OverloadController::maxLevel());
+    EXPECT_EQ(OverloadController::budgetForLevel(-1).level, 0);
+}
+
+TEST(OverloadController, FailingProbesAreIgnored) {
+    OverloadController controller;
+    controller.addProbe("broken", []() -> double { throw std::runtime_error("gone"); });
+    controller.addProbe("queue", [] { return 0.7; });
+    controller.addCpuProbe();
+    EXPECT_EQ(controller.evaluate(), 1);
+    EXPECT_GE(controller.pressure(), 0.7);
+    controller.start();
+    controller.stop();
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "profiled_mutex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+LockProfiling::LockSnapshot snapshotOf(const std::string& name) {
+    for (auto& lock : LockProfiling::snapshot()) {
+        if (lock.name == name) return lock;
+    }
+    return {};
+}
+} // namespace
+
+TEST(ProfiledMutex, HistogramBucketsAreLog2Microseconds) {
+    EXPECT_EQ(LockProfiling::histogramBucket(0), 0u);
+    EXPECT_EQ(LockProfiling::histogramBucket(999), 0u);
+    EXPECT_EQ(LockProfiling::histogramBucket(1000), 1u);     // 1 us
+    EXPECT_EQ(LockProfiling::histogramBucket(3000), 2u);     // 2-4 us
+    EXPECT_EQ(LockProfiling::histogramBucket(1000000), 10u); // 1 ms
+    EXPECT_EQ(LockProfiling::histogramBucket(int64_t(3600) * 1000000000), LockProfiling::HISTOGRAM_BUCKETS - 1);
+}
+
+TEST(ProfiledMutex, RecordsWaitHoldAndBlockingSite) {
+    LockProfiling::InstrumentedMutex mutex("test_contended");
+    LockProfiling::InstrumentedMutex sameName("test_contended"); // shares the statistics
+
+    std::atomic<bool> held{false};
+    std::thread holder([&] {
+        std::lock_guard<LockProfiling::InstrumentedMutex> lock(mutex);
+        held = true;
+        std::this_thread::sleep_for(30ms);
+    });
+    while (!held) std::this_thread::yield();
+    {
+        std::lock_guard<LockProfiling::InstrumentedMutex> lock(mutex);
+    }
+    holder.join();
+    { std::lock_guard<LockProfiling::InstrumentedMutex> lock(sameName); }
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+
+    const auto stats = snapshotOf("test_contended");
+    EXPECT_EQ(stats.acquisitions, 4u);
+    EXPECT_EQ(stats.contended, 1u);
+    EXPECT_GE(stats.maxWaitNs, 10000000u);
+    EXPECT_GE(stats.maxHoldNs, 25000000u);
+    EXPECT_EQ(stats.waitHistogram[0], 3u); // uncontended acquisitions
+    ASSERT_FALSE(stats.callSites.empty());
+    // The waiting site comes first, and the holder's site is blamed for blocking it
+    EXPECT_GT(stats.callSites.front().waitNs, 0u);
+    const bool blamed = std::any_of(stats.callSites.begin(), stats.callSites.end(),
+                                    [](const LockProfiling::CallSiteSnapshot& site) { return site.blockedOthers == 1; });
+    EXPECT_TRUE(blamed);
+
+    std::ostringstream report;
+    LockProfiling::writeReport(report);
+    EXPECT_NE(report.str().find("test_contended: 4 acquisitions"), std::string::npos);
+
+    LockProfiling::reset();
+    EXPECT_EQ(snapshotOf("test_contended").acquisitions, 0u);
+}
+
+TEST(ProfiledMutex, WorksWithProjectConditionVariable) {
+    ProfiledMutex mutex("test_condition");
+    ProfiledConditionVariable condition;
+    bool ready = false;
+    std::thread producer([&] {
+        {
+            std::lock_guard<ProfiledMutex> lock(mutex);
+            ready = true;
+        }
+        condition.notify_one();
+    });
+    {
+        ProfiledUniqueLock lock(mutex);
+        EXPECT_TRUE(condition.wait_for(lock, 2s, [&] { return ready; }));
+    }
+    producer.join();
+}
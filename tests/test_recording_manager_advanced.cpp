@@ -62,7 +62,8 @@ TEST_F(RecordingManagerFixture, StartRecordingSuccessFlow) {
     // Expectations for implicit destructor stop
     EXPECT_CALL(*frameRaw, stopRecording()).Times(1);
     EXPECT_CALL(*eventRaw, stopRecording()).Times(1);
-    EXPECT_CALL(*eventRaw, stopLiveStreaming()).Times(1);
+    // Event pipeline keeps running after the take (sink detach only)
+    EXPECT_CALL(*eventRaw, stopLiveStreaming()).Times(0);
 
     ASSERT_TRUE(mgr->startRecording("./tmp_test_recording_dir"));
     EXPECT_TRUE(mgr->isRecording());
@@ -84,7 +85,7 @@ TEST_F(RecordingManagerFixture, StopRecordingCallsManagers) {
 
     EXPECT_CALL(*frameRaw, stopRecording()).Times(1);
     EXPECT_CALL(*eventRaw, stopRecording()).Times(1);
-    EXPECT_CALL(*eventRaw, stopLiveStreaming()).Times(1);
+    EXPECT_CALL(*eventRaw, stopLiveStreaming()).Times(0);
     mgr->stopRecording();
     EXPECT_FALSE(mgr->isRecording());
 }
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "recording_manager.h"
+#include "mocks/mock_camera_managers.h"
+
+#include <filesystem>
+#include <thread>
+
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+struct RecordingManagerCommandFixture : public ::testing::Test {
+    std::unique_ptr<NiceMock<MockFrameCameraManager>> frameMock;
+    std::unique_ptr<NiceMock<MockEventCameraManager>> eventMock;
+    MockFrameCameraManager* frameRaw{}; MockEventCameraManager* eventRaw{};
+    std::unique_ptr<RecordingManager> mgr;
+    void SetUp() override {
+        frameMock = std::make_unique<NiceMock<MockFrameCameraManager>>();
+        eventMock = std::make_unique<NiceMock<MockEventCameraManager>>();
+        frameRaw = frameMock.get(); eventRaw = eventMock.get();
+        ON_CALL(*eventRaw, startLiveStreaming()).WillByDefault(Return(true));
+        mgr = std::make_unique<RecordingManager>(std::move(frameMock), std::move(eventMock));
+    }
+};
+
+TEST_F(RecordingManagerCommandFixture, CommandsRunInOrderOffTheCallerThread) {
+    using State = RecordingManager::State;
+    const auto caller = std::this_thread::get_id();
+    std::thread::id controlThread;
+    // A slow stop must not block the submitting thread
+    EXPECT_CALL(*eventRaw, stopRecording()).WillOnce(Invoke([] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }));
+
+    auto configured = mgr->submitConfigure({}, [&](const RecordingManager::CommandResult&) {
+        controlThread = std::this_thread::get_id();
+    });
+    auto previewing = mgr->submitPreview();
+    auto recording = mgr->submitRecord("./tmp_command_take");
+    const auto submitted = std::chrono::steady_clock::now();
+    auto stopped = mgr->submitStop();
+    EXPECT_LT(std::chrono::steady_clock::now() - submitted, std::chrono::milliseconds(50));
+
+    EXPECT_TRUE(configured.get().success);
+    EXPECT_NE(controlThread, caller);
+    EXPECT_EQ(previewing.get().state, State::Previewing);
+    const auto recordResult = recording.get();
+    EXPECT_TRUE(recordResult.success);
+    EXPECT_EQ(recordResult.state, State::Recording);
+    const auto stopResult = stopped.get();
+    EXPECT_TRUE(stopResult.success);
+    EXPECT_EQ(stopResult.state, State::Previewing);
+    EXPECT_EQ(stopResult.directory, "./tmp_command_take");
+    std::filesystem::remove_all("./tmp_command_take");
+}
+
+TEST_F(RecordingManagerCommandFixture, RejectsInvalidTransitions) {
+    using Command = RecordingManager::Command;
+    using State = RecordingManager::State;
+    EXPECT_FALSE(RecordingManager::isValidTransition(State::Closed, Command::Record));
+    EXPECT_FALSE(RecordingManager::isValidTransition(State::Recording, Command::Configure));
+    EXPECT_TRUE(RecordingManager::isValidTransition(State::Recording, Command::Close));
+    EXPECT_TRUE(RecordingManager::isValidTransition(State::Recording, Command::NextTake));
+    EXPECT_FALSE(RecordingManager::isValidTransition(State::Closed, Command::NextTake));
+
+    // Nothing is touched for rejected commands
+    EXPECT_CALL(*frameRaw, startRecording(::testing::_)).Times(0);
+    EXPECT_CALL(*frameRaw, closeDevices()).Times(0);
+    const auto record = mgr->submitRecord("./tmp_command_rejected").get();
+    EXPECT_FALSE(record.success);
+    EXPECT_EQ(record.state, State::Closed);
+    EXPECT_EQ(record.message, "Cannot record while closed");
+    EXPECT_FALSE(mgr->submitClose().get().success);
+    EXPECT_FALSE(std::filesystem::exists("./tmp_command_rejected"));
+}
+
+TEST_F(RecordingManagerCommandFixture, NextTakeSwitchesWritersWithoutStopping) {
+    using State = RecordingManager::State;
+    ASSERT_TRUE(mgr->submitConfigure({}).get().success);
+    ASSERT_TRUE(mgr->submitRecord("./tmp_command_take_a").get().success);
+
+    // Neither stream stops: events switch at one timestamp, the frame writer moves on
+    EXPECT_CALL(*eventRaw, stopRecording()).Times(0);
+    EXPECT_CALL(*eventRaw, startRecording(::testing::_, ::testing::_)).Times(0);
+    EXPECT_CALL(*frameRaw, stopRecording()).Times(0);
+    EXPECT_CALL(*frameRaw, stopRecordingOnly()).Times(0);
+    EXPECT_CALL(*frameRaw, startRecording(::testing::_)).Times(0);
+    EXPECT_CALL(*frameRaw, startRecordingToPath(::testing::_)).Times(0);
+    EXPECT_CALL(*eventRaw, switchRecording("./tmp_command_take_b", ::testing::_)).Times(1);
+    EXPECT_CALL(*frameRaw, switchRecordingPath("./tmp_command_take_b")).Times(1);
+
+    const auto next = mgr->submitNextTake("./tmp_command_take_b").get();
+    EXPECT_TRUE(next.success);
+    EXPECT_EQ(next.state, State::Recording);
+    EXPECT_EQ(next.closedDirectory, "./tmp_command_take_a");
+    EXPECT_EQ(next.directory, "./tmp_command_take_b");
+    ::testing::Mock::VerifyAndClearExpectations(frameRaw);
+    ::testing::Mock::VerifyAndClearExpectations(eventRaw);
+
+    EXPECT_TRUE(mgr->submitStop().get().success);
+    std::filesystem::remove_all("./tmp_command_take_a");
+    std::filesystem::remove_all("./tmp_command_take_b");
+}
@@ -52,3 +52,42 @@ TEST_F(RecordingManagerConfigFixture, BiasMappingAppliesDefaultsAndOverrides) {
     // A default bias (e.g. bias_hpf) should exist with default value 0
     EXPECT_EQ(captured[0].biases.at("bias_hpf"), 0);
 }
+
+TEST_F(RecordingManagerConfigFixture, BiasOnlyChangeIsAppliedWithoutReopen) {
+    RecordingManager::RecordingConfig cfg; cfg.eventCameraSerials = {"S1","S2"};
+    cfg.biases["bias_diff_on"] = {5,6};
+    EXPECT_CALL(*frameRaw, openAndSetupDevices()).Times(1);
+    EXPECT_CALL(*eventRaw, openAndSetupDevices(_)).Times(1);
+    EXPECT_CALL(*frameRaw, closeDevices()).Times(1); // initial configure only
+    EXPECT_CALL(*eventRaw, closeDevices()).Times(1);
+    ASSERT_TRUE(mgr->configure(cfg));
+
+    std::vector<RecordingManager::IEventCameraManager::CameraConfig> applied;
+    EXPECT_CALL(*eventRaw, applyBiases(_)).WillOnce(::testing::Invoke([&](const auto& v){ applied = v; }));
+    cfg.biases["bias_diff_on"] = {7,8};
+    cfg.eventFileFormat = "raw";
+    EXPECT_TRUE(mgr->configure(cfg));
+    ASSERT_EQ(applied.size(), 2u);
+    EXPECT_EQ(applied[0].serial, "S1");
+    EXPECT_EQ(applied[0].biases.at("bias_diff_on"), 7);
+    EXPECT_EQ(applied[1].biases.at("bias_diff_on"), 8);
+    EXPECT_TRUE(mgr->isConfigured());
+    ::testing::Mock::VerifyAndClearExpectations(frameRaw);
+    ::testing::Mock::VerifyAndClearExpectations(eventRaw);
+}
+
+TEST_F(RecordingManagerConfigFixture, SerialChangeReopensDevices) {
+    RecordingManager::RecordingConfig cfg; cfg.eventCameraSerials = {"S1"};
+    EXPECT_CALL(*frameRaw, openAndSetupDevices()).Times(2);
+    EXPECT_CALL(*eventRaw, openAndSetupDevices(_)).Times(2);
+    EXPECT_CALL(*eventRaw, applyBiases(_)).Times(0);
+    ASSERT_TRUE(mgr->configure(cfg));
+    cfg.eventCameraSerials = {"S1","S2"};
+    EXPECT_TRUE(mgr->configure(cfg));
+
+    RecordingManager::RecordingConfig a, b;
+    a.eventCameraSerials = {"S1","S2"}; b.eventCameraSerials = {"S2","S1"};
+    EXPECT_TRUE(RecordingManager::requiresDeviceReopen(a, b)); // master changed
+    b.eventCameraSerials = a.eventCameraSerials; b.biases["bias_fo"] = {1,2}; b.outputPrefix = "x";
+    EXPECT_FALSE(RecordingManager::requiresDeviceReopen(a, b));
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "recording_preload.h"
+
+namespace {
+struct TestEvent {
+    uint16_t x;
+    uint16_t y;
+    int16_t p;
+    int64_t t;
+};
+} // namespace
+
+TEST(RecordingPreload, EventStoreFindsTimeRanges) {
+    PreloadBudget budget(1u << 20);
+    std::vector<TestEvent> events;
+    for (int i = 0; i < 1000; ++i) {
+        events.push_back({static_cast<uint16_t>(i % 640), static_cast<uint16_t>(i % 480),
+                          static_cast<int16_t>(i % 2), 5000000 + i * 10});
+    }
+    {
+        PreloadedEventStore store(budget, false, 100);
+        ASSERT_TRUE(store.append(events.begin(), events.begin() + 400));
+        ASSERT_TRUE(store.append(events.begin() + 400, events.end()));
+        EXPECT_EQ(store.size(), 1000u);
+        EXPECT_EQ(store.t(999), 5000000 + 9990);
+        EXPECT_EQ(store.x(641), 1);
+        EXPECT_EQ(store.p(3), 1);
+
+        const auto r = store.range(5000100, 5000200); // events 10..19
+        EXPECT_EQ(r.first, 10u);
+        EXPECT_EQ(r.second, 20u);
+        EXPECT_EQ(store.range(0, 5000000).second, 0u);
+        EXPECT_EQ(store.range(6000000, 7000000).first, 1000u);
+        EXPECT_GE(budget.used(), 1000u * PreloadedEventStore::BYTES_PER_EVENT);
+    }
+    // Destroying the store returns its memory to the budget
+    EXPECT_EQ(budget.used(), 0u);
+}
+
+TEST(RecordingPreload, CeilingRejectsOversizedStreams) {
+    PreloadBudget budget(100 * PreloadedEventStore::BYTES_PER_EVENT);
+    std::vector<TestEvent> events(200, TestEvent{1, 2, 1, 0});
+    PreloadedEventStore store(budget, true, 0);
+    EXPECT_TRUE(store.append(events.begin(), events.begin() + 50));
+    EXPECT_FALSE(store.append(events.begin() + 50, events.end()));
+    EXPECT_FALSE(store.isComplete());
+
+    // Frames: the second image no longer fits once the first used up the budget
+    PreloadBudget frameBudget(4096);
+    PreloadedFrameStore frames(frameBudget, false, 0, 0);
+    const std::vector<uint8_t> jpeg(3000, 0xAB);
+    ASSERT_TRUE(frames.append(jpeg.data(), jpeg.size()));
+    EXPECT_FALSE(frames.append(jpeg.data(), jpeg.size()));
+    ASSERT_EQ(frames.frameCount(), 1u);
+    EXPECT_EQ(frames.frame(0).second, jpeg.size());
+    EXPECT_EQ(frames.frame(0).first[2999], 0xAB);
+    EXPECT_EQ(frames.frame(1).first, nullptr);
+}
+
+TEST(RecordingPreload, LargeBuffersUseMappings) {
+    // Above the mapping threshold; huge pages are advisory and must not change behaviour
+    PreloadVector<uint32_t> values(PreloadAllocator<uint32_t>(true));
+    values.resize(PreloadMemory::MAPPING_THRESHOLD); // 4x the threshold in bytes
+    values.back() = 42;
+    EXPECT_EQ(values.back(), 42u);
+    EXPECT_GT(PreloadMemory::ceilingFor(PreloadOptions{}), 0u);
+    EXPECT_EQ(PreloadMemory::ceilingFor(PreloadOptions{true, 1234, false}), 1234u);
+}
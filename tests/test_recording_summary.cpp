@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "recording_summary.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+struct TestEvent {
+    uint16_t x;
+    uint16_t y;
+    int16_t p;
+    int64_t t;
+};
+} // namespace
+
+TEST(RecordingSummary, FrameStreamRatesDropsAndGaps) {
+    StreamStatistics stats;
+    // 3 s at 100 fps with one frame missing at 1.5 s (a 20 ms interval)
+    int64_t t = 0;
+    for (int i = 0; i < 300; ++i, t += 10'000) {
+        if (i == 150) continue;
+        stats.addFrame(t, 1000);
+    }
+    stats.addDroppedFrames(2);
+
+    const auto summary = stats.summary("frame_cam0", false);
+    EXPECT_EQ(summary.frames, 299u);
+    EXPECT_EQ(summary.droppedFrames, 2u);
+    EXPECT_EQ(summary.bytes, 299000u);
+    EXPECT_NEAR(summary.durationSeconds, 2.99, 1e-9);
+    EXPECT_NEAR(summary.fpsAvg, 298.0 / 2.99, 1e-6);
+    // Two whole seconds: 100 and 99 frames
+    EXPECT_DOUBLE_EQ(summary.fpsMin, 99.0);
+    EXPECT_DOUBLE_EQ(summary.fpsMax, 100.0);
+    EXPECT_EQ(summary.gaps, 1u);
+    EXPECT_DOUBLE_EQ(summary.maxGapMs, 20.0);
+
+    stats.reset();
+    EXPECT_EQ(stats.summary("frame_cam0", false).frames, 0u);
+}
+
+TEST(RecordingSummary, EventStreamCountsPolaritiesAndSilences) {
+    StreamStatistics stats;
+    std::vector<TestEvent> chunk;
+    for (int64_t t = 0; t < 1'000'000; t += 10) chunk.push_back({0, 0, static_cast<int16_t>(t % 40 == 0), t});
+    stats.addEvents(chunk.data(), chunk.data() + chunk.size());
+    // 200 ms without events, then one more chunk
+    std::vector<TestEvent> late = {{0, 0, 1, 1'200'000}, {0, 0, 0, 2'000'000}};
+    stats.addEvents(late.data(), late.data() + late.size());
+    stats.addTriggers(3);
+    stats.setBytes(4096);
+
+    const auto summary = stats.summary("ebv_cam_0", true);
+    EXPECT_EQ(summary.eventsOn, 25'001u);
+    EXPECT_EQ(summary.eventsOff, 75'001u);
+    EXPECT_EQ(summary.triggers, 3u);
+    EXPECT_EQ(summary.bytes, 4096u);
+    EXPECT_NEAR(summary.durationSeconds, 2.0, 1e-9);
+    EXPECT_NEAR(summary.rateOn, 25'001 / 2.0, 1e-6);
+    EXPECT_EQ(summary.gaps, 2u);
+    EXPECT_DOUBLE_EQ(summary.maxGapMs, 800.0);
+    EXPECT_DOUBLE_EQ(summary.rateMax, 100'000.0);
+}
+
+TEST(RecordingSummary, SavesOneKeyValueLinePerStatistic) {
+    StreamStatistics frames;
+    frames.addFrame(0, 10);
+    frames.addFrame(50'000, 10);
+    RecordingSummary summary(1.5, {frames.summary("frame_cam0", false)});
+
+    const auto directory = std::filesystem::temp_directory_path() / "ebv_recording_summary_test";
+    std::filesystem::create_directories(directory);
+    {
+        std::ofstream stale(directory / RecordingSummary::FILE_NAME);
+        stale << "stale summary of an earlier take, much longer than the new one ...\n" << std::string(4096, 'x');
+    }
+    ASSERT_TRUE(summary.save(directory));
+    EXPECT_FALSE(std::filesystem::exists(directory / (std::string(RecordingSummary::FILE_NAME) + ".tmp")));
+    std::ifstream in(directory / RecordingSummary::FILE_NAME);
+    std::stringstream content;
+    content << in.rdbuf();
+    std::filesystem::remove_all(directory);
+
+    const std::string text = content.str();
+    EXPECT_NE(text.find("duration_s=1.500\n"), std::string::npos);
+    EXPECT_NE(text.find("frame_cam0.frames=2\n"), std::string::npos);
+    EXPECT_NE(text.find("frame_cam0.fps_avg=20.00\n"), std::string::npos);
+    EXPECT_NE(text.find("frame_cam0.bytes=20\n"), std::string::npos);
+    EXPECT_EQ(text.find("events"), std::string::npos);
+    EXPECT_EQ(text.find("stale"), std::string::npos);
+}
+
+TEST(RecordingSummary, ChunksCountedOnlyScaleTheSplit) {
+    struct Event { int64_t t; int16_t p; };
+    StreamStatistics stats;
+    // 2 s of events in 1 ms chunks (1000 events, one in four ON), one 100 ms silence at 1.0 s;
+    // chunks 500..539 arrive while the statistics backlog is full and are only counted
+    std::vector<Event> chunk(1000);
+    for (int64_t c = 0; c < 2000; ++c) {
+        const int64_t first = c * 1000 + (c >= 1000 ? 100'000 : 0);
+        if (c >= 500 && c < 540) {
+            stats.addEventChunk(chunk.size(), first, first + 999);
+            continue;
+        }
+        for (int64_t i = 0; i < 1000; ++i) chunk[i] = Event{first + i, static_cast<int16_t>(i % 4 == 0)};
+        stats.addEvents(chunk.data(), chunk.data() + chunk.size());
+    }
+
+    const auto summary = stats.summary("ebv_cam_0", true);
+    EXPECT_EQ(summary.eventsOn + summary.eventsOff, 2'000'000u);
+    EXPECT_EQ(summary.eventsOn, 500'000u);
+    EXPECT_EQ(summary.eventsCountedOnly, 40'000u);
+    // Silences between looked-at events are still found across counted-only chunks
+    EXPECT_EQ(summary.gaps, 1u);
+    EXPECT_DOUBLE_EQ(summary.maxGapMs, 100.001);
+    EXPECT_NE(RecordingSummary(2.1, {summary}).format().find("ebv_cam_0.events_counted_only=40000\n"), std::string::npos);
+}
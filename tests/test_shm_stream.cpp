@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "shm_stream_exporter.h"
+#include "shm_stream_reader.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+std::string uniqueName(const char* tag) {
+    return "/ebv_test_" + std::string(tag) + "_" + std::to_string(::getpid());
+}
+
+void fillPattern(std::vector<uint8_t>& buffer, uint64_t seed) {
+    for (size_t i = 0; i < buffer.size(); i += 64) buffer[i] = static_cast<uint8_t>(seed + i / 64);
+}
+
+bool checkPattern(const uint8_t* data, size_t bytes, uint64_t seed) {
+    for (size_t i = 0; i < bytes; i += 64) {
+        if (data[i] != static_cast<uint8_t>(seed + i / 64)) return false;
+    }
+    return true;
+}
+}
+
+TEST(ShmStream, ReaderReceivesFramesAndEvents) {
+    ShmStreamExporter::Options options;
+    options.name = uniqueName("basic");
+    options.slotCount = 4;
+    options.slotBytes = 1 << 16;
+    ShmStreamExporter exporter(options);
+    ASSERT_TRUE(exporter.open());
+
+    ShmStreamReader reader;
+    ASSERT_TRUE(reader.open(options.name));
+
+    std::vector<uint8_t> frame(32 * 16 * 4);
+    fillPattern(frame, 3);
+    ASSERT_TRUE(exporter.publishFrame(1, 42, 1000, 32, 16, 24, frame.data(), frame.size()));
+    std::vector<int64_t> events(8, 5);
+    ASSERT_TRUE(exporter.publishEvents(0, 7, 123, events.data(), 4, events.size() * sizeof(int64_t)));
+
+    ShmStreamReader::Record record;
+    ASSERT_TRUE(reader.tryNext(record));
+    EXPECT_EQ(record.type, ebv_shm::RecordType::Frame);
+    EXPECT_EQ(record.cameraId, 1);
+    EXPECT_EQ(record.index, 42u);
+    EXPECT_EQ(record.width, 32u);
+    EXPECT_EQ(record.height, 16u);
+    ASSERT_EQ(record.payloadBytes, frame.size());
+    EXPECT_TRUE(checkPattern(record.payload, record.payloadBytes, 3));
+    EXPECT_TRUE(reader.stillValid(record));
+
+    ASSERT_TRUE(reader.tryNext(record));
+    EXPECT_EQ(record.type, ebv_shm::RecordType::EventChunk);
+    EXPECT_EQ(record.eventCount, 4u);
+    EXPECT_EQ(record.timestampUs, 123);
+    EXPECT_FALSE(reader.tryNext(record));
+
+    // Oversized payloads are rejected instead of truncated
+    std::vector<uint8_t> huge(options.slotBytes);
+    EXPECT_FALSE(exporter.publishFrame(0, 0, 0, 1, 1, 0, huge.data(), huge.size()));
+    EXPECT_EQ(exporter.rejectedCount(), 1u);
+}
+
+TEST(ShmStream, SlowReaderLosesRecordsWithoutBlockingWriter) {
+    ShmStreamExporter::Options options;
+    options.name = uniqueName("overrun");
+    options.slotCount = 4;
+    options.slotBytes = 4096;
+    ShmStreamExporter exporter(options);
+    ASSERT_TRUE(exporter.open());
+    ShmStreamReader reader;
+    ASSERT_TRUE(reader.open(options.name));
+
+    std::vector<uint8_t> payload(1024);
+    for (uint64_t i = 0; i < 10; ++i) {
+        fillPattern(payload, i);
+        ASSERT_TRUE(exporter.publishFrame(0, i, 0, 1, 1, 0, payload.data(), payload.size()));
+    }
+
+    ShmStreamReader::Record record;
+    std::vector<uint64_t> seen;
+    while (reader.tryNext(record)) {
+        EXPECT_TRUE(checkPattern(record.payload, record.payloadBytes, record.index));
+        seen.push_back(record.index);
+    }
+    // Only the last slotCount records survive; the rest are accounted as lost
+    EXPECT_EQ(seen, (std::vector<uint64_t>{6, 7, 8, 9}));
+    EXPECT_EQ(reader.lostCount(), 6u);
+
+    // A writer that overwrites a record being consumed invalidates it
+    fillPattern(payload, 10);
+    exporter.publishFrame(0, 10, 0, 1, 1, 0, payload.data(), payload.size());
+    ASSERT_TRUE(reader.tryNext(record));
+    for (uint64_t i = 11; i < 15; ++i) exporter.publishFrame(0, i, 0, 1, 1, 0, payload.data(), payload.size());
+    EXPECT_FALSE(reader.stillValid(record));
+}
+
+TEST(ShmStream, ThroughputWithStandInConsumer) {
+    ShmStreamExporter::Options options;
+    options.name = uniqueName("throughput");
+    options.slotCount = 16;
+    options.slotBytes = (2u << 20) + 64;
+    ShmStreamExporter exporter(options);
+    ASSERT_TRUE(exporter.open());
+    ShmStreamReader reader;
+    ASSERT_TRUE(reader.open(options.name));
+
+    constexpr uint64_t kRecords = 400;
+    std::vector<uint8_t> payload(2u << 20);
+
+    std::atomic<bool> writerDone{false};
+    uint64_t consumed = 0, corrupt = 0, lastIndex = 0;
+    bool ordered = true;
+    std::thread consumer([&] {
+        ShmStreamReader::Record record;
+        while (true) {
+            if (!reader.next(record, std::chrono::milliseconds(5))) {
+                if (writerDone) break;
+                continue;
+            }
+            const bool intact = checkPattern(record.payload, record.payloadBytes, record.index);
+            // Torn reads are only acceptable if the seqlock reports the overwrite
+            if (reader.stillValid(record)) {
+                if (!intact) ++corrupt;
+                if (consumed > 0 && record.index <= lastIndex) ordered = false;
+                lastIndex = record.index;
+                ++consumed;
+            }
+        }
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < kRecords; ++i) {
+        fillPattern(payload, i);
+        exporter.publishFrame(0, i, 0, 1024, 512, 24, payload.data(), payload.size());
+    }
+    const double writerSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    writerDone = true;
+    consumer.join();
+
+    const double mib = kRecords * payload.size() / double(1 << 20);
+    std::cout << "[shm throughput] writer " << mib / writerSeconds << " MiB/s, consumer read "
+              << consumed << "/" << kRecords << " records, lost " << reader.lostCount() << std::endl;
+
+    EXPECT_EQ(exporter.publishedCount(), kRecords);
+    EXPECT_EQ(corrupt, 0u);
+    EXPECT_TRUE(ordered);
+    EXPECT_GT(consumed, 0u);
+    EXPECT_LE(consumed + reader.lostCount(), kRecords);
+}
+
+TEST(ShmStream, LiveSegmentIsNotReplacedButStaleOneIs) {
+    ShmStreamExporter::Options options;
+    options.name = uniqueName("owner");
+    options.slotCount = 2;
+    options.slotBytes = 4096;
+    auto first = std::make_unique<ShmStreamExporter>(options);
+    ASSERT_TRUE(first->open());
+
+    // The owner (this process) is alive: a second recorder must not take the name over
+    ShmStreamExporter second(options);
+    EXPECT_FALSE(second.open());
+    ShmStreamReader reader;
+    ASSERT_TRUE(reader.open(options.name));
+    ASSERT_TRUE(first->publishFrame(0, 1, 0, 1, 1, 0, "x", 1));
+    ShmStreamReader::Record record;
+    EXPECT_TRUE(reader.tryNext(record));
+
+    // Pretend the owner crashed: its pid no longer exists
+    const int fd = ::shm_open(options.name.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    void* base = ::mmap(nullptr, ebv_shm::kRingHeaderBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    ASSERT_NE(base, MAP_FAILED);
+    static_cast<ebv_shm::RingHeader*>(base)->writerPid = 0x7ffffffe;
+    ::munmap(base, ebv_shm::kRingHeaderBytes);
+
+    EXPECT_TRUE(second.open());
+    first.reset();
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "session_manifest.h"
+#include "staging_migrator.h"
+#include <chrono>
+#include <fstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+fs::path makeTempRoot(const char* tag) {
+    auto root = fs::temp_directory_path() / ("ebv_" + std::string(tag) + "_" + std::to_string(::getpid()));
+    fs::remove_all(root);
+    fs::create_directories(root);
+    return root;
+}
+
+void writeFile(const fs::path& path, size_t bytes, char fill) {
+    fs::create_directories(path.parent_path());
+    std::ofstream out(path, std::ios::binary);
+    std::string data(bytes, fill);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+}
+
+TEST(SessionManifest, SaveLoadRoundTripIsAtomic) {
+    const auto dir = makeTempRoot("manifest");
+    SessionManifest manifest;
+    manifest.set(SessionManifest::KEY_STATE, "captured");
+    manifest.set("file.a.jpg", "12");
+    manifest.set("file.b.hdf5", "34");
+    manifest.set("other", "x=y"); // '=' in values is preserved
+    ASSERT_TRUE(manifest.save(dir));
+    EXPECT_FALSE(fs::exists(dir / (std::string(SessionManifest::FILE_NAME) + ".tmp")));
+
+    SessionManifest loaded;
+    ASSERT_TRUE(loaded.load(dir));
+    EXPECT_EQ(loaded.get(SessionManifest::KEY_STATE), "captured");
+    EXPECT_EQ(loaded.get("other"), "x=y");
+    EXPECT_EQ(loaded.keysWithPrefix("file.").size(), 2u);
+    EXPECT_EQ(loaded.get("missing", "none"), "none");
+    fs::remove_all(dir);
+}
+
+TEST(StagingMigrator, MovesTakeAndCompletesManifest) {
+    const auto root = makeTempRoot("migrate");
+    const auto staging = root / "staging" / "take1";
+    const auto final = root / "final" / "take1";
+    writeFile(staging / "frame_cam0" / "frame_0.jpg", 1000, 'a');
+    writeFile(staging / "frame_cam0" / "frame_1.jpg", 2000, 'b');
+    writeFile(staging / "ebv_cam_0.raw", 3u << 20, 'c');
+    SessionManifest captured;
+    captured.set(SessionManifest::KEY_STATE, "captured");
+    captured.save(staging);
+
+    bool callbackOk = false;
+    StagingMigrator migrator;
+    migrator.setCompletionCallback([&](const StagingMigrator::Job&, bool ok, const std::string&) { callbackOk = ok; });
+    migrator.enqueue({staging, final});
+    migrator.waitIdle();
+
+    EXPECT_TRUE(callbackOk);
+    EXPECT_FALSE(fs::exists(staging));
+    EXPECT_EQ(fs::file_size(final / "frame_cam0" / "frame_1.jpg"), 2000u);
+    EXPECT_EQ(fs::file_size(final / "ebv_cam_0.raw"), 3u << 20);
+    EXPECT_FALSE(fs::exists(final / "ebv_cam_0.raw.partial"));
+
+    SessionManifest manifest;
+    ASSERT_TRUE(manifest.load(final));
+    EXPECT_EQ(manifest.get(SessionManifest::KEY_STATE), "complete");
+    EXPECT_EQ(manifest.get("file.frame_cam0/frame_0.jpg"), "1000");
+    EXPECT_EQ(migrator.bytesMigrated(), 1000u + 2000u + (3u << 20));
+    fs::remove_all(root);
+}
+
+TEST(StagingMigrator, ThrottleLimitsBandwidth) {
+    const auto root = makeTempRoot("throttle");
+    writeFile(root / "staging" / "data.bin", 4u << 20, 'x');
+
+    StagingMigrator migrator(16u << 20); // 16 MiB/s -> 4 MiB takes >= ~250 ms
+    const auto start = std::chrono::steady_clock::now();
+    migrator.enqueue({root / "staging", root / "final"});
+    migrator.waitIdle();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(elapsed, std::chrono::milliseconds(200));
+    EXPECT_TRUE(fs::exists(root / "final" / "data.bin"));
+    fs::remove_all(root);
+}
+
+TEST(StagingMigrator, FailedMigrationKeepsStagingCopy) {
+    const auto root = makeTempRoot("migrate_fail");
+    const auto staging = root / "staging";
+    const auto final = root / "final";
+    writeFile(staging / "frame_cam0" / "frame_0.jpg", 1000, 'a');
+    // A non-empty directory in the way makes the rename into place fail
+    writeFile(final / "frame_cam0" / "frame_0.jpg" / "blocker", 1, 'x');
+
+    bool callbackOk = true;
+    std::string callbackMessage;
+    StagingMigrator migrator;
+    migrator.setCompletionCallback([&](const StagingMigrator::Job&, bool ok, const std::string& message) {
+        callbackOk = ok;
+        callbackMessage = message;
+    });
+    migrator.enqueue({staging, final});
+    migrator.waitIdle();
+
+    EXPECT_FALSE(callbackOk);
+    EXPECT_NE(callbackMessage.find("rename failed"), std::string::npos);
+    EXPECT_EQ(fs::file_size(staging / "frame_cam0" / "frame_0.jpg"), 1000u);
+    SessionManifest manifest;
+    ASSERT_TRUE(manifest.load(final));
+    EXPECT_EQ(manifest.get(SessionManifest::KEY_STATE), "failed");
+    fs::remove_all(root);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "stall_watchdog.h"
+
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(StallWatchdog, ReportsStallOnceAndItsFinalDuration) {
+    StallWatchdog watchdog;
+    std::vector<StallWatchdog::StallEvent> events;
+    watchdog.setStallCallback([&events](const StallWatchdog::StallEvent& event) { events.push_back(event); });
+
+    auto writer = watchdog.registerStage("frame_writer", 50ms);
+    writer->setDetail("/mnt/ssd1/take/frame_cam0");
+    const auto begin = StallWatchdog::Clock::now();
+
+    // Short calls are fine
+    { StallWatchdog::Heartbeat::Scope scope(writer.get(), "imwrite"); }
+    watchdog.check(StallWatchdog::Clock::now() + 10ms);
+    EXPECT_TRUE(events.empty());
+    EXPECT_EQ(writer->progress(), 1u);
+
+    writer->begin("imwrite");
+    watchdog.check(StallWatchdog::Clock::now() + 100ms);
+    watchdog.check(StallWatchdog::Clock::now() + 200ms); // still the same stall, not reported again
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_TRUE(events[0].ongoing);
+    EXPECT_EQ(events[0].stage, "frame_writer");
+    EXPECT_EQ(events[0].operation, "imwrite");
+    EXPECT_EQ(events[0].detail, "/mnt/ssd1/take/frame_cam0");
+    EXPECT_GE(events[0].duration, 100ms);
+
+    std::this_thread::sleep_for(5ms);
+    writer->end();
+    watchdog.check();
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_FALSE(events[1].ongoing);
+    EXPECT_GE(events[1].duration, 5ms);
+    EXPECT_EQ(watchdog.stallCount(), 1u);
+    EXPECT_EQ(watchdog.stallsSince(begin).size(), 1u);
+    EXPECT_TRUE(watchdog.stallsSince(StallWatchdog::Clock::now() + 1s).empty());
+}
+
+TEST(StallWatchdog, IdleStagesAndFinishedWorkersAreNotStalls) {
+    StallWatchdog watchdog(5ms);
+    std::vector<StallWatchdog::StallEvent> events;
+    watchdog.setStallCallback([&events](const StallWatchdog::StallEvent& event) { events.push_back(event); });
+
+    auto idle = watchdog.registerStage("event_writer0", 10ms);
+    watchdog.check(StallWatchdog::Clock::now() + 1s); // waiting for work, never bracketed
+    EXPECT_TRUE(events.empty());
+
+    // A worker that goes away in the middle of a stall still gets its stall closed
+    auto capture = watchdog.registerStage("frame_capture0", 10ms);
+    capture->begin("WaitForFinishedBuffer");
+    watchdog.check(StallWatchdog::Clock::now() + 50ms);
+    capture.reset();
+    watchdog.check();
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[1].stage, "frame_capture0");
+    EXPECT_FALSE(events[1].ongoing);
+
+    // The watchdog thread picks up stalls on its own
+    idle->begin("add_events");
+    for (int i = 0; i < 200 && events.size() < 3; ++i) {
+        if (i == 0) watchdog.start();
+        std::this_thread::sleep_for(5ms);
+    }
+    watchdog.stop();
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[2].stage, "event_writer0");
+}
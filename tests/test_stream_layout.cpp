@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include "stream_layout.h"
+#include "session_manifest.h"
+
+TEST(StreamLayout, WithoutRootsEverythingStaysInTake) {
+    const auto streams = StreamLayout::streamNames(2, 2);
+    ASSERT_EQ(streams, (std::vector<std::string>{"frame_cam0", "ebv_cam_0", "frame_cam1", "ebv_cam_1"}));
+    const auto layout = StreamLayout::assign(streams, "rec/take_1", {});
+    for (const auto& [stream, dir] : layout) EXPECT_EQ(dir, std::filesystem::path("rec/take_1")) << stream;
+}
+
+TEST(StreamLayout, RoundRobinAndPinnedStreams) {
+    const auto streams = StreamLayout::streamNames(2, 2);
+    const auto layout = StreamLayout::assign(streams, "rec/take_1/", {"/mnt/a", "/mnt/b"},
+                                             {{"ebv_cam_1", "/mnt/c"}});
+    EXPECT_EQ(layout.at("frame_cam0"), std::filesystem::path("/mnt/a/take_1"));
+    EXPECT_EQ(layout.at("ebv_cam_0"), std::filesystem::path("/mnt/b/take_1"));
+    EXPECT_EQ(layout.at("frame_cam1"), std::filesystem::path("/mnt/a/take_1"));
+    EXPECT_EQ(layout.at("ebv_cam_1"), std::filesystem::path("/mnt/c/take_1"));
+
+    const auto eventDirs = StreamLayout::eventDirectories(layout, 2);
+    ASSERT_EQ(eventDirs.size(), 2u);
+    EXPECT_EQ(eventDirs[0], "/mnt/b/take_1");
+    EXPECT_EQ(eventDirs[1], "/mnt/c/take_1");
+}
+
+TEST(StreamLayout, ManifestResolvesStreamDirectory) {
+    SessionManifest manifest;
+    manifest.set(SessionManifest::streamKey("ebv_cam_0"), "/mnt/b/take_1");
+    EXPECT_EQ(manifest.streamDirectory("ebv_cam_0", "rec/take_1"), std::filesystem::path("/mnt/b/take_1"));
+    EXPECT_EQ(manifest.streamDirectory("frame_cam0", "rec/take_1"), std::filesystem::path("rec/take_1"));
+}